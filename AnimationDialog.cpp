@@ -14,6 +14,7 @@
 #include <vtkStreamingDemandDrivenPipeline.h>
 
 // STL includes
+#include <cmath>
 #include <iomanip>
 #include <sstream>
 
@@ -123,32 +124,52 @@ GLMotif::RowColumn* AnimationDialog::createTimeStepBox(
   loopButton->setToggle(false);
   loopButton->getValueChangedCallbacks().add(this,
     &AnimationDialog::loopPlayCallback);
-  std::stringstream stimeStepRange;
-  stimeStepRange << "Step (" << std::setprecision(4) <<
-    0 << " - " << this->numberOfTimeSteps - 1 << "):";
-  GLMotif::Label* timeStepLabel = new GLMotif::Label(
-    "TimeStep", buttonBox, stimeStepRange.str().c_str());
-  timeStepLabel->setHAlignment(GLFont::Center);
+  GLMotif::ToggleButton* globalRangeButton = new GLMotif::ToggleButton(
+    "GlobalRange", buttonBox, "Global Range");
+  globalRangeButton->setToggle(this->mooseViewer->reader().globalRanges());
+  globalRangeButton->getValueChangedCallbacks().add(this,
+    &AnimationDialog::globalRangeCallback);
+  GLMotif::ToggleButton* followButton = new GLMotif::ToggleButton(
+    "Follow", buttonBox, "Follow");
+  followButton->setToggle(this->mooseViewer->reader().follow());
+  followButton->getValueChangedCallbacks().add(this,
+    &AnimationDialog::followCallback);
+  this->timeStepLabel = new GLMotif::Label(
+    "TimeStep", buttonBox, "Step:");
+  this->timeStepLabel->setHAlignment(GLFont::Center);
   this->stepField = new GLMotif::TextField(
     "TimeStepField", buttonBox, 6);
   this->stepField->setHAlignment(GLFont::Center);
   this->stepField->setEditable(false);
   this->stepField->setValue(0);
-  std::stringstream stimeValueRange;
-  stimeValueRange << "Time (" << std::setprecision(4) <<
-    this->minTime << " - " << this->maxTime << "):";
-  GLMotif::Label* timeValueLabel = new GLMotif::Label(
-    "TimeValue", buttonBox, stimeValueRange.str().c_str());
-  timeValueLabel->setHAlignment(GLFont::Center);
+  this->timeValueLabel = new GLMotif::Label(
+    "TimeValue", buttonBox, "Time:");
+  this->timeValueLabel->setHAlignment(GLFont::Center);
   this->timeField = new GLMotif::TextField(
     "TimeValueField", buttonBox, 6);
   this->timeField->setHAlignment(GLFont::Center);
   this->timeField->setEditable(false);
   this->timeField->setPrecision(4);
   this->timeField->setValue(0.0f);
+  updateRangeLabels();
   return buttonBox;
 }
 
+/*
+ * updateRangeLabels - Show the current timestep and time ranges.
+ */
+void AnimationDialog::updateRangeLabels(void)
+{
+  std::stringstream stimeStepRange;
+  stimeStepRange << "Step (" << std::setprecision(4) <<
+    0 << " - " << this->numberOfTimeSteps - 1 << "):";
+  this->timeStepLabel->setString(stimeStepRange.str().c_str());
+  std::stringstream stimeValueRange;
+  stimeValueRange << "Time (" << std::setprecision(4) <<
+    this->minTime << " - " << this->maxTime << "):";
+  this->timeValueLabel->setString(stimeValueRange.str().c_str());
+}
+
 /*
  * renderFrameCallback - Render the appropriate frame.
  *
@@ -229,6 +250,32 @@ void AnimationDialog::loopPlayCallback(
   GLMotif::ToggleButton::ValueChangedCallbackData* _callbackData)
 {
   this->mooseViewer->Loop = _callbackData->set;
+  this->mooseViewer->reader().setPrefetchWraps(_callbackData->set);
+}
+
+/*
+ * globalRangeCallback - Map colors and contours over the range of all
+ *    timesteps instead of the current one.
+ *
+ * parameter _callbackData - Misc::CallbackData*
+ */
+void AnimationDialog::globalRangeCallback(
+  GLMotif::ToggleButton::ValueChangedCallbackData* _callbackData)
+{
+  this->mooseViewer->reader().setGlobalRanges(_callbackData->set);
+  Vrui::requestUpdate();
+}
+
+/*
+ * followCallback - Follow timesteps appended to the file.
+ *
+ * parameter _callbackData - GLMotif::ToggleButton::ValueChangedCallbackData*
+ */
+void AnimationDialog::followCallback(
+  GLMotif::ToggleButton::ValueChangedCallbackData* _callbackData)
+{
+  this->mooseViewer->setFollow(_callbackData->set, _callbackData->set);
+  Vrui::requestUpdate();
 }
 
 /*
@@ -244,19 +291,24 @@ void AnimationDialog::stopAnimation(void)
  */
 void AnimationDialog::updateTimeInformation(void)
 {
+  /* The range grows while following a file that is being written, and
+   * arrives after the dialog is created while the file is opened */
+  int numberOfTimeSteps = this->mooseViewer->reader().numberOfTimeSteps();
+  const double *timeRange = this->mooseViewer->reader().timeRange();
+  if (numberOfTimeSteps != this->numberOfTimeSteps ||
+      timeRange[0] != this->minTime || timeRange[1] != this->maxTime)
+    {
+    this->numberOfTimeSteps = numberOfTimeSteps;
+    this->minTime = timeRange[0];
+    this->maxTime = timeRange[1];
+    updateRangeLabels();
+    }
+
   int currentTimeStep = this->mooseViewer->reader().timeStep();
   this->stepField->setValue(currentTimeStep);
 
-  double timeValue = 0.0;
-  if (this->numberOfTimeSteps > 1)
-    {
-    timeValue = ((this->maxTime - this->minTime) *
-      (double(currentTimeStep)/(this->numberOfTimeSteps - 1))) + this->minTime;
-    timeValue = (timeValue < 1e-4) ? 0.0 : timeValue;
-    }
-  else
-    {
-    timeValue = this->minTime;
-    }
+  /* Exact once the time values are read, interpolated until then */
+  double timeValue = this->mooseViewer->reader().timeValue(currentTimeStep);
+  timeValue = (std::abs(timeValue) < 1e-4) ? 0.0 : timeValue;
   this->timeField->setValue(timeValue);
 }
@@ -3,6 +3,7 @@
 
 // Vrui includes
 #include <GLMotif/Button.h>
+#include <GLMotif/Label.h>
 #include <GLMotif/PopupWindow.h>
 #include <GLMotif/RowColumn.h>
 #include <GLMotif/StyleSheet.h>
@@ -35,10 +36,17 @@ private:
     void playPauseCallback(GLMotif::Button::CallbackData* _callbackData);
     void loopPlayCallback(
       GLMotif::ToggleButton::ValueChangedCallbackData* _callbackData);
+    void globalRangeCallback(
+      GLMotif::ToggleButton::ValueChangedCallbackData* _callbackData);
+    void followCallback(
+      GLMotif::ToggleButton::ValueChangedCallbackData* _callbackData);
+    void updateRangeLabels(void);
 
     GLMotif::Button* playButton;
     GLMotif::TextField* stepField;
     GLMotif::TextField* timeField;
+    GLMotif::Label* timeStepLabel;
+    GLMotif::Label* timeValueLabel;
 
     double minTime, maxTime;
     int numberOfTimeSteps;
@@ -0,0 +1,90 @@
+#include "BlocksDialog.h"
+
+#include <Vrui/Vrui.h>
+
+#include <GLMotif/Label.h>
+#include <GLMotif/RowColumn.h>
+#include <GLMotif/ScrolledListBox.h>
+
+using GLMotif::Label;
+using GLMotif::ListBox;
+using GLMotif::PopupWindow;
+using GLMotif::RowColumn;
+using GLMotif::ScrolledListBox;
+
+//------------------------------------------------------------------------------
+BlocksDialog::BlocksDialog()
+  : PopupWindow("Blocks", Vrui::getWidgetManager(), "Blocks and Sets")
+{
+  RowColumn *layout = new RowColumn("BlocksLayout", this, false);
+  layout->setOrientation(RowColumn::VERTICAL);
+  layout->setPacking(RowColumn::PACK_TIGHT);
+
+  new Label("BlocksLabel", layout, "Element Blocks");
+  this->Blocks =
+      new ScrolledListBox("BlockList", layout, ListBox::MULTIPLE, 20, 6);
+  new Label("NodeSetsLabel", layout, "Node Sets");
+  this->NodeSets =
+      new ScrolledListBox("NodeSetList", layout, ListBox::MULTIPLE, 20, 4);
+  new Label("SideSetsLabel", layout, "Side Sets");
+  this->SideSets =
+      new ScrolledListBox("SideSetList", layout, ListBox::MULTIPLE, 20, 4);
+
+  layout->manageChild();
+}
+
+//------------------------------------------------------------------------------
+BlocksDialog::~BlocksDialog()
+{
+}
+
+//------------------------------------------------------------------------------
+void BlocksDialog::clearAllObjects()
+{
+  this->Blocks->getListBox()->clear();
+  this->NodeSets->getListBox()->clear();
+  this->SideSets->getListBox()->clear();
+}
+
+//------------------------------------------------------------------------------
+void BlocksDialog::addObject(mvReader::ObjectType type,
+                             const std::string &name, bool selected)
+{
+  ListBox *list = this->getScrolledListBox(type)->getListBox();
+  int index = list->addItem(name.c_str());
+  if (selected)
+    {
+    list->selectItem(index);
+    }
+}
+
+//------------------------------------------------------------------------------
+GLMotif::ScrolledListBox *
+BlocksDialog::getScrolledListBox(mvReader::ObjectType type)
+{
+  switch (type)
+    {
+    case mvReader::ObjectType::NodeSet:
+      return this->NodeSets;
+    case mvReader::ObjectType::SideSet:
+      return this->SideSets;
+    case mvReader::ObjectType::ElementBlock:
+    default:
+      return this->Blocks;
+    }
+}
+
+//------------------------------------------------------------------------------
+mvReader::ObjectType
+BlocksDialog::getObjectType(const GLMotif::ListBox *listBox) const
+{
+  if (listBox == this->NodeSets->getListBox())
+    {
+    return mvReader::ObjectType::NodeSet;
+    }
+  if (listBox == this->SideSets->getListBox())
+    {
+    return mvReader::ObjectType::SideSet;
+    }
+  return mvReader::ObjectType::ElementBlock;
+}
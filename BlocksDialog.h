@@ -0,0 +1,38 @@
+#ifndef BLOCKSDIALOG_INCLUDED
+#define BLOCKSDIALOG_INCLUDED
+
+#include <GLMotif/PopupWindow.h>
+
+#include "mvReader.h"
+
+#include <string>
+
+namespace GLMotif {
+class ListBox;
+class ScrolledListBox;
+} // end namespace GLMotif
+
+/* Dialog for selecting the element blocks, node sets and side sets to load. */
+class BlocksDialog : public GLMotif::PopupWindow
+{
+public:
+  BlocksDialog();
+  ~BlocksDialog();
+
+  void clearAllObjects();
+
+  void addObject(mvReader::ObjectType type, const std::string &name,
+                 bool selected);
+
+  GLMotif::ScrolledListBox *getScrolledListBox(mvReader::ObjectType type);
+
+  /* The type of objects listed by listBox. */
+  mvReader::ObjectType getObjectType(const GLMotif::ListBox *listBox) const;
+
+private:
+  GLMotif::ScrolledListBox *Blocks;
+  GLMotif::ScrolledListBox *NodeSets;
+  GLMotif::ScrolledListBox *SideSets;
+};
+
+#endif // BLOCKSDIALOG_INCLUDED
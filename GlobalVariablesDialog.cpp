@@ -0,0 +1,179 @@
+#include "GlobalVariablesDialog.h"
+
+#include "MooseViewer.h"
+#include "TimeSeriesPlot.h"
+#include "mvReader.h"
+
+#include <Vrui/Vrui.h>
+
+#include <GLMotif/Label.h>
+#include <GLMotif/RowColumn.h>
+#include <GLMotif/ScrolledListBox.h>
+#include <GLMotif/StyleSheet.h>
+#include <GLMotif/TextField.h>
+#include <GLMotif/WidgetManager.h>
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
+using GLMotif::Label;
+using GLMotif::ListBox;
+using GLMotif::PopupWindow;
+using GLMotif::RowColumn;
+using GLMotif::ScrolledListBox;
+using GLMotif::TextField;
+
+//------------------------------------------------------------------------------
+GlobalVariablesDialog::GlobalVariablesDialog(MooseViewer *mooseViewer)
+  : PopupWindow("GlobalVariables", Vrui::getWidgetManager(),
+                "Postprocessors"),
+    Viewer(mooseViewer),
+    GlobalsVersion(0)
+{
+  const GLMotif::StyleSheet &styleSheet =
+      *Vrui::getWidgetManager()->getStyleSheet();
+
+  RowColumn *layout = new RowColumn("GlobalVariablesLayout", this, false);
+  layout->setOrientation(RowColumn::HORIZONTAL);
+  layout->setPacking(RowColumn::PACK_TIGHT);
+
+  this->List = new ScrolledListBox("GlobalVariableList", layout,
+                                   ListBox::ATMOST_ONE, 20, 10);
+  this->List->getListBox()->getSelectionChangedCallbacks().add(
+        this, &GlobalVariablesDialog::selectionChangedCallback);
+
+  RowColumn *plotBox = new RowColumn("PlotBox", layout, false);
+  plotBox->setOrientation(RowColumn::VERTICAL);
+  plotBox->setPacking(RowColumn::PACK_TIGHT);
+
+  this->Plot = new TimeSeriesPlot("Plot", plotBox, false);
+  this->Plot->setBorderWidth(styleSheet.size * 0.5f);
+  this->Plot->setBorderType(GLMotif::Widget::LOWERED);
+  this->Plot->setMarginWidth(styleSheet.size);
+  this->Plot->setPreferredSize(GLMotif::Vector(
+        styleSheet.fontHeight * 20.0f, styleSheet.fontHeight * 10.0f, 0.0f));
+  this->Plot->manageChild();
+
+  RowColumn *valueBox = new RowColumn("ValueBox", plotBox, false);
+  valueBox->setOrientation(RowColumn::HORIZONTAL);
+  this->RangeLabel = new Label("Range", valueBox, "Reading...");
+  new Label("ValueLabel", valueBox, "Value:");
+  this->ValueField = new TextField("Value", valueBox, 10);
+  this->ValueField->setEditable(false);
+  this->ValueField->setPrecision(6);
+  this->ValueField->setString("");
+  valueBox->manageChild();
+
+  plotBox->manageChild();
+  layout->manageChild();
+}
+
+//------------------------------------------------------------------------------
+GlobalVariablesDialog::~GlobalVariablesDialog()
+{
+}
+
+//------------------------------------------------------------------------------
+void GlobalVariablesDialog::updateGlobalVariables()
+{
+  const mvReader &reader = this->Viewer->reader();
+
+  const unsigned long version = reader.globalVariablesVersion();
+  if (version != this->GlobalsVersion)
+    {
+    this->GlobalsVersion = version;
+
+    mvTimeSeries::GlobalVariables globals;
+    reader.globalVariables(globals);
+    this->Times.swap(globals.times);
+    this->Values.swap(globals.values);
+
+    // Only rebuild the list if the variables changed, to keep its state when
+    // timesteps are appended:
+    if (globals.names != this->Names)
+      {
+      this->Names.swap(globals.names);
+      const std::string selection = this->Selection;
+      ListBox *list = this->List->getListBox();
+      list->clear();
+      for (const std::string &name : this->Names)
+        {
+        list->addItem(name.c_str());
+        }
+      this->Selection.clear();
+      auto it = std::find(this->Names.begin(), this->Names.end(), selection);
+      if (it != this->Names.end())
+        {
+        list->selectItem(static_cast<int>(it - this->Names.begin()));
+        this->Selection = selection;
+        }
+      }
+    this->plotSelection();
+    }
+
+  // Follow the current timestep:
+  auto it = std::find(this->Names.begin(), this->Names.end(), this->Selection);
+  const size_t step = static_cast<size_t>(reader.timeStep());
+  if (it != this->Names.end() && reader.timeStep() >= 0 &&
+      step < this->Times.size())
+    {
+    const std::vector<double> &values = this->Values[it - this->Names.begin()];
+    this->Plot->setCurrentTime(this->Times[step]);
+    this->ValueField->setValue(step < values.size() ? values[step] : 0.0);
+    }
+  else
+    {
+    this->Plot->setCurrentTime(std::numeric_limits<double>::quiet_NaN());
+    this->ValueField->setString("");
+    }
+}
+
+//------------------------------------------------------------------------------
+void GlobalVariablesDialog::selectionChangedCallback(
+    GLMotif::ListBox::SelectionChangedCallbackData *callBackData)
+{
+  switch (callBackData->reason)
+    {
+    case ListBox::SelectionChangedCallbackData::ITEM_SELECTED:
+      this->Selection = callBackData->listBox->getItem(callBackData->item);
+      break;
+    case ListBox::SelectionChangedCallbackData::ITEM_DESELECTED:
+    case ListBox::SelectionChangedCallbackData::SELECTION_CLEARED:
+      this->Selection.clear();
+      break;
+    default:
+      return;
+    }
+  this->plotSelection();
+}
+
+//------------------------------------------------------------------------------
+void GlobalVariablesDialog::plotSelection()
+{
+  auto it = std::find(this->Names.begin(), this->Names.end(), this->Selection);
+  if (it == this->Names.end())
+    {
+    this->Plot->clearData();
+    std::ostringstream text;
+    if (this->Names.empty())
+      {
+      text << (this->GlobalsVersion == 0 ? "Reading..."
+                                         : "No global variables.");
+      }
+    else
+      {
+      text << "Select a variable.";
+      }
+    this->RangeLabel->setString(text.str().c_str());
+    return;
+    }
+
+  this->Plot->setData(this->Times, this->Values[it - this->Names.begin()], 1);
+  std::ostringstream range;
+  range << "Values " << this->Plot->getValueRange()[0] << " - "
+        << this->Plot->getValueRange()[1] << " over t = "
+        << this->Plot->getTimeRange()[0] << " - "
+        << this->Plot->getTimeRange()[1];
+  this->RangeLabel->setString(range.str().c_str());
+}
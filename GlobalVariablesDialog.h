@@ -0,0 +1,49 @@
+#ifndef GLOBALVARIABLESDIALOG_INCLUDED
+#define GLOBALVARIABLESDIALOG_INCLUDED
+
+#include <GLMotif/ListBox.h>
+#include <GLMotif/PopupWindow.h>
+
+#include <string>
+#include <vector>
+
+namespace GLMotif {
+class Label;
+class ScrolledListBox;
+class TextField;
+} // end namespace GLMotif
+
+class MooseViewer;
+class TimeSeriesPlot;
+
+/* Dialog plotting a global variable (MOOSE postprocessor) over time, with a
+ * marker at the current timestep. */
+class GlobalVariablesDialog : public GLMotif::PopupWindow
+{
+public:
+  explicit GlobalVariablesDialog(MooseViewer *mooseViewer);
+  ~GlobalVariablesDialog();
+
+  /* Refresh the list and plot from the reader's global variables, and move
+   * the current time marker to the reader's timestep. */
+  void updateGlobalVariables();
+
+private:
+  void selectionChangedCallback(
+    GLMotif::ListBox::SelectionChangedCallbackData *callBackData);
+  void plotSelection();
+
+  MooseViewer *Viewer;
+  GLMotif::ScrolledListBox *List;
+  TimeSeriesPlot *Plot;
+  GLMotif::Label *RangeLabel;
+  GLMotif::TextField *ValueField;
+
+  unsigned long GlobalsVersion;
+  std::vector<std::string> Names;
+  std::vector<double> Times;
+  std::vector<std::vector<double> > Values;
+  std::string Selection;
+};
+
+#endif // GLOBALVARIABLESDIALOG_INCLUDED
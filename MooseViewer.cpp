@@ -14,6 +14,7 @@
 #include <vtkLookupTable.h>
 #include <vtkMultiBlockDataSet.h>
 #include <vtkPointData.h>
+#include <vtkTimerLog.h>
 
 // OpenGL/Motif includes
 #include <GL/GLContextData.h>
@@ -41,19 +42,25 @@
 
 // MooseViewer includes
 #include "AnimationDialog.h"
+#include "BlocksDialog.h"
 #include "ColorMap.h"
 #include "Contours.h"
+#include "GlobalVariablesDialog.h"
 #include "MooseViewer.h"
 #include "mvApplicationState.h"
 #include "mvContours.h"
+#include "mvEnsembleReader.h"
 #include "mvGeometry.h"
+#include "mvInteractor.h"
 #include "mvInteractorTool.h"
+#include "mvMemoryBudget.h"
 #include "mvMouseRotationTool.h"
 #include "mvOutline.h"
 #include "mvReader.h"
 #include "mvSlice.h"
 #include "mvVolume.h"
 #include "ScalarWidget.h"
+#include "TimeSeriesDialog.h"
 #include "TransferFunction1D.h"
 #include "VariablesDialog.h"
 #include "WidgetHints.h"
@@ -73,7 +80,26 @@ MooseViewer::MooseViewer(int& argc,char**& argv)
     opacityValue(NULL),
     renderingDialog(NULL),
     sampleValue(NULL),
-    variablesDialog(0)
+    variablesDialog(0),
+    blocksDialog(0),
+    globalVariablesDialog(0),
+    timeSeriesDialog(0),
+    ProbeActive(false),
+    ProbeMoved(false),
+    ProbePicked(false),
+    m_scrubStepsLeft(-1),
+    m_scrubInterval(0.),
+    m_scrubLastChange(-1.),
+    m_informationVersion(0),
+    m_variablesListed(false),
+    m_benchmark(false),
+    m_startTime(vtkTimerLog::GetUniversalTime()),
+    m_firstFrameShown(false),
+    m_firstDataShown(false),
+    m_displayCentered(false),
+    m_saveSession(false),
+    m_restoreSession(false),
+    m_colorMapIndex(-1)
 {
   std::fill(m_colorMapCache, m_colorMapCache + 4 * 256, -1.); // invalid
   std::fill(this->Histogram, this->Histogram + 256, 0.f);
@@ -81,6 +107,8 @@ MooseViewer::MooseViewer(int& argc,char**& argv)
   this->ScalarRange[0] = 0.0;
   this->ScalarRange[1] = 255.0;
 
+  std::fill(this->ProbePosition, this->ProbePosition + 3, 0.0);
+
   // Add tool factories:
   Vrui::ToolManager *toolMgr = Vrui::getToolManager();
 
@@ -94,6 +122,8 @@ MooseViewer::MooseViewer(int& argc,char**& argv)
 //----------------------------------------------------------------------------
 MooseViewer::~MooseViewer(void)
 {
+  this->saveSession();
+
   delete[] m_colorMapCache;
   delete[] this->Histogram;
 
@@ -103,6 +133,9 @@ MooseViewer::~MooseViewer(void)
   delete this->mainMenu;
   delete this->renderingDialog;
   delete this->variablesDialog;
+  delete this->blocksDialog;
+  delete this->globalVariablesDialog;
+  delete this->timeSeriesDialog;
 }
 
 //----------------------------------------------------------------------------
@@ -110,6 +143,13 @@ void MooseViewer::initialize()
 {
   this->Superclass::initialize();
 
+  /* Apply the saved session first, so that the first read loads its timestep
+   * and variables, and every object is computed from them at once: */
+  if (m_restoreSession)
+    {
+    this->restoreSession();
+    }
+
   // Start async file read.
   m_mvState.reader().update(m_mvState);
 
@@ -129,9 +169,25 @@ void MooseViewer::initialize()
       getSelectionChangedCallbacks().add(
         this, &MooseViewer::changeVariablesCallback);
 
+  this->blocksDialog = new BlocksDialog;
+  this->updateBlocksDialog();
+  for (auto type : { mvReader::ObjectType::ElementBlock,
+                     mvReader::ObjectType::NodeSet,
+                     mvReader::ObjectType::SideSet })
+    {
+    this->blocksDialog->getScrolledListBox(type)->getListBox()->
+        getSelectionChangedCallbacks().add(
+          this, &MooseViewer::changeBlocksCallback);
+    }
+
   renderingDialog = createRenderingDialog();
   mainMenu=createMainMenu();
   Vrui::setMainMenu(mainMenu);
+  if (this->colorByVariablesMenu &&
+      !m_mvState.reader().requestedVariables().empty())
+    {
+    this->updateColorByVariablesMenu();
+    }
 
   /* Initialize the color editor */
   this->ColorEditor = new TransferFunction1D(this);
@@ -141,8 +197,23 @@ void MooseViewer::initialize()
     this, &MooseViewer::colorMapChangedCallback);
   this->ColorEditor->getAlphaChangedCallbacks().add(this,
     &MooseViewer::alphaChangedCallback);
+  if (m_colorMapIndex >= 0)
+    {
+    this->ColorEditor->changeColorMap(m_colorMapIndex);
+    }
   updateColorMap();
 
+  /* The saved table also holds edits made in the color editor: */
+  if (m_session.colorTable.size() == 256 * 4)
+    {
+    std::copy(m_session.colorTable.begin(), m_session.colorTable.end(),
+              m_colorMapCache);
+    for (int i = 0; i < 256; ++i)
+      {
+      m_mvState.colorMap().SetTableValue(i, m_colorMapCache + 4*i);
+      }
+    }
+
   /* Contours */
   this->ContoursDialog = new Contours(this);
   this->ContoursDialog->getAlphaChangedCallbacks().add(this,
@@ -151,20 +222,21 @@ void MooseViewer::initialize()
   /* Initialize the Animation control */
   this->AnimationControl = new AnimationDialog(this);
 
-  // TODO This is ugly, it'd be great to find a way around this.
-  // Force sync reader output:
-  while (m_mvState.reader().running(std::chrono::seconds(1)))
-    {
-    std::cout << "Waiting for initial file read to complete..." << std::endl;
-    }
-  m_mvState.reader().update(m_mvState); // Update cached data object
+  /* Postprocessor plots */
+  this->globalVariablesDialog = new GlobalVariablesDialog(this);
+
+  /* Time series plot of the probe */
+  this->timeSeriesDialog = new TimeSeriesDialog(this);
+
+  /* The first timestep is still being read; see updateStartup(). */
 }
 
 //----------------------------------------------------------------------------
 void MooseViewer::setFileName(const std::string &name)
 {
+  // The dialogs fill in as the metadata is read (see updateMetaData()):
   m_mvState.reader().setFileName(name);
-  m_mvState.reader().updateInformation();
+  m_mvState.reader().requestInformation();
 }
 
 //----------------------------------------------------------------------------
@@ -188,6 +260,7 @@ const std::string& MooseViewer::getWidgetHintsFile()
 //----------------------------------------------------------------------------
 void MooseViewer::setBenchmark(bool bench)
 {
+  m_benchmark = bench;
   m_mvState.contours().setBenchmark(bench);
   m_mvState.geometry().setBenchmark(bench);
   m_mvState.reader().setBenchmark(bench);
@@ -201,6 +274,213 @@ void MooseViewer::setProgressVisibility(bool vis)
   m_mvState.progress().setVisible(vis);
 }
 
+//----------------------------------------------------------------------------
+void MooseViewer::setPrefetchWindow(int steps)
+{
+  m_mvState.reader().setPrefetchWindow(steps);
+}
+
+//----------------------------------------------------------------------------
+void MooseViewer::setCompressedCache(int steps, double tolerance)
+{
+  m_mvState.reader().setCompressedTimeSteps(
+        steps > 0 ? steps : 0,
+        tolerance > 0. ? mvCompressedDataSet::Codec::ErrorBounded
+                       : mvCompressedDataSet::Codec::Lossless,
+        tolerance);
+}
+
+//----------------------------------------------------------------------------
+void MooseViewer::setColumnarCache(bool enable)
+{
+  m_mvState.reader().setColumnarCache(enable);
+}
+
+//----------------------------------------------------------------------------
+void MooseViewer::setFollow(bool follow, bool latest)
+{
+  m_mvState.reader().setFollow(follow);
+  m_mvState.reader().setFollowLatest(latest);
+}
+
+//----------------------------------------------------------------------------
+void MooseViewer::setSinglePrecision(bool single)
+{
+  m_mvState.reader().setSinglePrecision(single);
+}
+
+//----------------------------------------------------------------------------
+void MooseViewer::setNativeReader(bool native)
+{
+  m_mvState.reader().setNativeReader(native);
+}
+
+//----------------------------------------------------------------------------
+void MooseViewer::setReadThreads(int threads)
+{
+  /* Concurrent reads are limited to the threads of one mvParallelReader
+     read, which holds the IO lock for them. The background readers keep
+     taking turns with it and with each other, as they would otherwise call
+     into netCDF/HDF5 builds that may not be thread-safe (see mvIOLock): */
+  m_mvState.reader().setReadThreads(threads);
+}
+
+//----------------------------------------------------------------------------
+void MooseViewer::setMemoryLimit(size_t mebibytes)
+{
+  m_mvState.memoryBudget().setLimit(mebibytes << 20);
+}
+
+//----------------------------------------------------------------------------
+void MooseViewer::setCancelSupersededWork(bool cancel)
+{
+  m_mvState.reader().setCancelSupersededWork(cancel);
+}
+
+//----------------------------------------------------------------------------
+void MooseViewer::setScrubBenchmark(int steps, double interval)
+{
+  m_scrubStepsLeft = steps > 0 ? steps : -1;
+  m_scrubInterval = interval;
+  m_scrubLastChange = -1.;
+}
+
+//----------------------------------------------------------------------------
+void MooseViewer::setRuns(const std::vector<std::string> &files)
+{
+  m_mvState.reader().setRuns(files);
+  m_mvState.reader().requestInformation();
+}
+
+//----------------------------------------------------------------------------
+void MooseViewer::setSideBySide(bool side)
+{
+  m_mvState.reader().setSideBySide(side);
+}
+
+//----------------------------------------------------------------------------
+void MooseViewer::setSession(const std::string &fileName, bool restore)
+{
+  m_sessionFile = fileName;
+  m_saveSession = !fileName.empty() || restore;
+  m_restoreSession = restore;
+}
+
+//----------------------------------------------------------------------------
+std::string MooseViewer::sessionFile(void) const
+{
+  return m_sessionFile.empty()
+      ? mvSession::defaultFileName(m_mvState.reader().fileName())
+      : m_sessionFile;
+}
+
+//----------------------------------------------------------------------------
+void MooseViewer::restoreSession(void)
+{
+  mvSession session;
+  if (!session.load(this->sessionFile()))
+    {
+    return;
+    }
+  m_session = session;
+
+  /* What is read only carries over to the same dataset: */
+  mvReader &reader = m_mvState.reader();
+  if (session.fileName == reader.fileName())
+    {
+    /* Variables the file no longer has are dropped by the reader: */
+    reader.setRequestedVariables(session.variables);
+    if (session.timeStep >= 0)
+      {
+      reader.setTimeStep(session.timeStep);
+      }
+    if (session.variables.count(session.colorBy))
+      {
+      m_mvState.setColorByArray(session.colorBy);
+      }
+    }
+  else
+    {
+    std::cerr << "The session in '" << this->sessionFile() << "' was saved "
+                 "for '" << session.fileName << "'. Only restoring the view."
+              << std::endl;
+    }
+
+  m_colorMapIndex = session.colorMap;
+
+  mvGeometry &geometry = m_mvState.geometry();
+  if (session.volumeVisible)
+    {
+    geometry.setRepresentation(mvGeometry::NoGeometry);
+    geometry.setVisible(false);
+    m_mvState.volume().setVisible(true);
+    }
+  else if (session.representation >= mvGeometry::NoGeometry &&
+           session.representation <= mvGeometry::SurfaceWithEdges)
+    {
+    geometry.setRepresentation(
+          static_cast<mvGeometry::Representation>(session.representation));
+    geometry.setVisible(session.representation != mvGeometry::NoGeometry);
+    m_mvState.volume().setVisible(false);
+    }
+  geometry.setOpacity(session.opacity);
+  m_mvState.outline().setVisible(session.outlineVisible);
+
+  m_mvState.contours().setContourValues(session.contourValues);
+  m_mvState.contours().setVisible(session.contoursVisible);
+
+  mvSlice::Plane plane;
+  plane.normal = session.sliceNormal;
+  plane.origin = session.sliceOrigin;
+  m_mvState.slice().setPlane(plane);
+  m_mvState.slice().setVisible(session.sliceVisible);
+
+  /* The camera is restored on the first frame; see updateStartup(). */
+}
+
+//----------------------------------------------------------------------------
+void MooseViewer::saveSession(void)
+{
+  const mvReader &reader = m_mvState.reader();
+  if (!m_saveSession || reader.fileName().empty())
+    {
+    return;
+    }
+
+  mvSession session;
+  session.fileName = reader.fileName();
+  session.timeStep = reader.timeStep();
+  session.variables = reader.requestedVariables();
+  session.colorBy = m_mvState.colorByArray();
+
+  session.colorMap = m_colorMapIndex;
+  session.colorTable.assign(m_colorMapCache, m_colorMapCache + 256 * 4);
+
+  session.representation = m_mvState.geometry().representation();
+  session.opacity = m_mvState.geometry().opacity();
+  session.outlineVisible = m_mvState.outline().visible();
+  session.volumeVisible = m_mvState.volume().visible();
+
+  session.contoursVisible = m_mvState.contours().visible();
+  session.contourValues = m_mvState.contours().contourValues();
+
+  session.sliceVisible = m_mvState.slice().visible();
+  session.sliceNormal = m_mvState.slice().plane().normal;
+  session.sliceOrigin = m_mvState.slice().plane().origin;
+
+  const Vrui::NavTransform &nav = Vrui::getNavigationTransformation();
+  session.hasCamera = true;
+  std::copy(nav.getTranslation().getComponents(),
+            nav.getTranslation().getComponents() + 3,
+            session.cameraTranslation.begin());
+  std::copy(nav.getRotation().getQuaternion(),
+            nav.getRotation().getQuaternion() + 4,
+            session.cameraRotation.begin());
+  session.cameraScaling = nav.getScaling();
+
+  session.save(this->sessionFile());
+}
+
 //----------------------------------------------------------------------------
 GLMotif::PopupMenu* MooseViewer::createMainMenu(void)
 {
@@ -224,6 +504,15 @@ GLMotif::PopupMenu* MooseViewer::createMainMenu(void)
           this, &MooseViewer::showVariableDialogCallback);
     }
 
+  if (m_mvState.widgetHints().isEnabled("Blocks"))
+    {
+    GLMotif::ToggleButton *showBlocksDialog =
+        new GLMotif::ToggleButton("ShowBlocksDialog", mainMenu, "Blocks");
+    showBlocksDialog->setToggle(false);
+    showBlocksDialog->getValueChangedCallbacks().add(
+          this, &MooseViewer::showBlocksDialogCallback);
+    }
+
   if (m_mvState.widgetHints().isEnabled("ColorBy"))
     {
     GLMotif::CascadeButton* colorByVariablesCascade =
@@ -239,6 +528,14 @@ GLMotif::PopupMenu* MooseViewer::createMainMenu(void)
     colorMapSubCascade->setPopup(createColorMapSubMenu());
     }
 
+  if (m_mvState.widgetHints().isEnabled("Ensemble") &&
+      m_mvState.reader().runs().size() > 1)
+    {
+    GLMotif::CascadeButton* ensembleCascade =
+        new GLMotif::CascadeButton("EnsembleCascade", mainMenu, "Ensemble");
+    ensembleCascade->setPopup(createEnsembleMenu());
+    }
+
   if (m_mvState.widgetHints().isEnabled("ColorEditor"))
     {
     GLMotif::ToggleButton * showColorEditorDialog =
@@ -259,6 +556,16 @@ GLMotif::PopupMenu* MooseViewer::createMainMenu(void)
           this, &MooseViewer::showAnimationDialogCallback);
     }
 
+  if (m_mvState.widgetHints().isEnabled("GlobalVariables"))
+    {
+    GLMotif::ToggleButton * showGlobalVariablesDialog =
+        new GLMotif::ToggleButton("ShowGlobalVariablesDialog", mainMenu,
+                                  "Postprocessors");
+    showGlobalVariablesDialog->setToggle(false);
+    showGlobalVariablesDialog->getValueChangedCallbacks().add(
+          this, &MooseViewer::showGlobalVariablesDialogCallback);
+    }
+
   if (m_mvState.widgetHints().isEnabled("Representation"))
     {
     GLMotif::CascadeButton* representationCascade =
@@ -335,7 +642,7 @@ GLMotif::Popup* MooseViewer::createRepresentationMenu(void)
           "ShowOutline",representationMenu,"Outline");
     showOutline->getValueChangedCallbacks().add(
           this,&MooseViewer::changeRepresentationCallback);
-    showOutline->setToggle(true);
+    showOutline->setToggle(m_mvState.outline().visible());
     }
 
   if (m_mvState.widgetHints().isEnabled("Representations"))
@@ -347,9 +654,28 @@ GLMotif::Popup* MooseViewer::createRepresentationMenu(void)
   GLMotif::RadioBox* representation_RadioBox =
     new GLMotif::RadioBox("Representation RadioBox",representationMenu,true);
 
-  // Set to the default selected option. If left NULL, the first representation
-  // is chosen.
+  // Set to the current option (Surface by default, or as restored from a
+  // session). If left NULL, the first representation is chosen.
   GLMotif::ToggleButton *selected = NULL;
+  const char *current = "ShowSurface";
+  if (m_mvState.volume().visible())
+    {
+    current = "ShowVolume";
+    }
+  else if (!m_mvState.geometry().visible())
+    {
+    current = "ShowNone";
+    }
+  else
+    {
+    switch (m_mvState.geometry().representation())
+      {
+      case mvGeometry::Points: current = "ShowPoints"; break;
+      case mvGeometry::Wireframe: current = "ShowWireframe"; break;
+      case mvGeometry::SurfaceWithEdges: current = "ShowSurfaceWithEdges"; break;
+      default: break;
+      }
+    }
 
   if (m_mvState.widgetHints().isEnabled("None"))
     {
@@ -357,6 +683,10 @@ GLMotif::Popup* MooseViewer::createRepresentationMenu(void)
           "ShowNone",representation_RadioBox,"None");
     showNone->getValueChangedCallbacks().add(
           this,&MooseViewer::changeRepresentationCallback);
+    if (strcmp(current, "ShowNone") == 0)
+      {
+      selected = showNone;
+      }
     }
   if (m_mvState.widgetHints().isEnabled("Points"))
     {
@@ -364,6 +694,10 @@ GLMotif::Popup* MooseViewer::createRepresentationMenu(void)
           "ShowPoints",representation_RadioBox,"Points");
     showPoints->getValueChangedCallbacks().add(
           this,&MooseViewer::changeRepresentationCallback);
+    if (strcmp(current, "ShowPoints") == 0)
+      {
+      selected = showPoints;
+      }
     }
   if (m_mvState.widgetHints().isEnabled("Wireframe"))
     {
@@ -371,6 +705,10 @@ GLMotif::Popup* MooseViewer::createRepresentationMenu(void)
           "ShowWireframe",representation_RadioBox,"Wireframe");
     showWireframe->getValueChangedCallbacks().add(
           this,&MooseViewer::changeRepresentationCallback);
+    if (strcmp(current, "ShowWireframe") == 0)
+      {
+      selected = showWireframe;
+      }
     }
   if (m_mvState.widgetHints().isEnabled("Surface"))
     {
@@ -378,7 +716,10 @@ GLMotif::Popup* MooseViewer::createRepresentationMenu(void)
           "ShowSurface",representation_RadioBox,"Surface");
     showSurface->getValueChangedCallbacks().add(
           this,&MooseViewer::changeRepresentationCallback);
-    selected = showSurface;
+    if (strcmp(current, "ShowSurface") == 0)
+      {
+      selected = showSurface;
+      }
     }
   if (m_mvState.widgetHints().isEnabled("SurfaceWithEdges"))
     {
@@ -386,6 +727,10 @@ GLMotif::Popup* MooseViewer::createRepresentationMenu(void)
           "ShowSurfaceWithEdges",representation_RadioBox,"Surface with Edges");
     showSurfaceWithEdges->getValueChangedCallbacks().add(
           this,&MooseViewer::changeRepresentationCallback);
+    if (strcmp(current, "ShowSurfaceWithEdges") == 0)
+      {
+      selected = showSurfaceWithEdges;
+      }
     }
   if (m_mvState.widgetHints().isEnabled("Volume"))
     {
@@ -393,6 +738,10 @@ GLMotif::Popup* MooseViewer::createRepresentationMenu(void)
           "ShowVolume",representation_RadioBox,"Volume");
     showVolume->getValueChangedCallbacks().add(
           this,&MooseViewer::changeRepresentationCallback);
+    if (strcmp(current, "ShowVolume") == 0)
+      {
+      selected = showVolume;
+      }
     }
 
   representation_RadioBox->setSelectionMode(GLMotif::RadioBox::ALWAYS_ONE);
@@ -425,15 +774,28 @@ GLMotif::Popup * MooseViewer::createAnalysisToolsMenu(void)
   GLMotif::RadioBox * analysisTools_RadioBox = new GLMotif::RadioBox(
     "analysisTools", analysisToolsMenu, true);
 
+  GLMotif::ToggleButton *showSlice = NULL;
   if (m_mvState.widgetHints().isEnabled("Slice"))
     {
-    GLMotif::ToggleButton *showSlice = new GLMotif::ToggleButton(
+    showSlice = new GLMotif::ToggleButton(
           "Slice", analysisTools_RadioBox, "Slice");
     showSlice->getValueChangedCallbacks().add(
           this,&MooseViewer::changeAnalysisToolsCallback);
     }
 
+  if (m_mvState.widgetHints().isEnabled("Probe"))
+    {
+    GLMotif::ToggleButton *showProbe = new GLMotif::ToggleButton(
+          "Probe", analysisTools_RadioBox, "Time Series Probe");
+    showProbe->getValueChangedCallbacks().add(
+          this,&MooseViewer::changeAnalysisToolsCallback);
+    }
+
   analysisTools_RadioBox->setSelectionMode(GLMotif::RadioBox::ATMOST_ONE);
+  if (showSlice != NULL && m_mvState.slice().visible())
+    {
+    analysisTools_RadioBox->setSelectedToggle(showSlice);
+    }
 
   analysisToolsMenu->manageChild();
   m_mvState.widgetHints().popGroup();
@@ -465,6 +827,23 @@ void MooseViewer::updateVariablesDialog(void)
     }
 }
 
+//----------------------------------------------------------------------------
+void MooseViewer::updateBlocksDialog(void)
+{
+  const mvReader &reader = m_mvState.reader();
+  this->blocksDialog->clearAllObjects();
+  for (auto type : { mvReader::ObjectType::ElementBlock,
+                     mvReader::ObjectType::NodeSet,
+                     mvReader::ObjectType::SideSet })
+    {
+    for (const auto &name : reader.availableObjects(type))
+      {
+      this->blocksDialog->addObject(type, name,
+                                    reader.isObjectSelected(type, name));
+      }
+    }
+}
+
 //----------------------------------------------------------------------------
 void MooseViewer::updateColorByVariablesMenu(void)
 {
@@ -596,7 +975,8 @@ GLMotif::Popup* MooseViewer::createColorMapSubMenu(void)
     colorMaps->addToggle("Inverse Seismic");
     }
 
-  colorMaps->setSelectedToggle(selectedToggle);
+  colorMaps->setSelectedToggle(m_colorMapIndex >= 0 ? m_colorMapIndex
+                                                    : selectedToggle);
   colorMaps->getValueChangedCallbacks().add(this,
     &MooseViewer::changeColorMapCallback);
 
@@ -607,6 +987,45 @@ GLMotif::Popup* MooseViewer::createColorMapSubMenu(void)
   return colorMapSubMenuPopup;
 } // end createColorMapSubMenu()
 
+//----------------------------------------------------------------------------
+GLMotif::Popup* MooseViewer::createEnsembleMenu(void)
+{
+  m_mvState.widgetHints().pushGroup("Ensemble");
+
+  GLMotif::Popup* ensembleMenuPopup =
+    new GLMotif::Popup("EnsembleMenuPopup", Vrui::getWidgetManager());
+  GLMotif::SubMenu* ensembleMenu = new GLMotif::SubMenu(
+    "EnsembleMenu", ensembleMenuPopup, false);
+
+  /* One toggle per run, the displayed run selected: */
+  GLMotif::RadioBox* runs =
+    new GLMotif::RadioBox("Runs", ensembleMenu, false);
+  runs->setSelectionMode(GLMotif::RadioBox::ALWAYS_ONE);
+  for (const auto &run : m_mvState.reader().runs())
+    {
+    runs->addToggle(mvEnsembleReader::label(run).c_str());
+    }
+  runs->setSelectedToggle(std::max(0, m_mvState.reader().activeRun()));
+  runs->getValueChangedCallbacks().add(this,
+    &MooseViewer::changeRunCallback);
+  runs->manageChild();
+
+  if (m_mvState.widgetHints().isEnabled("SideBySide"))
+    {
+    GLMotif::ToggleButton* sideBySide = new GLMotif::ToggleButton(
+          "SideBySide", ensembleMenu, "Side by Side");
+    sideBySide->setToggle(m_mvState.reader().sideBySide());
+    sideBySide->getValueChangedCallbacks().add(
+          this, &MooseViewer::sideBySideCallback);
+    }
+
+  ensembleMenu->manageChild();
+
+  m_mvState.widgetHints().popGroup();
+
+  return ensembleMenuPopup;
+}
+
 //----------------------------------------------------------------------------
 GLMotif::PopupWindow* MooseViewer::createRenderingDialog(void) {
   const GLMotif::StyleSheet& ss = *Vrui::getWidgetManager()->getStyleSheet();
@@ -669,7 +1088,11 @@ void MooseViewer::frame()
 {
   // Update internal state:
   m_mvState.reader().update(m_mvState);
+  this->updateMetaData();
+  this->updateStartup();
   this->updateHistogram();
+  this->updateScrubBenchmark();
+  this->updateProbe();
 
   this->Superclass::frame();
 
@@ -696,15 +1119,180 @@ void MooseViewer::frame()
       }
     }
   this->AnimationControl->updateTimeInformation();
+  this->globalVariablesDialog->updateGlobalVariables();
+
+  // Keep polling a file that is being written:
+  if (m_mvState.reader().follow())
+    {
+    Vrui::scheduleUpdate(Vrui::getApplicationTime() +
+                         m_mvState.reader().followInterval());
+    }
 }
 
 //----------------------------------------------------------------------------
-void MooseViewer::initContext(GLContextData& contextData) const
+void MooseViewer::updateProbe(void)
 {
-  this->Superclass::initContext(contextData);
+  if (!this->ProbeActive)
+    {
+    return;
+    }
 
-  // Initialize the display:
-  this->centerDisplay();
+  /* Track the interactor while it is dragged, and read the time series once
+   * it is released, or when the color-by variable changes: */
+  const mvInteractor &interactor = m_mvState.interactor();
+  if (interactor.state() == mvInteractor::Translating)
+    {
+    const Vrui::Vector &v = interactor.current().getTranslation();
+    std::copy(v.getComponents(), v.getComponents() + 3, this->ProbePosition);
+    this->ProbeMoved = true;
+    }
+  else if (this->ProbeMoved ||
+           (this->ProbePicked &&
+            this->ProbeVariable != m_mvState.colorByArray()))
+    {
+    this->ProbeMoved = false;
+    this->ProbeVariable = m_mvState.colorByArray();
+    if (!this->ProbeVariable.empty())
+      {
+      m_mvState.reader().requestTimeSeries(this->ProbeVariable,
+                                           this->ProbePosition);
+      this->ProbePicked = true;
+      }
+    }
+
+  this->timeSeriesDialog->updateTimeSeries();
+
+  /* Poll until the time series is read: */
+  if (m_mvState.reader().readingTimeSeries())
+    {
+    Vrui::scheduleUpdate(Vrui::getApplicationTime() + 0.05);
+    }
+}
+
+//----------------------------------------------------------------------------
+void MooseViewer::updateMetaData(void)
+{
+  const mvReader &reader = m_mvState.reader();
+  if (reader.informationVersion() != m_informationVersion)
+    {
+    m_informationVersion = reader.informationVersion();
+    m_variablesListed = false;
+    this->updateBlocksDialog();
+    }
+
+  /* Fill in the variables a page at a time, so that files with thousands of
+   * variables do not stall a frame: */
+  if (!m_variablesListed)
+    {
+    m_variablesListed = this->variablesDialog->updateVariables(
+          reader.availableVariables(), reader.requestedVariables(), 64);
+    }
+
+  const bool loading = !reader.informationComplete() || !m_variablesListed;
+  this->variablesDialog->setLoading(loading);
+  if (loading)
+    {
+    Vrui::scheduleUpdate(Vrui::getApplicationTime() + 0.05);
+    }
+}
+
+//----------------------------------------------------------------------------
+void MooseViewer::updateStartup(void)
+{
+  const mvReader &reader = m_mvState.reader();
+
+  /* Return to the view of a restored session. Otherwise, center on the
+   * bounds, which come from the metadata until the first timestep arrives, if
+   * the format provides them: */
+  if (!m_displayCentered && m_session.hasCamera)
+    {
+    Vrui::Scalar rotation[4];
+    std::copy(m_session.cameraRotation.begin(),
+              m_session.cameraRotation.end(), rotation);
+    Vrui::setNavigationTransformation(Vrui::NavTransform(
+          Vrui::Vector(m_session.cameraTranslation.data()),
+          Vrui::Rotation::fromQuaternion(rotation),
+          m_session.cameraScaling));
+    m_displayCentered = true;
+    }
+  else if (!m_displayCentered && reader.bounds().IsValid())
+    {
+    this->centerDisplay();
+    m_displayCentered = true;
+    }
+
+  if (m_firstDataShown)
+    {
+    return;
+    }
+
+  const double elapsed = vtkTimerLog::GetUniversalTime() - m_startTime;
+  if (!m_firstFrameShown)
+    {
+    m_firstFrameShown = true;
+    if (m_benchmark)
+      {
+      std::cerr << "Time to first frame: " << elapsed << " s." << std::endl;
+      }
+    }
+
+  /* The outline and slice hints are drawn from the bounds meanwhile. Poll
+   * until the data is in: */
+  if (reader.dataTimeStep() < 0)
+    {
+    if (!reader.fileName().empty())
+      {
+      Vrui::scheduleUpdate(Vrui::getApplicationTime() + 0.05);
+      }
+    return;
+    }
+
+  m_firstDataShown = true;
+  if (m_benchmark)
+    {
+    std::cerr << "Time to first data frame: " << elapsed << " s." << std::endl;
+    }
+}
+
+//----------------------------------------------------------------------------
+void MooseViewer::updateScrubBenchmark(void)
+{
+  mvReader &reader = m_mvState.reader();
+  if (m_scrubStepsLeft < 0 || reader.dataTimeStep() < 0)
+    {
+    // Not scrubbing, or still waiting for the first dataset.
+    return;
+    }
+
+  const double now = Vrui::getApplicationTime();
+  if (m_scrubStepsLeft > 0)
+    {
+    if (m_scrubLastChange < 0. || now - m_scrubLastChange >= m_scrubInterval)
+      {
+      int next = reader.timeStep() + 1;
+      if (next > reader.timeStepRange()[1])
+        {
+        next = reader.timeStepRange()[0];
+        }
+      reader.setTimeStep(next);
+      m_scrubLastChange = now;
+      --m_scrubStepsLeft;
+      }
+    Vrui::scheduleUpdate(now + m_scrubInterval);
+    }
+  else if (reader.dataTimeStep() == reader.timeStep())
+    {
+    std::cerr << "Scrub load latency (cancellation "
+              << (reader.cancelSupersededWork() ? "on" : "off") << "): "
+              << now - m_scrubLastChange << " s from the last step change "
+                 "until timestep " << reader.timeStep() << " was loaded."
+              << std::endl;
+    m_scrubStepsLeft = -1;
+    }
+  else
+    {
+    Vrui::scheduleUpdate(now + 0.001);
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -771,6 +1359,24 @@ void MooseViewer::showVariableDialogCallback(
     }
 }
 
+//----------------------------------------------------------------------------
+void MooseViewer::showBlocksDialogCallback(
+    GLMotif::ToggleButton::ValueChangedCallbackData *callBackData)
+{
+  GLMotif::WidgetManager *mgr = Vrui::getWidgetManager();
+
+  if (callBackData->set)
+    {
+    GLMotif::WidgetManager::Transformation xform =
+        mgr->calcWidgetTransformation(mainMenu);
+    mgr->popupPrimaryWidget(this->blocksDialog, xform);
+    }
+  else
+    {
+    mgr->popdownWidget(this->blocksDialog);
+    }
+}
+
 //----------------------------------------------------------------------------
 void MooseViewer::changeRepresentationCallback(
   GLMotif::ToggleButton::ValueChangedCallbackData* callBackData)
@@ -825,6 +1431,32 @@ void MooseViewer::changeAnalysisToolsCallback(
   if (strcmp(callBackData->toggle->getName(), "Slice") == 0)
   {
     m_mvState.slice().setVisible(callBackData->set);
+    if (callBackData->set && this->ProbeActive)
+    {
+      this->ProbeActive = false;
+      Vrui::popdownPrimaryWidget(this->timeSeriesDialog);
+    }
+  }
+  else if (strcmp(callBackData->toggle->getName(), "Probe") == 0)
+  {
+    /* The interactor tool moves the probe instead of the slice: */
+    this->ProbeActive = callBackData->set;
+    if (callBackData->set)
+    {
+      m_mvState.slice().setVisible(false);
+      /* The time series reader is open now, so read the globals too: */
+      m_mvState.reader().requestGlobalVariables();
+      Vrui::getWidgetManager()->popupPrimaryWidget(
+        this->timeSeriesDialog,
+        Vrui::getWidgetManager()->calcWidgetTransformation(mainMenu));
+    }
+    else
+    {
+      Vrui::popdownPrimaryWidget(this->timeSeriesDialog);
+      m_mvState.reader().clearTimeSeries();
+      this->ProbeMoved = false;
+      this->ProbePicked = false;
+    }
   }
 }
 
@@ -892,6 +1524,25 @@ void MooseViewer::showAnimationDialogCallback(
   }
 }
 
+//----------------------------------------------------------------------------
+void MooseViewer::showGlobalVariablesDialogCallback(
+  GLMotif::ToggleButton::ValueChangedCallbackData* callBackData)
+{
+  GLMotif::WidgetManager *mgr = Vrui::getWidgetManager();
+
+  if (callBackData->set)
+    {
+    m_mvState.reader().requestGlobalVariables();
+    GLMotif::WidgetManager::Transformation xform =
+        mgr->calcWidgetTransformation(mainMenu);
+    mgr->popupPrimaryWidget(this->globalVariablesDialog, xform);
+    }
+  else
+    {
+    mgr->popdownWidget(this->globalVariablesDialog);
+    }
+}
+
 //----------------------------------------------------------------------------
 void MooseViewer::changeVariablesCallback(
     GLMotif::ListBox::SelectionChangedCallbackData *callBackData)
@@ -930,6 +1581,30 @@ void MooseViewer::changeVariablesCallback(
   this->updateColorByVariablesMenu();
 }
 
+//----------------------------------------------------------------------------
+void MooseViewer::changeBlocksCallback(
+    GLMotif::ListBox::SelectionChangedCallbackData *callBackData)
+{
+  bool selected;
+  switch (callBackData->reason)
+    {
+    case GLMotif::ListBox::SelectionChangedCallbackData::ITEM_SELECTED:
+      selected = true;
+      break;
+    case GLMotif::ListBox::SelectionChangedCallbackData::ITEM_DESELECTED:
+      selected = false;
+      break;
+    default:
+      return; // don't care
+    }
+
+  std::string name(callBackData->listBox->getItem(callBackData->item));
+  m_mvState.reader().setObjectSelected(
+        this->blocksDialog->getObjectType(callBackData->listBox), name,
+        selected);
+  Vrui::requestUpdate();
+}
+
 //----------------------------------------------------------------------------
 void MooseViewer::changeColorByVariablesCallback(
   GLMotif::ToggleButton::ValueChangedCallbackData* callBackData)
@@ -961,10 +1636,36 @@ void MooseViewer::changeColorMapCallback(
 {
   int value = callBackData->radioBox->getToggleIndex(
     callBackData->newSelectedToggle);
+  m_colorMapIndex = value;
   this->ColorEditor->changeColorMap(value);
   this->updateColorMap();
 }
 
+//----------------------------------------------------------------------------
+void MooseViewer::changeRunCallback(
+  GLMotif::RadioBox::ValueChangedCallbackData* callBackData)
+{
+  int run = callBackData->radioBox->getToggleIndex(
+    callBackData->newSelectedToggle);
+  if (run == m_mvState.reader().activeRun())
+    {
+    return;
+    }
+
+  // The runs share the mesh, so the selections usually carry over:
+  m_mvState.reader().setActiveRun(run);
+  m_mvState.reader().requestInformation();
+  Vrui::requestUpdate();
+}
+
+//----------------------------------------------------------------------------
+void MooseViewer::sideBySideCallback(
+  GLMotif::ToggleButton::ValueChangedCallbackData* callBackData)
+{
+  m_mvState.reader().setSideBySide(callBackData->set);
+  Vrui::requestUpdate();
+}
+
 //----------------------------------------------------------------------------
 void MooseViewer::colorMapChangedCallback(
   Misc::CallbackData* callBackData)
@@ -1016,7 +1717,14 @@ float * MooseViewer::getHistogram(void)
 //----------------------------------------------------------------------------
 void MooseViewer::updateHistogram(void)
 {
+  if (!m_mvState.reader().dataObject())
+    {
+    // Still reading the first timestep.
+    return;
+    }
+
   if (this->HistogramMTime > m_mvState.reader().dataObject()->GetMTime() &&
+      this->HistogramMTime > m_mvState.reader().metaDataMTime() &&
       this->HistogramMTime > m_mvState.colorByMTime())
     {
     // Up to date.
@@ -1026,7 +1734,9 @@ void MooseViewer::updateHistogram(void)
   std::fill(this->Histogram, this->Histogram + 256, 0.f);
 
   auto metaData = m_mvState.reader().variableMetaData(m_mvState.colorByArray());
-  if (metaData.valid())
+  if (metaData.valid() &&
+      !m_mvState.reader().histogram(m_mvState.colorByArray(), metaData.range,
+                                    this->Histogram, 256))
     {
     vtkCompositeDataIterator *it =
         m_mvState.reader().typedDataObject()->NewIterator();
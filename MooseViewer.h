@@ -3,6 +3,7 @@
 
 // MooseViewer includes
 #include "mvApplicationState.h"
+#include "mvSession.h"
 
 // vtkVRUI includes
 #include <vvApplication.h>
@@ -34,10 +35,13 @@ namespace GLMotif
 }
 
 class AnimationDialog;
+class BlocksDialog;
 class Contours;
 class TransferFunction1D;
+class GlobalVariablesDialog;
 class mvContours;
 class mvReader;
+class TimeSeriesDialog;
 class VariablesDialog;
 class vtkDataArray;
 class vtkLookupTable;
@@ -57,17 +61,22 @@ private:
   GLMotif::Popup* createAnalysisToolsMenu(void);
   GLMotif::Popup* createColorByVariablesMenu(void);
   GLMotif::Popup*  createColorMapSubMenu(void);
+  GLMotif::Popup* createEnsembleMenu(void);
   GLMotif::PopupWindow* renderingDialog;
   GLMotif::PopupWindow* createRenderingDialog(void);
   GLMotif::TextField* opacityValue;
 
   /* Update the menus */
   void updateVariablesDialog(void);
+  void updateBlocksDialog(void);
   void updateColorByVariablesMenu(void);
 
   /* Variables dialog */
   VariablesDialog *variablesDialog;
 
+  /* Blocks dialog */
+  BlocksDialog *blocksDialog;
+
   GLMotif::SubMenu* colorByVariablesMenu;
 
   /* Color editor dialog */
@@ -80,6 +89,9 @@ private:
   /* Animation dialog */
   AnimationDialog* AnimationControl;
 
+  /* Global variables (postprocessors) dialog */
+  GlobalVariablesDialog* globalVariablesDialog;
+
   /* Draw histogram */
   float* Histogram;
   vtkTimeStamp HistogramMTime;
@@ -88,6 +100,16 @@ private:
   /* Contours dialog */
   Contours* ContoursDialog;
 
+  /* Time series probe: the history of the color-by variable at the last
+   * position the interactor tool was dragged to. */
+  TimeSeriesDialog* timeSeriesDialog;
+  bool ProbeActive;
+  bool ProbeMoved;
+  bool ProbePicked;
+  double ProbePosition[3];
+  std::string ProbeVariable;
+  void updateProbe(void);
+
   /* Volume visible */
   GLMotif::TextField* sampleValue;
   GLMotif::TextField* radiusValue;
@@ -96,6 +118,36 @@ private:
   /* Custom scalar range */
   double ScalarRange[2];
 
+  /* Scripted scrubbing (see setScrubBenchmark()) */
+  int m_scrubStepsLeft; // -1 when not scrubbing
+  double m_scrubInterval;
+  double m_scrubLastChange; // Application time of the last step change
+  void updateScrubBenchmark(void);
+
+  /* Metadata read in the background (see mvReader::requestInformation()) */
+  unsigned long m_informationVersion; // Last version shown in the dialogs
+  bool m_variablesListed; // Whether the variables dialog caught up with it
+  void updateMetaData(void);
+
+  /* Progressive startup: frames are drawn while the first timestep is read,
+   * and the display is centered once the bounds are known. */
+  bool m_benchmark;
+  double m_startTime; // Wall time at construction
+  bool m_firstFrameShown;
+  bool m_firstDataShown;
+  bool m_displayCentered;
+  void updateStartup(void);
+
+  /* Session state optionally saved on exit and restored (see setSession()) */
+  std::string m_sessionFile; // Empty for the default of the dataset
+  bool m_saveSession;
+  bool m_restoreSession;
+  mvSession m_session; // As restored; defaults otherwise
+  int m_colorMapIndex; // Selected in the color map menu, -1 for the default
+  std::string sessionFile(void) const;
+  void restoreSession(void);
+  void saveSession(void);
+
   /* Constructors and destructors: */
 public:
   using Superclass = vvApplication;
@@ -103,7 +155,6 @@ public:
   virtual ~MooseViewer(void);
 
   void initialize() override;
-  virtual void initContext(GLContextData& contextData) const override;
   virtual void display(GLContextData& contextData) const override;
   virtual void frame() override;
 
@@ -126,6 +177,55 @@ public:
   // updated.
   void setProgressVisibility(bool vis);
 
+  // Number of upcoming timesteps to read in the background during animation.
+  void setPrefetchWindow(int steps);
+
+  // Keep up to `steps` timesteps that leave the prefetch cache compressed in
+  // memory: lossless if `tolerance` is 0, otherwise error-bounded with that
+  // maximum error relative to each component's range.
+  void setCompressedCache(int steps, double tolerance);
+
+  // Keep a memory-mapped sidecar cache of the loaded data next to the file.
+  void setColumnarCache(bool enable);
+
+  // Store coordinates and result arrays as floats.
+  void setSinglePrecision(bool single);
+
+  // Read through the Exodus C API instead of vtkExodusIIReader when possible.
+  void setNativeReader(bool native);
+
+  // Number of threads that read element blocks in parallel (1 = serial).
+  void setReadThreads(int threads);
+
+  // Watch the file for appended timesteps, optionally jumping to the newest.
+  void setFollow(bool follow, bool latest);
+
+  // Ceiling on the memory used by datasets, in MiB (0 = unlimited).
+  void setMemoryLimit(size_t mebibytes);
+
+  // Abandon reads and object updates of timesteps that are no longer current.
+  void setCancelSupersededWork(bool cancel);
+
+  // Once the first dataset is loaded, advance the timestep `steps` times, once
+  // every `interval` seconds, like repeated presses of "Next". Prints the time
+  // from the last change until the reader has loaded that timestep's data to
+  // stderr. This excludes the asynchronous updates of the displayed objects.
+  void setScrubBenchmark(int steps, double interval);
+
+  // Open the runs in `files` as an ensemble on the same mesh. The file name
+  // should be one of them; it is the run that is displayed.
+  void setRuns(const std::vector<std::string> &files);
+
+  // Display all the runs of the ensemble side by side.
+  void setSideBySide(bool side);
+
+  // Save the session (variables, coloring, contours, slice, timestep,
+  // representation and camera) to `fileName` on exit, or next to the dataset
+  // if empty. If `restore` is true, the session saved there is applied before
+  // the first timestep is read. Nothing is saved if `fileName` is empty and
+  // `restore` is false.
+  void setSession(const std::string &fileName, bool restore);
+
   /* Animation */
   bool IsPlaying;
   bool Loop;
@@ -155,15 +255,20 @@ public:
   void opacitySliderCallback(GLMotif::Slider::ValueChangedCallbackData* cbData);
   void sampleSliderCallback(GLMotif::Slider::ValueChangedCallbackData* cbData);
   void showVariableDialogCallback(GLMotif::ToggleButton::ValueChangedCallbackData* callBackData);
+  void showBlocksDialogCallback(GLMotif::ToggleButton::ValueChangedCallbackData* callBackData);
   void changeRepresentationCallback(GLMotif::ToggleButton::ValueChangedCallbackData* callBackData);
   void showRenderingDialogCallback(GLMotif::ToggleButton::ValueChangedCallbackData* callBackData);
   void showColorEditorDialogCallback(GLMotif::ToggleButton::ValueChangedCallbackData* callBackData);
   void showContoursDialogCallback(GLMotif::ToggleButton::ValueChangedCallbackData* callBackData);
   void showAnimationDialogCallback(GLMotif::ToggleButton::ValueChangedCallbackData* callBackData);
+  void showGlobalVariablesDialogCallback(GLMotif::ToggleButton::ValueChangedCallbackData* callBackData);
   void changeAnalysisToolsCallback(GLMotif::ToggleButton::ValueChangedCallbackData* callBackData);
   void changeVariablesCallback(GLMotif::ListBox::SelectionChangedCallbackData* callBackData);
+  void changeBlocksCallback(GLMotif::ListBox::SelectionChangedCallbackData* callBackData);
   void changeColorByVariablesCallback(GLMotif::ToggleButton::ValueChangedCallbackData* callBackData);
   void changeColorMapCallback(GLMotif::RadioBox::ValueChangedCallbackData* callBackData);
+  void changeRunCallback(GLMotif::RadioBox::ValueChangedCallbackData* callBackData);
+  void sideBySideCallback(GLMotif::ToggleButton::ValueChangedCallbackData* callBackData);
   void alphaChangedCallback(Misc::CallbackData* callBackData);
   void colorMapChangedCallback(Misc::CallbackData* callBackData);
   void updateColorMap(void);
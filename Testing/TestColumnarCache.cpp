@@ -0,0 +1,91 @@
+// Tests mvColumnarCache with an Exodus file whose displacements move the
+// mesh: each cached timestep keeps the coordinates it was read with.
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkExodusIIReader.h>
+#include <vtkMultiBlockDataSet.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+#include <vtkUnstructuredGrid.h>
+
+// STD includes
+#include <string>
+
+// MooseViewer includes
+#include "mvColumnarCache.h"
+#include "mvReadSettings.h"
+#include "mvTesting.h"
+#include "mvTestingExodus.h"
+
+namespace {
+
+const int NumberOfSteps = 2;
+
+//------------------------------------------------------------------------------
+// The first "temperature" value of data, or -1 if there is none.
+double firstTemperature(vtkMultiBlockDataSet *data)
+{
+  vtkUnstructuredGrid *leaf = mvTesting::firstLeaf(data);
+  vtkDataArray *array = leaf
+      ? leaf->GetPointData()->GetArray("temperature") : nullptr;
+  return array ? array->GetComponent(0, 0) : -1.;
+}
+
+//------------------------------------------------------------------------------
+void testDisplacements(const std::string &dir)
+{
+  mvReadSettings settings;
+  settings.fileName = dir + "displaced.e";
+  settings.numberOfTimeSteps = NumberOfSteps;
+  settings.variables.insert("temperature");
+  MV_CHECK(mvTesting::writeDisplacedFile(settings.fileName, NumberOfSteps));
+
+  // Cache every timestep as read:
+    {
+    mvColumnarCache cache;
+    cache.setEnabled(true);
+    vtkNew<vtkExodusIIReader> reader;
+    for (int step = 0; step < NumberOfSteps; ++step)
+      {
+      settings.apply(reader.Get());
+      reader->SetTimeStep(step);
+      reader->Update();
+      vtkNew<vtkMultiBlockDataSet> data;
+      data->DeepCopy(reader->GetOutput());
+      MV_CHECK(mvTesting::firstX(data.Get()) ==
+               mvTesting::displacement(step));
+      cache.store(settings, step, data.Get());
+      }
+    }
+
+  // A later session maps each timestep with its own coordinates:
+  mvColumnarCache cache;
+  cache.setEnabled(true);
+  for (int step = NumberOfSteps - 1; step >= 0; --step)
+    {
+    vtkSmartPointer<vtkMultiBlockDataSet> data = cache.load(settings, step);
+    MV_CHECK(data != nullptr);
+    MV_CHECK(mvTesting::firstX(data) == mvTesting::displacement(step));
+    MV_CHECK(firstTemperature(data) == step);
+    }
+}
+
+} // end anon namespace
+
+//------------------------------------------------------------------------------
+int main(int, char *[])
+{
+  const std::string dir = mvTesting::makeDirectory();
+  if (dir.empty())
+    {
+    return EXIT_FAILURE;
+    }
+  testDisplacements(dir);
+
+  // The cache directory is next to the data file:
+  mvTesting::removeDirectory(dir + "displaced.e.mvcache/");
+  mvTesting::removeDirectory(dir);
+  return mvTesting::result();
+}
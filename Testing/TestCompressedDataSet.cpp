@@ -0,0 +1,237 @@
+// Tests mvCompressedDataSet: lossless round trips, the error bound of the
+// ErrorBounded codec, and its lossless fallbacks.
+
+// VTK includes
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkDataSet.h>
+#include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
+#include <vtkIntArray.h>
+#include <vtkMultiBlockDataSet.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkSmartPointer.h>
+#include <vtkUnstructuredGrid.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+
+// MooseViewer includes
+#include "mvCompressedDataSet.h"
+#include "mvTesting.h"
+
+namespace {
+
+const vtkIdType NumberOfPoints = 1000;
+const vtkIdType NumberOfCells = 200;
+
+//------------------------------------------------------------------------------
+// A multiblock with one leaf holding smooth point data, cell data, an integer
+// array and an array with a NaN.
+vtkSmartPointer<vtkMultiBlockDataSet> makeData()
+{
+  vtkNew<vtkUnstructuredGrid> grid;
+  vtkNew<vtkPoints> points;
+  points->SetNumberOfPoints(NumberOfPoints);
+  for (vtkIdType i = 0; i < NumberOfPoints; ++i)
+    {
+    points->SetPoint(i, 0.01 * i, 0., 0.);
+    }
+  grid->SetPoints(points.Get());
+
+  vtkNew<vtkDoubleArray> velocity;
+  velocity->SetName("velocity");
+  velocity->SetNumberOfComponents(3);
+  velocity->SetNumberOfTuples(NumberOfPoints);
+  vtkNew<vtkDoubleArray> temperature;
+  temperature->SetName("temperature");
+  temperature->SetNumberOfTuples(NumberOfPoints);
+  vtkNew<vtkDoubleArray> damaged;
+  damaged->SetName("damaged");
+  damaged->SetNumberOfTuples(NumberOfPoints);
+  for (vtkIdType i = 0; i < NumberOfPoints; ++i)
+    {
+    const double x = 0.01 * i;
+    velocity->SetTuple3(i, std::sin(x), 100. * std::cos(x), 1e-3 * x);
+    temperature->SetValue(i, 300. + 50. * std::sin(3. * x));
+    damaged->SetValue(i, i == 10 ? std::numeric_limits<double>::quiet_NaN()
+                                 : x);
+    }
+  grid->GetPointData()->AddArray(velocity.Get());
+  grid->GetPointData()->SetScalars(temperature.Get());
+  grid->GetPointData()->AddArray(damaged.Get());
+
+  vtkNew<vtkFloatArray> stress;
+  stress->SetName("stress");
+  stress->SetNumberOfTuples(NumberOfCells);
+  vtkNew<vtkIntArray> ids;
+  ids->SetName("ObjectId");
+  ids->SetNumberOfTuples(NumberOfCells);
+  for (vtkIdType i = 0; i < NumberOfCells; ++i)
+    {
+    stress->SetValue(i, static_cast<float>(1e6 * std::cos(0.05 * i)));
+    ids->SetValue(i, static_cast<int>(i % 7));
+    }
+  grid->GetCellData()->AddArray(stress.Get());
+  grid->GetCellData()->AddArray(ids.Get());
+
+  vtkSmartPointer<vtkMultiBlockDataSet> mbds =
+      vtkSmartPointer<vtkMultiBlockDataSet>::New();
+  mbds->SetBlock(0, grid.Get());
+  return mbds;
+}
+
+//------------------------------------------------------------------------------
+vtkDataSet* leaf(vtkMultiBlockDataSet *mbds)
+{
+  return vtkDataSet::SafeDownCast(mbds->GetBlock(0));
+}
+
+//------------------------------------------------------------------------------
+// The largest difference between the values of a and b, relative to the range
+// of each component of a. Infinite if the arrays differ in shape, or if only
+// one of two values is NaN.
+double relativeError(vtkDataArray *a, vtkDataArray *b)
+{
+  if (!a || !b || a->GetNumberOfTuples() != b->GetNumberOfTuples() ||
+      a->GetNumberOfComponents() != b->GetNumberOfComponents())
+    {
+    return std::numeric_limits<double>::infinity();
+    }
+  double error = 0.;
+  for (int c = 0; c < a->GetNumberOfComponents(); ++c)
+    {
+    double range[2];
+    a->GetRange(range, c);
+    const double spread = range[1] > range[0] ? range[1] - range[0] : 1.;
+    for (vtkIdType t = 0; t < a->GetNumberOfTuples(); ++t)
+      {
+      const double x = a->GetComponent(t, c);
+      const double y = b->GetComponent(t, c);
+      if (std::isnan(x) || std::isnan(y))
+        {
+        if (std::isnan(x) != std::isnan(y))
+          {
+          return std::numeric_limits<double>::infinity();
+          }
+        continue;
+        }
+      error = std::max(error, std::fabs(x - y) / spread);
+      }
+    }
+  return error;
+}
+
+//------------------------------------------------------------------------------
+void testLossless()
+{
+  vtkSmartPointer<vtkMultiBlockDataSet> input = makeData();
+  mvCompressedDataSet compressed;
+  compressed.compress(input, mvCompressedDataSet::Codec::Lossless, 0.);
+  MV_CHECK(compressed.arrayBytes() > 0);
+  MV_CHECK(compressed.compressedBytes() <= compressed.arrayBytes());
+
+  // Compressing strips the arrays, not the input:
+  vtkDataSet *in = leaf(input);
+  MV_CHECK(in->GetPointData()->GetNumberOfArrays() == 3);
+
+  vtkSmartPointer<vtkMultiBlockDataSet> output = compressed.decompress();
+  MV_CHECK(output && output->GetNumberOfBlocks() == 1);
+  vtkDataSet *out = output ? leaf(output) : nullptr;
+  MV_CHECK(out && out->GetNumberOfPoints() == NumberOfPoints);
+  if (!out)
+    {
+    return;
+    }
+
+  const char *pointArrays[] = { "velocity", "temperature", "damaged" };
+  for (const char *name : pointArrays)
+    {
+    MV_CHECK(relativeError(in->GetPointData()->GetArray(name),
+                           out->GetPointData()->GetArray(name)) == 0.);
+    }
+  const char *cellArrays[] = { "stress", "ObjectId" };
+  for (const char *name : cellArrays)
+    {
+    vtkDataArray *a = in->GetCellData()->GetArray(name);
+    vtkDataArray *b = out->GetCellData()->GetArray(name);
+    MV_CHECK(relativeError(a, b) == 0.);
+    MV_CHECK(b && b->GetDataType() == a->GetDataType());
+    }
+
+  // Active attributes survive:
+  MV_CHECK(out->GetPointData()->GetScalars() &&
+           std::string(out->GetPointData()->GetScalars()->GetName()) ==
+           "temperature");
+}
+
+//------------------------------------------------------------------------------
+void testErrorBounded()
+{
+  const double tolerance = 1e-3;
+  vtkSmartPointer<vtkMultiBlockDataSet> input = makeData();
+  mvCompressedDataSet compressed;
+  compressed.compress(input, mvCompressedDataSet::Codec::ErrorBounded,
+                      tolerance);
+  MV_CHECK(compressed.compressedBytes() < compressed.arrayBytes());
+  MV_CHECK(compressed.memorySize() >= compressed.compressedBytes());
+
+  vtkSmartPointer<vtkMultiBlockDataSet> output = compressed.decompress();
+  vtkDataSet *in = leaf(input);
+  vtkDataSet *out = output ? leaf(output) : nullptr;
+  MV_CHECK(out != nullptr);
+  if (!out)
+    {
+    return;
+    }
+
+  // Quantized arrays move by at most the tolerance, with some slack for the
+  // rounding of single precision values:
+  MV_CHECK(relativeError(in->GetPointData()->GetArray("velocity"),
+                         out->GetPointData()->GetArray("velocity")) <=
+           tolerance * 1.001);
+  MV_CHECK(relativeError(in->GetPointData()->GetArray("temperature"),
+                         out->GetPointData()->GetArray("temperature")) <=
+           tolerance * 1.001);
+  MV_CHECK(relativeError(in->GetCellData()->GetArray("stress"),
+                         out->GetCellData()->GetArray("stress")) <=
+           tolerance * 1.001);
+
+  // Integer arrays and arrays with non-finite values stay exact:
+  MV_CHECK(relativeError(in->GetCellData()->GetArray("ObjectId"),
+                         out->GetCellData()->GetArray("ObjectId")) == 0.);
+  MV_CHECK(relativeError(in->GetPointData()->GetArray("damaged"),
+                         out->GetPointData()->GetArray("damaged")) == 0.);
+
+  // The exact ranges are seeded in the decompressed arrays:
+  double inRange[2];
+  double outRange[2];
+  in->GetPointData()->GetArray("velocity")->GetRange(inRange, 1);
+  out->GetPointData()->GetArray("velocity")->GetRange(outRange, 1);
+  MV_CHECK(inRange[0] == outRange[0] && inRange[1] == outRange[1]);
+}
+
+//------------------------------------------------------------------------------
+void testEmpty()
+{
+  // A dataset that was never compressed decompresses to nothing:
+  mvCompressedDataSet compressed;
+  MV_CHECK(!compressed.decompress());
+  MV_CHECK(compressed.arrayBytes() == 0);
+}
+
+} // end anon namespace
+
+//------------------------------------------------------------------------------
+int main(int, char *[])
+{
+  testLossless();
+  testErrorBounded();
+  testEmpty();
+  return mvTesting::result();
+}
@@ -0,0 +1,206 @@
+// Tests mvFormatReader: the choice of format from the file name, the cell
+// arrays built from offsets and connectivity, and reading an XML file series
+// with mvXMLReader.
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkCellType.h>
+#include <vtkCompositeDataSet.h>
+#include <vtkDataArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkInformation.h>
+#include <vtkMultiBlockDataSet.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkSmartPointer.h>
+#include <vtkUnstructuredGrid.h>
+#include <vtkXMLUnstructuredGridWriter.h>
+
+// STD includes
+#include <memory>
+#include <string>
+#include <vector>
+
+// MooseViewer includes
+#include "mvFormatReader.h"
+#include "mvReadSettings.h"
+#include "mvTesting.h"
+
+namespace {
+
+//------------------------------------------------------------------------------
+// Exposes the protected helpers of mvFormatReader.
+class Helpers : public mvFormatReader
+{
+public:
+  using mvFormatReader::makeCells;
+};
+
+//------------------------------------------------------------------------------
+void testFormats()
+{
+  MV_CHECK(mvFormatReader::isExodus("run.e"));
+  MV_CHECK(mvFormatReader::isExodus("run.exo"));
+  MV_CHECK(mvFormatReader::isExodus("results.vtu/run.e"));
+  MV_CHECK(!mvFormatReader::isExodus("run.VTU"));
+  MV_CHECK(!mvFormatReader::isExodus("run.pvtu"));
+  MV_CHECK(!mvFormatReader::isExodus("run.vtkhdf"));
+  MV_CHECK(!mvFormatReader::isExodus("run.h5"));
+  MV_CHECK(!mvFormatReader::isExodus("unix:/tmp/run.sock"));
+
+  MV_CHECK(mvFormatReader::isStream("unix:/tmp/run.sock"));
+  MV_CHECK(!mvFormatReader::isStream("/tmp/unix:run.e"));
+
+  MV_CHECK(!mvFormatReader::create("run.e"));
+  std::unique_ptr<mvFormatReader> reader = mvFormatReader::create("run.vtu");
+  MV_CHECK(reader && std::string(reader->formatName()) == "VTK XML");
+  reader = mvFormatReader::create("run.HDF");
+  MV_CHECK(reader && std::string(reader->formatName()) == "VTKHDF");
+
+  // forFile() keeps the reader of the same file, and replaces it otherwise:
+  mvFormatReader *same = mvFormatReader::forFile(reader, "run.HDF");
+  MV_CHECK(same && same == reader.get());
+  mvFormatReader *other = mvFormatReader::forFile(reader, "run.pvtu");
+  MV_CHECK(other && std::string(other->formatName()) == "VTK XML");
+  MV_CHECK(!mvFormatReader::forFile(reader, "run.e") && !reader);
+}
+
+//------------------------------------------------------------------------------
+void testCells()
+{
+  vtkSmartPointer<vtkIdTypeArray> locations;
+  vtkSmartPointer<vtkCellArray> cells;
+
+  // A triangle and a quad sharing an edge:
+  const std::vector<int64_t> offsets = { 0, 3, 7 };
+  const std::vector<int64_t> connectivity = { 0, 1, 2, 1, 3, 4, 2 };
+  MV_CHECK(Helpers::makeCells(offsets, connectivity, 5, locations, cells));
+  MV_CHECK(cells && cells->GetNumberOfCells() == 2);
+  MV_CHECK(locations && locations->GetNumberOfTuples() == 2);
+
+  // Offsets that are missing, decrease, or overrun the connectivity:
+  MV_CHECK(!Helpers::makeCells({}, connectivity, 5, locations, cells));
+  MV_CHECK(!Helpers::makeCells({ 0, 4, 3 }, connectivity, 5, locations,
+                               cells));
+  MV_CHECK(!Helpers::makeCells({ 0, 3, 8 }, connectivity, 5, locations,
+                               cells));
+
+  // Point ids outside the points:
+  MV_CHECK(!Helpers::makeCells(offsets, connectivity, 4, locations, cells));
+  MV_CHECK(!Helpers::makeCells(offsets, { 0, 1, -1, 1, 3, 4, 2 }, 5,
+                               locations, cells));
+}
+
+//------------------------------------------------------------------------------
+// A tetrahedron whose "temperature" points and "pressure" cell are value.
+bool writeTetrahedron(const std::string &fileName, double value)
+{
+  vtkNew<vtkPoints> points;
+  points->InsertNextPoint(0., 0., 0.);
+  points->InsertNextPoint(1., 0., 0.);
+  points->InsertNextPoint(0., 1., 0.);
+  points->InsertNextPoint(0., 0., 1.);
+  vtkNew<vtkUnstructuredGrid> grid;
+  grid->SetPoints(points.Get());
+  const vtkIdType ids[4] = { 0, 1, 2, 3 };
+  grid->InsertNextCell(VTK_TETRA, 4, ids);
+
+  vtkNew<vtkDoubleArray> temperature;
+  temperature->SetName("temperature");
+  temperature->SetNumberOfTuples(4);
+  temperature->FillComponent(0, value);
+  grid->GetPointData()->AddArray(temperature.Get());
+  vtkNew<vtkDoubleArray> pressure;
+  pressure->SetName("pressure");
+  pressure->SetNumberOfTuples(1);
+  pressure->FillComponent(0, value);
+  grid->GetCellData()->AddArray(pressure.Get());
+
+  vtkNew<vtkXMLUnstructuredGridWriter> writer;
+  writer->SetFileName(fileName.c_str());
+  writer->SetInputData(grid.Get());
+  return writer->Write() == 1;
+}
+
+//------------------------------------------------------------------------------
+void testSeries(const std::string &dir)
+{
+  // Numbered files of the same prefix form a series, in numerical order:
+  const int numbers[] = { 10, 1, 2 };
+  for (int number : numbers)
+    {
+    MV_CHECK(writeTetrahedron(dir + "run_" + std::to_string(number) + ".vtu",
+                              number));
+    }
+  MV_CHECK(writeTetrahedron(dir + "other_3.vtu", 3.));
+  MV_CHECK(writeTetrahedron(dir + "single.vtu", 0.));
+
+  std::unique_ptr<mvFormatReader> reader =
+      mvFormatReader::create(dir + "run_2.vtu");
+  mvFormatReader::Information info;
+  MV_CHECK(reader && reader->readInformation(info));
+  MV_CHECK(info.numberOfTimeSteps == 3);
+  MV_CHECK(info.times == std::vector<double>({ 0., 1., 2. }));
+  MV_CHECK(info.blocks == std::vector<std::string>({ "Piece 0" }));
+  MV_CHECK(info.pointVariables.count("temperature") == 1);
+  MV_CHECK(info.cellVariables.count("pressure") == 1);
+
+  // Only the requested arrays are read:
+  mvReadSettings settings;
+  settings.fileName = dir + "run_2.vtu";
+  settings.numberOfTimeSteps = info.numberOfTimeSteps;
+  settings.variables.insert("temperature");
+  vtkSmartPointer<vtkMultiBlockDataSet> output = reader->read(settings, 2);
+  MV_CHECK(output && output->GetNumberOfBlocks() == 1);
+  if (output)
+    {
+    MV_CHECK(std::string(output->GetMetaData(0u)->Get(
+                           vtkCompositeDataSet::NAME())) == "Element Blocks");
+    vtkMultiBlockDataSet *blocks =
+        vtkMultiBlockDataSet::SafeDownCast(output->GetBlock(0));
+    vtkUnstructuredGrid *grid = blocks
+        ? vtkUnstructuredGrid::SafeDownCast(blocks->GetBlock(0)) : nullptr;
+    MV_CHECK(grid && grid->GetNumberOfCells() == 1);
+    if (grid)
+      {
+      vtkDataArray *temperature =
+          grid->GetPointData()->GetArray("temperature");
+      MV_CHECK(temperature && temperature->GetComponent(0, 0) == 10.);
+      MV_CHECK(!grid->GetCellData()->GetArray("pressure"));
+      }
+    }
+  MV_CHECK(!reader->read(settings, 3));
+
+  // Excluded blocks are left out:
+  settings.excludedBlocks.insert("Piece 0");
+  output = reader->read(settings, 0);
+  vtkMultiBlockDataSet *blocks = output
+      ? vtkMultiBlockDataSet::SafeDownCast(output->GetBlock(0)) : nullptr;
+  MV_CHECK(blocks && blocks->GetNumberOfBlocks() == 0);
+
+  // A file without a number has a single timestep:
+  reader = mvFormatReader::create(dir + "single.vtu");
+  MV_CHECK(reader && reader->readInformation(info));
+  MV_CHECK(info.numberOfTimeSteps == 1);
+}
+
+} // end anon namespace
+
+//------------------------------------------------------------------------------
+int main(int, char *[])
+{
+  testFormats();
+  testCells();
+
+  const std::string dir = mvTesting::makeDirectory();
+  if (dir.empty())
+    {
+    return EXIT_FAILURE;
+    }
+  testSeries(dir);
+  mvTesting::removeDirectory(dir);
+  return mvTesting::result();
+}
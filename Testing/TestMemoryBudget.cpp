@@ -0,0 +1,130 @@
+// Tests mvMemoryBudget: requests evict accounts least important first, stop
+// once enough is freed, and never touch more important accounts.
+
+// STD includes
+#include <map>
+#include <string>
+#include <vector>
+
+// MooseViewer includes
+#include "mvMemoryBudget.h"
+#include "mvTesting.h"
+
+namespace {
+
+using Priority = mvMemoryBudget::Priority;
+
+//------------------------------------------------------------------------------
+// Accounts whose evictors free everything they hold and record the order in
+// which they were called.
+class Accounts
+{
+public:
+  explicit Accounts(mvMemoryBudget &budget)
+    : m_budget(budget)
+  {
+  }
+
+  void add(const std::string &account, size_t bytes, Priority priority)
+  {
+    m_budget.setUsage(account, bytes, priority);
+    m_budget.setEvictor(account, [this, account, priority](size_t)
+      {
+      m_evicted.push_back(account);
+      const size_t freed = m_bytes[account];
+      m_bytes[account] = 0;
+      m_budget.setUsage(account, size_t(0), priority);
+      return freed;
+      });
+    m_bytes[account] = bytes;
+  }
+
+  const std::vector<std::string>& evicted() const { return m_evicted; }
+  void clear() { m_evicted.clear(); }
+
+private:
+  mvMemoryBudget &m_budget;
+  std::map<std::string, size_t> m_bytes;
+  std::vector<std::string> m_evicted;
+};
+
+//------------------------------------------------------------------------------
+void testUnlimited()
+{
+  mvMemoryBudget budget;
+  MV_CHECK(budget.limit() == 0);
+  budget.setUsage("data", 1000, Priority::Visible);
+  MV_CHECK(budget.usage() == 1000);
+  MV_CHECK(!budget.overLimit());
+  MV_CHECK(budget.request(1000000, Priority::Prefetched));
+}
+
+//------------------------------------------------------------------------------
+void testEvictionOrder()
+{
+  mvMemoryBudget budget;
+  budget.setLimit(100);
+  Accounts accounts(budget);
+  // Registered out of priority order, so that the order of the evictions
+  // does not follow the account names:
+  accounts.add("a visible", 30, Priority::Visible);
+  accounts.add("b hidden", 20, Priority::Hidden);
+  accounts.add("c prefetched", 20, Priority::Prefetched);
+  accounts.add("d prefetched", 20, Priority::Prefetched);
+  MV_CHECK(budget.usage() == 90);
+
+  // Fits without evicting anything:
+  MV_CHECK(budget.request(10, Priority::Prefetched));
+  MV_CHECK(accounts.evicted().empty());
+
+  // Needs 10 bytes: only the first prefetched account goes.
+  MV_CHECK(budget.request(20, Priority::Visible));
+  MV_CHECK(accounts.evicted() == std::vector<std::string>({"c prefetched"}));
+  MV_CHECK(budget.usage() == 70);
+
+  // Needs 40 bytes: the remaining prefetched account, then the hidden one.
+  accounts.clear();
+  MV_CHECK(budget.request(70, Priority::Visible));
+  MV_CHECK(accounts.evicted() ==
+           std::vector<std::string>({"d prefetched", "b hidden"}));
+  MV_CHECK(budget.usage() == 30);
+}
+
+//------------------------------------------------------------------------------
+void testPriorityCeiling()
+{
+  mvMemoryBudget budget;
+  budget.setLimit(100);
+  Accounts accounts(budget);
+  accounts.add("hidden", 40, Priority::Hidden);
+  accounts.add("prefetched", 40, Priority::Prefetched);
+  accounts.add("visible", 20, Priority::Visible);
+
+  // A prefetch may only evict other prefetched data, which is not enough:
+  MV_CHECK(!budget.request(50, Priority::Prefetched));
+  MV_CHECK(accounts.evicted() == std::vector<std::string>({"prefetched"}));
+  MV_CHECK(budget.usage() == 60);
+
+  // Larger than the limit: nothing is evicted.
+  accounts.clear();
+  MV_CHECK(!budget.request(101, Priority::Visible));
+  MV_CHECK(accounts.evicted().empty());
+
+  // Accounts without evictors are never evicted:
+  budget.setUsage("pinned", 30, Priority::Prefetched);
+  MV_CHECK(budget.request(40, Priority::Hidden));
+  MV_CHECK(accounts.evicted() == std::vector<std::string>({"hidden"}));
+  MV_CHECK(budget.usage() == 50);
+  MV_CHECK(!budget.overLimit());
+}
+
+} // end anon namespace
+
+//------------------------------------------------------------------------------
+int main(int, char *[])
+{
+  testUnlimited();
+  testEvictionOrder();
+  testPriorityCeiling();
+  return mvTesting::result();
+}
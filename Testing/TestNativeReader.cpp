@@ -0,0 +1,98 @@
+// Tests mvNativeReader against vtkExodusIIReader with an Exodus file whose
+// displacements move the mesh: both readers return the same coordinates.
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkExodusIIReader.h>
+#include <vtkMultiBlockDataSet.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkSmartPointer.h>
+#include <vtkUnstructuredGrid.h>
+
+// STD includes
+#include <string>
+
+// MooseViewer includes
+#include "mvNativeReader.h"
+#include "mvReadSettings.h"
+#include "mvTesting.h"
+#include "mvTestingExodus.h"
+
+namespace {
+
+const int NumberOfSteps = 2;
+
+//------------------------------------------------------------------------------
+// Whether the first leaves of a and b have the same points.
+bool samePoints(vtkMultiBlockDataSet *a, vtkMultiBlockDataSet *b)
+{
+  vtkUnstructuredGrid *leafA = mvTesting::firstLeaf(a);
+  vtkUnstructuredGrid *leafB = mvTesting::firstLeaf(b);
+  if (!leafA || !leafB ||
+      leafA->GetNumberOfPoints() != leafB->GetNumberOfPoints())
+    {
+    return false;
+    }
+  for (vtkIdType i = 0; i < leafA->GetNumberOfPoints(); ++i)
+    {
+    double p[3];
+    double q[3];
+    leafA->GetPoint(i, p);
+    leafB->GetPoint(i, q);
+    if (p[0] != q[0] || p[1] != q[1] || p[2] != q[2])
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void testDisplacements(const std::string &dir)
+{
+  mvReadSettings settings;
+  settings.fileName = dir + "displaced.e";
+  settings.numberOfTimeSteps = NumberOfSteps;
+  settings.variables.insert("temperature");
+  MV_CHECK(mvTesting::writeDisplacedFile(settings.fileName, NumberOfSteps));
+
+  mvNativeReader native;
+  vtkNew<vtkExodusIIReader> reader;
+  for (int step = 0; step < NumberOfSteps; ++step)
+    {
+    settings.apply(reader.Get());
+    reader->SetTimeStep(step);
+    reader->Update();
+
+    vtkSmartPointer<vtkMultiBlockDataSet> data = native.read(settings, step);
+    MV_CHECK(data != nullptr);
+    MV_CHECK(mvTesting::firstX(data) == mvTesting::displacement(step));
+    MV_CHECK(samePoints(data, reader->GetOutput()));
+
+    vtkUnstructuredGrid *leaf = mvTesting::firstLeaf(data);
+    vtkDataArray *temperature = leaf
+        ? leaf->GetPointData()->GetArray("temperature") : nullptr;
+    MV_CHECK(temperature && temperature->GetComponent(0, 0) == step);
+    }
+
+  // The displacements are not added twice when stepping back:
+  vtkSmartPointer<vtkMultiBlockDataSet> data = native.read(settings, 0);
+  MV_CHECK(mvTesting::firstX(data) == mvTesting::displacement(0));
+}
+
+} // end anon namespace
+
+//------------------------------------------------------------------------------
+int main(int, char *[])
+{
+  const std::string dir = mvTesting::makeDirectory();
+  if (dir.empty())
+    {
+    return EXIT_FAILURE;
+    }
+  testDisplacements(dir);
+  mvTesting::removeDirectory(dir);
+  return mvTesting::result();
+}
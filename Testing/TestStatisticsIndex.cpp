@@ -0,0 +1,165 @@
+// Tests mvStatisticsIndex: per-block and summary statistics, and the sidecar
+// that persists them until the data file changes.
+
+// VTK includes
+#include <vtkDoubleArray.h>
+#include <vtkMultiBlockDataSet.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <string>
+
+// MooseViewer includes
+#include "mvReadSettings.h"
+#include "mvStatisticsIndex.h"
+#include "mvTesting.h"
+
+namespace {
+
+//------------------------------------------------------------------------------
+// A leaf with "temperature" point values first, first + 1, ..., and a NaN if
+// requested.
+vtkSmartPointer<vtkPolyData> makeLeaf(double first, int count, bool nan)
+{
+  const int numPoints = count + (nan ? 1 : 0);
+  vtkNew<vtkPoints> points;
+  points->SetNumberOfPoints(numPoints);
+  vtkNew<vtkDoubleArray> temperature;
+  temperature->SetName("temperature");
+  temperature->SetNumberOfTuples(numPoints);
+  for (int i = 0; i < numPoints; ++i)
+    {
+    points->SetPoint(i, i, 0., 0.);
+    temperature->SetValue(i, i < count
+                          ? first + i
+                          : std::numeric_limits<double>::quiet_NaN());
+    }
+
+  vtkSmartPointer<vtkPolyData> leaf = vtkSmartPointer<vtkPolyData>::New();
+  leaf->SetPoints(points.Get());
+  leaf->GetPointData()->AddArray(temperature.Get());
+  return leaf;
+}
+
+//------------------------------------------------------------------------------
+// Two blocks, at flat indices 1 and 2: 0..9, and 10..19 with a NaN.
+vtkSmartPointer<vtkMultiBlockDataSet> makeData(double offset)
+{
+  vtkSmartPointer<vtkMultiBlockDataSet> mbds =
+      vtkSmartPointer<vtkMultiBlockDataSet>::New();
+  mbds->SetBlock(0, makeLeaf(offset, 10, false));
+  mbds->SetBlock(1, makeLeaf(offset + 10., 10, true));
+  return mbds;
+}
+
+//------------------------------------------------------------------------------
+void writeFile(const std::string &fileName, const std::string &contents)
+{
+  std::ofstream out(fileName.c_str(), std::ios::binary | std::ios::app);
+  out << contents;
+}
+
+//------------------------------------------------------------------------------
+void testStatistics(const std::string &dataFile)
+{
+  mvStatisticsIndex index;
+  index.setFileName(dataFile);
+
+  mvReadSettings settings;
+  settings.fileName = dataFile;
+  settings.variables.insert("temperature");
+  settings.variables.insert("pressure"); // Not in the data.
+  index.add(settings, 0, makeData(0.));
+
+  MV_CHECK(index.contains("temperature", 0));
+  MV_CHECK(!index.contains("temperature", 1));
+
+  mvStatisticsIndex::Statistics stats;
+  MV_CHECK(index.find("temperature", 0, 1, stats));
+  MV_CHECK(stats.min == 0. && stats.max == 9. && stats.count == 10);
+  MV_CHECK(std::fabs(stats.mean - 4.5) < 1e-12);
+  double total = 0.;
+  for (double bin : stats.histogram)
+    {
+    total += bin;
+    }
+  MV_CHECK(total == 10.);
+
+  // NaNs are not counted:
+  MV_CHECK(index.find("temperature", 0, 2, stats));
+  MV_CHECK(stats.min == 10. && stats.max == 19. && stats.count == 10);
+  MV_CHECK(!index.find("temperature", 0, 3, stats));
+
+  MV_CHECK(index.summary("temperature", 0, stats));
+  MV_CHECK(stats.min == 0. && stats.max == 19. && stats.count == 20);
+  MV_CHECK(std::fabs(stats.mean - 9.5) < 1e-12);
+
+  float bins[4] = { 0.f, 0.f, 0.f, 0.f };
+  const double range[2] = { 0., 20. };
+  MV_CHECK(index.histogram("temperature", 0, range, bins, 4));
+  MV_CHECK(std::fabs(bins[0] + bins[1] + bins[2] + bins[3] - 20.f) < 1e-3f);
+
+  // Indexed, but without values:
+  MV_CHECK(index.contains("pressure", 0));
+  MV_CHECK(!index.summary("pressure", 0, stats));
+
+  // Indexed variables are not recomputed:
+  index.add(settings, 0, makeData(100.));
+  MV_CHECK(index.summary("temperature", 0, stats) && stats.min == 0.);
+
+  // Block indices of datasets read with other objects do not match:
+  mvReadSettings excluded = settings;
+  excluded.excludedBlocks.insert("block_1");
+  index.add(excluded, 1, makeData(0.));
+  MV_CHECK(!index.contains("temperature", 1));
+
+  index.save();
+}
+
+//------------------------------------------------------------------------------
+void testSidecar(const std::string &dataFile)
+{
+    {
+    mvStatisticsIndex index;
+    index.setFileName(dataFile);
+    mvStatisticsIndex::Statistics stats;
+    MV_CHECK(index.find("temperature", 0, 2, stats));
+    MV_CHECK(stats.min == 10. && stats.max == 19. && stats.count == 10);
+    MV_CHECK(index.contains("pressure", 0));
+    }
+
+  // A file that grew has other data:
+  writeFile(dataFile, "more data");
+    {
+    mvStatisticsIndex index;
+    index.setFileName(dataFile);
+    MV_CHECK(!index.contains("temperature", 0));
+    }
+}
+
+} // end anon namespace
+
+//------------------------------------------------------------------------------
+int main(int, char *[])
+{
+  const std::string dir = mvTesting::makeDirectory();
+  if (dir.empty())
+    {
+    return EXIT_FAILURE;
+    }
+  const std::string dataFile = dir + "run.e";
+  writeFile(dataFile, "data");
+
+  testStatistics(dataFile);
+  testSidecar(dataFile);
+
+  mvTesting::removeDirectory(dir);
+  return mvTesting::result();
+}
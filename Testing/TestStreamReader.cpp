@@ -0,0 +1,286 @@
+// Tests mvStreamReader against a producer speaking mvStreamProtocol over a
+// Unix domain socket: the information and arrays of the received timesteps,
+// the window of stored timesteps, and the rejection of invalid meshes.
+
+// VTK includes
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkMultiBlockDataSet.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+#include <vtkUnstructuredGrid.h>
+
+// STD includes
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// POSIX includes
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// MooseViewer includes
+#include "mvFormatReader.h"
+#include "mvReadSettings.h"
+#include "mvStreamProtocol.h"
+#include "mvStreamReader.h"
+#include "mvTesting.h"
+
+namespace {
+
+//------------------------------------------------------------------------------
+// Collects the payload of one message, as mvStreamProducer does.
+class Message
+{
+public:
+  template <typename T>
+  void add(const T &value)
+  {
+    this->add(&value, sizeof(T));
+  }
+
+  template <typename T>
+  void add(const std::vector<T> &values)
+  {
+    this->add(values.data(), values.size() * sizeof(T));
+  }
+
+  void add(const std::string &str)
+  {
+    this->add(static_cast<std::uint32_t>(str.size()));
+    this->add(str.data(), str.size());
+  }
+
+  void add(const void *data, size_t size)
+  {
+    const char *bytes = static_cast<const char*>(data);
+    m_payload.insert(m_payload.end(), bytes, bytes + size);
+  }
+
+  bool send(int fd, mvStreamProtocol::MessageType type) const
+  {
+    mvStreamProtocol::MessageHeader header;
+    std::memcpy(header.magic, mvStreamProtocol::Magic, sizeof(header.magic));
+    header.type = type;
+    header.size = m_payload.size();
+    return sendAll(fd, &header, sizeof(header)) &&
+        sendAll(fd, m_payload.data(), m_payload.size());
+  }
+
+private:
+  static bool sendAll(int fd, const void *data, size_t size)
+  {
+    const char *bytes = static_cast<const char*>(data);
+    while (size > 0)
+      {
+      // The reader may close the stream first:
+      const ssize_t sent = ::send(fd, bytes, size, MSG_NOSIGNAL);
+      if (sent <= 0)
+        {
+        return false;
+        }
+      bytes += sent;
+      size -= static_cast<size_t>(sent);
+      }
+    return true;
+  }
+
+  std::vector<char> m_payload;
+};
+
+//------------------------------------------------------------------------------
+// A block holding one tetrahedron, whose last point id is lastId.
+bool sendBlock(int fd, std::int64_t lastId)
+{
+  const std::vector<double> points = {
+    0., 0., 0.,  1., 0., 0.,  0., 1., 0.,  0., 0., 1.
+  };
+  Message message;
+  message.add(std::string("block_1"));
+  message.add(static_cast<std::int64_t>(4)); // Points
+  message.add(static_cast<std::int64_t>(1)); // Cells
+  message.add(static_cast<std::int64_t>(4)); // Connectivity ids
+  message.add(points);
+  message.add(static_cast<std::uint8_t>(10)); // VTK_TETRA
+  message.add(std::vector<std::int64_t>({ 0, 4 }));
+  message.add(std::vector<std::int64_t>({ 0, 1, 2, lastId }));
+  return message.send(fd, mvStreamProtocol::Block);
+}
+
+//------------------------------------------------------------------------------
+// "temperature" (double) on the points and "stress" (float) on the cell, all
+// equal to the step number.
+bool sendStep(int fd, int step)
+{
+  Message message;
+  message.add(0.5 * step);
+  message.add(static_cast<std::uint32_t>(2));
+
+  message.add(static_cast<std::uint32_t>(0));
+  message.add(static_cast<std::uint8_t>(mvStreamProtocol::PointData));
+  message.add(static_cast<std::uint8_t>(mvStreamProtocol::Float64));
+  message.add(std::string("temperature"));
+  message.add(static_cast<std::uint32_t>(1));
+  message.add(static_cast<std::int64_t>(4));
+  message.add(std::vector<double>(4, step));
+
+  message.add(static_cast<std::uint32_t>(0));
+  message.add(static_cast<std::uint8_t>(mvStreamProtocol::CellData));
+  message.add(static_cast<std::uint8_t>(mvStreamProtocol::Float32));
+  message.add(std::string("stress"));
+  message.add(static_cast<std::uint32_t>(1));
+  message.add(static_cast<std::int64_t>(1));
+  message.add(std::vector<float>(1, static_cast<float>(step)));
+
+  return message.send(fd, mvStreamProtocol::Step);
+}
+
+//------------------------------------------------------------------------------
+// Listen on path, and run send on the first connection from a thread.
+class Producer
+{
+public:
+  Producer(const std::string &path, const std::function<void(int)> &send)
+    : m_listener(socket(AF_UNIX, SOCK_STREAM, 0))
+  {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(),
+                 sizeof(address.sun_path) - 1);
+    MV_CHECK(m_listener >= 0 &&
+             bind(m_listener, reinterpret_cast<sockaddr*>(&address),
+                  sizeof(address)) == 0 &&
+             listen(m_listener, 1) == 0);
+
+    m_thread = std::thread([this, send]()
+      {
+      const int fd = accept(m_listener, nullptr, nullptr);
+      if (fd >= 0)
+        {
+        send(fd);
+        close(fd);
+        }
+      });
+  }
+
+  ~Producer()
+  {
+    m_thread.join();
+    close(m_listener);
+  }
+
+private:
+  int m_listener;
+  std::thread m_thread;
+};
+
+//------------------------------------------------------------------------------
+void testStream(const std::string &dir)
+{
+  const int numSteps = mvStreamReader::StoredTimeSteps + 2;
+  const std::string path = dir + "stream.sock";
+  Producer producer(path, [numSteps](int fd)
+    {
+    bool ok = sendBlock(fd, 3);
+    for (int step = 0; ok && step < numSteps; ++step)
+      {
+      ok = sendStep(fd, step);
+      }
+    if (ok)
+      {
+      Message().send(fd, mvStreamProtocol::End);
+      }
+    });
+
+  std::unique_ptr<mvFormatReader> reader =
+      mvFormatReader::create("unix:" + path);
+  MV_CHECK(reader && std::string(reader->formatName()) == "stream");
+  if (!reader)
+    {
+    return;
+    }
+
+  // Timesteps are reported as they arrive:
+  mvFormatReader::Information info;
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (reader->readInformation(info) && info.numberOfTimeSteps < numSteps &&
+         std::chrono::steady_clock::now() < deadline)
+    {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  MV_CHECK(info.numberOfTimeSteps == numSteps);
+  MV_CHECK(info.times.size() == static_cast<size_t>(numSteps) &&
+           info.times.back() == 0.5 * (numSteps - 1));
+  MV_CHECK(info.blocks == std::vector<std::string>({ "block_1" }));
+  MV_CHECK(info.pointVariables.count("temperature") == 1);
+  MV_CHECK(info.cellVariables.count("stress") == 1);
+
+  // Only the latest StoredTimeSteps keep their arrays:
+  MV_CHECK(!reader->canRead(0));
+  MV_CHECK(!reader->canRead(1));
+  MV_CHECK(reader->canRead(2));
+  MV_CHECK(reader->canRead(numSteps - 1));
+  MV_CHECK(!reader->canRead(numSteps));
+
+  mvReadSettings settings;
+  settings.fileName = "unix:" + path;
+  settings.variables.insert("stress");
+  MV_CHECK(!reader->read(settings, 0));
+  vtkSmartPointer<vtkMultiBlockDataSet> output =
+      reader->read(settings, numSteps - 1);
+  vtkMultiBlockDataSet *blocks = output
+      ? vtkMultiBlockDataSet::SafeDownCast(output->GetBlock(0)) : nullptr;
+  vtkUnstructuredGrid *grid = blocks
+      ? vtkUnstructuredGrid::SafeDownCast(blocks->GetBlock(0)) : nullptr;
+  MV_CHECK(grid && grid->GetNumberOfPoints() == 4 &&
+           grid->GetNumberOfCells() == 1);
+  if (grid)
+    {
+    vtkDataArray *stress = grid->GetCellData()->GetArray("stress");
+    MV_CHECK(stress && stress->GetComponent(0, 0) == numSteps - 1);
+    MV_CHECK(!grid->GetPointData()->GetArray("temperature"));
+    }
+}
+
+//------------------------------------------------------------------------------
+void testInvalidMesh(const std::string &dir)
+{
+  // Point id 4 of a block of 4 points closes the stream before any step:
+  const std::string path = dir + "invalid.sock";
+  Producer producer(path, [](int fd)
+    {
+    if (sendBlock(fd, 4) && sendStep(fd, 0))
+      {
+      Message().send(fd, mvStreamProtocol::End);
+      }
+    });
+
+  std::unique_ptr<mvFormatReader> reader =
+      mvFormatReader::create("unix:" + path);
+  mvFormatReader::Information info;
+  MV_CHECK(reader && !reader->readInformation(info));
+}
+
+} // end anon namespace
+
+//------------------------------------------------------------------------------
+int main(int, char *[])
+{
+  const std::string dir = mvTesting::makeDirectory();
+  if (dir.empty())
+    {
+    return EXIT_FAILURE;
+    }
+  testStream(dir);
+  testInvalidMesh(dir);
+  mvTesting::removeDirectory(dir);
+  return mvTesting::result();
+}
@@ -0,0 +1,189 @@
+// Tests mvTimeStepCache: the least recently used eviction order, the
+// protection of the prefetch window from eviction, and timesteps read by the
+// worker thread from an XML file series.
+
+// VTK includes
+#include <vtkCellType.h>
+#include <vtkDataArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkMultiBlockDataSet.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkSmartPointer.h>
+#include <vtkUnstructuredGrid.h>
+#include <vtkXMLUnstructuredGridWriter.h>
+
+// STD includes
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+// MooseViewer includes
+#include "mvReadSettings.h"
+#include "mvTimeStepCache.h"
+#include "mvTesting.h"
+
+namespace {
+
+const int NumberOfSteps = 4;
+
+//------------------------------------------------------------------------------
+// A tetrahedron whose "temperature" points are value.
+vtkSmartPointer<vtkUnstructuredGrid> makeTetrahedron(double value)
+{
+  vtkNew<vtkPoints> points;
+  points->InsertNextPoint(0., 0., 0.);
+  points->InsertNextPoint(1., 0., 0.);
+  points->InsertNextPoint(0., 1., 0.);
+  points->InsertNextPoint(0., 0., 1.);
+  vtkSmartPointer<vtkUnstructuredGrid> grid =
+      vtkSmartPointer<vtkUnstructuredGrid>::New();
+  grid->SetPoints(points.Get());
+  const vtkIdType ids[4] = { 0, 1, 2, 3 };
+  grid->InsertNextCell(VTK_TETRA, 4, ids);
+
+  vtkNew<vtkDoubleArray> temperature;
+  temperature->SetName("temperature");
+  temperature->SetNumberOfTuples(4);
+  temperature->FillComponent(0, value);
+  grid->GetPointData()->AddArray(temperature.Get());
+  return grid;
+}
+
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkMultiBlockDataSet> makeStep(int step)
+{
+  vtkSmartPointer<vtkMultiBlockDataSet> mbds =
+      vtkSmartPointer<vtkMultiBlockDataSet>::New();
+  mbds->SetBlock(0, makeTetrahedron(step));
+  return mbds;
+}
+
+//------------------------------------------------------------------------------
+// The first "temperature" value of a timestep read from the file series, or
+// -1 if there is none.
+double temperature(vtkMultiBlockDataSet *data)
+{
+  vtkMultiBlockDataSet *blocks = data
+      ? vtkMultiBlockDataSet::SafeDownCast(data->GetBlock(0)) : nullptr;
+  vtkUnstructuredGrid *grid = blocks
+      ? vtkUnstructuredGrid::SafeDownCast(blocks->GetBlock(0)) : nullptr;
+  vtkDataArray *array = grid
+      ? grid->GetPointData()->GetArray("temperature") : nullptr;
+  return array ? array->GetComponent(0, 0) : -1.;
+}
+
+//------------------------------------------------------------------------------
+// Wait for the worker to cache step. find() marks it as recently used.
+mvTimeStepCache::DataObject waitFor(mvTimeStepCache &cache, int step)
+{
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  mvTimeStepCache::DataObject data = cache.find(step);
+  while (!data && std::chrono::steady_clock::now() < deadline)
+    {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    data = cache.find(step);
+    }
+  return data;
+}
+
+//------------------------------------------------------------------------------
+void testEviction()
+{
+  mvTimeStepCache cache;
+  MV_CHECK(cache.capacity() == 0);
+
+  // Nothing is kept while the cache is disabled:
+  cache.insert(0, makeStep(0));
+  MV_CHECK(!cache.find(0));
+
+  cache.setCapacity(3);
+  cache.insert(0, makeStep(0));
+  cache.insert(1, makeStep(1));
+  cache.insert(2, makeStep(2));
+
+  // Using 0 leaves 1 as the least recently used:
+  MV_CHECK(cache.find(0));
+  cache.insert(3, makeStep(3));
+  MV_CHECK(!cache.find(1));
+  MV_CHECK(cache.find(0) && cache.find(2) && cache.find(3));
+
+  // Trimming follows the same order. 0 was used least recently:
+  MV_CHECK(cache.trim(1) > 0);
+  MV_CHECK(!cache.find(0));
+  MV_CHECK(cache.find(2) && cache.find(3));
+
+  // Shrinking evicts down to the capacity:
+  cache.setCapacity(1);
+  MV_CHECK(!cache.find(2) && cache.find(3));
+
+  cache.clear();
+  MV_CHECK(!cache.find(3));
+}
+
+//------------------------------------------------------------------------------
+void testPrefetch(const std::string &dir)
+{
+  for (int step = 0; step < NumberOfSteps; ++step)
+    {
+    vtkNew<vtkXMLUnstructuredGridWriter> writer;
+    writer->SetFileName(
+          (dir + "run_" + std::to_string(step) + ".vtu").c_str());
+    writer->SetInputData(makeTetrahedron(step));
+    MV_CHECK(writer->Write() == 1);
+    }
+
+  mvReadSettings settings;
+  settings.fileName = dir + "run_0.vtu";
+  settings.numberOfTimeSteps = NumberOfSteps;
+  settings.variables.insert("temperature");
+
+  mvTimeStepCache cache;
+  cache.setCapacity(2);
+  cache.setReadSettings(settings);
+
+  // The worker reads the requested timesteps, and nothing else:
+  cache.prefetch({ 1, 2 });
+  MV_CHECK(temperature(waitFor(cache, 1)) == 1.);
+  MV_CHECK(temperature(waitFor(cache, 2)) == 2.);
+  MV_CHECK(!cache.find(0) && !cache.find(3));
+
+  // Using 1 leaves 2 as the least recently used. Moving the window to 2 and 3
+  // still evicts 1, which is no longer requested:
+  MV_CHECK(cache.find(1));
+  cache.prefetch({ 2, 3 });
+  MV_CHECK(temperature(waitFor(cache, 3)) == 3.);
+  MV_CHECK(!cache.find(1));
+  MV_CHECK(temperature(cache.find(2)) == 2.);
+
+  // A timestep inserted outside the window is the first to go, although it
+  // was used most recently:
+  cache.insert(0, makeStep(0));
+  MV_CHECK(!cache.find(0));
+  MV_CHECK(cache.find(2) && cache.find(3));
+
+  // Other settings discard the cached timesteps:
+  settings.variables.clear();
+  cache.setReadSettings(settings);
+  MV_CHECK(!cache.find(2) && !cache.find(3));
+}
+
+} // end anon namespace
+
+//------------------------------------------------------------------------------
+int main(int, char *[])
+{
+  testEviction();
+
+  const std::string dir = mvTesting::makeDirectory();
+  if (dir.empty())
+    {
+    return EXIT_FAILURE;
+    }
+  testPrefetch(dir);
+  mvTesting::removeDirectory(dir);
+  return mvTesting::result();
+}
@@ -0,0 +1,93 @@
+#ifndef MVTESTING_H
+#define MVTESTING_H
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <unistd.h>
+
+/**
+ * Helpers shared by the unit tests. Each test is a stand-alone program that
+ * runs its checks and returns EXIT_FAILURE if any failed.
+ */
+namespace mvTesting {
+
+//------------------------------------------------------------------------------
+// The number of failed checks.
+inline int& failures()
+{
+  static int count = 0;
+  return count;
+}
+
+//------------------------------------------------------------------------------
+inline void check(bool condition, const char *expression, const char *file,
+                  int line)
+{
+  if (!condition)
+    {
+    std::cerr << file << ":" << line << ": Check failed: " << expression
+              << std::endl;
+    ++failures();
+    }
+}
+
+//------------------------------------------------------------------------------
+// The exit code of a test.
+inline int result()
+{
+  return failures() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+//------------------------------------------------------------------------------
+// Create an empty directory under /tmp. Returns its path with a trailing
+// slash, or an empty string on failure. Short enough for socket paths.
+inline std::string makeDirectory()
+{
+  char name[] = "/tmp/mvtest.XXXXXX";
+  if (!mkdtemp(name))
+    {
+    std::cerr << "mvTesting: Unable to create a temporary directory."
+              << std::endl;
+    return std::string();
+    }
+  return std::string(name) + "/";
+}
+
+//------------------------------------------------------------------------------
+// Remove a directory made by makeDirectory() and the files in it.
+inline void removeDirectory(const std::string &dir)
+{
+  if (dir.empty())
+    {
+    return;
+    }
+  if (DIR *handle = opendir(dir.c_str()))
+    {
+    std::vector<std::string> names;
+    while (dirent *entry = readdir(handle))
+      {
+      const std::string name = entry->d_name;
+      if (name != "." && name != "..")
+        {
+        names.push_back(dir + name);
+        }
+      }
+    closedir(handle);
+    for (const std::string &name : names)
+      {
+      unlink(name.c_str());
+      }
+    }
+  rmdir(dir.c_str());
+}
+
+} // end namespace mvTesting
+
+#define MV_CHECK(condition) \
+  mvTesting::check((condition), #condition, __FILE__, __LINE__)
+
+#endif // MVTESTING_H
@@ -0,0 +1,108 @@
+#ifndef MVTESTINGEXODUS_H
+#define MVTESTINGEXODUS_H
+
+#include <vtkMultiBlockDataSet.h>
+#include <vtkPoints.h>
+#include <vtkUnstructuredGrid.h>
+#include <vtk_exodusII.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Exodus files for the unit tests, written with the Exodus C API as
+ * mvExodusProducer does, and helpers to inspect what is read from them.
+ */
+namespace mvTesting {
+
+//------------------------------------------------------------------------------
+// The x displacement of every node at step.
+inline double displacement(int step)
+{
+  return 0.5 * step;
+}
+
+//------------------------------------------------------------------------------
+// A unit hexahedron with "temperature" and the "disp_x", "disp_y" and
+// "disp_z" displacements on its nodes. vtkExodusIIReader applies the latter
+// to the coordinates.
+inline bool writeDisplacedFile(const std::string &fileName, int numSteps)
+{
+  int compWordSize = sizeof(double);
+  int ioWordSize = sizeof(double);
+  const int exoid = ex_create(fileName.c_str(), EX_CLOBBER | EX_ALL_INT64_API,
+                              &compWordSize, &ioWordSize);
+  if (exoid < 0)
+    {
+    return false;
+    }
+
+  const double x[8] = { 0., 1., 1., 0., 0., 1., 1., 0. };
+  const double y[8] = { 0., 0., 1., 1., 0., 0., 1., 1. };
+  const double z[8] = { 0., 0., 0., 0., 1., 1., 1., 1. };
+  const std::int64_t connectivity[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+  const char *blockNames[] = { "block_1" };
+  const char *nodal[] = { "temperature", "disp_x", "disp_y", "disp_z" };
+  bool ok = ex_put_init(exoid, "mvTesting", 3, 8, 1, 1, 0, 0) >= 0 &&
+      ex_put_coord(exoid, x, y, z) >= 0 &&
+      ex_put_block(exoid, EX_ELEM_BLOCK, 1, "HEX8", 1, 8, 0, 0, 0) >= 0 &&
+      ex_put_conn(exoid, EX_ELEM_BLOCK, 1, connectivity, nullptr,
+                  nullptr) >= 0 &&
+      ex_put_names(exoid, EX_ELEM_BLOCK,
+                   const_cast<char**>(blockNames)) >= 0 &&
+      ex_put_variable_param(exoid, EX_NODAL, 4) >= 0 &&
+      ex_put_variable_names(exoid, EX_NODAL, 4,
+                            const_cast<char**>(nodal)) >= 0;
+
+  for (int step = 0; ok && step < numSteps; ++step)
+    {
+    const int fileStep = step + 1; // Exodus timesteps are 1-based.
+    double time = step;
+    const std::vector<double> temperature(8, step);
+    const std::vector<double> dispX(8, displacement(step));
+    const std::vector<double> zero(8, 0.);
+    ok = ex_put_time(exoid, fileStep, &time) >= 0 &&
+        ex_put_var(exoid, fileStep, EX_NODAL, 1, 1, 8,
+                   temperature.data()) >= 0 &&
+        ex_put_var(exoid, fileStep, EX_NODAL, 2, 1, 8, dispX.data()) >= 0 &&
+        ex_put_var(exoid, fileStep, EX_NODAL, 3, 1, 8, zero.data()) >= 0 &&
+        ex_put_var(exoid, fileStep, EX_NODAL, 4, 1, 8, zero.data()) >= 0;
+    }
+
+  return ex_close(exoid) >= 0 && ok;
+}
+
+//------------------------------------------------------------------------------
+// The first unstructured grid in obj.
+inline vtkUnstructuredGrid* firstLeaf(vtkDataObject *obj)
+{
+  if (vtkMultiBlockDataSet *mb = vtkMultiBlockDataSet::SafeDownCast(obj))
+    {
+    for (unsigned int i = 0; i < mb->GetNumberOfBlocks(); ++i)
+      {
+      if (vtkUnstructuredGrid *leaf = firstLeaf(mb->GetBlock(i)))
+        {
+        return leaf;
+        }
+      }
+    return nullptr;
+    }
+  return vtkUnstructuredGrid::SafeDownCast(obj);
+}
+
+//------------------------------------------------------------------------------
+// The x coordinate of the first point of data, or -1 if there is none.
+inline double firstX(vtkMultiBlockDataSet *data)
+{
+  vtkUnstructuredGrid *leaf = firstLeaf(data);
+  if (!leaf || !leaf->GetPoints() || leaf->GetNumberOfPoints() == 0)
+    {
+    return -1.;
+    }
+  return leaf->GetPoints()->GetPoint(0)[0];
+}
+
+} // end namespace mvTesting
+
+#endif // MVTESTINGEXODUS_H
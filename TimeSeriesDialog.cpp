@@ -0,0 +1,126 @@
+#include "TimeSeriesDialog.h"
+
+#include "MooseViewer.h"
+#include "TimeSeriesPlot.h"
+#include "mvReader.h"
+
+#include <Vrui/Vrui.h>
+
+#include <GLMotif/Label.h>
+#include <GLMotif/RowColumn.h>
+#include <GLMotif/StyleSheet.h>
+#include <GLMotif/TextField.h>
+#include <GLMotif/WidgetManager.h>
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
+using GLMotif::Label;
+using GLMotif::PopupWindow;
+using GLMotif::RowColumn;
+using GLMotif::TextField;
+
+//------------------------------------------------------------------------------
+TimeSeriesDialog::TimeSeriesDialog(MooseViewer *mooseViewer)
+  : PopupWindow("TimeSeries", Vrui::getWidgetManager(), "Time Series"),
+    Viewer(mooseViewer),
+    SeriesVersion(0),
+    Reading(false),
+    NumberOfComponents(1)
+{
+  const GLMotif::StyleSheet &styleSheet =
+      *Vrui::getWidgetManager()->getStyleSheet();
+
+  RowColumn *dialog = new RowColumn("TimeSeriesDialog", this, false);
+
+  this->LocationLabel = new Label(
+        "Location", dialog, "Pick a location with the interactor tool.");
+
+  this->Plot = new TimeSeriesPlot("Plot", dialog, false);
+  this->Plot->setBorderWidth(styleSheet.size * 0.5f);
+  this->Plot->setBorderType(GLMotif::Widget::LOWERED);
+  this->Plot->setMarginWidth(styleSheet.size);
+  this->Plot->setPreferredSize(GLMotif::Vector(
+        styleSheet.fontHeight * 20.0f, styleSheet.fontHeight * 10.0f, 0.0f));
+  this->Plot->manageChild();
+
+  RowColumn *valueBox = new RowColumn("ValueBox", dialog, false);
+  valueBox->setOrientation(RowColumn::HORIZONTAL);
+  this->RangeLabel = new Label("Range", valueBox, "");
+  new Label("ValueLabel", valueBox, "Value:");
+  this->ValueField = new TextField("Value", valueBox, 10);
+  this->ValueField->setEditable(false);
+  this->ValueField->setPrecision(6);
+  this->ValueField->setString("");
+  valueBox->manageChild();
+
+  dialog->manageChild();
+}
+
+//------------------------------------------------------------------------------
+TimeSeriesDialog::~TimeSeriesDialog()
+{
+}
+
+//------------------------------------------------------------------------------
+void TimeSeriesDialog::updateTimeSeries()
+{
+  const mvReader &reader = this->Viewer->reader();
+
+  const unsigned long version = reader.timeSeriesVersion();
+  const bool reading = reader.readingTimeSeries();
+  if (version != this->SeriesVersion || reading != this->Reading)
+    {
+    this->SeriesVersion = version;
+    this->Reading = reading;
+
+    mvTimeSeries::Series series;
+    std::ostringstream location;
+    std::ostringstream range;
+    if (reader.timeSeries(series))
+      {
+      this->Times = series.times;
+      this->Values = series.values;
+      this->NumberOfComponents = std::max(1, series.numberOfComponents);
+      this->Plot->setData(this->Times, this->Values, this->NumberOfComponents);
+
+      location << series.variable << " at "
+               << (series.nodal ? "node " : "element ") << series.id
+               << " of " << series.block << " (" << series.position[0]
+               << ", " << series.position[1] << ", " << series.position[2]
+               << ")";
+      range << "Values " << this->Plot->getValueRange()[0] << " - "
+            << this->Plot->getValueRange()[1] << " over t = "
+            << this->Plot->getTimeRange()[0] << " - "
+            << this->Plot->getTimeRange()[1];
+      }
+    else
+      {
+      this->Times.clear();
+      this->Values.clear();
+      this->Plot->clearData();
+      location << "Pick a location with the interactor tool.";
+      }
+    if (reading)
+      {
+      location.str("");
+      location << "Reading time series...";
+      }
+    this->LocationLabel->setString(location.str().c_str());
+    this->RangeLabel->setString(range.str().c_str());
+    }
+
+  // Follow the current timestep:
+  const size_t step = static_cast<size_t>(reader.timeStep());
+  if (reader.timeStep() >= 0 && step < this->Times.size())
+    {
+    this->Plot->setCurrentTime(this->Times[step]);
+    this->ValueField->setValue(this->Values[step * this->NumberOfComponents]);
+    }
+  else
+    {
+    this->Plot->setCurrentTime(std::numeric_limits<double>::quiet_NaN());
+    this->ValueField->setString("");
+    }
+}
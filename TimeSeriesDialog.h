@@ -0,0 +1,42 @@
+#ifndef TIMESERIESDIALOG_INCLUDED
+#define TIMESERIESDIALOG_INCLUDED
+
+#include <GLMotif/PopupWindow.h>
+
+#include <vector>
+
+namespace GLMotif {
+class Label;
+class TextField;
+} // end namespace GLMotif
+
+class MooseViewer;
+class TimeSeriesPlot;
+
+/* Dialog plotting the history of the color-by variable at the location picked
+ * with the probe analysis tool. */
+class TimeSeriesDialog : public GLMotif::PopupWindow
+{
+public:
+  explicit TimeSeriesDialog(MooseViewer *mooseViewer);
+  ~TimeSeriesDialog();
+
+  /* Refresh the plot from the reader's time series, and move the current time
+   * marker to the reader's timestep. */
+  void updateTimeSeries();
+
+private:
+  MooseViewer *Viewer;
+  GLMotif::Label *LocationLabel;
+  TimeSeriesPlot *Plot;
+  GLMotif::Label *RangeLabel;
+  GLMotif::TextField *ValueField;
+
+  unsigned long SeriesVersion;
+  bool Reading;
+  std::vector<double> Times;
+  std::vector<double> Values;
+  int NumberOfComponents;
+};
+
+#endif // TIMESERIESDIALOG_INCLUDED
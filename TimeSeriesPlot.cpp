@@ -0,0 +1,267 @@
+#include "TimeSeriesPlot.h"
+
+#include <GL/GLColorTemplates.h>
+#include <GL/GLVertexTemplates.h>
+#include <GLMotif/Container.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// Curve colors, cycled through by component:
+const GLfloat CurveColors[][3] = {
+  { 0.0f, 0.0f, 0.6f },
+  { 0.7f, 0.0f, 0.0f },
+  { 0.0f, 0.5f, 0.0f },
+  { 0.6f, 0.4f, 0.0f },
+  { 0.5f, 0.0f, 0.5f },
+  { 0.0f, 0.5f, 0.5f }
+};
+const int NumberOfCurveColors = sizeof(CurveColors) / sizeof(CurveColors[0]);
+
+} // end anon namespace
+
+//------------------------------------------------------------------------------
+TimeSeriesPlot::TimeSeriesPlot(const char *name, GLMotif::Container *parent,
+                               bool manageChild)
+  : GLMotif::Widget(name, parent, false),
+    PreferredSize(0.0f, 0.0f, 0.0f),
+    MarginWidth(0.0f),
+    NumberOfComponents(0),
+    TimeRange{0., 0.},
+    ValueRange{0., 0.},
+    CurrentTime(std::numeric_limits<double>::quiet_NaN())
+{
+  if (manageChild)
+    {
+    this->manageChild();
+    }
+}
+
+//------------------------------------------------------------------------------
+TimeSeriesPlot::~TimeSeriesPlot()
+{
+}
+
+//------------------------------------------------------------------------------
+GLMotif::Vector TimeSeriesPlot::calcNaturalSize() const
+{
+  GLMotif::Vector result = this->PreferredSize;
+  result[0] += 2.0f * this->MarginWidth;
+  result[1] += 2.0f * this->MarginWidth;
+  return this->calcExteriorSize(result);
+}
+
+//------------------------------------------------------------------------------
+void TimeSeriesPlot::resize(const GLMotif::Box &exterior)
+{
+  GLMotif::Widget::resize(exterior);
+  this->AreaBox = this->getInterior();
+  this->AreaBox.doInset(
+    GLMotif::Vector(this->MarginWidth, this->MarginWidth, 0.0f));
+}
+
+//------------------------------------------------------------------------------
+void TimeSeriesPlot::draw(GLContextData &contextData) const
+{
+  GLMotif::Widget::draw(contextData);
+
+  GLboolean lightingEnabled = glIsEnabled(GL_LIGHTING);
+  if (lightingEnabled)
+    {
+    glDisable(GL_LIGHTING);
+    }
+  GLfloat lineWidth;
+  glGetFloatv(GL_LINE_WIDTH, &lineWidth);
+
+  this->drawBackground();
+  this->drawCurves();
+  this->drawMarker();
+
+  glLineWidth(lineWidth);
+  if (lightingEnabled)
+    {
+    glEnable(GL_LIGHTING);
+    }
+}
+
+//------------------------------------------------------------------------------
+void TimeSeriesPlot::setPreferredSize(const GLMotif::Vector &size)
+{
+  this->PreferredSize = size;
+  if (this->isManaged)
+    {
+    this->parent->requestResize(this, this->calcNaturalSize());
+    }
+  else
+    {
+    this->resize(GLMotif::Box(GLMotif::Vector(0.0f, 0.0f, 0.0f),
+                              this->calcNaturalSize()));
+    }
+}
+
+//------------------------------------------------------------------------------
+void TimeSeriesPlot::setMarginWidth(GLfloat width)
+{
+  this->MarginWidth = width;
+  if (this->isManaged)
+    {
+    this->parent->requestResize(this, this->calcNaturalSize());
+    }
+  else
+    {
+    this->resize(GLMotif::Box(GLMotif::Vector(0.0f, 0.0f, 0.0f),
+                              this->calcNaturalSize()));
+    }
+}
+
+//------------------------------------------------------------------------------
+void TimeSeriesPlot::setData(const std::vector<double> &times,
+                             const std::vector<double> &values,
+                             int numberOfComponents)
+{
+  this->Times = times;
+  this->Values = values;
+  this->NumberOfComponents = std::max(1, numberOfComponents);
+
+  this->TimeRange[0] = this->TimeRange[1] = 0.;
+  if (!this->Times.empty())
+    {
+    const auto range =
+      std::minmax_element(this->Times.begin(), this->Times.end());
+    this->TimeRange[0] = *range.first;
+    this->TimeRange[1] = *range.second;
+    }
+
+  this->ValueRange[0] = std::numeric_limits<double>::max();
+  this->ValueRange[1] = std::numeric_limits<double>::lowest();
+  for (double value : this->Values)
+    {
+    if (std::isfinite(value))
+      {
+      this->ValueRange[0] = std::min(this->ValueRange[0], value);
+      this->ValueRange[1] = std::max(this->ValueRange[1], value);
+      }
+    }
+  if (this->ValueRange[0] > this->ValueRange[1])
+    {
+    this->ValueRange[0] = this->ValueRange[1] = 0.;
+    }
+}
+
+//------------------------------------------------------------------------------
+void TimeSeriesPlot::clearData()
+{
+  this->setData(std::vector<double>(), std::vector<double>(), 1);
+}
+
+//------------------------------------------------------------------------------
+void TimeSeriesPlot::setCurrentTime(double time)
+{
+  this->CurrentTime = time;
+}
+
+//------------------------------------------------------------------------------
+void TimeSeriesPlot::drawBackground() const
+{
+  // Margin in the background color, around the plot area:
+  glColor(this->backgroundColor);
+  glBegin(GL_QUADS);
+  glNormal3f(0.0f, 0.0f, 1.0f);
+  glVertex(this->getInterior().getCorner(0));
+  glVertex(this->AreaBox.getCorner(0));
+  glVertex(this->AreaBox.getCorner(2));
+  glVertex(this->getInterior().getCorner(2));
+  glVertex(this->getInterior().getCorner(1));
+  glVertex(this->getInterior().getCorner(3));
+  glVertex(this->AreaBox.getCorner(3));
+  glVertex(this->AreaBox.getCorner(1));
+  glVertex(this->getInterior().getCorner(0));
+  glVertex(this->getInterior().getCorner(1));
+  glVertex(this->AreaBox.getCorner(1));
+  glVertex(this->AreaBox.getCorner(0));
+  glVertex(this->getInterior().getCorner(2));
+  glVertex(this->AreaBox.getCorner(2));
+  glVertex(this->AreaBox.getCorner(3));
+  glVertex(this->getInterior().getCorner(3));
+  glEnd();
+
+  glColor3f(0.9f, 0.9f, 0.9f);
+  glBegin(GL_QUADS);
+  glNormal3f(0.0f, 0.0f, 1.0f);
+  glVertex(this->AreaBox.getCorner(0));
+  glVertex(this->AreaBox.getCorner(1));
+  glVertex(this->AreaBox.getCorner(3));
+  glVertex(this->AreaBox.getCorner(2));
+  glEnd();
+}
+
+//------------------------------------------------------------------------------
+void TimeSeriesPlot::drawCurves() const
+{
+  const size_t numSteps = this->Times.size();
+  if (numSteps == 0 ||
+      this->Values.size() < numSteps * this->NumberOfComponents)
+    {
+    return;
+    }
+
+  const GLfloat x1 = this->AreaBox.getCorner(0)[0];
+  const GLfloat x2 = this->AreaBox.getCorner(1)[0];
+  const GLfloat y1 = this->AreaBox.getCorner(0)[1];
+  const GLfloat y2 = this->AreaBox.getCorner(2)[1];
+  const GLfloat z = this->AreaBox.getCorner(0)[2] + this->MarginWidth * 0.25f;
+
+  // Flat series are drawn across the middle of the area:
+  const double timeSpan = this->TimeRange[1] - this->TimeRange[0];
+  const double valueSpan = this->ValueRange[1] - this->ValueRange[0];
+
+  glLineWidth(2.0f);
+  for (int c = 0; c < this->NumberOfComponents; ++c)
+    {
+    glColor3fv(CurveColors[c % NumberOfCurveColors]);
+    glBegin(GL_LINE_STRIP);
+    for (size_t i = 0; i < numSteps; ++i)
+      {
+      const double value = this->Values[i * this->NumberOfComponents + c];
+      if (!std::isfinite(value))
+        {
+        continue;
+        }
+      const double s = timeSpan > 0. ?
+        (this->Times[i] - this->TimeRange[0]) / timeSpan :
+        (numSteps > 1 ? double(i) / double(numSteps - 1) : 0.5);
+      const double t = valueSpan > 0. ?
+        (value - this->ValueRange[0]) / valueSpan : 0.5;
+      glVertex3f(GLfloat(x1 + s * (x2 - x1)), GLfloat(y1 + t * (y2 - y1)), z);
+      }
+    glEnd();
+    }
+}
+
+//------------------------------------------------------------------------------
+void TimeSeriesPlot::drawMarker() const
+{
+  const double timeSpan = this->TimeRange[1] - this->TimeRange[0];
+  if (!std::isfinite(this->CurrentTime) || this->Times.empty() ||
+      timeSpan <= 0.)
+    {
+    return;
+    }
+
+  const double s = std::min(1., std::max(0.,
+    (this->CurrentTime - this->TimeRange[0]) / timeSpan));
+  const GLfloat x1 = this->AreaBox.getCorner(0)[0];
+  const GLfloat x2 = this->AreaBox.getCorner(1)[0];
+  const GLfloat x = GLfloat(x1 + s * (x2 - x1));
+  const GLfloat z = this->AreaBox.getCorner(0)[2] + this->MarginWidth * 0.5f;
+
+  glLineWidth(1.0f);
+  glColor3f(0.0f, 0.0f, 0.0f);
+  glBegin(GL_LINES);
+  glVertex3f(x, this->AreaBox.getCorner(0)[1], z);
+  glVertex3f(x, this->AreaBox.getCorner(2)[1], z);
+  glEnd();
+}
@@ -0,0 +1,62 @@
+#ifndef TIMESERIESPLOT_INCLUDED
+#define TIMESERIESPLOT_INCLUDED
+
+#include <GL/gl.h>
+
+#include <GLMotif/Types.h>
+#include <GLMotif/Widget.h>
+
+#include <vector>
+
+namespace GLMotif {
+class Container;
+} // end namespace GLMotif
+
+/* Line plot of the components of a variable over time, with a marker at the
+ * current time. */
+class TimeSeriesPlot : public GLMotif::Widget
+{
+public:
+  TimeSeriesPlot(const char *name, GLMotif::Container *parent,
+                 bool manageChild = true);
+  ~TimeSeriesPlot();
+
+  /* GLMotif::Widget API: */
+  GLMotif::Vector calcNaturalSize() const override;
+  void resize(const GLMotif::Box &exterior) override;
+  void draw(GLContextData &contextData) const override;
+
+  void setPreferredSize(const GLMotif::Vector &size);
+  void setMarginWidth(GLfloat width);
+
+  /* Plot one curve per component. values holds one interleaved tuple of
+   * numberOfComponents values per time. */
+  void setData(const std::vector<double> &times,
+               const std::vector<double> &values, int numberOfComponents);
+  void clearData();
+
+  /* The time of the vertical marker, or NaN to hide it. */
+  void setCurrentTime(double time);
+
+  /* The plotted time and value ranges. */
+  const double *getTimeRange() const { return TimeRange; }
+  const double *getValueRange() const { return ValueRange; }
+
+private:
+  void drawBackground() const;
+  void drawCurves() const;
+  void drawMarker() const;
+
+  GLMotif::Vector PreferredSize;
+  GLfloat MarginWidth;
+  GLMotif::Box AreaBox;
+
+  std::vector<double> Times;
+  std::vector<double> Values;
+  int NumberOfComponents;
+  double TimeRange[2];
+  double ValueRange[2];
+  double CurrentTime;
+};
+
+#endif // TIMESERIESPLOT_INCLUDED
@@ -12,7 +12,8 @@ using GLMotif::ScrolledListBox;
 //------------------------------------------------------------------------------
 VariablesDialog::VariablesDialog()
   : PopupWindow("Variables", Vrui::getWidgetManager(), "Active Variables"),
-    List(new ScrolledListBox("VariableList", this, ListBox::MULTIPLE, 20, 8))
+    List(new ScrolledListBox("VariableList", this, ListBox::MULTIPLE, 20, 8)),
+    Loading(false)
 {
 }
 
@@ -32,3 +33,53 @@ void VariablesDialog::addVariable(const std::string &var)
 {
   this->List->getListBox()->addItem(var.c_str());
 }
+
+//------------------------------------------------------------------------------
+bool VariablesDialog::updateVariables(const std::set<std::string> &variables,
+                                      const std::set<std::string> &selected,
+                                      size_t maxChanges)
+{
+  // Both the set and the list are sorted, so they are merged in one pass:
+  ListBox *list = this->List->getListBox();
+  auto var = variables.begin();
+  int index = 0;
+  size_t changes = 0;
+  while (changes < maxChanges &&
+         (var != variables.end() || index < list->getNumItems()))
+    {
+    if (index < list->getNumItems() &&
+        (var == variables.end() || *var > list->getItem(index)))
+      {
+      list->removeItem(index);
+      ++changes;
+      }
+    else if (index >= list->getNumItems() || *var < list->getItem(index))
+      {
+      list->insertItem(index, var->c_str());
+      if (selected.count(*var))
+        {
+        list->selectItem(index);
+        }
+      ++var;
+      ++index;
+      ++changes;
+      }
+    else
+      {
+      ++var;
+      ++index;
+      }
+    }
+  return var == variables.end() && index == list->getNumItems();
+}
+
+//------------------------------------------------------------------------------
+void VariablesDialog::setLoading(bool loading)
+{
+  if (loading != this->Loading)
+    {
+    this->Loading = loading;
+    this->setTitleString(loading ? "Active Variables (loading...)"
+                                 : "Active Variables");
+    }
+}
@@ -3,6 +3,7 @@
 
 #include <GLMotif/PopupWindow.h>
 
+#include <set>
 #include <string>
 #include <vector>
 
@@ -22,10 +23,21 @@ public:
 
   void addVariable(const std::string &var);
 
+  /* Insert and remove variables until the list shows variables, with at most
+   * maxChanges changes. Inserted variables that are in selected are selected.
+   * Returns true once the list is up to date. */
+  bool updateVariables(const std::set<std::string> &variables,
+                       const std::set<std::string> &selected,
+                       size_t maxChanges);
+
+  /* Show that the variables are still being read. */
+  void setLoading(bool loading);
+
   GLMotif::ScrolledListBox *getScrolledListBox() { return List; }
 
 private:
   GLMotif::ScrolledListBox *List;
+  bool Loading;
 };
 
 #endif // VARIABLESDIALOG_INCLUDED
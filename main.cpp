@@ -1,6 +1,8 @@
 // STD includes
+#include <algorithm>
 #include <iostream>
 #include <string>
+#include <vector>
 
 // MooseViewer includes
 #include "MooseViewer.h"
@@ -15,15 +17,93 @@ void printUsage(bool longForm = true)
     std::cout << "\nUSAGE:\n\t./MooseViewer -f <string> [-h]" << std::endl;
     std::cout << "\nWhere:" << std::endl;
     std::cout << "\t-f <string>, -fileName <string>" << std::endl;
-    std::cout << "\tName of ExodusII file to load using VTK.\n" << std::endl;
+    std::cout << "\tName of ExodusII file to load using VTK. Naming any piece\n"
+                 "\tof a decomposed output (<file>.N.i), or <file> itself,\n"
+                 "\tloads all N pieces as one dataset. VTKHDF (.vtkhdf, .hdf,\n"
+                 "\t.h5) and VTK XML (.pvtu, .vtu) unstructured grids are\n"
+                 "\talso read; a numbered file name (run_0012.pvtu) loads\n"
+                 "\tthe whole series. unix:<socket> receives the timesteps\n"
+                 "\tof a running simulation over a Unix domain socket (try\n"
+                 "\tmvStreamProducer). Products precomputed by mvpreprocess\n"
+                 "\tin <file>.mvproducts are used when present.\n" << std::endl;
+    std::cout << "\t-run <string>" << std::endl;
+    std::cout << "\tAnother run of the simulation on the same mesh, opened\n"
+                 "\twith the file as an ensemble. Repeat for each run. The\n"
+                 "\truns share the mesh in memory; the Ensemble menu shows\n"
+                 "\tanother run, or all of them.\n" << std::endl;
+    std::cout << "\t-sideBySide" << std::endl;
+    std::cout << "\tDisplay the runs of the ensemble side by side.\n"
+              << std::endl;
     std::cout << "\t-r <digit>, -renderMode <digit>" << std::endl;
     std::cout << "\tRender mode to request for vtkSmartVolumeMapper.\n" << std::endl;
     std::cout << "\t-showfps" << std::endl;
     std::cout << "\tShow the FPS display by default.\n" << std::endl;
     std::cout << "\t-benchmark" << std::endl;
-    std::cout << "\tPrints timing information for data updates to stderr.\n" << std::endl;
+    std::cout << "\tPrints timing information for data updates, and the time to\n"
+                 "\tthe first frame and to the first timestep, to stderr.\n" << std::endl;
     std::cout << "\t-hidebgnotifs" << std::endl;
     std::cout << "\tHide notifications for background updates.\n" << std::endl;
+    std::cout << "\t-prefetch <digit>" << std::endl;
+    std::cout << "\tNumber of upcoming timesteps to read in the background\n"
+                 "\tduring animation (default 4, 0 disables).\n" << std::endl;
+    std::cout << "\t-compressCache <digit>" << std::endl;
+    std::cout << "\tKeep up to this many timesteps that leave the prefetch\n"
+                 "\tcache in memory, LZ4 compressed (default 0).\n" << std::endl;
+    std::cout << "\t-lossyCache <tolerance>" << std::endl;
+    std::cout << "\tCompress those timesteps with an error-bounded codec\n"
+                 "\tinstead, e.g. 1e-4 of each variable's range.\n" << std::endl;
+    std::cout << "\t-columnarCache" << std::endl;
+    std::cout << "\tStore loaded timesteps in <file>.mvcache and memory-map\n"
+                 "\tthem from there when the file is reopened.\n" << std::endl;
+    std::cout << "\t-singlePrecision" << std::endl;
+    std::cout << "\tConvert coordinates and results to 32-bit floats after\n"
+                 "\treading. Variable ranges stay exact.\n" << std::endl;
+    std::cout << "\t-follow" << std::endl;
+    std::cout << "\tWatch the file for timesteps appended by a running\n"
+                 "\tsimulation.\n" << std::endl;
+    std::cout << "\t-followLatest" << std::endl;
+    std::cout << "\tLike -follow, and show each new timestep as it is\n"
+                 "\twritten.\n" << std::endl;
+    std::cout << "\t-nativeReader" << std::endl;
+    std::cout << "\tRead timesteps through the Exodus C API, one variable and\n"
+                 "\tblock at a time. Unsupported files fall back to the VTK\n"
+                 "\treader. Compare with -benchmark.\n" << std::endl;
+    std::cout << "\t-readThreads <digit>" << std::endl;
+    std::cout << "\tNumber of threads reading element blocks, or the pieces\n"
+                 "\tof a decomposed dataset, in parallel (default 1, 0 uses\n"
+                 "\tone per core). Requires a thread-safe netCDF/HDF5\n"
+                 "\tbuild. Reads by the background threads (prefetching,\n"
+                 "\trange scans, file watching) always take turns with the\n"
+                 "\tforeground read.\n"
+              << std::endl;
+    std::cout << "\t-memoryLimit <MiB>" << std::endl;
+    std::cout << "\tCeiling on the memory used by loaded data, cached\n"
+                 "\ttimesteps, the reader's array cache and derived\n"
+                 "\tgeometry (default 0, unlimited). Cached timesteps and\n"
+                 "\thidden objects are released first, and derived data\n"
+                 "\tthat still doesn't fit is skipped.\n"
+              << std::endl;
+    std::cout << "\t-noCancel" << std::endl;
+    std::cout << "\tFinish reading and processing each requested timestep,\n"
+                 "\teven when the timestep changes again in the meantime.\n"
+              << std::endl;
+    std::cout << "\t-scrubBenchmark <digit>" << std::endl;
+    std::cout << "\tOnce loaded, step forward this many times, 10 steps per\n"
+                 "\tsecond, and print the time until the last timestep is\n"
+                 "\tloaded by the reader. The surfaces and volumes derived\n"
+                 "\tfrom it are updated afterwards and are not included. Use\n"
+                 "\twith -prefetch 0 to measure reads only.\n"
+              << std::endl;
+    std::cout << "\t-session <path>" << std::endl;
+    std::cout << "\tSave the session (variables, coloring, contours, slice,\n"
+                 "\ttimestep, representation and camera) to <path> on exit.\n"
+                 "\tNo session is saved unless -session or -restore is given.\n"
+              << std::endl;
+    std::cout << "\t-restore" << std::endl;
+    std::cout << "\tRestore the saved session, and save it again on exit.\n"
+                 "\tIts timestep, variables and display are all loaded at\n"
+                 "\tonce on startup. Without -session, the session is\n"
+                 "\t<file>.mvsession next to the dataset.\n" << std::endl;
     std::cout << "\t-widgetHints <path>" << std::endl;
     std::cout << "\tPath to a JSON file providing widget hints.\n" << std::endl;
     std::cout << "\t-h, -help" << std::endl;
@@ -55,7 +135,23 @@ int main(int argc, char* argv[])
     bool showFPS = false;
     bool benchmark = false;
     bool hidebgnotifs = false;
+    int prefetch = -1;
+    bool columnarCache = false;
+    int compressSteps = 0;
+    double lossyTolerance = 0.;
+    int readThreads = 1;
+    bool singlePrecision = false;
+    bool nativeReader = false;
+    bool follow = false;
+    bool followLatest = false;
+    long memoryLimit = 0;
+    bool cancel = true;
+    int scrubSteps = 0;
     std::string widgetHints;
+    std::string session;
+    bool restore = false;
+    std::vector<std::string> runs;
+    bool sideBySide = false;
     if(argc > 1)
       {
       /* Parse the command-line arguments */
@@ -66,6 +162,15 @@ int main(int argc, char* argv[])
           name.assign(argv[i+1]);
           ++i;
           }
+        if(strcmp(argv[i], "-run")==0)
+          {
+          runs.push_back(argv[i+1]);
+          ++i;
+          }
+        if(strcmp(argv[i], "-sideBySide")==0)
+          {
+          sideBySide = true;
+          }
         if(strcmp(argv[i], "-r")==0 || strcmp(argv[i], "-renderMode")==0)
           {
           renderMode = atoi(argv[i+1]);
@@ -83,6 +188,70 @@ int main(int argc, char* argv[])
           {
           hidebgnotifs = true;
           }
+        if(strcmp(argv[i], "-prefetch")==0)
+          {
+          prefetch = atoi(argv[i+1]);
+          ++i;
+          }
+        if(strcmp(argv[i], "-compressCache")==0)
+          {
+          compressSteps = atoi(argv[i+1]);
+          ++i;
+          }
+        if(strcmp(argv[i], "-lossyCache")==0)
+          {
+          lossyTolerance = atof(argv[i+1]);
+          ++i;
+          }
+        if(strcmp(argv[i], "-columnarCache")==0)
+          {
+          columnarCache = true;
+          }
+        if(strcmp(argv[i], "-singlePrecision")==0)
+          {
+          singlePrecision = true;
+          }
+        if(strcmp(argv[i], "-nativeReader")==0)
+          {
+          nativeReader = true;
+          }
+        if(strcmp(argv[i], "-follow")==0)
+          {
+          follow = true;
+          }
+        if(strcmp(argv[i], "-followLatest")==0)
+          {
+          follow = true;
+          followLatest = true;
+          }
+        if(strcmp(argv[i], "-readThreads")==0)
+          {
+          readThreads = atoi(argv[i+1]);
+          ++i;
+          }
+        if(strcmp(argv[i], "-memoryLimit")==0)
+          {
+          memoryLimit = atol(argv[i+1]);
+          ++i;
+          }
+        if(strcmp(argv[i], "-noCancel")==0)
+          {
+          cancel = false;
+          }
+        if(strcmp(argv[i], "-scrubBenchmark")==0)
+          {
+          scrubSteps = atoi(argv[i+1]);
+          ++i;
+          }
+        if(strcmp(argv[i], "-session")==0)
+          {
+          session.assign(argv[i+1]);
+          ++i;
+          }
+        if(strcmp(argv[i], "-restore")==0)
+          {
+          restore = true;
+          }
         if(strcmp(argv[i], "-widgetHints")==0)
           {
           widgetHints.assign(argv[i+1]);
@@ -107,15 +276,38 @@ int main(int argc, char* argv[])
     application.setShowFPS(showFPS);
     application.setBenchmark(benchmark);
     application.setProgressVisibility(!hidebgnotifs);
+    application.setColumnarCache(columnarCache);
+    application.setCompressedCache(compressSteps, lossyTolerance);
+    application.setReadThreads(readThreads);
+    application.setSinglePrecision(singlePrecision);
+    application.setNativeReader(nativeReader);
+    application.setFollow(follow, followLatest);
+    application.setMemoryLimit(memoryLimit > 0 ? memoryLimit : 0);
+    application.setCancelSupersededWork(cancel);
+    application.setScrubBenchmark(scrubSteps, 0.1);
     application.setWidgetHintsFile(widgetHints);
+    application.setSession(session, restore);
     if(!name.empty())
       {
       application.setFileName(name.c_str());
       }
+    if(!runs.empty())
+      {
+      if(std::find(runs.begin(), runs.end(), name) == runs.end())
+        {
+        runs.insert(runs.begin(), name);
+        }
+      application.setRuns(runs);
+      application.setSideBySide(sideBySide);
+      }
     if(renderMode != -1)
       {
       application.setRequestedRenderMode(renderMode);
       }
+    if(prefetch != -1)
+      {
+      application.setPrefetchWindow(prefetch);
+      }
     application.initialize();
     application.run();
     return 0;
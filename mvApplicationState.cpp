@@ -5,6 +5,7 @@
 #include "mvContours.h"
 #include "mvGeometry.h"
 #include "mvInteractor.h"
+#include "mvMemoryBudget.h"
 #include "mvOutline.h"
 #include "mvSlice.h"
 #include "mvReader.h"
@@ -17,6 +18,7 @@ mvApplicationState::mvApplicationState()
     m_contours(new mvContours),
     m_geometry(new mvGeometry),
     m_interactor(new mvInteractor),
+    m_memoryBudget(new mvMemoryBudget),
     m_outline(new mvOutline),
     m_reader(new mvReader),
     m_widgetHints(new WidgetHints()),
@@ -28,6 +30,8 @@ mvApplicationState::mvApplicationState()
   m_objects.push_back(m_outline);
   m_objects.push_back(m_slice);
   m_objects.push_back(m_volume);
+
+  m_reader->setMemoryBudget(m_memoryBudget);
 }
 
 mvApplicationState::~mvApplicationState()
@@ -41,6 +45,8 @@ mvApplicationState::~mvApplicationState()
   delete m_slice;
   delete m_volume;
   delete m_widgetHints;
+  // Last, as the others report to it:
+  delete m_memoryBudget;
 }
 
 void mvApplicationState::init()
@@ -11,6 +11,7 @@
 class mvContours;
 class mvGeometry;
 class mvInteractor;
+class mvMemoryBudget;
 class mvOutline;
 class mvReader;
 class mvSlice;
@@ -56,6 +57,10 @@ public:
   mvInteractor& interactor() { return *m_interactor; }
   const mvInteractor& interactor() const { return *m_interactor; }
 
+  /** Memory accounting for the datasets of the reader and the objects.
+   * Access is not const-correct, as it is updated by the data pipelines. */
+  mvMemoryBudget& memoryBudget() const { return *m_memoryBudget; }
+
   /** Render dataset outline. */
   mvOutline& outline() { return *m_outline; }
   const mvOutline& outline() const { return *m_outline; }
@@ -87,6 +92,7 @@ private:
   mvContours *m_contours;
   mvGeometry *m_geometry;
   mvInteractor *m_interactor;
+  mvMemoryBudget *m_memoryBudget;
   mvOutline *m_outline;
   mvReader *m_reader;
   mvSlice *m_slice;
@@ -0,0 +1,78 @@
+#include "mvCancellation.h"
+
+#include <vtkAlgorithm.h>
+#include <vtkCommand.h>
+
+#include "mvReader.h"
+
+//------------------------------------------------------------------------------
+mvCancellation::mvCancellation()
+  : m_reader(nullptr),
+    m_timeStep(-1),
+    m_cancelled(false)
+{
+}
+
+//------------------------------------------------------------------------------
+mvCancellation::~mvCancellation()
+{
+  for (const Watched &watched : m_filters)
+    {
+    watched.filter->RemoveObserver(watched.observer);
+    }
+}
+
+//------------------------------------------------------------------------------
+void mvCancellation::watch(vtkAlgorithm *filter)
+{
+  Watched watched;
+  watched.filter = filter;
+  watched.observer = filter->AddObserver(vtkCommand::ProgressEvent, this,
+                                         &mvCancellation::abortIfSuperseded);
+  m_filters.push_back(watched);
+}
+
+//------------------------------------------------------------------------------
+void mvCancellation::configure(const mvReader &reader)
+{
+  m_reader = &reader;
+  m_timeStep = reader.dataTimeStep();
+}
+
+//------------------------------------------------------------------------------
+bool mvCancellation::superseded() const
+{
+  return m_reader && m_reader->superseded(m_timeStep);
+}
+
+//------------------------------------------------------------------------------
+bool mvCancellation::start()
+{
+  m_cancelled = this->superseded();
+  return !m_cancelled;
+}
+
+//------------------------------------------------------------------------------
+bool mvCancellation::finish()
+{
+  if (m_cancelled)
+    {
+    // The outputs are incomplete, but the pipeline considers them current:
+    for (const Watched &watched : m_filters)
+      {
+      watched.filter->SetAbortExecute(0);
+      watched.filter->Modified();
+      }
+    }
+  return m_cancelled;
+}
+
+//------------------------------------------------------------------------------
+void mvCancellation::abortIfSuperseded(vtkObject *caller, unsigned long, void *)
+{
+  if (this->superseded())
+    {
+    m_cancelled = true;
+    static_cast<vtkAlgorithm*>(caller)->SetAbortExecute(1);
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef MVCANCELLATION_H
+#define MVCANCELLATION_H
+
+#include <vtkSmartPointer.h>
+
+#include <atomic>
+#include <vector>
+
+class mvReader;
+class vtkAlgorithm;
+class vtkObject;
+
+/**
+ * @brief The mvCancellation class stops the work of a vvLODAsyncGLObject data
+ * pipeline when its input timestep is superseded.
+ *
+ * The pipeline watch()es its filters once, and calls configure() from
+ * DataPipeline::configure() to record the timestep of its input. While the
+ * reader is loading a different timestep (see mvReader::superseded()):
+ *
+ * - needsUpdate() should return false, so no work is started on a timestep the
+ *   user has already left.
+ * - The watched filters abort from their progress events. execute() calls
+ *   start() and finish() around the update, and exportResult() keeps the
+ *   previous result if cancelled(). The filters are marked as modified, so the
+ *   work is redone once the pipeline is configured with current data.
+ *
+ * The observers only abort filters that check vtkAlgorithm::GetAbortExecute(),
+ * which most of the contouring and cutting filters do periodically.
+ */
+class mvCancellation
+{
+public:
+  mvCancellation();
+  ~mvCancellation();
+
+  /** Abort @a filter when the input is superseded. */
+  void watch(vtkAlgorithm *filter);
+
+  /** Record the timestep of the data currently held by @a reader. */
+  void configure(const mvReader &reader);
+
+  /** True if the reader was asked for another timestep since configure(). */
+  bool superseded() const;
+
+  /**
+   * Call before executing the filters. Returns false if the input is already
+   * superseded, in which case the filters should not be executed.
+   */
+  bool start();
+
+  /**
+   * Call after executing the filters. Returns true if they were aborted, and
+   * marks them as modified.
+   */
+  bool finish();
+
+  /** True if the last execution was aborted or skipped. */
+  bool cancelled() const { return m_cancelled; }
+
+private:
+  void abortIfSuperseded(vtkObject *caller, unsigned long, void *);
+
+private:
+  // Not implemented -- disable copy:
+  mvCancellation(const mvCancellation&);
+  mvCancellation& operator=(const mvCancellation&);
+
+private:
+  const mvReader *m_reader;
+  int m_timeStep;
+  std::atomic<bool> m_cancelled;
+
+  struct Watched
+  {
+    vtkSmartPointer<vtkAlgorithm> filter;
+    unsigned long observer;
+  };
+  std::vector<Watched> m_filters;
+};
+
+#endif // MVCANCELLATION_H
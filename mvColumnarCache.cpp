@@ -0,0 +1,961 @@
+#include "mvColumnarCache.h"
+
+#include <vtkAOSDataArrayTemplate.h>
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkCompositeDataSet.h>
+#include <vtkDataArray.h>
+#include <vtkFieldData.h>
+#include <vtkIdTypeArray.h>
+#include <vtkInformation.h>
+#include <vtkMultiBlockDataSet.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char ManifestVersion[] = "mvColumnarCache 2";
+const char ColumnMagic[8] = {'M', 'V', 'C', 'O', 'L', '0', '0', '1'};
+const size_t HeaderSize = 64;
+
+// Stored at the start of each column file. The values follow at HeaderSize.
+struct ColumnHeader
+{
+  char magic[8];
+  std::uint64_t fileSize;
+  std::int32_t dataType;
+  std::int32_t numberOfComponents;
+  std::int64_t numberOfTuples;
+  char reserved[HeaderSize - 32];
+};
+static_assert(sizeof(ColumnHeader) == HeaderSize,
+              "Column header must match the payload alignment.");
+
+//------------------------------------------------------------------------------
+// Free function for mapped arrays. The mapping starts HeaderSize bytes before
+// the values, and its header records the mapping size.
+void unmapColumn(void *values)
+{
+  char *base = static_cast<char*>(values) - HeaderSize;
+  ColumnHeader header;
+  std::memcpy(&header, base, sizeof(header));
+  munmap(base, header.fileSize);
+}
+
+//------------------------------------------------------------------------------
+template <typename ValueType>
+bool wrapValues(ValueType*, vtkDataArray *array, char *base,
+                vtkIdType numValues)
+{
+  auto *aos = vtkAOSDataArrayTemplate<ValueType>::FastDownCast(array);
+  if (!aos)
+    {
+    return false;
+    }
+
+  ValueType *values = reinterpret_cast<ValueType*>(base + HeaderSize);
+  aos->SetArrayFreeFunction(&unmapColumn);
+  aos->SetArray(values, numValues, 0,
+                vtkAbstractArray::VTK_DATA_ARRAY_USER_DEFINED);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Write contents to a temporary file and move it into place.
+bool writeFileAtomically(const std::string &fileName,
+                         const ColumnHeader *header,
+                         const void *data, size_t size)
+{
+  const std::string tmpName =
+      fileName + ".tmp" + std::to_string(static_cast<long>(getpid()));
+  std::ofstream out(tmpName, std::ios::binary | std::ios::trunc);
+  if (header)
+    {
+    out.write(reinterpret_cast<const char*>(header), sizeof(*header));
+    }
+  if (size > 0)
+    {
+    out.write(static_cast<const char*>(data), size);
+    }
+  out.close();
+
+  if (!out || std::rename(tmpName.c_str(), fileName.c_str()) != 0)
+    {
+    std::remove(tmpName.c_str());
+    return false;
+    }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool writeTextFile(const std::string &fileName, const std::string &contents)
+{
+  return writeFileAtomically(fileName, nullptr, contents.data(),
+                             contents.size());
+}
+
+//------------------------------------------------------------------------------
+// Leaves in the same order as mvColumnarCache::writeNode numbers them.
+void collectLeaves(vtkDataObject *obj,
+                   std::vector<vtkUnstructuredGrid*> &leaves)
+{
+  if (vtkMultiBlockDataSet *mb = vtkMultiBlockDataSet::SafeDownCast(obj))
+    {
+    for (unsigned int i = 0; i < mb->GetNumberOfBlocks(); ++i)
+      {
+      collectLeaves(mb->GetBlock(i), leaves);
+      }
+    }
+  else if (vtkUnstructuredGrid *ug = vtkUnstructuredGrid::SafeDownCast(obj))
+    {
+    leaves.push_back(ug);
+    }
+}
+
+//------------------------------------------------------------------------------
+// Whether a and b hold the same coordinates.
+bool samePoints(vtkPoints *a, vtkPoints *b)
+{
+  if (a == b || (a && b && a->GetData() == b->GetData()))
+    {
+    return true;
+    }
+  if (!a || !b || a->GetNumberOfPoints() != b->GetNumberOfPoints())
+    {
+    return false;
+    }
+
+  double p[3];
+  double q[3];
+  for (vtkIdType i = 0; i < a->GetNumberOfPoints(); ++i)
+    {
+    a->GetPoint(i, p);
+    b->GetPoint(i, q);
+    if (p[0] != q[0] || p[1] != q[1] || p[2] != q[2])
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+vtkFieldData* arraysFor(vtkDataSet *ds, char association)
+{
+  switch (association)
+    {
+    case 'p':
+      return ds->GetPointData();
+    case 'c':
+      return ds->GetCellData();
+    case 'f':
+      return ds->GetFieldData();
+    default:
+      return nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+// Split "prefix.leaf.association.name" column names.
+bool parseColumnName(const std::string &column, int &leaf, char &association,
+                     std::string &escapedName)
+{
+  const size_t leafStart = column.find('.');
+  const size_t assocStart = leafStart == std::string::npos
+      ? leafStart : column.find('.', leafStart + 1);
+  if (assocStart == std::string::npos || assocStart + 3 > column.size() ||
+      column[assocStart + 2] != '.')
+    {
+    return false;
+    }
+
+  leaf = std::atoi(column.substr(leafStart + 1,
+                                 assocStart - leafStart - 1).c_str());
+  association = column[assocStart + 1];
+  escapedName = column.substr(assocStart + 3);
+  return true;
+}
+
+} // end anon namespace
+
+//------------------------------------------------------------------------------
+mvColumnarCache::mvColumnarCache()
+  : m_enabled(false),
+    m_usable(false),
+    m_meshLoaded(false)
+{
+}
+
+//------------------------------------------------------------------------------
+mvColumnarCache::~mvColumnarCache()
+{
+}
+
+//------------------------------------------------------------------------------
+bool mvColumnarCache::enabled() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_enabled;
+}
+
+//------------------------------------------------------------------------------
+void mvColumnarCache::setEnabled(bool enable)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_enabled = enable;
+}
+
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkMultiBlockDataSet>
+mvColumnarCache::load(const mvReadSettings &settings, int step)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_enabled || !settings.defaultObjects() ||
+      !this->openLocked(settings.fileName) ||
+      (!m_meshLoaded && !this->loadMeshLocked()))
+    {
+    return nullptr;
+    }
+
+  StepIndex index;
+  if (!this->readStepIndexLocked(step, index))
+    {
+    return nullptr;
+    }
+  for (const auto &var : settings.variables)
+    {
+    if (index.variables.find(var) == index.variables.end())
+      {
+      return nullptr;
+      }
+    }
+
+  // The new leaves share the mapped mesh:
+  std::vector<vtkSmartPointer<vtkUnstructuredGrid> > leaves;
+  leaves.reserve(m_meshLeaves.size());
+  for (const auto &mesh : m_meshLeaves)
+    {
+    vtkNew<vtkUnstructuredGrid> leaf;
+    leaf->ShallowCopy(mesh);
+    leaves.push_back(leaf.Get());
+    }
+
+  // Displaced coordinates replace those of the mesh:
+  for (int leaf : index.pointLeaves)
+    {
+    vtkSmartPointer<vtkDataArray> coords;
+    if (leaf >= 0 && leaf < static_cast<int>(leaves.size()))
+      {
+      coords = mapColumn(this->path(pointsColumnName(step, leaf)));
+      }
+    if (!coords)
+      {
+      return nullptr;
+      }
+    vtkNew<vtkPoints> points;
+    points->SetData(coords);
+    leaves[leaf]->SetPoints(points.Get());
+    }
+
+  for (const auto &column : index.columns)
+    {
+    int leaf;
+    char association;
+    std::string escapedName;
+    if (!parseColumnName(column, leaf, association, escapedName) ||
+        leaf < 0 || leaf >= static_cast<int>(leaves.size()))
+      {
+      return nullptr;
+      }
+
+    const std::string name = unescape(escapedName);
+    if (settings.variables.find(name) == settings.variables.end())
+      {
+      continue;
+      }
+
+    vtkFieldData *fd = arraysFor(leaves[leaf], association);
+    vtkSmartPointer<vtkDataArray> array = mapColumn(this->path(column));
+    if (!fd || !array)
+      {
+      return nullptr;
+      }
+    array->SetName(name.c_str());
+    fd->AddArray(array);
+    }
+
+  return vtkMultiBlockDataSet::SafeDownCast(
+        buildNode(m_structure, leaves).GetPointer());
+}
+
+//------------------------------------------------------------------------------
+void mvColumnarCache::store(const mvReadSettings &settings, int step,
+                            vtkMultiBlockDataSet *mbds)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_enabled || !mbds || !settings.defaultObjects() ||
+      !this->openLocked(settings.fileName))
+    {
+    return;
+    }
+
+  if (!m_meshLoaded && !this->loadMeshLocked())
+    {
+    if (!this->storeMeshLocked(mbds, settings.variables) ||
+        !this->loadMeshLocked())
+      {
+      std::cerr << "Unable to write columnar cache in " << m_directory
+                << ". The cache is disabled for this file." << std::endl;
+      m_usable = false;
+      return;
+      }
+    }
+
+  std::vector<vtkUnstructuredGrid*> leaves;
+  collectLeaves(mbds, leaves);
+  if (leaves.size() != m_meshLeaves.size())
+    {
+    return;
+    }
+
+  StepIndex index;
+  bool modified = false;
+  if (!this->readStepIndexLocked(step, index))
+    {
+    // A new timestep. Its coordinates differ from the mesh if displaced:
+    for (size_t i = 0; i < leaves.size(); ++i)
+      {
+      vtkPoints *points = leaves[i]->GetPoints();
+      if (!points)
+        {
+        return;
+        }
+      if (samePoints(points, m_meshLeaves[i]->GetPoints()))
+        {
+        continue;
+        }
+
+      const int leaf = static_cast<int>(i);
+      const std::string column = pointsColumnName(step, leaf);
+      if (!writeColumn(this->path(column), points->GetData()))
+        {
+        std::cerr << "Unable to write columnar cache file "
+                  << this->path(column) << "." << std::endl;
+        return;
+        }
+      index.pointLeaves.push_back(leaf);
+      modified = true;
+      }
+    }
+
+  const std::string prefix = "t" + std::to_string(step);
+  for (const auto &var : settings.variables)
+    {
+    if (index.variables.find(var) != index.variables.end())
+      {
+      continue;
+      }
+
+    for (size_t i = 0; i < leaves.size(); ++i)
+      {
+      for (char association : {'p', 'c'})
+        {
+        vtkDataArray *array =
+            arraysFor(leaves[i], association)->GetArray(var.c_str());
+        if (!array)
+          {
+          continue;
+          }
+
+        const std::string column =
+            columnName(prefix, static_cast<int>(i), association, var);
+        if (!writeColumn(this->path(column), array))
+          {
+          std::cerr << "Unable to write columnar cache file "
+                    << this->path(column) << "." << std::endl;
+          return;
+          }
+        index.columns.push_back(column);
+        }
+      }
+    index.variables.insert(var);
+    modified = true;
+    }
+
+  if (modified)
+    {
+    this->writeStepIndexLocked(step, index);
+    }
+}
+
+//------------------------------------------------------------------------------
+bool mvColumnarCache::openLocked(const std::string &dataFileName)
+{
+  if (dataFileName == m_dataFileName)
+    {
+    return m_usable;
+    }
+
+  m_dataFileName = dataFileName;
+  m_directory = dataFileName + ".mvcache";
+  m_usable = false;
+  m_meshLoaded = false;
+  m_structure = Node();
+  m_meshLeaves.clear();
+
+  struct stat info;
+  if (dataFileName.empty() || stat(dataFileName.c_str(), &info) != 0)
+    {
+    return false;
+    }
+
+  std::ostringstream manifest;
+  manifest << ManifestVersion << "\n"
+           << "source " << info.st_size << " " << info.st_mtime << "\n"
+           << "idsize " << sizeof(vtkIdType) << "\n";
+
+  std::ifstream in(this->path("manifest"));
+  std::ostringstream existing;
+  existing << in.rdbuf();
+  if (in && existing.str() == manifest.str())
+    {
+    m_usable = true;
+    return true;
+    }
+
+  // Missing or stale. Start over:
+  if (mkdir(m_directory.c_str(), 0755) != 0 && errno != EEXIST)
+    {
+    std::cerr << "Unable to create columnar cache directory " << m_directory
+              << ": " << std::strerror(errno) << std::endl;
+    return false;
+    }
+
+  if (DIR *dir = opendir(m_directory.c_str()))
+    {
+    while (dirent *entry = readdir(dir))
+      {
+      const std::string name = entry->d_name;
+      if (name != "." && name != "..")
+        {
+        unlink(this->path(name).c_str());
+        }
+      }
+    closedir(dir);
+    }
+
+  if (!writeTextFile(this->path("manifest"), manifest.str()))
+    {
+    std::cerr << "Unable to write columnar cache manifest in " << m_directory
+              << "." << std::endl;
+    return false;
+    }
+
+  m_usable = true;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool mvColumnarCache::loadMeshLocked()
+{
+  std::ifstream in(this->path("structure"));
+  Node root;
+  int numLeaves = 0;
+  if (!in || !readNode(in, root, numLeaves))
+    {
+    return false;
+    }
+
+  std::vector<vtkSmartPointer<vtkUnstructuredGrid> > leaves;
+  for (int i = 0; i < numLeaves; ++i)
+    {
+    const std::string prefix = "mesh." + std::to_string(i) + ".";
+    vtkSmartPointer<vtkDataArray> coords =
+        mapColumn(this->path(prefix + "points"));
+    vtkSmartPointer<vtkIdTypeArray> connectivity =
+        vtkIdTypeArray::SafeDownCast(mapColumn(this->path(prefix + "cells")));
+    vtkSmartPointer<vtkUnsignedCharArray> types =
+        vtkUnsignedCharArray::SafeDownCast(
+          mapColumn(this->path(prefix + "types")));
+    vtkSmartPointer<vtkIdTypeArray> locations =
+        vtkIdTypeArray::SafeDownCast(
+          mapColumn(this->path(prefix + "locations")));
+    if (!coords || !connectivity || !types || !locations)
+      {
+      return false;
+      }
+
+    vtkNew<vtkPoints> points;
+    points->SetData(coords);
+    vtkNew<vtkCellArray> cells;
+    cells->SetCells(types->GetNumberOfTuples(), connectivity);
+
+    vtkNew<vtkUnstructuredGrid> leaf;
+    leaf->SetPoints(points.Get());
+    leaf->SetCells(types, locations, cells.Get());
+    leaves.push_back(leaf.Get());
+    }
+
+  // Time-invariant arrays follow the structure:
+  std::string keyword;
+  std::string column;
+  while (in >> keyword >> column)
+    {
+    int leaf;
+    char association;
+    std::string escapedName;
+    if (keyword != "column" ||
+        !parseColumnName(column, leaf, association, escapedName) ||
+        leaf < 0 || leaf >= numLeaves)
+      {
+      return false;
+      }
+
+    vtkFieldData *fd = arraysFor(leaves[leaf], association);
+    vtkSmartPointer<vtkDataArray> array = mapColumn(this->path(column));
+    if (!fd || !array)
+      {
+      return false;
+      }
+    array->SetName(unescape(escapedName).c_str());
+    fd->AddArray(array);
+    }
+
+  m_structure = root;
+  m_meshLeaves = leaves;
+  m_meshLoaded = true;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool mvColumnarCache::storeMeshLocked(vtkMultiBlockDataSet *mbds,
+                                      const std::set<std::string> &variables)
+{
+  std::ostringstream structure;
+  int numLeaves = 0;
+  if (!writeNode(structure, mbds, numLeaves))
+    {
+    return false;
+    }
+
+  std::vector<vtkUnstructuredGrid*> leaves;
+  collectLeaves(mbds, leaves);
+  for (size_t i = 0; i < leaves.size(); ++i)
+    {
+    vtkUnstructuredGrid *leaf = leaves[i];
+    vtkCellArray *cells = leaf->GetCells();
+    if (!leaf->GetPoints() || !cells || leaf->GetFaces())
+      {
+      return false;
+      }
+
+    const std::string prefix = "mesh." + std::to_string(i) + ".";
+    if (!writeColumn(this->path(prefix + "points"),
+                     leaf->GetPoints()->GetData()) ||
+        !writeColumn(this->path(prefix + "cells"), cells->GetData()) ||
+        !writeColumn(this->path(prefix + "types"),
+                     leaf->GetCellTypesArray()) ||
+        !writeColumn(this->path(prefix + "locations"),
+                     leaf->GetCellLocationsArray()))
+      {
+      return false;
+      }
+
+    // Everything but the result variables is constant over time:
+    for (char association : {'p', 'c', 'f'})
+      {
+      vtkFieldData *fd = arraysFor(leaf, association);
+      for (int a = 0; a < fd->GetNumberOfArrays(); ++a)
+        {
+        vtkDataArray *array = fd->GetArray(a);
+        if (!array || !array->GetName() ||
+            variables.find(array->GetName()) != variables.end())
+          {
+          continue;
+          }
+
+        const std::string column = columnName("mesh", static_cast<int>(i),
+                                              association, array->GetName());
+        if (!writeColumn(this->path(column), array))
+          {
+          return false;
+          }
+        structure << "column " << column << "\n";
+        }
+      }
+    }
+
+  // Written last, so that the mesh is only used once it is complete:
+  return writeTextFile(this->path("structure"), structure.str());
+}
+
+//------------------------------------------------------------------------------
+bool mvColumnarCache::readStepIndexLocked(int step, StepIndex &index) const
+{
+  std::ifstream in(this->path("t" + std::to_string(step) + ".index"));
+  if (!in)
+    {
+    return false;
+    }
+
+  std::string keyword;
+  std::string value;
+  while (in >> keyword >> value)
+    {
+    if (keyword == "variable")
+      {
+      index.variables.insert(unescape(value));
+      }
+    else if (keyword == "column")
+      {
+      index.columns.push_back(value);
+      }
+    else if (keyword == "points")
+      {
+      index.pointLeaves.push_back(std::atoi(value.c_str()));
+      }
+    else
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool mvColumnarCache::writeStepIndexLocked(int step,
+                                           const StepIndex &index) const
+{
+  std::ostringstream out;
+  for (const auto &var : index.variables)
+    {
+    out << "variable " << escape(var) << "\n";
+    }
+  for (const auto &column : index.columns)
+    {
+    out << "column " << column << "\n";
+    }
+  for (int leaf : index.pointLeaves)
+    {
+    out << "points " << leaf << "\n";
+    }
+  return writeTextFile(this->path("t" + std::to_string(step) + ".index"),
+                       out.str());
+}
+
+//------------------------------------------------------------------------------
+std::string mvColumnarCache::path(const std::string &name) const
+{
+  return m_directory + "/" + name;
+}
+
+//------------------------------------------------------------------------------
+std::string mvColumnarCache::escape(const std::string &name)
+{
+  if (name.empty())
+    {
+    return "-";
+    }
+
+  static const char hex[] = "0123456789abcdef";
+  std::string result;
+  for (unsigned char c : name)
+    {
+    if (std::isalnum(c) || c == '_')
+      {
+      result.push_back(static_cast<char>(c));
+      }
+    else
+      {
+      result.push_back('%');
+      result.push_back(hex[c >> 4]);
+      result.push_back(hex[c & 0xf]);
+      }
+    }
+  return result;
+}
+
+//------------------------------------------------------------------------------
+std::string mvColumnarCache::unescape(const std::string &name)
+{
+  if (name == "-")
+    {
+    return std::string();
+    }
+
+  std::string result;
+  for (size_t i = 0; i < name.size(); ++i)
+    {
+    if (name[i] == '%' && i + 2 < name.size())
+      {
+      result.push_back(static_cast<char>(
+                         std::stoi(name.substr(i + 1, 2), nullptr, 16)));
+      i += 2;
+      }
+    else
+      {
+      result.push_back(name[i]);
+      }
+    }
+  return result;
+}
+
+//------------------------------------------------------------------------------
+std::string mvColumnarCache::columnName(const std::string &prefix, int leaf,
+                                        char association,
+                                        const std::string &array)
+{
+  return prefix + "." + std::to_string(leaf) + "." + association + "." +
+      escape(array);
+}
+
+//------------------------------------------------------------------------------
+std::string mvColumnarCache::pointsColumnName(int step, int leaf)
+{
+  return "t" + std::to_string(step) + "." + std::to_string(leaf) + ".points";
+}
+
+//------------------------------------------------------------------------------
+bool mvColumnarCache::writeColumn(const std::string &fileName,
+                                  vtkDataArray *array)
+{
+  if (!array)
+    {
+    return false;
+    }
+
+  // Columns are stored interleaved. Arrays with one buffer per component (see
+  // mvNativeReader) are interleaved into a temporary copy for writing only.
+  vtkSmartPointer<vtkDataArray> interleaved;
+  if (!array->HasStandardMemoryLayout())
+    {
+    interleaved.TakeReference(
+          vtkDataArray::CreateDataArray(array->GetDataType()));
+    interleaved->DeepCopy(array);
+    array = interleaved;
+    }
+
+  const size_t payload = static_cast<size_t>(array->GetNumberOfValues()) *
+      array->GetDataTypeSize();
+
+  ColumnHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, ColumnMagic, sizeof(header.magic));
+  header.fileSize = HeaderSize + payload;
+  header.dataType = array->GetDataType();
+  header.numberOfComponents = array->GetNumberOfComponents();
+  header.numberOfTuples = array->GetNumberOfTuples();
+
+  return writeFileAtomically(fileName, &header,
+                             payload > 0 ? array->GetVoidPointer(0) : nullptr,
+                             payload);
+}
+
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkDataArray>
+mvColumnarCache::mapColumn(const std::string &fileName)
+{
+  const int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0)
+    {
+    return nullptr;
+    }
+
+  struct stat info;
+  if (fstat(fd, &info) != 0 ||
+      static_cast<size_t>(info.st_size) < HeaderSize)
+    {
+    close(fd);
+    return nullptr;
+    }
+
+  // Private, writable mapping: the pages stay shared with the page cache
+  // unless a filter modifies the array in place.
+  const size_t size = static_cast<size_t>(info.st_size);
+  void *mapping =
+      mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED)
+    {
+    return nullptr;
+    }
+
+  char *base = static_cast<char*>(mapping);
+  ColumnHeader header;
+  std::memcpy(&header, base, sizeof(header));
+
+  vtkSmartPointer<vtkDataArray> array;
+  if (std::memcmp(header.magic, ColumnMagic, sizeof(header.magic)) == 0 &&
+      header.fileSize == size && header.numberOfComponents > 0 &&
+      header.numberOfTuples >= 0)
+    {
+    array.TakeReference(vtkDataArray::CreateDataArray(header.dataType));
+    }
+
+  const vtkIdType numValues = static_cast<vtkIdType>(header.numberOfTuples) *
+      header.numberOfComponents;
+  bool wrapped = false;
+  if (array &&
+      HeaderSize + numValues * array->GetDataTypeSize() == header.fileSize)
+    {
+    array->SetNumberOfComponents(header.numberOfComponents);
+    switch (header.dataType)
+      {
+      vtkTemplateMacro(wrapped = wrapValues(static_cast<VTK_TT*>(nullptr),
+                                            array, base, numValues));
+      }
+    }
+
+  if (!wrapped)
+    {
+    munmap(mapping, size);
+    return nullptr;
+    }
+
+  return array;
+}
+
+//------------------------------------------------------------------------------
+bool mvColumnarCache::writeNode(std::ostream &out, vtkDataObject *obj,
+                                int &numLeaves)
+{
+  if (!obj)
+    {
+    out << "empty\n";
+    return true;
+    }
+
+  if (vtkMultiBlockDataSet *mb = vtkMultiBlockDataSet::SafeDownCast(obj))
+    {
+    const unsigned int numBlocks = mb->GetNumberOfBlocks();
+    out << "multiblock " << numBlocks << "\n";
+    for (unsigned int i = 0; i < numBlocks; ++i)
+      {
+      const char *name = nullptr;
+      if (mb->HasMetaData(i))
+        {
+        name = mb->GetMetaData(i)->Get(vtkCompositeDataSet::NAME());
+        }
+      out << "name " << escape(name ? name : "") << "\n";
+      if (!writeNode(out, mb->GetBlock(i), numLeaves))
+        {
+        return false;
+        }
+      }
+    return true;
+    }
+
+  if (vtkUnstructuredGrid::SafeDownCast(obj))
+    {
+    out << "leaf " << numLeaves++ << "\n";
+    return true;
+    }
+
+  // Other dataset types are not supported.
+  return false;
+}
+
+//------------------------------------------------------------------------------
+bool mvColumnarCache::readNode(std::istream &in, Node &node, int &numLeaves)
+{
+  std::string keyword;
+  if (!(in >> keyword))
+    {
+    return false;
+    }
+
+  if (keyword == "empty")
+    {
+    node.type = Node::Empty;
+    return true;
+    }
+
+  if (keyword == "leaf")
+    {
+    int leaf;
+    if (!(in >> leaf) || leaf != numLeaves)
+      {
+      return false;
+      }
+    node.type = Node::Leaf;
+    node.leaf = numLeaves++;
+    return true;
+    }
+
+  if (keyword == "multiblock")
+    {
+    unsigned int numBlocks;
+    if (!(in >> numBlocks))
+      {
+      return false;
+      }
+    node.type = Node::MultiBlock;
+    node.children.resize(numBlocks);
+    for (Node &child : node.children)
+      {
+      std::string name;
+      if (!(in >> keyword >> name) || keyword != "name" ||
+          !readNode(in, child, numLeaves))
+        {
+        return false;
+        }
+      child.name = unescape(name);
+      }
+    return true;
+    }
+
+  return false;
+}
+
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkDataObject> mvColumnarCache::buildNode(
+    const Node &node,
+    const std::vector<vtkSmartPointer<vtkUnstructuredGrid> > &leaves)
+{
+  switch (node.type)
+    {
+    case Node::Leaf:
+      return leaves[node.leaf].GetPointer();
+
+    case Node::MultiBlock:
+      {
+      vtkNew<vtkMultiBlockDataSet> mb;
+      mb->SetNumberOfBlocks(static_cast<unsigned int>(node.children.size()));
+      for (size_t i = 0; i < node.children.size(); ++i)
+        {
+        const Node &child = node.children[i];
+        const unsigned int block = static_cast<unsigned int>(i);
+        mb->SetBlock(block, buildNode(child, leaves));
+        if (!child.name.empty())
+          {
+          mb->GetMetaData(block)->Set(vtkCompositeDataSet::NAME(),
+                                      child.name.c_str());
+          }
+        }
+      return mb.Get();
+      }
+
+    case Node::Empty:
+    default:
+      return nullptr;
+    }
+}
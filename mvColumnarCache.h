@@ -0,0 +1,135 @@
+#ifndef MVCOLUMNARCACHE_H
+#define MVCOLUMNARCACHE_H
+
+#include <vtkSmartPointer.h>
+
+#include <iosfwd>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "mvReadSettings.h"
+
+class vtkDataArray;
+class vtkDataObject;
+class vtkMultiBlockDataSet;
+class vtkUnstructuredGrid;
+
+/**
+ * @brief The mvColumnarCache class stores datasets read from an Exodus file
+ * in an uncompressed sidecar that can be memory-mapped on later sessions.
+ *
+ * The cache lives in a directory named after the data file with a ".mvcache"
+ * suffix. Each array is stored in its own "column" file: a 64 byte header
+ * followed by the raw array values, so that the values are 64 byte aligned
+ * when the file is mapped. Mapped columns are wrapped by VTK arrays without
+ * copying and are unmapped when the array is released.
+ *
+ * The directory contains:
+ * - manifest: The size and modification time of the data file. The cache is
+ *   discarded when these no longer match.
+ * - structure: The multiblock hierarchy and block names.
+ * - mesh.*: Coordinates, connectivity and other time-invariant arrays of each
+ *   leaf dataset.
+ * - tN.index: The variables stored for timestep N and their columns.
+ * - tN.*: The result arrays of timestep N.
+ * - tN.L.points: The coordinates of leaf L at timestep N, where they differ
+ *   from the mesh. vtkExodusIIReader adds the displacements to the
+ *   coordinates of each timestep.
+ *
+ * Only datasets read with the default blocks and sets are cached, so that
+ * every cached timestep has the same structure.
+ *
+ * Columns are written to a temporary file and renamed, so a partially written
+ * cache is never mapped. The public API is thread-safe.
+ */
+class mvColumnarCache
+{
+public:
+  mvColumnarCache();
+  ~mvColumnarCache();
+
+  /** Whether the cache is used. Default is false. @{ */
+  bool enabled() const;
+  void setEnabled(bool enable);
+  /** @} */
+
+  /**
+   * Return the dataset for @a step with all of the variables in @a settings,
+   * built from mapped columns, or nullptr if the cache doesn't hold them.
+   */
+  vtkSmartPointer<vtkMultiBlockDataSet> load(const mvReadSettings &settings,
+                                             int step);
+
+  /**
+   * Write the columns of @a mbds, which was read for @a step with
+   * @a settings, that are not already in the cache.
+   */
+  void store(const mvReadSettings &settings, int step,
+             vtkMultiBlockDataSet *mbds);
+
+private:
+  // Multiblock hierarchy, as stored in the structure file.
+  struct Node
+  {
+    enum Type { Empty, Leaf, MultiBlock } type{Empty};
+    std::string name;
+    int leaf{-1}; // Leaf index in traversal order.
+    std::vector<Node> children;
+  };
+
+  // Variables of a timestep, as stored in the index file.
+  struct StepIndex
+  {
+    std::set<std::string> variables;
+    std::vector<std::string> columns; // Column file names.
+    std::vector<int> pointLeaves; // Leaves with coordinates of their own.
+  };
+
+  // These require m_mutex to be held:
+  bool openLocked(const std::string &dataFileName);
+  bool loadMeshLocked();
+  bool storeMeshLocked(vtkMultiBlockDataSet *mbds,
+                       const std::set<std::string> &variables);
+  bool readStepIndexLocked(int step, StepIndex &index) const;
+  bool writeStepIndexLocked(int step, const StepIndex &index) const;
+
+  std::string path(const std::string &name) const;
+
+  static std::string escape(const std::string &name);
+  static std::string unescape(const std::string &name);
+  static std::string columnName(const std::string &prefix, int leaf,
+                                char association, const std::string &array);
+  static std::string pointsColumnName(int step, int leaf);
+
+  static bool writeColumn(const std::string &fileName, vtkDataArray *array);
+  static vtkSmartPointer<vtkDataArray> mapColumn(const std::string &fileName);
+
+  static bool writeNode(std::ostream &out, vtkDataObject *obj,
+                        int &numLeaves);
+  static bool readNode(std::istream &in, Node &node, int &numLeaves);
+  static vtkSmartPointer<vtkDataObject> buildNode(
+      const Node &node,
+      const std::vector<vtkSmartPointer<vtkUnstructuredGrid> > &leaves);
+
+private:
+  // Not implemented -- disable copy:
+  mvColumnarCache(const mvColumnarCache&);
+  mvColumnarCache& operator=(const mvColumnarCache&);
+
+private:
+  mutable std::mutex m_mutex;
+  bool m_enabled;
+
+  std::string m_dataFileName;
+  std::string m_directory;
+  bool m_usable; // False if the directory can't be used.
+
+  // Parsed structure and the mapped mesh, shared by all loaded timesteps:
+  bool m_meshLoaded;
+  Node m_structure;
+  std::vector<vtkSmartPointer<vtkUnstructuredGrid> > m_meshLeaves;
+};
+
+#endif // MVCOLUMNARCACHE_H
@@ -0,0 +1,470 @@
+#include "mvCompressedDataSet.h"
+
+#include "mvMemoryBudget.h"
+
+#include <vtkCellData.h>
+#include <vtkCompositeDataIterator.h>
+#include <vtkDataArray.h>
+#include <vtkDataSet.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkMultiBlockDataSet.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+
+#include <vtk_lz4.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+namespace {
+
+//------------------------------------------------------------------------------
+// Replace out with the LZ4 compressed data. Returns false if it doesn't
+// shrink.
+bool compressLZ4(const char *data, size_t size, std::vector<char> &out)
+{
+  if (size == 0 || size > static_cast<size_t>(LZ4_MAX_INPUT_SIZE))
+    {
+    return false;
+    }
+  out.resize(LZ4_compressBound(static_cast<int>(size)));
+  const int compressed =
+      LZ4_compress_default(data, out.data(), static_cast<int>(size),
+                           static_cast<int>(out.size()));
+  if (compressed <= 0 || static_cast<size_t>(compressed) >= size)
+    {
+    out.clear();
+    return false;
+    }
+  out.resize(compressed);
+  out.shrink_to_fit();
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Group the bytes of equal significance of count values of width bytes.
+// Float exponents and high integer bytes vary little between neighbors, which
+// gives LZ4 the repeats it needs.
+void shuffle(const char *in, char *out, size_t count, size_t width)
+{
+  for (size_t b = 0; b < width; ++b)
+    {
+    for (size_t i = 0; i < count; ++i)
+      {
+      out[b * count + i] = in[i * width + b];
+      }
+    }
+}
+
+//------------------------------------------------------------------------------
+void unshuffle(const char *in, char *out, size_t count, size_t width)
+{
+  for (size_t b = 0; b < width; ++b)
+    {
+    for (size_t i = 0; i < count; ++i)
+      {
+      out[i * width + b] = in[b * count + i];
+      }
+    }
+}
+
+//------------------------------------------------------------------------------
+void putVarint(std::uint64_t value, std::vector<char> &out)
+{
+  while (value >= 0x80)
+    {
+    out.push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+    }
+  out.push_back(static_cast<char>(value));
+}
+
+//------------------------------------------------------------------------------
+std::uint64_t getVarint(const unsigned char *&in)
+{
+  std::uint64_t value = 0;
+  for (int shift = 0; ; shift += 7)
+    {
+    const unsigned char byte = *in++;
+    value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80))
+      {
+      return value;
+      }
+    }
+}
+
+//------------------------------------------------------------------------------
+// The exact [min, max] of each component. Returns false if a value is not
+// finite.
+template <typename T>
+bool componentRanges(const T *values, long long numTuples, int numComps,
+                     std::vector<double> &ranges)
+{
+  ranges.assign(2 * numComps, 0.);
+  for (int c = 0; c < numComps; ++c)
+    {
+    ranges[2 * c] = std::numeric_limits<double>::max();
+    ranges[2 * c + 1] = std::numeric_limits<double>::lowest();
+    }
+  for (long long t = 0; t < numTuples; ++t)
+    {
+    for (int c = 0; c < numComps; ++c)
+      {
+      const double value = *values++;
+      if (!std::isfinite(value))
+        {
+        return false;
+        }
+      ranges[2 * c] = std::min(ranges[2 * c], value);
+      ranges[2 * c + 1] = std::max(ranges[2 * c + 1], value);
+      }
+    }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Quantize component by component, and store the zigzag encoded differences
+// between neighbors as varints.
+template <typename T>
+void quantize(const T *values, long long numTuples, int numComps,
+              const std::vector<double> &minimum,
+              const std::vector<double> &step, std::vector<char> &out)
+{
+  for (int c = 0; c < numComps; ++c)
+    {
+    std::int64_t previous = 0;
+    for (long long t = 0; t < numTuples; ++t)
+      {
+      const double value = values[t * numComps + c];
+      const std::int64_t q = step[c] > 0.
+          ? std::llround((value - minimum[c]) / step[c]) : 0;
+      const std::int64_t delta = q - previous;
+      putVarint((static_cast<std::uint64_t>(delta) << 1) ^
+                static_cast<std::uint64_t>(delta >> 63), out);
+      previous = q;
+      }
+    }
+}
+
+//------------------------------------------------------------------------------
+template <typename T>
+void dequantize(const unsigned char *in, long long numTuples, int numComps,
+                const std::vector<double> &minimum,
+                const std::vector<double> &step, T *values)
+{
+  for (int c = 0; c < numComps; ++c)
+    {
+    std::int64_t q = 0;
+    for (long long t = 0; t < numTuples; ++t)
+      {
+      const std::uint64_t zigzag = getVarint(in);
+      q += static_cast<std::int64_t>((zigzag >> 1) ^ (~(zigzag & 1) + 1));
+      values[t * numComps + c] =
+          static_cast<T>(minimum[c] + static_cast<double>(q) * step[c]);
+      }
+    }
+}
+
+//------------------------------------------------------------------------------
+// Seed the range cache that vtkDataArray::GetRange() consults.
+void seedRanges(vtkDataArray *array, const std::vector<double> &ranges)
+{
+  const int numComps = array->GetNumberOfComponents();
+  vtkNew<vtkInformationVector> perComponent;
+  perComponent->SetNumberOfInformationObjects(numComps);
+  for (int c = 0; c < numComps; ++c)
+    {
+    perComponent->GetInformationObject(c)->Set(
+          vtkDataArray::COMPONENT_RANGE(), &ranges[2 * c], 2);
+    }
+  array->GetInformation()->Set(vtkAbstractArray::PER_COMPONENT(),
+                               perComponent.Get());
+}
+
+} // end anon namespace
+
+//------------------------------------------------------------------------------
+mvCompressedDataSet::mvCompressedDataSet()
+  : m_arrayBytes(0),
+    m_compressedBytes(0)
+{
+}
+
+//------------------------------------------------------------------------------
+mvCompressedDataSet::~mvCompressedDataSet()
+{
+}
+
+//------------------------------------------------------------------------------
+void mvCompressedDataSet::compress(vtkMultiBlockDataSet *data, Codec codec,
+                                   double tolerance)
+{
+  m_columns.clear();
+  m_arrayBytes = 0;
+  m_compressedBytes = 0;
+  m_skeleton.TakeReference(data->NewInstance());
+  m_skeleton->CopyStructure(data);
+
+  size_t leafIndex = 0;
+  vtkCompositeDataIterator *it = data->NewIterator();
+  for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextItem())
+    {
+    vtkDataSet *ds = vtkDataSet::SafeDownCast(it->GetCurrentDataObject());
+    if (!ds)
+      {
+      m_skeleton->SetDataSet(it, it->GetCurrentDataObject());
+      continue;
+      }
+
+    vtkSmartPointer<vtkDataSet> leaf;
+    leaf.TakeReference(ds->NewInstance());
+    leaf->ShallowCopy(ds);
+    for (int cellData = 0; cellData < 2; ++cellData)
+      {
+      vtkDataSetAttributes *attributes =
+          cellData ? static_cast<vtkDataSetAttributes*>(leaf->GetCellData())
+                   : static_cast<vtkDataSetAttributes*>(leaf->GetPointData());
+      std::vector<std::string> names;
+      for (int i = 0; i < attributes->GetNumberOfArrays(); ++i)
+        {
+        vtkDataArray *array = attributes->GetArray(i);
+        if (!array || !array->GetName())
+          {
+          continue;
+          }
+        Column column;
+        column.leaf = leafIndex;
+        column.cellData = cellData != 0;
+        column.attribute = attributes->IsArrayAnAttribute(i);
+        column.name = array->GetName();
+        encode(array, codec, tolerance, column);
+        m_arrayBytes += static_cast<size_t>(array->GetNumberOfValues()) *
+            array->GetDataTypeSize();
+        m_compressedBytes += column.bytes.size();
+        m_columns.push_back(std::move(column));
+        names.push_back(array->GetName());
+        }
+      for (const std::string &name : names)
+        {
+        attributes->RemoveArray(name.c_str());
+        }
+      }
+    m_skeleton->SetDataSet(it, leaf);
+    ++leafIndex;
+    }
+  it->Delete();
+}
+
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkMultiBlockDataSet> mvCompressedDataSet::decompress() const
+{
+  vtkSmartPointer<vtkMultiBlockDataSet> result;
+  if (!m_skeleton)
+    {
+    return result;
+    }
+  result.TakeReference(m_skeleton->NewInstance());
+  result->CopyStructure(m_skeleton);
+
+  std::vector<vtkDataSet*> leaves;
+  vtkCompositeDataIterator *it = m_skeleton->NewIterator();
+  for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextItem())
+    {
+    vtkDataSet *ds = vtkDataSet::SafeDownCast(it->GetCurrentDataObject());
+    if (!ds)
+      {
+      result->SetDataSet(it, it->GetCurrentDataObject());
+      continue;
+      }
+    vtkSmartPointer<vtkDataSet> leaf;
+    leaf.TakeReference(ds->NewInstance());
+    leaf->ShallowCopy(ds);
+    result->SetDataSet(it, leaf);
+    leaves.push_back(leaf);
+    }
+  it->Delete();
+
+  for (const Column &column : m_columns)
+    {
+    vtkDataSet *leaf = leaves[column.leaf];
+    vtkDataSetAttributes *attributes = column.cellData
+        ? static_cast<vtkDataSetAttributes*>(leaf->GetCellData())
+        : static_cast<vtkDataSetAttributes*>(leaf->GetPointData());
+    vtkSmartPointer<vtkDataArray> array = decode(column);
+    if (!array)
+      {
+      return nullptr;
+      }
+    const int index = attributes->AddArray(array);
+    if (column.attribute >= 0)
+      {
+      attributes->SetActiveAttribute(index, column.attribute);
+      }
+    }
+
+  return result;
+}
+
+//------------------------------------------------------------------------------
+size_t mvCompressedDataSet::memorySize() const
+{
+  return mvMemoryBudget::dataSize(m_skeleton) + m_compressedBytes;
+}
+
+//------------------------------------------------------------------------------
+void mvCompressedDataSet::encode(vtkDataArray *array, Codec codec,
+                                 double tolerance, Column &column)
+{
+  column.dataType = array->GetDataType();
+  column.numberOfComponents = array->GetNumberOfComponents();
+  column.numberOfTuples = array->GetNumberOfTuples();
+  column.lz4 = false;
+
+  // The codecs work on interleaved values:
+  vtkSmartPointer<vtkDataArray> interleaved = array;
+  if (!array->HasStandardMemoryLayout())
+    {
+    interleaved.TakeReference(vtkDataArray::CreateDataArray(column.dataType));
+    interleaved->DeepCopy(array);
+    }
+  const char *data = static_cast<const char*>(interleaved->GetVoidPointer(0));
+  const size_t width = static_cast<size_t>(array->GetDataTypeSize());
+  const size_t count = static_cast<size_t>(array->GetNumberOfValues());
+  const int numComps = column.numberOfComponents;
+
+  std::vector<char> encoding;
+  bool quantized = false;
+  if (codec == Codec::ErrorBounded &&
+      (column.dataType == VTK_DOUBLE || column.dataType == VTK_FLOAT))
+    {
+    const bool finite = column.dataType == VTK_DOUBLE
+        ? componentRanges(reinterpret_cast<const double*>(data),
+                          column.numberOfTuples, numComps, column.ranges)
+        : componentRanges(reinterpret_cast<const float*>(data),
+                          column.numberOfTuples, numComps, column.ranges);
+    // Also keep the quantized values well inside 64 bit integers:
+    tolerance = std::max(tolerance, 1e-12);
+    if (finite && column.numberOfTuples > 0)
+      {
+      quantized = true;
+      for (int c = 0; c < numComps; ++c)
+        {
+        column.minimum.push_back(column.ranges[2 * c]);
+        const double range = column.ranges[2 * c + 1] - column.ranges[2 * c];
+        column.step.push_back(2. * tolerance * range);
+        }
+      if (column.dataType == VTK_DOUBLE)
+        {
+        quantize(reinterpret_cast<const double*>(data), column.numberOfTuples,
+                 numComps, column.minimum, column.step, encoding);
+        }
+      else
+        {
+        quantize(reinterpret_cast<const float*>(data), column.numberOfTuples,
+                 numComps, column.minimum, column.step, encoding);
+        }
+      }
+    }
+
+  if (quantized)
+    {
+    column.encoding = Encoding::Quantized;
+    }
+  else
+    {
+    column.ranges.clear();
+    column.encoding = width > 1 ? Encoding::Shuffled : Encoding::Raw;
+    encoding.resize(count * width);
+    if (width > 1)
+      {
+      shuffle(data, encoding.data(), count, width);
+      }
+    else if (!encoding.empty())
+      {
+      std::memcpy(encoding.data(), data, encoding.size());
+      }
+    }
+
+  column.encodedSize = encoding.size();
+  column.lz4 = compressLZ4(encoding.data(), encoding.size(), column.bytes);
+  if (!column.lz4)
+    {
+    column.bytes.swap(encoding);
+    column.bytes.shrink_to_fit();
+    }
+}
+
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkDataArray>
+mvCompressedDataSet::decode(const Column &column)
+{
+  vtkSmartPointer<vtkDataArray> array;
+  array.TakeReference(vtkDataArray::CreateDataArray(column.dataType));
+  array->SetName(column.name.c_str());
+  array->SetNumberOfComponents(column.numberOfComponents);
+  array->SetNumberOfTuples(column.numberOfTuples);
+
+  std::vector<char> decompressed;
+  const char *encoding = column.bytes.data();
+  if (column.lz4)
+    {
+    decompressed.resize(column.encodedSize);
+    const int size =
+        LZ4_decompress_safe(column.bytes.data(), decompressed.data(),
+                            static_cast<int>(column.bytes.size()),
+                            static_cast<int>(decompressed.size()));
+    if (size != static_cast<int>(decompressed.size()))
+      {
+      std::cerr << "mvCompressedDataSet: Unable to decompress array '"
+                << column.name << "'." << std::endl;
+      return nullptr;
+      }
+    encoding = decompressed.data();
+    }
+
+  char *values = static_cast<char*>(array->GetVoidPointer(0));
+  const size_t width = static_cast<size_t>(array->GetDataTypeSize());
+  const size_t count = static_cast<size_t>(array->GetNumberOfValues());
+  switch (column.encoding)
+    {
+    case Encoding::Raw:
+      if (count > 0)
+        {
+        std::memcpy(values, encoding, count * width);
+        }
+      break;
+
+    case Encoding::Shuffled:
+      unshuffle(encoding, values, count, width);
+      break;
+
+    case Encoding::Quantized:
+      {
+      const unsigned char *in =
+          reinterpret_cast<const unsigned char*>(encoding);
+      if (column.dataType == VTK_DOUBLE)
+        {
+        dequantize(in, column.numberOfTuples, column.numberOfComponents,
+                   column.minimum, column.step,
+                   reinterpret_cast<double*>(values));
+        }
+      else
+        {
+        dequantize(in, column.numberOfTuples, column.numberOfComponents,
+                   column.minimum, column.step,
+                   reinterpret_cast<float*>(values));
+        }
+      // Report the ranges of the original values:
+      seedRanges(array, column.ranges);
+      }
+      break;
+    }
+
+  return array;
+}
@@ -0,0 +1,108 @@
+#ifndef MVCOMPRESSEDDATASET_H
+#define MVCOMPRESSEDDATASET_H
+
+#include <vtkSmartPointer.h>
+
+#include <string>
+#include <vector>
+
+class vtkDataArray;
+class vtkMultiBlockDataSet;
+
+/**
+ * @brief The mvCompressedDataSet class holds a timestep with its point and
+ * cell arrays compressed in memory.
+ *
+ * Only the arrays are compressed. The leaves keep their points and cells,
+ * which mvSharedTopology shares between timesteps, so compressing them would
+ * not free memory.
+ *
+ * Two codecs are available:
+ *
+ * - Lossless: the bytes of each array are shuffled so that the bytes of equal
+ *   significance are adjacent, and compressed with LZ4.
+ * - ErrorBounded: float and double arrays are quantized per component to a
+ *   step of 2 * tolerance * (component range), so that no value moves by more
+ *   than tolerance times the range of its component. The quantized values are
+ *   delta and variable-length encoded, and compressed with LZ4. Other arrays,
+ *   and arrays with non-finite values, are compressed losslessly. The exact
+ *   component ranges are seeded in the range cache of decompressed arrays, as
+ *   mvSinglePrecision does.
+ *
+ * Decompressed arrays are interleaved (AOS), whatever their original layout.
+ * Instances are immutable once compressed, and may be decompressed from
+ * several threads.
+ */
+class mvCompressedDataSet
+{
+public:
+  enum class Codec
+  {
+    Lossless,
+    ErrorBounded
+  };
+
+  mvCompressedDataSet();
+  ~mvCompressedDataSet();
+
+  /**
+   * Compress the arrays of @a data. @a tolerance is the maximum error
+   * relative to each component's range, and is only used by ErrorBounded.
+   */
+  void compress(vtkMultiBlockDataSet *data, Codec codec, double tolerance);
+
+  /**
+   * Return a new dataset equivalent to the one compressed, or nullptr if an
+   * array can't be decoded.
+   */
+  vtkSmartPointer<vtkMultiBlockDataSet> decompress() const;
+
+  /** The size of the arrays before and after compression, in bytes. @{ */
+  size_t arrayBytes() const { return m_arrayBytes; }
+  size_t compressedBytes() const { return m_compressedBytes; }
+  /** @} */
+
+  /**
+   * The memory held, in bytes, counting the mesh like
+   * mvMemoryBudget::dataSize() does.
+   */
+  size_t memorySize() const;
+
+private:
+  enum class Encoding
+  {
+    Raw,
+    Shuffled,
+    Quantized
+  };
+
+  struct Column
+  {
+    size_t leaf; // In iteration order.
+    bool cellData;
+    int attribute; // vtkDataSetAttributes type, or -1.
+    std::string name;
+    int dataType;
+    int numberOfComponents;
+    long long numberOfTuples;
+    Encoding encoding;
+    bool lz4; // Whether bytes holds the LZ4 compressed encoding.
+    size_t encodedSize; // The size of the encoding before LZ4.
+    std::vector<double> minimum; // Per component, if Quantized.
+    std::vector<double> step;
+    std::vector<double> ranges; // Exact [min, max] per component.
+    std::vector<char> bytes;
+  };
+
+  static void encode(vtkDataArray *array, Codec codec, double tolerance,
+                     Column &column);
+  static vtkSmartPointer<vtkDataArray> decode(const Column &column);
+
+private:
+  vtkSmartPointer<vtkMultiBlockDataSet> m_skeleton; // Leaves without arrays.
+  std::vector<Column> m_columns;
+  size_t m_arrayBytes;
+  size_t m_compressedBytes;
+};
+
+#endif // MVCOMPRESSEDDATASET_H
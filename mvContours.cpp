@@ -14,9 +14,13 @@
 #include <vtkUnstructuredGrid.h>
 
 #include "mvApplicationState.h"
+#include "mvProductCache.h"
+#include "mvProductFilters.h"
 #include "vvContextState.h"
 #include "mvReader.h"
 
+#include <algorithm>
+
 //------------------------------------------------------------------------------
 mvContours::LoResDataPipeline::LoResDataPipeline()
 {
@@ -69,7 +73,6 @@ void mvContours::LoResDataPipeline::configure(
     }
 
   // Set contour values:
-  const ContourState &state = static_cast<const ContourState&>(objState);
   double min = metaData.range[0];
   double spread = metaData.range[1] - min;
   this->contour->SetNumberOfContours(state.contourValues.size());
@@ -183,15 +186,10 @@ void mvContours::LoResRenderPipeline::disable()
 //------------------------------------------------------------------------------
 mvContours::HiResDataPipeline::HiResDataPipeline()
 {
-  this->contour->GenerateTrianglesOn();
-  this->contour->ComputeScalarsOn();
-
-  // These cause artifacts with the SMPContourGrid filter. Reported as VTK
-  // bug 15969.
-  this->contour->MergePiecesOff();
-  this->contour->UseScalarTreeOff();
+  mvProductFilters::setupContour(this->contour.Get(), this->geometry.Get());
 
-  this->geometry->SetInputConnection(this->contour->GetOutputPort());
+  this->cancel.watch(this->contour.Get());
+  this->cancel.watch(this->geometry.Get());
 }
 
 //------------------------------------------------------------------------------
@@ -200,6 +198,11 @@ void mvContours::HiResDataPipeline::configure(
 {
   const mvApplicationState &appState =
       static_cast<const mvApplicationState &>(vvState);
+  const ContourState &state = static_cast<const ContourState&>(objState);
+
+  this->memory.configure(appState.memoryBudget(), state.visible);
+  this->cancel.configure(appState.reader());
+  this->products = nullptr;
 
   // Only modify the filter if the colorByArray is loaded.
   auto metaData = appState.reader().variableMetaData(appState.colorByArray());
@@ -212,39 +215,42 @@ void mvContours::HiResDataPipeline::configure(
   this->contour->SetInputDataObject(appState.reader().dataObject());
 
   // Use the correct array for contouring:
+  this->association = -1;
   switch (metaData.location)
     {
     case mvReader::VariableMetaData::Location::CellData:
-      this->contour->SetInputArrayToProcess(
-            0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_CELLS,
-            appState.colorByArray().c_str());
+      this->association = vtkDataObject::FIELD_ASSOCIATION_CELLS;
       break;
 
     case mvReader::VariableMetaData::Location::PointData:
-      this->contour->SetInputArrayToProcess(
-            0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_POINTS,
-            appState.colorByArray().c_str());
+      this->association = vtkDataObject::FIELD_ASSOCIATION_POINTS;
       break;
 
     case mvReader::VariableMetaData::Location::FieldData:
-      this->contour->SetInputArrayToProcess(
-            0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_NONE,
-            appState.colorByArray().c_str());
+      this->association = vtkDataObject::FIELD_ASSOCIATION_NONE;
       break;
 
     default:
       break;
     }
-
-  // Set contour values:
-  const ContourState &state = static_cast<const ContourState&>(objState);
-  double min = metaData.range[0];
-  double spread = metaData.range[1] - min;
-  this->contour->SetNumberOfContours(state.contourValues.size());
-  for (int i = 0; i < state.contourValues.size(); ++i)
+  if (this->association >= 0)
     {
-    this->contour->SetValue(i, (state.contourValues[i]/255.0) * spread + min);
+    this->contour->SetInputArrayToProcess(0, 0, 0, this->association,
+                                          appState.colorByArray().c_str());
     }
+
+  // Set contour values:
+  this->isovalues = mvProductFilters::setContourValues(
+        this->contour.Get(), state.contourValues, metaData.range);
+
+  this->products = appState.reader().products();
+  this->step = appState.reader().dataTimeStep();
+  this->variable = appState.colorByArray();
+
+  vtkDataObject *input = this->contour->GetInputDataObject(0, 0);
+  this->memory.request(this->memory.estimate(input),
+                       std::max(this->contour->GetMTime(),
+                                this->geometry->GetMTime()));
 }
 
 //------------------------------------------------------------------------------
@@ -254,8 +260,15 @@ bool mvContours::HiResDataPipeline::needsUpdate(const ObjectState &objState,
   const ContourState& state = static_cast<const ContourState&>(objState);
   const HiResLODData& data = static_cast<const HiResLODData&>(result);
 
+  if (this->memory.release())
+    {
+    return data.contours != nullptr;
+    }
+
   return
       state.visible &&
+      this->memory.allowed() &&
+      !this->cancel.superseded() &&
       this->contour->GetInputDataObject(0, 0) &&
       (!data.contours ||
        data.contours->GetMTime() < this->contour->GetMTime() ||
@@ -265,7 +278,20 @@ bool mvContours::HiResDataPipeline::needsUpdate(const ObjectState &objState,
 //------------------------------------------------------------------------------
 void mvContours::HiResDataPipeline::execute()
 {
-  this->geometry->Update();
+  this->product = nullptr;
+  if (!this->memory.release() && this->cancel.start())
+    {
+    if (this->products)
+      {
+      this->product = this->products->loadContours(
+            this->variable, this->association, this->isovalues, this->step);
+      }
+    if (!this->product)
+      {
+      this->geometry->Update();
+      }
+    }
+  this->cancel.finish();
 }
 
 //------------------------------------------------------------------------------
@@ -273,9 +299,27 @@ void mvContours::HiResDataPipeline::exportResult(LODData &result) const
 {
   HiResLODData& data = static_cast<HiResLODData&>(result);
 
-  vtkDataObject *newContours = this->geometry->GetOutputDataObject(0);
-  data.contours.TakeReference(newContours->NewInstance());
-  data.contours->ShallowCopy(newContours);
+  if (!this->memory.release() && this->cancel.cancelled())
+    {
+    // Keep the previous contours until the current timestep is contoured:
+    return;
+    }
+
+  if (this->memory.release())
+    {
+    data.contours = nullptr;
+    }
+  else if (this->product)
+    {
+    data.contours = this->product;
+    }
+  else
+    {
+    vtkDataObject *newContours = this->geometry->GetOutputDataObject(0);
+    data.contours.TakeReference(newContours->NewInstance());
+    data.contours->ShallowCopy(newContours);
+    }
+  this->memory.exportResult(data.contours);
 }
 
 //------------------------------------------------------------------------------
@@ -3,11 +3,16 @@
 
 #include "vvLODAsyncGLObject.h"
 
+#include "mvCancellation.h"
+#include "mvMemoryBudget.h"
+
 #include <vtkNew.h>
 #include <vtkSmartPointer.h>
 
+#include <string>
 #include <vector>
 
+class mvProductCache;
 class vtkActor;
 class vtkCompositeDataGeometryFilter;
 class vtkDataObject;
@@ -76,11 +81,22 @@ public:
   };
 
   // HiRes LOD: ----------------------------------------------------------------
-  // Use vtkSMPContourGrid to cut contours from the full dataset.
+  // Use vtkSMPContourGrid to cut contours from the full dataset, or load the
+  // contours precomputed by mvpreprocess for the same isovalues.
   struct HiResDataPipeline : public Superclass::DataPipeline
   {
     vtkNew<vtkSMPContourGrid> contour;
     vtkNew<vtkCompositeDataGeometryFilter> geometry;
+    mvMemoryBudget::Result memory{"Contours"};
+    mvCancellation cancel;
+
+    // The precomputed contours to look for, and the one found:
+    const mvProductCache *products{nullptr};
+    int step{-1};
+    std::string variable;
+    int association{-1};
+    std::vector<double> isovalues;
+    vtkSmartPointer<vtkDataObject> product;
 
     HiResDataPipeline();
     void configure(const ObjectState &objState,
@@ -0,0 +1,298 @@
+#include "mvEnsembleReader.h"
+
+#include "mvFormatReader.h"
+#include "mvIOLock.h"
+#include "mvNativeReader.h"
+#include "mvParallelReader.h"
+
+#include <vtkBoundingBox.h>
+#include <vtkCommand.h>
+#include <vtkCompositeDataIterator.h>
+#include <vtkDataSet.h>
+#include <vtkExodusIIReader.h>
+#include <vtkInformation.h>
+#include <vtkMultiBlockDataSet.h>
+#include <vtkPoints.h>
+#include <vtkPointSet.h>
+
+#include <iostream>
+#include <iterator>
+
+/**
+ * The readers of one run. Only those needed by the run's format are created.
+ */
+struct mvEnsembleReader::Run
+{
+  std::string fileName;
+  std::vector<std::string> pieces;
+  std::unique_ptr<mvFormatReader> format;
+  std::unique_ptr<mvNativeReader> native;
+  std::unique_ptr<mvParallelReader> pieceReader;
+  vtkSmartPointer<vtkExodusIIReader> exodus;
+};
+
+//------------------------------------------------------------------------------
+mvEnsembleReader::mvEnsembleReader()
+  : m_aborted(false)
+{
+}
+
+//------------------------------------------------------------------------------
+mvEnsembleReader::~mvEnsembleReader()
+{
+}
+
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkMultiBlockDataSet>
+mvEnsembleReader::read(const mvReadSettings &settings, int step)
+{
+  m_aborted = false;
+
+  std::vector<std::string> files(1, settings.fileName);
+  files.insert(files.end(), settings.runs.begin(), settings.runs.end());
+
+  vtkSmartPointer<vtkMultiBlockDataSet> result =
+      vtkSmartPointer<vtkMultiBlockDataSet>::New();
+  result->SetNumberOfBlocks(static_cast<unsigned int>(files.size()));
+  double offset = 0.;
+  for (size_t i = 0; i < files.size(); ++i)
+    {
+    Run &run = this->run(i, files[i]);
+
+    // The first run is read as configured; the others are found the same way
+    // mvReader finds the pieces of its file:
+    mvReadSettings runSettings = settings;
+    runSettings.runs.clear();
+    if (i > 0)
+      {
+      runSettings.pieces = run.pieces;
+      runSettings.fileName = run.pieces.empty() ? run.fileName
+                                                : run.pieces.front();
+      runSettings.numberOfTimeSteps = 0;
+      }
+
+    vtkSmartPointer<vtkMultiBlockDataSet> data =
+        this->readRun(run, runSettings, step);
+    if (this->aborted())
+      {
+      return nullptr;
+      }
+    if (!data)
+      {
+      if (i == 0)
+        {
+        return nullptr;
+        }
+      if (m_warned.insert(run.fileName).second)
+        {
+        std::cerr << "mvEnsembleReader: Unable to read timestep " << step
+                  << " of run '" << run.fileName << "'. Leaving it empty."
+                  << std::endl;
+        }
+      }
+    else
+      {
+      m_warned.erase(run.fileName);
+      m_topology.share(data);
+
+      if (i == 0)
+        {
+        // Space the runs by the width of the first:
+        vtkBoundingBox bounds;
+        vtkCompositeDataIterator *it = data->NewIterator();
+        for (it->InitTraversal(); !it->IsDoneWithTraversal();
+             it->GoToNextItem())
+          {
+          if (vtkDataSet *ds =
+              vtkDataSet::SafeDownCast(it->GetCurrentDataObject()))
+            {
+            double b[6];
+            ds->GetBounds(b);
+            bounds.AddBounds(b);
+            }
+          }
+        it->Delete();
+        const double width =
+            bounds.IsValid() ? bounds.GetLength(0) : 0.;
+        offset = width > 0. ? 1.1 * width : 1.;
+        }
+      else
+        {
+        data = this->translate(data, i, offset * i);
+        }
+      }
+
+    const unsigned int index = static_cast<unsigned int>(i);
+    result->SetBlock(index, data);
+    result->GetMetaData(index)->Set(vtkCompositeDataSet::NAME(),
+                                    label(files[i]).c_str());
+    }
+  return result;
+}
+
+//------------------------------------------------------------------------------
+std::string mvEnsembleReader::label(const std::string &fileName)
+{
+  const size_t slash = fileName.find_last_of('/');
+  return slash == std::string::npos ? fileName : fileName.substr(slash + 1);
+}
+
+//------------------------------------------------------------------------------
+mvEnsembleReader::Run& mvEnsembleReader::run(size_t i,
+                                             const std::string &fileName)
+{
+  if (m_runs.size() <= i)
+    {
+    m_runs.resize(i + 1);
+    }
+  if (!m_runs[i] || m_runs[i]->fileName != fileName)
+    {
+    m_runs[i].reset(new Run);
+    m_runs[i]->fileName = fileName;
+    if (i > 0 && mvFormatReader::isExodus(fileName))
+      {
+      m_runs[i]->pieces = mvReadSettings::findPieces(fileName);
+      }
+
+    // Translations of a replaced run are stale:
+    for (auto it = m_translations.begin(); it != m_translations.end();)
+      {
+      it = it->first.first == i ? m_translations.erase(it) : std::next(it);
+      }
+    }
+  return *m_runs[i];
+}
+
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkMultiBlockDataSet>
+mvEnsembleReader::readRun(Run &run, const mvReadSettings &settings, int step)
+{
+  vtkSmartPointer<vtkMultiBlockDataSet> data;
+  mvFormatReader *format = mvFormatReader::forFile(run.format,
+                                                   settings.fileName);
+  if (format)
+    {
+    format->setAbortCheck([this]() { return this->aborted(); });
+    return format->read(settings, step);
+    }
+
+  if (!settings.pieces.empty())
+    {
+    if (!run.pieceReader)
+      {
+      run.pieceReader.reset(new mvParallelReader);
+      }
+    run.pieceReader->setAbortCheck([this]() { return this->aborted(); });
+    return run.pieceReader->read(settings, step);
+    }
+
+  // The native reader shares the mesh across runs; it falls back to
+  // vtkExodusIIReader for the files it does not support:
+  if (!run.native)
+    {
+    run.native.reset(new mvNativeReader);
+    run.native->setSharedTopology(&m_topology);
+    }
+  run.native->setAbortCheck([this]() { return this->aborted(); });
+  data = run.native->read(settings, step);
+  if (data || this->aborted())
+    {
+    return data;
+    }
+
+  if (!run.exodus)
+    {
+    run.exodus = vtkSmartPointer<vtkExodusIIReader>::New();
+    run.exodus->AddObserver(vtkCommand::ProgressEvent, this,
+                            &mvEnsembleReader::abortReader);
+    }
+  settings.apply(run.exodus);
+  if (step > run.exodus->GetTimeStepRange()[1])
+    {
+    return nullptr;
+    }
+  run.exodus->SetTimeStep(step);
+  mvIOLock lock;
+  run.exodus->Update();
+  if (run.exodus->GetAbortExecute())
+    {
+    // The output is incomplete, but the pipeline considers it current:
+    run.exodus->SetAbortExecute(0);
+    run.exodus->Modified();
+    return nullptr;
+    }
+  vtkMultiBlockDataSet *output = run.exodus->GetOutput();
+  data.TakeReference(output->NewInstance());
+  data->ShallowCopy(output);
+  return data;
+}
+
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkMultiBlockDataSet>
+mvEnsembleReader::translate(vtkMultiBlockDataSet *mbds, size_t run,
+                            double offset)
+{
+  vtkSmartPointer<vtkMultiBlockDataSet> result;
+  result.TakeReference(mbds->NewInstance());
+  result->ShallowCopy(mbds);
+
+  vtkCompositeDataIterator *it = mbds->NewIterator();
+  for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextItem())
+    {
+    vtkPointSet *ps = vtkPointSet::SafeDownCast(it->GetCurrentDataObject());
+    if (!ps || !ps->GetPoints())
+      {
+      continue;
+      }
+
+    // The mesh is shared, so the translation usually is too:
+    Translation &translation =
+        m_translations[std::make_pair(run, it->GetCurrentFlatIndex())];
+    if (translation.source.Get() != ps->GetPoints() ||
+        translation.offset != offset)
+      {
+      vtkPoints *source = ps->GetPoints();
+      const vtkIdType numPoints = source->GetNumberOfPoints();
+      translation.source = source;
+      translation.offset = offset;
+      translation.points = vtkSmartPointer<vtkPoints>::New();
+      translation.points->SetDataType(source->GetDataType());
+      translation.points->SetNumberOfPoints(numPoints);
+      for (vtkIdType i = 0; i < numPoints; ++i)
+        {
+        double x[3];
+        source->GetPoint(i, x);
+        x[0] += offset;
+        translation.points->SetPoint(i, x);
+        }
+      }
+
+    vtkSmartPointer<vtkPointSet> leaf;
+    leaf.TakeReference(ps->NewInstance());
+    leaf->ShallowCopy(ps);
+    leaf->SetPoints(translation.points);
+    result->SetDataSet(it, leaf);
+    }
+  it->Delete();
+
+  return result;
+}
+
+//------------------------------------------------------------------------------
+bool mvEnsembleReader::aborted()
+{
+  if (!m_aborted && m_abortCheck && m_abortCheck())
+    {
+    m_aborted = true;
+    }
+  return m_aborted;
+}
+
+//------------------------------------------------------------------------------
+void mvEnsembleReader::abortReader(vtkObject *caller, unsigned long, void *)
+{
+  if (this->aborted())
+    {
+    static_cast<vtkExodusIIReader*>(caller)->SetAbortExecute(1);
+    }
+}
@@ -0,0 +1,116 @@
+#ifndef MVENSEMBLEREADER_H
+#define MVENSEMBLEREADER_H
+
+#include "mvReadSettings.h"
+#include "mvSharedTopology.h"
+
+#include <vtkSmartPointer.h>
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+class mvFormatReader;
+class mvNativeReader;
+class mvParallelReader;
+class vtkExodusIIReader;
+class vtkMultiBlockDataSet;
+class vtkObject;
+class vtkPoints;
+
+/**
+ * @brief The mvEnsembleReader class reads a timestep of several runs of a
+ * simulation on the same mesh, and lays them out side by side.
+ *
+ * The runs are mvReadSettings::fileName followed by mvReadSettings::runs. Each
+ * run is read with the other settings unchanged, by its own readers, and the
+ * output has one child per run, named by label(), that holds the dataset
+ * read from that run. Run i is translated along x by i times 1.1 the width of
+ * the first run, so that the runs do not overlap. A run that cannot be read
+ * at the timestep (e.g. a shorter run) is left empty.
+ *
+ * The runs share their mesh in memory: the outputs pass through a private
+ * mvSharedTopology before they are laid out, and Exodus runs are read with
+ * mvNativeReader, which then drops its own copy of the mesh (see
+ * mvNativeReader::setSharedTopology()). Runs that mvNativeReader does not
+ * support are read with vtkExodusIIReader, which keeps the mesh of each run
+ * in its array cache. The translated coordinates of each run are computed
+ * once and reused by later timesteps, so that each additional run costs one
+ * copy of the coordinates, and its result arrays.
+ *
+ * A read can be abandoned part way (see setAbortCheck()).
+ *
+ * read() must not be called concurrently.
+ */
+class mvEnsembleReader
+{
+public:
+  mvEnsembleReader();
+  ~mvEnsembleReader();
+
+  /**
+   * If set, @a check is polled during read(). Once it returns true, the read
+   * stops as soon as possible and returns nullptr.
+   */
+  using AbortCheck = std::function<bool()>;
+  void setAbortCheck(const AbortCheck &check) { m_abortCheck = check; }
+
+  /**
+   * Read @a step of every run in @a settings. Returns nullptr if the read was
+   * aborted or the first run could not be read.
+   */
+  vtkSmartPointer<vtkMultiBlockDataSet> read(const mvReadSettings &settings,
+                                             int step);
+
+  /** The name of the run in @a fileName: its file name without directory. */
+  static std::string label(const std::string &fileName);
+
+private:
+  struct Run;
+
+  // Return run i, reset if it reads another file than fileName.
+  Run& run(size_t i, const std::string &fileName);
+
+  // Read one run. Returns nullptr if it cannot be read or the read aborted.
+  vtkSmartPointer<vtkMultiBlockDataSet> readRun(Run &run,
+                                                const mvReadSettings &settings,
+                                                int step);
+
+  // Return a copy of mbds whose points are translated by offset along x.
+  vtkSmartPointer<vtkMultiBlockDataSet> translate(vtkMultiBlockDataSet *mbds,
+                                                  size_t run, double offset);
+
+  bool aborted();
+
+  // Progress observer of the vtkExodusIIReaders.
+  void abortReader(vtkObject *caller, unsigned long, void *);
+
+private:
+  // Not implemented -- disable copy:
+  mvEnsembleReader(const mvEnsembleReader&);
+  mvEnsembleReader& operator=(const mvEnsembleReader&);
+
+private:
+  // The translated points of a leaf of a run, keyed by run and flat index.
+  struct Translation
+  {
+    vtkSmartPointer<vtkPoints> source;
+    double offset;
+    vtkSmartPointer<vtkPoints> points;
+  };
+
+  AbortCheck m_abortCheck;
+  std::atomic<bool> m_aborted;
+
+  mvSharedTopology m_topology; // Declared before the readers that use it.
+  std::vector<std::unique_ptr<Run> > m_runs;
+  std::map<std::pair<size_t, unsigned int>, Translation> m_translations;
+  std::set<std::string> m_warned; // Runs that failed to read.
+};
+
+#endif // MVENSEMBLEREADER_H
@@ -0,0 +1,316 @@
+// Stand-alone test producer for MooseViewer's follow mode.
+//
+// Writes a synthetic transient hexahedral mesh to an Exodus file and appends
+// a timestep at a fixed interval, as a running simulation would:
+//
+//   ./mvExodusProducer /tmp/run.e &
+//   ./MooseViewer -f /tmp/run.e -followLatest
+//
+// The fields are the same travelling wave as mvStreamProducer's.
+//
+// With -interval 0 it also writes synthetic files of any size for comparing
+// the readers (-nativeReader, -readThreads) with -benchmark:
+//
+//   ./mvExodusProducer /tmp/large.e -size 100 -steps 20 -interval 0
+//   ./MooseViewer -f /tmp/large.e -nativeReader -benchmark
+
+// VTK includes
+#include <vtk_exodusII.h>
+
+// STD includes
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// POSIX includes
+#include <strings.h>
+
+namespace {
+
+//------------------------------------------------------------------------------
+// A structured block of n^3 hexahedra, offset along x. The node numbers are
+// global and 1-based, as in the file.
+struct Block
+{
+  std::string name;
+  std::vector<double> x;
+  std::vector<double> y;
+  std::vector<double> z;
+  std::vector<std::int64_t> connectivity;
+
+  std::int64_t numPoints() const { return static_cast<std::int64_t>(x.size()); }
+  std::int64_t numCells() const
+  {
+    return static_cast<std::int64_t>(connectivity.size() / 8);
+  }
+};
+
+//------------------------------------------------------------------------------
+Block makeBlock(int index, int n, std::int64_t firstNode)
+{
+  Block block;
+  block.name = "block_" + std::to_string(index + 1);
+  const int np = n + 1;
+  for (int k = 0; k < np; ++k)
+    {
+    for (int j = 0; j < np; ++j)
+      {
+      for (int i = 0; i < np; ++i)
+        {
+        block.x.push_back(index + static_cast<double>(i) / n);
+        block.y.push_back(static_cast<double>(j) / n);
+        block.z.push_back(static_cast<double>(k) / n);
+        }
+      }
+    }
+
+  for (int k = 0; k < n; ++k)
+    {
+    for (int j = 0; j < n; ++j)
+      {
+      for (int i = 0; i < n; ++i)
+        {
+        const std::int64_t p = firstNode + i + np * (j + np * k);
+        const std::int64_t ids[8] = {
+          p, p + 1, p + 1 + np, p + np,
+          p + np * np, p + 1 + np * np, p + 1 + np + np * np, p + np + np * np
+        };
+        block.connectivity.insert(block.connectivity.end(), ids, ids + 8);
+        }
+      }
+    }
+  return block;
+}
+
+//------------------------------------------------------------------------------
+// Create the file with the mesh and variable names, but no timesteps.
+// Returns the Exodus id, or -1.
+int createFile(const std::string &fileName, const std::vector<Block> &blocks)
+{
+  int compWordSize = sizeof(double);
+  int ioWordSize = sizeof(double);
+  const int exoid = ex_create(fileName.c_str(), EX_CLOBBER | EX_ALL_INT64_API,
+                              &compWordSize, &ioWordSize);
+  if (exoid < 0)
+    {
+    return -1;
+    }
+
+  std::int64_t numNodes = 0;
+  std::int64_t numElements = 0;
+  std::vector<double> x;
+  std::vector<double> y;
+  std::vector<double> z;
+  for (const Block &block : blocks)
+    {
+    numNodes += block.numPoints();
+    numElements += block.numCells();
+    x.insert(x.end(), block.x.begin(), block.x.end());
+    y.insert(y.end(), block.y.begin(), block.y.end());
+    z.insert(z.end(), block.z.begin(), block.z.end());
+    }
+
+  bool ok = ex_put_init(exoid, "mvExodusProducer", 3, numNodes, numElements,
+                        static_cast<std::int64_t>(blocks.size()), 0, 0) >= 0 &&
+      ex_put_coord(exoid, x.data(), y.data(), z.data()) >= 0;
+
+  std::vector<char*> blockNames;
+  for (size_t b = 0; ok && b < blocks.size(); ++b)
+    {
+    const std::int64_t id = static_cast<std::int64_t>(b) + 1;
+    ok = ex_put_block(exoid, EX_ELEM_BLOCK, id, "HEX8", blocks[b].numCells(),
+                      8, 0, 0, 0) >= 0 &&
+        ex_put_conn(exoid, EX_ELEM_BLOCK, id, blocks[b].connectivity.data(),
+                    nullptr, nullptr) >= 0;
+    blockNames.push_back(const_cast<char*>(blocks[b].name.c_str()));
+    }
+
+  // vtkExodusIIReader joins velocity_x, _y and _z into a vector:
+  const char *nodal[] = { "temperature", "velocity_x", "velocity_y",
+                          "velocity_z" };
+  const char *element[] = { "stress" };
+  const char *global[] = { "energy" };
+  ok = ok &&
+      ex_put_names(exoid, EX_ELEM_BLOCK, blockNames.data()) >= 0 &&
+      ex_put_variable_param(exoid, EX_NODAL, 4) >= 0 &&
+      ex_put_variable_names(exoid, EX_NODAL, 4,
+                            const_cast<char**>(nodal)) >= 0 &&
+      ex_put_variable_param(exoid, EX_ELEM_BLOCK, 1) >= 0 &&
+      ex_put_variable_names(exoid, EX_ELEM_BLOCK, 1,
+                            const_cast<char**>(element)) >= 0 &&
+      ex_put_variable_param(exoid, EX_GLOBAL, 1) >= 0 &&
+      ex_put_variable_names(exoid, EX_GLOBAL, 1,
+                            const_cast<char**>(global)) >= 0;
+  if (!ok)
+    {
+    ex_close(exoid);
+    return -1;
+    }
+  return exoid;
+}
+
+//------------------------------------------------------------------------------
+// Append timestep step (0-based), and flush it so that readers see it.
+bool writeStep(int exoid, const std::vector<Block> &blocks, int step)
+{
+  const int fileStep = step + 1; // Exodus timesteps are 1-based.
+  double time = 0.1 * step;
+  std::vector<double> temperature;
+  std::vector<double> velocity[3];
+  for (const Block &block : blocks)
+    {
+    for (std::int64_t p = 0; p < block.numPoints(); ++p)
+      {
+      temperature.push_back(std::sin(3. * block.x[p] - time) *
+                            std::cos(2. * block.y[p]));
+      velocity[0].push_back(std::cos(block.z[p] + time));
+      velocity[1].push_back(std::sin(block.x[p] - time));
+      velocity[2].push_back(0.1 * block.y[p]);
+      }
+    }
+  const std::int64_t numNodes = static_cast<std::int64_t>(temperature.size());
+
+  bool ok = ex_put_time(exoid, fileStep, &time) >= 0 &&
+      ex_put_var(exoid, fileStep, EX_NODAL, 1, 1, numNodes,
+                 temperature.data()) >= 0;
+  for (int c = 0; ok && c < 3; ++c)
+    {
+    ok = ex_put_var(exoid, fileStep, EX_NODAL, c + 2, 1, numNodes,
+                    velocity[c].data()) >= 0;
+    }
+
+  double energy = 0.;
+  std::int64_t firstNode = 1;
+  for (size_t b = 0; ok && b < blocks.size(); ++b)
+    {
+    const Block &block = blocks[b];
+    std::vector<double> stress;
+    for (std::int64_t c = 0; c < block.numCells(); ++c)
+      {
+      const std::int64_t p = block.connectivity[8 * c] - firstNode;
+      stress.push_back(block.x[p] * block.z[p] + 0.5 * std::sin(time));
+      energy += stress.back();
+      }
+    ok = ex_put_var(exoid, fileStep, EX_ELEM_BLOCK, 1,
+                    static_cast<std::int64_t>(b) + 1, block.numCells(),
+                    stress.data()) >= 0;
+    firstNode += block.numPoints();
+    }
+
+  return ok && ex_put_var(exoid, fileStep, EX_GLOBAL, 1, 0, 1, &energy) >= 0 &&
+      ex_update(exoid) >= 0;
+}
+
+//------------------------------------------------------------------------------
+void printUsage()
+{
+  std::cout << "\nmvExodusProducer - Write a synthetic simulation to an "
+               "Exodus file" << std::endl;
+  std::cout << "\nUSAGE:\n\t./mvExodusProducer <filename> [-blocks <digit>] "
+               "[-size <digit>]\n\t\t[-steps <digit>] [-interval <ms>]"
+            << std::endl;
+  std::cout << "\nWhere:" << std::endl;
+  std::cout << "\t<filename>" << std::endl;
+  std::cout << "\tExodus file to create. An existing file is replaced.\n"
+            << std::endl;
+  std::cout << "\t-blocks <digit>" << std::endl;
+  std::cout << "\tNumber of element blocks (default 3).\n" << std::endl;
+  std::cout << "\t-size <digit>" << std::endl;
+  std::cout << "\tHexahedra along each edge of a block (default 20).\n"
+            << std::endl;
+  std::cout << "\t-steps <digit>" << std::endl;
+  std::cout << "\tNumber of timesteps to write (default 100).\n" << std::endl;
+  std::cout << "\t-interval <ms>" << std::endl;
+  std::cout << "\tTime between timesteps (default 500).\n" << std::endl;
+}
+
+} // end anon namespace
+
+//------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  if (argc < 2 || argv[1][0] == '-')
+    {
+    printUsage();
+    return 1;
+    }
+  const std::string fileName = argv[1];
+  int numBlocks = 3;
+  int size = 20;
+  int numSteps = 100;
+  int interval = 500;
+  for (int i = 2; i + 1 < argc; i += 2)
+    {
+    const int value = std::atoi(argv[i + 1]);
+    if (strcasecmp(argv[i], "-blocks") == 0)
+      {
+      numBlocks = value;
+      }
+    else if (strcasecmp(argv[i], "-size") == 0)
+      {
+      size = value;
+      }
+    else if (strcasecmp(argv[i], "-steps") == 0)
+      {
+      numSteps = value;
+      }
+    else if (strcasecmp(argv[i], "-interval") == 0)
+      {
+      interval = value;
+      }
+    else
+      {
+      printUsage();
+      return 1;
+      }
+    }
+  if (numBlocks < 1 || size < 1 || numSteps < 0 || interval < 0)
+    {
+    printUsage();
+    return 1;
+    }
+
+  std::vector<Block> blocks;
+  std::int64_t firstNode = 1;
+  for (int b = 0; b < numBlocks; ++b)
+    {
+    blocks.push_back(makeBlock(b, size, firstNode));
+    firstNode += blocks.back().numPoints();
+    }
+
+  const int exoid = createFile(fileName, blocks);
+  if (exoid < 0)
+    {
+    std::cerr << "mvExodusProducer: Unable to create '" << fileName << "'."
+              << std::endl;
+    return 1;
+    }
+
+  bool ok = true;
+  for (int step = 0; ok && step < numSteps; ++step)
+    {
+    if (step > 0)
+      {
+      std::this_thread::sleep_for(std::chrono::milliseconds(interval));
+      }
+    ok = writeStep(exoid, blocks, step);
+    if (ok)
+      {
+      std::cout << "Wrote timestep " << step + 1 << "/" << numSteps << "."
+                << std::endl;
+      }
+    }
+  if (!ok)
+    {
+    std::cerr << "mvExodusProducer: Unable to write to '" << fileName << "'."
+              << std::endl;
+    }
+
+  ex_close(exoid);
+  return ok ? 0 : 1;
+}
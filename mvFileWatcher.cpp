@@ -0,0 +1,234 @@
+#include "mvFileWatcher.h"
+
+#include "mvFormatReader.h"
+#include "mvIOLock.h"
+
+#include <vtkExodusIIReader.h>
+#include <vtkInformation.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <chrono>
+
+//------------------------------------------------------------------------------
+mvFileWatcher::mvFileWatcher()
+  : m_quit(false),
+    m_enabled(false),
+    m_interval(2.),
+    m_version(0),
+    m_numberOfTimeSteps(0),
+    m_timeRange{0., 0.},
+    m_seenSize(-1),
+    m_seenTime(-1),
+    m_readSize(-1),
+    m_readTime(-1)
+{
+  m_worker = std::thread(&mvFileWatcher::workerLoop, this);
+}
+
+//------------------------------------------------------------------------------
+mvFileWatcher::~mvFileWatcher()
+{
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_quit = true;
+    }
+  m_condition.notify_all();
+  m_worker.join();
+}
+
+//------------------------------------------------------------------------------
+void mvFileWatcher::setFileName(const std::string &fileName)
+{
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (fileName == m_fileName)
+      {
+      return;
+      }
+    m_fileName = fileName;
+    m_numberOfTimeSteps = 0;
+    m_timeRange[0] = m_timeRange[1] = 0.;
+    ++m_version;
+    }
+  m_condition.notify_all();
+}
+
+//------------------------------------------------------------------------------
+bool mvFileWatcher::enabled() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_enabled;
+}
+
+//------------------------------------------------------------------------------
+void mvFileWatcher::setEnabled(bool enable)
+{
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_enabled = enable;
+    }
+  m_condition.notify_all();
+}
+
+//------------------------------------------------------------------------------
+double mvFileWatcher::interval() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_interval;
+}
+
+//------------------------------------------------------------------------------
+void mvFileWatcher::setInterval(double seconds)
+{
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_interval = seconds > 0.01 ? seconds : 0.01;
+    }
+  m_condition.notify_all();
+}
+
+//------------------------------------------------------------------------------
+unsigned long mvFileWatcher::version() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_version;
+}
+
+//------------------------------------------------------------------------------
+int mvFileWatcher::numberOfTimeSteps() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_numberOfTimeSteps;
+}
+
+//------------------------------------------------------------------------------
+void mvFileWatcher::timeRange(double range[2]) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  range[0] = m_timeRange[0];
+  range[1] = m_timeRange[1];
+}
+
+//------------------------------------------------------------------------------
+void mvFileWatcher::workerLoop()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  for (;;)
+    {
+    m_condition.wait(lock, [this]()
+      {
+      return m_quit || (m_enabled && !m_fileName.empty());
+      });
+    if (m_quit)
+      {
+      return;
+      }
+
+    const std::string fileName = m_fileName;
+    lock.unlock();
+    int numSteps;
+    double range[2];
+    const bool changed = this->check(fileName, numSteps, range);
+    lock.lock();
+
+    if (changed && fileName == m_fileName && numSteps != m_numberOfTimeSteps)
+      {
+      m_numberOfTimeSteps = numSteps;
+      m_timeRange[0] = range[0];
+      m_timeRange[1] = range[1];
+      ++m_version;
+      }
+
+    const std::chrono::duration<double> interval(m_interval);
+    m_condition.wait_for(lock, interval, [this, &fileName]()
+      {
+      return m_quit || fileName != m_fileName;
+      });
+    }
+}
+
+//------------------------------------------------------------------------------
+bool mvFileWatcher::check(const std::string &fileName, int &numSteps,
+                          double range[2])
+{
+  // A stream grows without a file to look at, so it is always polled:
+  if (mvFormatReader::isStream(fileName))
+    {
+    m_readerFileName = fileName;
+    return this->checkFormat(
+          mvFormatReader::forFile(m_formatReader, fileName), numSteps, range);
+    }
+
+  struct stat info;
+  if (stat(fileName.c_str(), &info) != 0)
+    {
+    return false;
+    }
+  const long long size = static_cast<long long>(info.st_size);
+  const long long time = static_cast<long long>(info.st_mtime);
+
+  const bool newFile = fileName != m_readerFileName;
+  if (!newFile)
+    {
+    // Wait for the writer to finish before looking at the file:
+    const bool settled = size == m_seenSize && time == m_seenTime;
+    m_seenSize = size;
+    m_seenTime = time;
+    if (!settled || (size == m_readSize && time == m_readTime))
+      {
+      return false;
+      }
+    }
+
+  m_readerFileName = fileName;
+  m_seenSize = m_readSize = size;
+  m_seenTime = m_readTime = time;
+
+  mvFormatReader *format = mvFormatReader::forFile(m_formatReader, fileName);
+  if (format)
+    {
+    return this->checkFormat(format, numSteps, range);
+    }
+
+  mvIOLock lock;
+  if (newFile)
+    {
+    m_reader->SetFileName(fileName.c_str());
+    }
+  else
+    {
+    m_reader->UpdateTimeInformation();
+    }
+  m_reader->UpdateInformation();
+
+  numSteps = m_reader->GetNumberOfTimeSteps();
+  range[0] = range[1] = 0.;
+  vtkInformation *outInfo = m_reader->GetOutputInformation(0);
+  if (outInfo->Has(vtkStreamingDemandDrivenPipeline::TIME_RANGE()))
+    {
+    outInfo->Get(vtkStreamingDemandDrivenPipeline::TIME_RANGE(), range);
+    }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool mvFileWatcher::checkFormat(mvFormatReader *format, int &numSteps,
+                                double range[2])
+{
+  mvFormatReader::Information info;
+  if (!format->readInformation(info))
+    {
+    return false;
+    }
+  numSteps = info.numberOfTimeSteps;
+  range[0] = range[1] = 0.;
+  if (!info.times.empty())
+    {
+    range[0] = *std::min_element(info.times.begin(), info.times.end());
+    range[1] = *std::max_element(info.times.begin(), info.times.end());
+    }
+  return true;
+}
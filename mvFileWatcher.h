@@ -0,0 +1,96 @@
+#ifndef MVFILEWATCHER_H
+#define MVFILEWATCHER_H
+
+#include <vtkNew.h>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+class mvFormatReader;
+class vtkExodusIIReader;
+
+/**
+ * @brief The mvFileWatcher class polls an Exodus II file that is still being
+ * written for appended timesteps.
+ *
+ * A background thread stats the file every interval(). Only when the file's
+ * size or modification time changed, and then stayed the same for one more
+ * interval (so that the writer has finished the timestep), the time values
+ * are re-read with vtkExodusIIReader::UpdateTimeInformation(). No other
+ * metadata and no array data is read. Files in other formats are re-read with
+ * mvFormatReader::readInformation(), which picks up the steps appended to a
+ * VTKHDF file; files added to a VTK XML file series are not detected.
+ * Streams (see mvStreamReader) have no file to stat and are re-read on every
+ * check.
+ *
+ * The public API is thread-safe.
+ */
+class mvFileWatcher
+{
+public:
+  mvFileWatcher();
+  ~mvFileWatcher();
+
+  /** The file to watch. Changing the file resets the results. */
+  void setFileName(const std::string &fileName);
+
+  /** Whether the file is polled. Default is false. @{ */
+  bool enabled() const;
+  void setEnabled(bool enable);
+  /** @} */
+
+  /** Seconds between checks. Default is 2. @{ */
+  double interval() const;
+  void setInterval(double seconds);
+  /** @} */
+
+  /**
+   * Incremented whenever numberOfTimeSteps() changes, so that callers can
+   * cheaply poll for new results.
+   */
+  unsigned long version() const;
+
+  /** The number of timesteps and the time range found by the last check. @{ */
+  int numberOfTimeSteps() const;
+  void timeRange(double range[2]) const;
+  /** @} */
+
+private:
+  void workerLoop();
+
+  // Re-read the time values of fileName. Only called by the worker thread.
+  bool check(const std::string &fileName, int &numSteps, double range[2]);
+  bool checkFormat(mvFormatReader *format, int &numSteps, double range[2]);
+
+private:
+  // Not implemented -- disable copy:
+  mvFileWatcher(const mvFileWatcher&);
+  mvFileWatcher& operator=(const mvFileWatcher&);
+
+private:
+  mutable std::mutex m_mutex;
+  std::condition_variable m_condition;
+  std::thread m_worker;
+  bool m_quit;
+  bool m_enabled;
+  double m_interval;
+
+  std::string m_fileName;
+  unsigned long m_version;
+  int m_numberOfTimeSteps;
+  double m_timeRange[2];
+
+  // Only used by the worker thread:
+  vtkNew<vtkExodusIIReader> m_reader;
+  std::unique_ptr<mvFormatReader> m_formatReader;
+  std::string m_readerFileName;
+  long long m_seenSize;  // The file state at the previous check...
+  long long m_seenTime;
+  long long m_readSize;  // ...and when the time values were last read.
+  long long m_readTime;
+};
+
+#endif // MVFILEWATCHER_H
@@ -0,0 +1,173 @@
+#include "mvFormatReader.h"
+
+#include "mvHDFReader.h"
+#include "mvStreamReader.h"
+#include "mvXMLReader.h"
+
+#include <vtkCellArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkInformation.h>
+#include <vtkMultiBlockDataSet.h>
+#include <vtkNew.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <algorithm>
+#include <cctype>
+
+namespace {
+
+//------------------------------------------------------------------------------
+// The lower case extension of fileName, without the dot.
+std::string extension(const std::string &fileName)
+{
+  const size_t dot = fileName.find_last_of('.');
+  const size_t slash = fileName.find_last_of('/');
+  if (dot == std::string::npos ||
+      (slash != std::string::npos && dot < slash))
+    {
+    return std::string();
+    }
+
+  std::string ext = fileName.substr(dot + 1);
+  std::transform(ext.begin(), ext.end(), ext.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  return ext;
+}
+
+} // end anon namespace
+
+//------------------------------------------------------------------------------
+mvFormatReader::mvFormatReader(const std::string &fileName)
+  : m_fileName(fileName)
+{
+}
+
+//------------------------------------------------------------------------------
+mvFormatReader::~mvFormatReader()
+{
+}
+
+//------------------------------------------------------------------------------
+bool mvFormatReader::isExodus(const std::string &fileName)
+{
+  const std::string ext = extension(fileName);
+  return ext != "vtkhdf" && ext != "hdf" && ext != "h5" &&
+      ext != "pvtu" && ext != "vtu" && !isStream(fileName);
+}
+
+//------------------------------------------------------------------------------
+bool mvFormatReader::isStream(const std::string &fileName)
+{
+  return fileName.compare(0, 5, "unix:") == 0;
+}
+
+//------------------------------------------------------------------------------
+std::unique_ptr<mvFormatReader>
+mvFormatReader::create(const std::string &fileName)
+{
+  if (isStream(fileName))
+    {
+    return std::unique_ptr<mvFormatReader>(new mvStreamReader(fileName));
+    }
+  const std::string ext = extension(fileName);
+  if (ext == "vtkhdf" || ext == "hdf" || ext == "h5")
+    {
+    return std::unique_ptr<mvFormatReader>(new mvHDFReader(fileName));
+    }
+  if (ext == "pvtu" || ext == "vtu")
+    {
+    return std::unique_ptr<mvFormatReader>(new mvXMLReader(fileName));
+    }
+  return nullptr;
+}
+
+//------------------------------------------------------------------------------
+mvFormatReader*
+mvFormatReader::forFile(std::unique_ptr<mvFormatReader> &reader,
+                        const std::string &fileName)
+{
+  if (!reader || reader->fileName() != fileName)
+    {
+    // Keep the abort check across files:
+    AbortCheck check = reader ? reader->m_abortCheck : AbortCheck();
+    reader = create(fileName);
+    if (reader)
+      {
+      reader->setAbortCheck(check);
+      }
+    }
+  return reader.get();
+}
+
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkMultiBlockDataSet> mvFormatReader::makeOutput(
+    const std::vector<vtkSmartPointer<vtkUnstructuredGrid> > &blocks,
+    const std::vector<std::string> &names)
+{
+  vtkNew<vtkMultiBlockDataSet> elementBlocks;
+  unsigned int numLeaves = 0;
+  for (size_t i = 0; i < blocks.size(); ++i)
+    {
+    if (!blocks[i])
+      {
+      continue;
+      }
+    elementBlocks->SetBlock(numLeaves, blocks[i]);
+    elementBlocks->GetMetaData(numLeaves)->Set(vtkCompositeDataSet::NAME(),
+                                               names[i].c_str());
+    ++numLeaves;
+    }
+
+  vtkSmartPointer<vtkMultiBlockDataSet> output =
+      vtkSmartPointer<vtkMultiBlockDataSet>::New();
+  output->SetBlock(0, elementBlocks.Get());
+  output->GetMetaData(0u)->Set(vtkCompositeDataSet::NAME(), "Element Blocks");
+  return output;
+}
+
+//------------------------------------------------------------------------------
+bool mvFormatReader::makeCells(const std::vector<int64_t> &offsets,
+                               const std::vector<int64_t> &connectivity,
+                               int64_t numPoints,
+                               vtkSmartPointer<vtkIdTypeArray> &locations,
+                               vtkSmartPointer<vtkCellArray> &cells)
+{
+  if (offsets.empty())
+    {
+    return false;
+    }
+  const vtkIdType numCells = static_cast<vtkIdType>(offsets.size() - 1);
+  const int64_t numIds = static_cast<int64_t>(connectivity.size());
+
+  locations = vtkSmartPointer<vtkIdTypeArray>::New();
+  locations->SetNumberOfValues(numCells);
+  vtkNew<vtkIdTypeArray> cellIds;
+  cellIds->SetNumberOfValues(numCells + static_cast<vtkIdType>(numIds));
+  vtkIdType *cell = cellIds->GetPointer(0);
+  for (vtkIdType c = 0; c < numCells; ++c)
+    {
+    const int64_t begin = offsets[c];
+    const int64_t end = offsets[c + 1];
+    if (begin < 0 || end < begin || end > numIds)
+      {
+      return false;
+      }
+    locations->SetValue(c, cell - cellIds->GetPointer(0));
+    *cell++ = static_cast<vtkIdType>(end - begin);
+    for (int64_t i = begin; i < end; ++i)
+      {
+      // Out of range ids would be dereferenced by every filter downstream:
+      if (connectivity[i] < 0 || connectivity[i] >= numPoints)
+        {
+        return false;
+        }
+      *cell++ = static_cast<vtkIdType>(connectivity[i]);
+      }
+    }
+  // Offsets that skip ids leave the tail unused:
+  cellIds->SetNumberOfValues(cell - cellIds->GetPointer(0));
+
+  cells = vtkSmartPointer<vtkCellArray>::New();
+  cells->SetCells(numCells, cellIds.Get());
+  return true;
+}
@@ -0,0 +1,144 @@
+#ifndef MVFORMATREADER_H
+#define MVFORMATREADER_H
+
+#include "mvReadSettings.h"
+
+#include <vtkSmartPointer.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+class vtkCellArray;
+class vtkIdTypeArray;
+class vtkMultiBlockDataSet;
+class vtkUnstructuredGrid;
+
+/**
+ * @brief The mvFormatReader class is the interface of the readers for file
+ * formats other than Exodus II.
+ *
+ * Exodus files are read by vtkExodusIIReader, mvNativeReader and
+ * mvParallelReader as before. Every other supported format has a subclass
+ * that provides the metadata mvReader needs (timesteps, variables, blocks)
+ * and reads one timestep at a time with only the requested variables and
+ * blocks, producing the same structure as vtkExodusIIReader: a multiblock
+ * whose first child, "Element Blocks", holds one named vtkUnstructuredGrid
+ * per selected block. Node and side sets are not supported.
+ *
+ * The format is chosen from the file name (see create()):
+ * - .vtkhdf, .hdf, .h5: VTKHDF unstructured grids (see mvHDFReader).
+ * - .pvtu, .vtu: XML unstructured grids, optionally numbered as a file series
+ *   (see mvXMLReader).
+ * - "unix:<socket path>": a running simulation streaming its timesteps (see
+ *   mvStreamReader).
+ *
+ * The read methods of an instance must not be called concurrently. Each
+ * thread that reads keeps its own instance (see forFile()).
+ */
+class mvFormatReader
+{
+public:
+  virtual ~mvFormatReader();
+
+  /** Metadata of a file, as needed by mvReader::updateInformation(). */
+  struct Information
+  {
+    int numberOfTimeSteps{0};
+    std::vector<double> times; // One per timestep.
+    std::set<std::string> pointVariables;
+    std::set<std::string> cellVariables;
+    std::vector<std::string> blocks; // Element block names, in file order.
+  };
+
+  /** True if @a fileName is read as Exodus, i.e. not by an mvFormatReader. */
+  static bool isExodus(const std::string &fileName);
+
+  /** True if @a fileName names a stream rather than a file. */
+  static bool isStream(const std::string &fileName);
+
+  /**
+   * Return a reader for @a fileName, or nullptr if it is an Exodus file.
+   */
+  static std::unique_ptr<mvFormatReader> create(const std::string &fileName);
+
+  /**
+   * Return @a reader, replaced by a new reader first if it reads another file
+   * than @a fileName. Returns nullptr (and resets @a reader) for Exodus files.
+   */
+  static mvFormatReader* forFile(std::unique_ptr<mvFormatReader> &reader,
+                                 const std::string &fileName);
+
+  /** The file that is read. */
+  const std::string& fileName() const { return m_fileName; }
+
+  /** A short name of the format, for messages. */
+  virtual const char* formatName() const = 0;
+
+  /**
+   * If set, @a check is polled between array reads. Once it returns true,
+   * read() stops and returns nullptr.
+   */
+  using AbortCheck = std::function<bool()>;
+  void setAbortCheck(const AbortCheck &check) { m_abortCheck = check; }
+
+  /**
+   * Read the metadata of the file into @a info. This rereads the file, so
+   * timesteps appended since the last call are included. Returns false if
+   * the file cannot be read.
+   */
+  virtual bool readInformation(Information &info) = 0;
+
+  /**
+   * Read @a step as described by @a settings. Returns nullptr if the read
+   * fails or is aborted.
+   */
+  virtual vtkSmartPointer<vtkMultiBlockDataSet> read(
+      const mvReadSettings &settings, int step) = 0;
+
+  /**
+   * False if @a step is in the time information but can no longer be read,
+   * as for the older timesteps of a stream.
+   */
+  virtual bool canRead(int step) const { return step >= 0; }
+
+protected:
+  explicit mvFormatReader(const std::string &fileName);
+
+  bool aborted() const { return m_abortCheck && m_abortCheck(); }
+
+  /**
+   * Build the output of read(): the leaves of @a blocks with their
+   * @a names, under an "Element Blocks" child. Null leaves are skipped.
+   */
+  static vtkSmartPointer<vtkMultiBlockDataSet> makeOutput(
+      const std::vector<vtkSmartPointer<vtkUnstructuredGrid> > &blocks,
+      const std::vector<std::string> &names);
+
+  /**
+   * Build the legacy cell array (size of each cell, then its points) and the
+   * cell locations used by vtkUnstructuredGrid::SetCells() from VTK style
+   * @a offsets (one per cell and one past the end) into @a connectivity.
+   * Returns false if the offsets are invalid, or if a point id is not in
+   * [0, @a numPoints).
+   */
+  static bool makeCells(const std::vector<int64_t> &offsets,
+                        const std::vector<int64_t> &connectivity,
+                        int64_t numPoints,
+                        vtkSmartPointer<vtkIdTypeArray> &locations,
+                        vtkSmartPointer<vtkCellArray> &cells);
+
+private:
+  // Not implemented -- disable copy:
+  mvFormatReader(const mvFormatReader&);
+  mvFormatReader& operator=(const mvFormatReader&);
+
+private:
+  std::string m_fileName;
+  AbortCheck m_abortCheck;
+};
+
+#endif // MVFORMATREADER_H
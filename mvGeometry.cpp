@@ -14,9 +14,18 @@
 #include <vvContextState.h>
 
 #include "mvApplicationState.h"
+#include "mvProductCache.h"
+#include "mvProductFilters.h"
 #include "mvReader.h"
 
 
+//------------------------------------------------------------------------------
+mvGeometry::LoResDataPipeline::LoResDataPipeline()
+{
+  mvProductFilters::setupSurface(this->filter.Get());
+  this->cancel.watch(this->filter.Get());
+}
+
 //------------------------------------------------------------------------------
 vtkDataObject *
 mvGeometry::LoResDataPipeline::input(const vvApplicationState &vvState) const
@@ -29,9 +38,19 @@ mvGeometry::LoResDataPipeline::input(const vvApplicationState &vvState) const
 
 //------------------------------------------------------------------------------
 void mvGeometry::LoResDataPipeline::configure(
-    const ObjectState &, const vvApplicationState &appState)
+    const ObjectState &objState, const vvApplicationState &vvState)
 {
+  const mvApplicationState &appState =
+      static_cast<const mvApplicationState &>(vvState);
+  const GeometryState &state = static_cast<const GeometryState&>(objState);
+
+  this->memory.configure(appState.memoryBudget(),
+                         state.visible &&
+                         state.representation != Representation::NoGeometry);
+  this->cancel.configure(appState.reader());
   this->filter->SetInputDataObject(this->input(appState));
+  this->memory.request(this->memory.estimate(this->input(appState)),
+                       this->filter->GetMTime());
 }
 
 //------------------------------------------------------------------------------
@@ -41,9 +60,16 @@ bool mvGeometry::LoResDataPipeline::needsUpdate(const ObjectState &objState,
   const GeometryState &state = static_cast<const GeometryState&>(objState);
   const GeometryLODData &data = static_cast<const GeometryLODData&>(result);
 
+  if (this->memory.release())
+    {
+    return data.geometry != nullptr;
+    }
+
   return
       state.visible &&
       state.representation != Representation::NoGeometry &&
+      this->memory.allowed() &&
+      !this->cancel.superseded() &&
       this->filter->GetInputDataObject(0, 0) &&
       (!data.geometry ||
        data.geometry->GetMTime() < this->filter->GetMTime());
@@ -52,7 +78,11 @@ bool mvGeometry::LoResDataPipeline::needsUpdate(const ObjectState &objState,
 //------------------------------------------------------------------------------
 void mvGeometry::LoResDataPipeline::execute()
 {
-  this->filter->Update();
+  if (!this->memory.release() && this->cancel.start())
+    {
+    this->filter->Update();
+    }
+  this->cancel.finish();
 }
 
 //------------------------------------------------------------------------------
@@ -60,9 +90,29 @@ void mvGeometry::LoResDataPipeline::exportResult(LODData &result) const
 {
   GeometryLODData &data = static_cast<GeometryLODData&>(result);
 
-  vtkDataObject *dObj = this->filter->GetOutputDataObject(0);
-  data.geometry.TakeReference(dObj->NewInstance());
-  data.geometry->ShallowCopy(dObj);
+  if (!this->memory.release() && this->cancel.cancelled())
+    {
+    // Keep the previous surface until the current timestep is extracted:
+    return;
+    }
+
+  if (this->memory.release())
+    {
+    data.geometry = nullptr;
+    }
+  else
+    {
+    vtkDataObject *dObj = this->filter->GetOutputDataObject(0);
+    data.geometry.TakeReference(dObj->NewInstance());
+    data.geometry->ShallowCopy(dObj);
+    }
+  this->memory.exportResult(data.geometry);
+}
+
+//------------------------------------------------------------------------------
+mvGeometry::HiResDataPipeline::HiResDataPipeline()
+{
+  this->memory = mvMemoryBudget::Result("Geometry (HiRes)");
 }
 
 //------------------------------------------------------------------------------
@@ -75,6 +125,50 @@ mvGeometry::HiResDataPipeline::input(const vvApplicationState &vvState) const
   return state.reader().dataObject();
 }
 
+//------------------------------------------------------------------------------
+void mvGeometry::HiResDataPipeline::configure(
+    const ObjectState &objState, const vvApplicationState &vvState)
+{
+  const mvApplicationState &appState =
+      static_cast<const mvApplicationState &>(vvState);
+
+  this->LoResDataPipeline::configure(objState, vvState);
+  this->products = appState.reader().products();
+  this->step = appState.reader().dataTimeStep();
+  this->variables = appState.reader().loadedVariables();
+}
+
+//------------------------------------------------------------------------------
+void mvGeometry::HiResDataPipeline::execute()
+{
+  this->product = nullptr;
+  if (this->products && !this->memory.release() && this->cancel.start())
+    {
+    this->product = this->products->load(mvProductCache::Product::Surface,
+                                         this->step, this->variables);
+    }
+  if (this->product)
+    {
+    this->cancel.finish();
+    return;
+    }
+  this->LoResDataPipeline::execute();
+}
+
+//------------------------------------------------------------------------------
+void mvGeometry::HiResDataPipeline::exportResult(LODData &result) const
+{
+  if (!this->product)
+    {
+    this->LoResDataPipeline::exportResult(result);
+    return;
+    }
+
+  GeometryLODData &data = static_cast<GeometryLODData&>(result);
+  data.geometry = this->product;
+  this->memory.exportResult(data.geometry);
+}
+
 //------------------------------------------------------------------------------
 void mvGeometry::GeometryRenderPipeline::init(const ObjectState &,
                                               vvContextState &contextState)
@@ -3,9 +3,16 @@
 
 #include "vvLODAsyncGLObject.h"
 
+#include "mvCancellation.h"
+#include "mvMemoryBudget.h"
+
 #include <vtkNew.h>
 #include <vtkSmartPointer.h>
 
+#include <set>
+#include <string>
+
+class mvProductCache;
 class vtkActor;
 class vtkCompositeDataGeometryFilter;
 class vtkDataObject;
@@ -42,6 +49,10 @@ public:
   struct LoResDataPipeline : public Superclass::DataPipeline
   {
     vtkNew<vtkCompositeDataGeometryFilter> filter;
+    mvMemoryBudget::Result memory{"Geometry (LoRes)"};
+    mvCancellation cancel;
+
+    LoResDataPipeline();
 
     // Returns the dataset to use. This is the only difference between the
     // LoRes and HiRes pipelines, so this should save some duplication.
@@ -55,10 +66,21 @@ public:
   };
 
   // HiRes LOD: ----------------------------------------------------------------
-  // Run vtkCompositeDataGeometryFilter on the full dataset:
+  // Run vtkCompositeDataGeometryFilter on the full dataset, or load the
+  // surface precomputed by mvpreprocess:
   struct HiResDataPipeline : public LoResDataPipeline
   {
+    const mvProductCache *products{nullptr};
+    int step{-1};
+    std::set<std::string> variables; // Read from the product.
+    vtkSmartPointer<vtkDataObject> product;
+
+    HiResDataPipeline();
     vtkDataObject* input(const vvApplicationState &state) const override;
+
+    void configure(const ObjectState &, const vvApplicationState &) override;
+    void execute() override;
+    void exportResult(LODData &result) const override;
   };
 
   // Shared: LODData and RenderPipeline are shared between LoRes and HiRes. ----
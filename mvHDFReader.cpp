@@ -0,0 +1,758 @@
+#include "mvHDFReader.h"
+
+#include "mvIOLock.h"
+
+#include <vtkAOSDataArrayTemplate.h>
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkMultiBlockDataSet.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <vtk_hdf5.h>
+
+#include <algorithm>
+#include <iostream>
+#include <mutex>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+
+// Mappings made by mapValues, by the address of their first value:
+std::mutex MappingsMutex;
+std::map<void*, std::pair<void*, size_t> > Mappings;
+
+//------------------------------------------------------------------------------
+// Free function for mapped arrays.
+void unmapValues(void *values)
+{
+  std::lock_guard<std::mutex> lock(MappingsMutex);
+  auto it = Mappings.find(values);
+  if (it != Mappings.end())
+    {
+    munmap(it->second.first, it->second.second);
+    Mappings.erase(it);
+    }
+}
+
+//------------------------------------------------------------------------------
+template <typename ValueType>
+bool wrapValues(ValueType*, vtkDataArray *array, void *values,
+                vtkIdType numValues)
+{
+  auto *aos = vtkAOSDataArrayTemplate<ValueType>::FastDownCast(array);
+  if (!aos)
+    {
+    return false;
+    }
+
+  aos->SetArrayFreeFunction(&unmapValues);
+  aos->SetArray(static_cast<ValueType*>(values), numValues, 0,
+                vtkAbstractArray::VTK_DATA_ARRAY_USER_DEFINED);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Map numValues values of array's type at offset in fd into array. Returns
+// false if the values can't be mapped, e.g. because they are misaligned.
+bool mapValues(int fd, off_t offset, vtkIdType numValues, vtkDataArray *array)
+{
+  const size_t valueSize = static_cast<size_t>(array->GetDataTypeSize());
+  const off_t pageSize = static_cast<off_t>(sysconf(_SC_PAGESIZE));
+  const off_t base = offset - offset % pageSize;
+  if ((offset - base) % valueSize != 0)
+    {
+    return false;
+    }
+
+  // Private, writable mapping: the pages stay shared with the page cache
+  // unless a filter modifies the array in place.
+  const size_t length = static_cast<size_t>(offset - base) +
+      static_cast<size_t>(numValues) * valueSize;
+  void *mapping = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                       fd, base);
+  if (mapping == MAP_FAILED)
+    {
+    return false;
+    }
+
+  void *values = static_cast<char*>(mapping) + (offset - base);
+    {
+    std::lock_guard<std::mutex> lock(MappingsMutex);
+    Mappings[values] = std::make_pair(mapping, length);
+    }
+
+  bool wrapped = false;
+  switch (array->GetDataType())
+    {
+    vtkTemplateMacro(wrapped = wrapValues(static_cast<VTK_TT*>(nullptr),
+                                          array, values, numValues));
+    }
+  if (!wrapped)
+    {
+    unmapValues(values);
+    }
+  return wrapped;
+}
+
+//------------------------------------------------------------------------------
+// The VTK type matching the native HDF5 type, or 0 if there is none.
+int vtkDataType(hid_t type)
+{
+  const size_t size = H5Tget_size(type);
+  switch (H5Tget_class(type))
+    {
+    case H5T_FLOAT:
+      return size == 4 ? VTK_FLOAT : size == 8 ? VTK_DOUBLE : 0;
+    case H5T_INTEGER:
+      {
+      const bool isSigned = H5Tget_sign(type) == H5T_SGN_2;
+      switch (size)
+        {
+        case 1:
+          return isSigned ? VTK_SIGNED_CHAR : VTK_UNSIGNED_CHAR;
+        case 2:
+          return isSigned ? VTK_SHORT : VTK_UNSIGNED_SHORT;
+        case 4:
+          return isSigned ? VTK_INT : VTK_UNSIGNED_INT;
+        case 8:
+          return isSigned ? VTK_LONG_LONG : VTK_UNSIGNED_LONG_LONG;
+        default:
+          return 0;
+        }
+      }
+    default:
+      return 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+// True if every link of the absolute path exists. Checking each level keeps
+// HDF5 from printing errors for missing optional objects.
+bool linkExists(hid_t file, const std::string &path)
+{
+  size_t end = 0;
+  while (end != std::string::npos)
+    {
+    end = path.find('/', end + 1);
+    if (H5Lexists(file, path.substr(0, end).c_str(), H5P_DEFAULT) <= 0)
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Read the string attribute name of obj.
+bool readStringAttribute(hid_t obj, const char *name, std::string &value)
+{
+  if (H5Aexists(obj, name) <= 0)
+    {
+    return false;
+    }
+
+  const hid_t attr = H5Aopen(obj, name, H5P_DEFAULT);
+  const hid_t type = H5Aget_type(attr);
+  bool ok = H5Tget_class(type) == H5T_STRING;
+  if (ok && H5Tis_variable_str(type) > 0)
+    {
+    char *str = nullptr;
+    ok = H5Aread(attr, type, &str) >= 0 && str;
+    if (ok)
+      {
+      value = str;
+      H5free_memory(str);
+      }
+    }
+  else if (ok)
+    {
+    std::vector<char> str(H5Tget_size(type) + 1, '\0');
+    ok = H5Aread(attr, type, str.data()) >= 0;
+    value = str.data();
+    }
+  H5Tclose(type);
+  H5Aclose(attr);
+  return ok;
+}
+
+//------------------------------------------------------------------------------
+// Read all values of the dataset at path as memType.
+template <typename T>
+bool readDataset(hid_t file, const std::string &path, hid_t memType,
+                 std::vector<T> &values)
+{
+  values.clear();
+  if (!linkExists(file, path))
+    {
+    return false;
+    }
+
+  const hid_t dset = H5Dopen(file, path.c_str(), H5P_DEFAULT);
+  if (dset < 0)
+    {
+    return false;
+    }
+  const hid_t space = H5Dget_space(dset);
+  const hssize_t numValues = H5Sget_simple_extent_npoints(space);
+  bool ok = numValues >= 0;
+  if (ok && numValues > 0)
+    {
+    values.resize(static_cast<size_t>(numValues));
+    ok = H5Dread(dset, memType, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+                 values.data()) >= 0;
+    }
+  H5Sclose(space);
+  H5Dclose(dset);
+  return ok;
+}
+
+const char RootGroup[] = "/VTKHDF";
+
+} // end anon namespace
+
+//------------------------------------------------------------------------------
+mvHDFReader::mvHDFReader(const std::string &fileName)
+  : mvFormatReader(fileName),
+    m_file(-1),
+    m_fd(-1),
+    m_numberOfTimeSteps(0),
+    m_transient(false)
+{
+}
+
+//------------------------------------------------------------------------------
+mvHDFReader::~mvHDFReader()
+{
+  this->close();
+}
+
+//------------------------------------------------------------------------------
+bool mvHDFReader::readInformation(Information &info)
+{
+  mvIOLock lock;
+  // Reopen, to pick up appended steps:
+  this->close();
+  if (!this->open(0))
+    {
+    return false;
+    }
+
+  info.numberOfTimeSteps = m_numberOfTimeSteps;
+  info.times = m_times;
+  info.pointVariables.clear();
+  info.pointVariables.insert(m_pointArrays.begin(), m_pointArrays.end());
+  info.cellVariables.clear();
+  info.cellVariables.insert(m_cellArrays.begin(), m_cellArrays.end());
+
+  int64_t numParts = static_cast<int64_t>(m_numberOfPoints.size());
+  if (m_transient && !m_numberOfParts.empty())
+    {
+    numParts = *std::max_element(m_numberOfParts.begin(),
+                                 m_numberOfParts.end());
+    }
+  info.blocks.clear();
+  for (int64_t i = 0; i < numParts; ++i)
+    {
+    info.blocks.push_back("Partition " + std::to_string(i));
+    }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkMultiBlockDataSet>
+mvHDFReader::read(const mvReadSettings &settings, int step)
+{
+  mvIOLock lock;
+  if (!this->open(settings.numberOfTimeSteps))
+    {
+    return nullptr;
+    }
+  if (step < 0 || step >= m_numberOfTimeSteps)
+    {
+    std::cerr << "mvHDFReader: Timestep " << step << " is not in '"
+              << this->fileName() << "'." << std::endl;
+    return nullptr;
+    }
+
+  std::vector<Partition> parts;
+  if (!this->partitions(step, parts))
+    {
+    std::cerr << "mvHDFReader: The partitions of timestep " << step
+              << " are inconsistent in '" << this->fileName() << "'."
+              << std::endl;
+    return nullptr;
+    }
+
+  std::vector<vtkSmartPointer<vtkUnstructuredGrid> > blocks(parts.size());
+  std::vector<std::string> names(parts.size());
+  for (size_t i = 0; i < parts.size(); ++i)
+    {
+    names[i] = "Partition " + std::to_string(i);
+    if (settings.excludedBlocks.count(names[i]))
+      {
+      continue;
+      }
+
+    const Partition &part = parts[i];
+    Mesh &mesh = m_meshes[static_cast<int64_t>(i)];
+    if (!this->loadMesh(part, mesh) || this->aborted())
+      {
+      return nullptr;
+      }
+
+    vtkNew<vtkUnstructuredGrid> grid;
+    grid->SetPoints(mesh.points);
+    grid->SetCells(mesh.types, mesh.locations, mesh.cells);
+
+    // The data of a step starts at its own offset, or the geometry's:
+    const int64_t stepPoints = part.pointStart - part.pointsBefore;
+    const int64_t stepCells = part.cellStart - part.cellsBefore;
+    for (const std::string &name : m_pointArrays)
+      {
+      if (!settings.variables.count(name))
+        {
+        continue;
+        }
+      const int64_t start = part.pointsBefore +
+          this->dataOffset("PointData", name, step, stepPoints);
+      vtkSmartPointer<vtkDataArray> array = this->readArray(
+            std::string(RootGroup) + "/PointData/" + name, start,
+            part.numPoints);
+      if (!array || this->aborted())
+        {
+        return nullptr;
+        }
+      grid->GetPointData()->AddArray(array);
+      }
+    for (const std::string &name : m_cellArrays)
+      {
+      if (!settings.variables.count(name))
+        {
+        continue;
+        }
+      const int64_t start = part.cellsBefore +
+          this->dataOffset("CellData", name, step, stepCells);
+      vtkSmartPointer<vtkDataArray> array = this->readArray(
+            std::string(RootGroup) + "/CellData/" + name, start,
+            part.numCells);
+      if (!array || this->aborted())
+        {
+        return nullptr;
+        }
+      grid->GetCellData()->AddArray(array);
+      }
+
+    blocks[i] = grid.Get();
+    }
+
+  return makeOutput(blocks, names);
+}
+
+//------------------------------------------------------------------------------
+bool mvHDFReader::open(int numberOfTimeSteps)
+{
+  if (m_file >= 0 && numberOfTimeSteps <= m_numberOfTimeSteps)
+    {
+    return true;
+    }
+  this->close();
+
+  const std::string &fileName = this->fileName();
+  const hid_t file = H5Fopen(fileName.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  if (file < 0)
+    {
+    std::cerr << "mvHDFReader: Cannot open '" << fileName << "'."
+              << std::endl;
+    return false;
+    }
+  m_file = file;
+
+  std::string type;
+  if (!linkExists(file, RootGroup))
+    {
+    std::cerr << "mvHDFReader: '" << fileName << "' is not a VTKHDF file."
+              << std::endl;
+    this->close();
+    return false;
+    }
+  const hid_t root = H5Gopen(file, RootGroup, H5P_DEFAULT);
+  const bool typed = readStringAttribute(root, "Type", type);
+  H5Gclose(root);
+  if (!typed || type != "UnstructuredGrid")
+    {
+    std::cerr << "mvHDFReader: '" << fileName << "' does not hold an "
+                 "unstructured grid (type '" << type << "')." << std::endl;
+    this->close();
+    return false;
+    }
+
+  const std::string prefix(RootGroup);
+  if (!readDataset(file, prefix + "/NumberOfPoints", H5T_NATIVE_INT64,
+                   m_numberOfPoints) ||
+      !readDataset(file, prefix + "/NumberOfCells", H5T_NATIVE_INT64,
+                   m_numberOfCells) ||
+      !readDataset(file, prefix + "/NumberOfConnectivityIds",
+                   H5T_NATIVE_INT64, m_numberOfConnectivityIds) ||
+      m_numberOfCells.size() != m_numberOfPoints.size() ||
+      m_numberOfConnectivityIds.size() != m_numberOfPoints.size())
+    {
+    std::cerr << "mvHDFReader: The partition sizes are missing from '"
+              << fileName << "'." << std::endl;
+    this->close();
+    return false;
+    }
+
+  m_pointArrays = this->datasetNames(prefix + "/PointData");
+  m_cellArrays = this->datasetNames(prefix + "/CellData");
+
+  const std::string steps = prefix + "/Steps";
+  m_transient = linkExists(file, steps);
+  if (m_transient)
+    {
+    readDataset(file, steps + "/Values", H5T_NATIVE_DOUBLE, m_times);
+    m_numberOfTimeSteps = static_cast<int>(m_times.size());
+    const size_t numSteps = m_times.size();
+    auto perStep = [&](const char *name, std::vector<int64_t> &values,
+                       int64_t fallback)
+    {
+      readDataset(file, steps + "/" + name, H5T_NATIVE_INT64, values);
+      // Offsets of unstructured grids have one column per cell type group,
+      // of which there is one:
+      values.resize(numSteps, fallback);
+    };
+    perStep("PartOffsets", m_partOffsets, 0);
+    perStep("NumberOfParts", m_numberOfParts,
+            static_cast<int64_t>(m_numberOfPoints.size()));
+    perStep("PointOffsets", m_pointOffsets, 0);
+    perStep("CellOffsets", m_cellOffsets, 0);
+    perStep("ConnectivityIdOffsets", m_connectivityOffsets, 0);
+    for (const char *group : {"PointData", "CellData"})
+      {
+      const std::string offsets = steps + "/" + group + "Offsets";
+      for (const std::string &name : this->datasetNames(offsets))
+        {
+        std::vector<int64_t> &values =
+            m_dataOffsets[std::string(group) + "/" + name];
+        readDataset(file, offsets + "/" + name, H5T_NATIVE_INT64, values);
+        values.resize(numSteps, 0);
+        }
+      }
+    }
+  else
+    {
+    m_numberOfTimeSteps = 1;
+    m_times.assign(1, 0.);
+    }
+
+  // Mapping needs a descriptor of its own:
+  m_fd = ::open(fileName.c_str(), O_RDONLY);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void mvHDFReader::close()
+{
+  if (m_file >= 0)
+    {
+    H5Fclose(static_cast<hid_t>(m_file));
+    m_file = -1;
+    }
+  if (m_fd >= 0)
+    {
+    // Existing mappings stay valid.
+    ::close(m_fd);
+    m_fd = -1;
+    }
+  m_numberOfTimeSteps = 0;
+  m_transient = false;
+  m_times.clear();
+  m_numberOfPoints.clear();
+  m_numberOfCells.clear();
+  m_numberOfConnectivityIds.clear();
+  m_partOffsets.clear();
+  m_numberOfParts.clear();
+  m_pointOffsets.clear();
+  m_cellOffsets.clear();
+  m_connectivityOffsets.clear();
+  m_dataOffsets.clear();
+  m_pointArrays.clear();
+  m_cellArrays.clear();
+  m_meshes.clear();
+}
+
+//------------------------------------------------------------------------------
+bool mvHDFReader::partitions(int step, std::vector<Partition> &parts) const
+{
+  parts.clear();
+  const int64_t first = m_transient ? m_partOffsets[step] : 0;
+  const int64_t count = m_transient ? m_numberOfParts[step]
+                                    : static_cast<int64_t>(
+                                        m_numberOfPoints.size());
+  int64_t point = m_transient ? m_pointOffsets[step] : 0;
+  int64_t cell = m_transient ? m_cellOffsets[step] : 0;
+  int64_t connectivity = m_transient ? m_connectivityOffsets[step] : 0;
+  if (first < 0 || count < 0 ||
+      first + count > static_cast<int64_t>(m_numberOfPoints.size()))
+    {
+    return false;
+    }
+
+  int64_t pointsBefore = 0;
+  int64_t cellsBefore = 0;
+  for (int64_t p = first; p < first + count; ++p)
+    {
+    Partition part;
+    part.index = p;
+    part.numPoints = m_numberOfPoints[p];
+    part.numCells = m_numberOfCells[p];
+    part.numConnectivityIds = m_numberOfConnectivityIds[p];
+    part.pointStart = point;
+    part.cellStart = cell;
+    part.connectivityStart = connectivity;
+    // Each preceding partition has one more offset than cells:
+    part.offsetsStart = cell + p;
+    part.pointsBefore = pointsBefore;
+    part.cellsBefore = cellsBefore;
+    parts.push_back(part);
+
+    point += part.numPoints;
+    cell += part.numCells;
+    connectivity += part.numConnectivityIds;
+    pointsBefore += part.numPoints;
+    cellsBefore += part.numCells;
+    }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool mvHDFReader::loadMesh(const Partition &part, Mesh &mesh)
+{
+  if (mesh.cells && mesh.pointStart == part.pointStart &&
+      mesh.cellStart == part.cellStart &&
+      mesh.connectivityStart == part.connectivityStart)
+    {
+    return true;
+    }
+  mesh = Mesh();
+
+  const std::string prefix(RootGroup);
+  vtkSmartPointer<vtkDataArray> coordinates =
+      this->readArray(prefix + "/Points", part.pointStart, part.numPoints);
+  vtkSmartPointer<vtkUnsignedCharArray> types =
+      vtkUnsignedCharArray::SafeDownCast(
+        this->readArray(prefix + "/Types", part.cellStart, part.numCells));
+  std::vector<int64_t> offsets;
+  std::vector<int64_t> connectivity;
+  if (!coordinates || coordinates->GetNumberOfComponents() != 3 || !types ||
+      !this->readRange(prefix + "/Offsets", part.offsetsStart,
+                       part.numCells + 1, offsets) ||
+      !this->readRange(prefix + "/Connectivity", part.connectivityStart,
+                       part.numConnectivityIds, connectivity))
+    {
+    std::cerr << "mvHDFReader: Cannot read the mesh of partition "
+              << part.index << " of '" << this->fileName() << "'."
+              << std::endl;
+    return false;
+    }
+
+  // The connectivity of each partition is numbered from its first point.
+  if (!makeCells(offsets, connectivity, part.numPoints, mesh.locations,
+                 mesh.cells))
+    {
+    std::cerr << "mvHDFReader: Invalid cells in partition "
+              << part.index << " of '" << this->fileName() << "'."
+              << std::endl;
+    mesh = Mesh();
+    return false;
+    }
+
+  mesh.pointStart = part.pointStart;
+  mesh.cellStart = part.cellStart;
+  mesh.connectivityStart = part.connectivityStart;
+  mesh.points = vtkSmartPointer<vtkPoints>::New();
+  mesh.points->SetData(coordinates);
+  mesh.types = types;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+int64_t mvHDFReader::dataOffset(const std::string &group,
+                                const std::string &array, int step,
+                                int64_t geometryOffset) const
+{
+  if (!m_transient)
+    {
+    return 0;
+    }
+  auto it = m_dataOffsets.find(group + "/" + array);
+  return it != m_dataOffsets.end() ? it->second[step] : geometryOffset;
+}
+
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkDataArray>
+mvHDFReader::readArray(const std::string &path, int64_t start, int64_t count)
+{
+  if (!linkExists(m_file, path))
+    {
+    return nullptr;
+    }
+
+  const hid_t dset = H5Dopen(m_file, path.c_str(), H5P_DEFAULT);
+  if (dset < 0)
+    {
+    return nullptr;
+    }
+  const hid_t space = H5Dget_space(dset);
+  const hid_t fileType = H5Dget_type(dset);
+  const hid_t memType = H5Tget_native_type(fileType, H5T_DIR_ASCEND);
+  const hid_t plist = H5Dget_create_plist(dset);
+
+  const int rank = H5Sget_simple_extent_ndims(space);
+  hsize_t dims[2] = {0, 1};
+  vtkSmartPointer<vtkDataArray> array;
+  if (rank >= 1 && rank <= 2)
+    {
+    H5Sget_simple_extent_dims(space, dims, nullptr);
+    const int dataType = vtkDataType(memType);
+    if (dataType != 0 && start >= 0 && count >= 0 &&
+        static_cast<hsize_t>(start + count) <= dims[0])
+      {
+      array.TakeReference(vtkDataArray::CreateDataArray(dataType));
+      }
+    }
+
+  bool ok = array != nullptr;
+  if (ok)
+    {
+    array->SetName(path.substr(path.find_last_of('/') + 1).c_str());
+    array->SetNumberOfComponents(static_cast<int>(dims[1]));
+    const vtkIdType numValues = static_cast<vtkIdType>(count * dims[1]);
+
+    // Contiguous, unfiltered datasets in native byte order are plain arrays
+    // in the file:
+    bool mapped = false;
+    if (m_fd >= 0 && numValues > 0 &&
+        H5Pget_layout(plist) == H5D_CONTIGUOUS &&
+        H5Pget_nfilters(plist) == 0 && H5Tequal(fileType, memType) > 0)
+      {
+      const haddr_t address = H5Dget_offset(dset);
+      if (address != HADDR_UNDEF)
+        {
+        const off_t offset = static_cast<off_t>(address) +
+            static_cast<off_t>(start * dims[1]) * array->GetDataTypeSize();
+        mapped = mapValues(m_fd, offset, numValues, array);
+        }
+      }
+
+    if (!mapped)
+      {
+      array->SetNumberOfTuples(static_cast<vtkIdType>(count));
+      if (numValues > 0)
+        {
+        hsize_t fileStart[2] = {static_cast<hsize_t>(start), 0};
+        hsize_t fileCount[2] = {static_cast<hsize_t>(count), dims[1]};
+        const hid_t memSpace = H5Screate_simple(rank, fileCount, nullptr);
+        ok = H5Sselect_hyperslab(space, H5S_SELECT_SET, fileStart, nullptr,
+                                 fileCount, nullptr) >= 0 &&
+            H5Dread(dset, memType, memSpace, space, H5P_DEFAULT,
+                    array->GetVoidPointer(0)) >= 0;
+        H5Sclose(memSpace);
+        }
+      }
+    }
+  else
+    {
+    std::cerr << "mvHDFReader: Cannot read " << count << " tuples from "
+              << start << " of '" << path << "' in '" << this->fileName()
+              << "'." << std::endl;
+    }
+
+  H5Pclose(plist);
+  H5Tclose(memType);
+  H5Tclose(fileType);
+  H5Sclose(space);
+  H5Dclose(dset);
+  return ok ? array : nullptr;
+}
+
+//------------------------------------------------------------------------------
+bool mvHDFReader::readRange(const std::string &path, int64_t start,
+                            int64_t count, std::vector<int64_t> &values)
+{
+  values.clear();
+  if (!linkExists(m_file, path))
+    {
+    return false;
+    }
+
+  const hid_t dset = H5Dopen(m_file, path.c_str(), H5P_DEFAULT);
+  if (dset < 0)
+    {
+    return false;
+    }
+  const hid_t space = H5Dget_space(dset);
+  hsize_t size = 0;
+  bool ok = H5Sget_simple_extent_ndims(space) == 1 &&
+      H5Sget_simple_extent_dims(space, &size, nullptr) >= 0 &&
+      start >= 0 && count >= 0 &&
+      static_cast<hsize_t>(start + count) <= size;
+  if (ok && count > 0)
+    {
+    values.resize(static_cast<size_t>(count));
+    hsize_t fileStart = static_cast<hsize_t>(start);
+    hsize_t fileCount = static_cast<hsize_t>(count);
+    const hid_t memSpace = H5Screate_simple(1, &fileCount, nullptr);
+    ok = H5Sselect_hyperslab(space, H5S_SELECT_SET, &fileStart, nullptr,
+                             &fileCount, nullptr) >= 0 &&
+        H5Dread(dset, H5T_NATIVE_INT64, memSpace, space, H5P_DEFAULT,
+                values.data()) >= 0;
+    H5Sclose(memSpace);
+    }
+  H5Sclose(space);
+  H5Dclose(dset);
+  return ok;
+}
+
+//------------------------------------------------------------------------------
+std::vector<std::string>
+mvHDFReader::datasetNames(const std::string &group) const
+{
+  std::vector<std::string> names;
+  if (!linkExists(m_file, group))
+    {
+    return names;
+    }
+
+  const hid_t g = H5Gopen(m_file, group.c_str(), H5P_DEFAULT);
+  H5G_info_t info;
+  if (g >= 0 && H5Gget_info(g, &info) >= 0)
+    {
+    for (hsize_t i = 0; i < info.nlinks; ++i)
+      {
+      const ssize_t length = H5Lget_name_by_idx(
+            g, ".", H5_INDEX_NAME, H5_ITER_INC, i, nullptr, 0, H5P_DEFAULT);
+      if (length <= 0)
+        {
+        continue;
+        }
+      std::vector<char> name(static_cast<size_t>(length) + 1, '\0');
+      H5Lget_name_by_idx(g, ".", H5_INDEX_NAME, H5_ITER_INC, i, name.data(),
+                         name.size(), H5P_DEFAULT);
+      names.push_back(name.data());
+      }
+    }
+  if (g >= 0)
+    {
+    H5Gclose(g);
+    }
+  return names;
+}
@@ -0,0 +1,132 @@
+#ifndef MVHDFREADER_H
+#define MVHDFREADER_H
+
+#include "mvFormatReader.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+class vtkCellArray;
+class vtkDataArray;
+class vtkIdTypeArray;
+class vtkPoints;
+class vtkUnsignedCharArray;
+
+/**
+ * @brief The mvHDFReader class reads VTKHDF unstructured grids through the
+ * HDF5 C API.
+ *
+ * Each partition of the grid is presented as an element block named
+ * "Partition N". Transient files (with a "Steps" group) provide one timestep
+ * per step; otherwise the file has a single timestep at time 0.
+ *
+ * Only the requested point and cell arrays of the requested step and
+ * partitions are read. Datasets that are stored contiguously, unfiltered and
+ * in native byte order are memory-mapped from the file instead of being read:
+ * the VTK arrays wrap the mapped pages, so a timestep costs no copy and the
+ * pages are shared with the page cache. Other datasets (chunked, compressed)
+ * are read with one hyperslab read each.
+ *
+ * The mesh of a partition is kept while the point, cell and connectivity
+ * offsets of the requested steps don't change, so that a static mesh is read
+ * once.
+ */
+class mvHDFReader : public mvFormatReader
+{
+public:
+  explicit mvHDFReader(const std::string &fileName);
+  ~mvHDFReader();
+
+  const char* formatName() const override { return "VTKHDF"; }
+
+  bool readInformation(Information &info) override;
+  vtkSmartPointer<vtkMultiBlockDataSet> read(const mvReadSettings &settings,
+                                             int step) override;
+
+private:
+  // Where the data of a partition starts in the flattened datasets.
+  struct Partition
+  {
+    int64_t index{0}; // Global partition index.
+    int64_t numPoints{0};
+    int64_t numCells{0};
+    int64_t numConnectivityIds{0};
+    int64_t pointStart{0};
+    int64_t cellStart{0};
+    int64_t connectivityStart{0};
+    int64_t offsetsStart{0}; // Each partition has numCells + 1 offsets.
+    // Points and cells of the preceding partitions of the same step:
+    int64_t pointsBefore{0};
+    int64_t cellsBefore{0};
+  };
+
+  // A partition's mesh, kept between timesteps.
+  struct Mesh
+  {
+    int64_t pointStart{-1};
+    int64_t cellStart{-1};
+    int64_t connectivityStart{-1};
+    vtkSmartPointer<vtkPoints> points;
+    vtkSmartPointer<vtkUnsignedCharArray> types;
+    vtkSmartPointer<vtkIdTypeArray> locations;
+    vtkSmartPointer<vtkCellArray> cells;
+  };
+
+  // Open the file and read its step tables. Returns false on failure.
+  bool open(int numberOfTimeSteps);
+  void close();
+
+  bool partitions(int step, std::vector<Partition> &parts) const;
+  bool loadMesh(const Partition &part, Mesh &mesh);
+
+  // The offset of the data of array in group at step, in tuples.
+  int64_t dataOffset(const std::string &group, const std::string &array,
+                     int step, int64_t geometryOffset) const;
+
+  // Read count tuples of the dataset at path from start. Maps the values
+  // when possible.
+  vtkSmartPointer<vtkDataArray> readArray(const std::string &path,
+                                          int64_t start, int64_t count);
+
+  // Names of the datasets in group, or none if there is no such group.
+  std::vector<std::string> datasetNames(const std::string &group) const;
+
+  // Read count values of a one-dimensional integer dataset from start.
+  bool readRange(const std::string &path, int64_t start, int64_t count,
+                 std::vector<int64_t> &values);
+
+private:
+  // Not implemented -- disable copy:
+  mvHDFReader(const mvHDFReader&);
+  mvHDFReader& operator=(const mvHDFReader&);
+
+private:
+  int64_t m_file; // hid_t, or -1 if not open.
+  int m_fd; // For mapping, or -1.
+  int m_numberOfTimeSteps;
+  bool m_transient;
+  std::vector<double> m_times;
+
+  // Per partition:
+  std::vector<int64_t> m_numberOfPoints;
+  std::vector<int64_t> m_numberOfCells;
+  std::vector<int64_t> m_numberOfConnectivityIds;
+
+  // Per step (transient files only):
+  std::vector<int64_t> m_partOffsets;
+  std::vector<int64_t> m_numberOfParts;
+  std::vector<int64_t> m_pointOffsets;
+  std::vector<int64_t> m_cellOffsets;
+  std::vector<int64_t> m_connectivityOffsets;
+  // Per step, by "PointData/<array>" or "CellData/<array>":
+  std::map<std::string, std::vector<int64_t> > m_dataOffsets;
+
+  std::vector<std::string> m_pointArrays;
+  std::vector<std::string> m_cellArrays;
+
+  std::map<int64_t, Mesh> m_meshes; // By partition index within a step.
+};
+
+#endif // MVHDFREADER_H
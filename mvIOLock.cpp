@@ -0,0 +1,36 @@
+#include "mvIOLock.h"
+
+namespace {
+
+std::recursive_mutex ioMutex;
+thread_local bool ioDelegated = false;
+
+} // end anon namespace
+
+//------------------------------------------------------------------------------
+mvIOLock::mvIOLock()
+  : m_lock(ioMutex, std::defer_lock)
+{
+  if (!ioDelegated)
+    {
+    m_lock.lock();
+    }
+}
+
+//------------------------------------------------------------------------------
+mvIOLock::~mvIOLock()
+{
+}
+
+//------------------------------------------------------------------------------
+mvIOLock::Delegate::Delegate()
+  : m_wasDelegated(ioDelegated)
+{
+  ioDelegated = true;
+}
+
+//------------------------------------------------------------------------------
+mvIOLock::Delegate::~Delegate()
+{
+  ioDelegated = m_wasDelegated;
+}
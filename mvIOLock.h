@@ -0,0 +1,55 @@
+#ifndef MVIOLOCK_H
+#define MVIOLOCK_H
+
+#include <mutex>
+
+/**
+ * @brief The mvIOLock class serializes file access through netCDF, HDF5 and
+ * the Exodus API across threads.
+ *
+ * Those libraries are only safe to call from several threads at once when
+ * built for it. The readers that run on the data update thread and on the
+ * background workers (prefetching, range scans, file watching, time series,
+ * metadata) hold an mvIOLock for the duration of each call into them, so that
+ * at most one thread is in the libraries at a time.
+ *
+ * The lock is process-wide and recursive. A thread may also read on behalf of
+ * a thread that holds the lock (see Delegate), which is how mvParallelReader
+ * overlaps its own reads while every other reader waits.
+ */
+class mvIOLock
+{
+public:
+  mvIOLock();
+  ~mvIOLock();
+
+  /**
+   * Marks the constructing thread as reading for a thread that holds an
+   * mvIOLock, until destroyed: mvIOLocks taken meanwhile on this thread do
+   * nothing. The holder must outlive the Delegate.
+   */
+  class Delegate
+  {
+  public:
+    Delegate();
+    ~Delegate();
+
+  private:
+    // Not implemented -- disable copy:
+    Delegate(const Delegate&);
+    Delegate& operator=(const Delegate&);
+
+  private:
+    bool m_wasDelegated;
+  };
+
+private:
+  // Not implemented -- disable copy:
+  mvIOLock(const mvIOLock&);
+  mvIOLock& operator=(const mvIOLock&);
+
+private:
+  std::unique_lock<std::recursive_mutex> m_lock;
+};
+
+#endif // MVIOLOCK_H
@@ -0,0 +1,278 @@
+#include "mvInformationReader.h"
+
+#include "mvIOLock.h"
+
+#include <vtkExodusIIReader.h>
+#include <vtkInformation.h>
+#include <vtkInformationDoubleVectorKey.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
+
+#include <vtk_exodusII.h>
+
+#include <algorithm>
+#include <iostream>
+
+//------------------------------------------------------------------------------
+mvInformationReader::mvInformationReader()
+  : m_quit(false),
+    m_pending(false),
+    m_busy(false),
+    m_version(0)
+{
+  m_worker = std::thread(&mvInformationReader::workerLoop, this);
+}
+
+//------------------------------------------------------------------------------
+mvInformationReader::~mvInformationReader()
+{
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_quit = true;
+    }
+  m_condition.notify_all();
+  m_worker.join();
+}
+
+//------------------------------------------------------------------------------
+void mvInformationReader::request(const std::string &fileName)
+{
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (fileName == m_fileName)
+      {
+      return;
+      }
+    m_fileName = fileName;
+    m_pending = !fileName.empty();
+    m_information = Information();
+    m_information.fileName = fileName;
+    ++m_version;
+    }
+  m_condition.notify_all();
+}
+
+//------------------------------------------------------------------------------
+bool mvInformationReader::busy() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_pending || m_busy;
+}
+
+//------------------------------------------------------------------------------
+unsigned long mvInformationReader::version() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_version;
+}
+
+//------------------------------------------------------------------------------
+void mvInformationReader::information(Information &info) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  info = m_information;
+}
+
+//------------------------------------------------------------------------------
+void mvInformationReader::fromReader(vtkExodusIIReader *reader,
+                                     Information &info)
+{
+  info.numberOfTimeSteps = reader->GetNumberOfTimeSteps();
+  vtkInformation *outInfo = reader->GetOutputInformation(0);
+  info.timeRange[0] = info.timeRange[1] = 0.;
+  outInfo->Get(vtkStreamingDemandDrivenPipeline::TIME_RANGE(), info.timeRange);
+  info.times.clear();
+  vtkInformationDoubleVectorKey *timeSteps =
+      vtkStreamingDemandDrivenPipeline::TIME_STEPS();
+  if (outInfo->Has(timeSteps))
+    {
+    const double *times = outInfo->Get(timeSteps);
+    info.times.assign(times, times + outInfo->Length(timeSteps));
+    }
+
+  info.variables.clear();
+  const int numPointArrays = reader->GetNumberOfPointResultArrays();
+  for (int i = 0; i < numPointArrays; ++i)
+    {
+    info.variables.insert(reader->GetPointResultArrayName(i));
+    }
+  const int numElementArrays = reader->GetNumberOfElementResultArrays();
+  for (int i = 0; i < numElementArrays; ++i)
+    {
+    info.variables.insert(reader->GetElementResultArrayName(i));
+    }
+
+  auto objectNames = [reader](int type, std::vector<std::string> &names)
+  {
+    names.clear();
+    const int numObjects = reader->GetNumberOfObjects(type);
+    for (int i = 0; i < numObjects; ++i)
+      {
+      names.push_back(reader->GetObjectName(type, i));
+      }
+  };
+  objectNames(vtkExodusIIReader::ELEM_BLOCK, info.blocks);
+  objectNames(vtkExodusIIReader::NODE_SET, info.nodeSets);
+  objectNames(vtkExodusIIReader::SIDE_SET, info.sideSets);
+  info.complete = true;
+}
+
+//------------------------------------------------------------------------------
+void mvInformationReader::fromFormat(const mvFormatReader::Information &format,
+                                     Information &info)
+{
+  info.numberOfTimeSteps = format.numberOfTimeSteps;
+  info.times = format.times;
+  info.timeRange[0] = info.timeRange[1] = 0.;
+  if (!format.times.empty())
+    {
+    const auto range = std::minmax_element(format.times.begin(),
+                                           format.times.end());
+    info.timeRange[0] = *range.first;
+    info.timeRange[1] = *range.second;
+    }
+
+  info.variables = format.pointVariables;
+  info.variables.insert(format.cellVariables.begin(),
+                        format.cellVariables.end());
+
+  // Only element blocks; node and side sets are Exodus concepts:
+  info.blocks = format.blocks;
+  info.nodeSets.clear();
+  info.sideSets.clear();
+  info.complete = true;
+}
+
+//------------------------------------------------------------------------------
+void mvInformationReader::workerLoop()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  for (;;)
+    {
+    m_condition.wait(lock, [this]() { return m_quit || m_pending; });
+    if (m_quit)
+      {
+      return;
+      }
+
+    Information info;
+    info.fileName = m_fileName;
+    m_pending = false;
+    m_busy = true;
+    lock.unlock();
+
+    mvFormatReader *format =
+        mvFormatReader::forFile(m_formatReader, info.fileName);
+    if (format)
+      {
+      mvFormatReader::Information formatInfo;
+      if (!format->readInformation(formatInfo))
+        {
+        std::cerr << "mvInformationReader: Unable to read the metadata of '"
+                  << info.fileName << "'." << std::endl;
+        formatInfo = mvFormatReader::Information();
+        }
+      fromFormat(formatInfo, info);
+      }
+    else
+      {
+      // The timesteps first, then the extent of the mesh, then the rest:
+      if (this->readHeader(info))
+        {
+        this->publish(info);
+        if (this->readBounds(info))
+          {
+          this->publish(info);
+          }
+        }
+      {
+      mvIOLock ioLock;
+      m_reader->SetFileName(info.fileName.c_str());
+      m_reader->UpdateInformation();
+      }
+      fromReader(m_reader.Get(), info);
+      }
+    this->publish(info);
+
+    lock.lock();
+    m_busy = false;
+    }
+}
+
+//------------------------------------------------------------------------------
+bool mvInformationReader::readHeader(Information &info)
+{
+  int compWordSize = sizeof(double);
+  int ioWordSize = 0;
+  float version = 0.f;
+  mvIOLock lock;
+  const int exoid = ex_open(info.fileName.c_str(), EX_READ, &compWordSize,
+                            &ioWordSize, &version);
+  if (exoid < 0)
+    {
+    return false;
+    }
+
+  // The other time values are left to the second stage:
+  info.numberOfTimeSteps =
+      static_cast<int>(ex_inquire_int(exoid, EX_INQ_TIME));
+  bool result = true;
+  if (info.numberOfTimeSteps > 0)
+    {
+    result = ex_get_time(exoid, 1, &info.timeRange[0]) >= 0 &&
+        ex_get_time(exoid, info.numberOfTimeSteps, &info.timeRange[1]) >= 0;
+    }
+  ex_close(exoid);
+  return result;
+}
+
+//------------------------------------------------------------------------------
+bool mvInformationReader::readBounds(Information &info)
+{
+  int compWordSize = sizeof(double);
+  int ioWordSize = 0;
+  float version = 0.f;
+  mvIOLock lock;
+  const int exoid = ex_open(info.fileName.c_str(), EX_READ, &compWordSize,
+                            &ioWordSize, &version);
+  if (exoid < 0)
+    {
+    return false;
+    }
+  ex_set_int64_status(exoid, EX_ALL_INT64_API);
+
+  ex_init_params params;
+  bool result = ex_get_init_ext(exoid, &params) >= 0 && params.num_nodes > 0;
+  double bounds[6] = { 0., 0., 0., 0., 0., 0. };
+  std::vector<double> values(result ? params.num_nodes : 0);
+  for (int i = 0; result && i < params.num_dim && i < 3; ++i)
+    {
+    double *coordinates[3] = { nullptr, nullptr, nullptr };
+    coordinates[i] = values.data();
+    result = ex_get_coord(exoid, coordinates[0], coordinates[1],
+                          coordinates[2]) >= 0;
+    if (result)
+      {
+      const auto range = std::minmax_element(values.begin(), values.end());
+      bounds[2 * i] = *range.first;
+      bounds[2 * i + 1] = *range.second;
+      }
+    }
+  ex_close(exoid);
+
+  if (result)
+    {
+    info.bounds.SetBounds(bounds);
+    }
+  return result;
+}
+
+//------------------------------------------------------------------------------
+void mvInformationReader::publish(const Information &info)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (info.fileName == m_fileName)
+    {
+    m_information = info;
+    ++m_version;
+    }
+}
@@ -0,0 +1,126 @@
+#ifndef MVINFORMATIONREADER_H
+#define MVINFORMATIONREADER_H
+
+#include "mvFormatReader.h"
+
+#include <vtkBoundingBox.h>
+#include <vtkNew.h>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+class vtkExodusIIReader;
+
+/**
+ * @brief The mvInformationReader class reads the metadata of a file in the
+ * background, so that opening a large file does not block the caller.
+ *
+ * The metadata of an Exodus II file is read in three stages, and published
+ * after each (see version()):
+ *
+ * 1. The file header, through the Exodus C API: the number of timesteps and
+ *    the first and last time values. This takes a few small reads regardless
+ *    of the size of the file.
+ * 2. The bounds of the mesh, from its coordinates, one component at a time.
+ *    This lets the caller outline the dataset before any timestep is read.
+ * 3. Everything else, with vtkExodusIIReader::UpdateInformation(): the
+ *    variables, element blocks, node and side sets, and every time value.
+ *    Files with thousands of timesteps and variables spend most of their
+ *    metadata time here.
+ *
+ * Files in other formats are read with mvFormatReader::readInformation() in
+ * a single stage.
+ *
+ * Only the latest request is read. A request made while another file is read
+ * is started once that read returns; the results of the superseded file are
+ * dropped.
+ *
+ * The public API is thread-safe.
+ */
+class mvInformationReader
+{
+public:
+  /** The metadata known so far of a file. */
+  struct Information
+  {
+    std::string fileName;
+    bool complete{false}; // False until the last stage is read.
+    int numberOfTimeSteps{0};
+    double timeRange[2]{0., 0.};
+    vtkBoundingBox bounds; // Of the whole mesh. Exodus files only.
+    std::vector<double> times; // One per timestep once complete, or empty.
+    std::set<std::string> variables;
+    std::vector<std::string> blocks; // In file order.
+    std::vector<std::string> nodeSets;
+    std::vector<std::string> sideSets;
+  };
+
+  mvInformationReader();
+  ~mvInformationReader();
+
+  /**
+   * Start reading the metadata of @a fileName, unless it is already read or
+   * being read. Resets the results if the file changes.
+   */
+  void request(const std::string &fileName);
+
+  /** True while a request is being read. */
+  bool busy() const;
+
+  /**
+   * Incremented whenever information() changes, so that callers can cheaply
+   * poll for new results.
+   */
+  unsigned long version() const;
+
+  /** Copy the metadata read so far into @a info. */
+  void information(Information &info) const;
+
+  /** Fill @a info from the metadata of an up to date @a reader. */
+  static void fromReader(vtkExodusIIReader *reader, Information &info);
+
+  /** Fill @a info from the metadata read by an mvFormatReader. */
+  static void fromFormat(const mvFormatReader::Information &format,
+                         Information &info);
+
+private:
+  void workerLoop();
+
+  // Read the number of timesteps and the time range. Only called by the
+  // worker thread.
+  bool readHeader(Information &info);
+
+  // Read the bounds of the mesh. Only called by the worker thread.
+  bool readBounds(Information &info);
+
+  // Publish info if it is still requested.
+  void publish(const Information &info);
+
+private:
+  // Not implemented -- disable copy:
+  mvInformationReader(const mvInformationReader&);
+  mvInformationReader& operator=(const mvInformationReader&);
+
+private:
+  mutable std::mutex m_mutex;
+  std::condition_variable m_condition;
+  std::thread m_worker;
+  bool m_quit;
+
+  std::string m_fileName; // The latest request...
+  bool m_pending;         // ...which the worker has not picked up yet.
+  bool m_busy;
+  unsigned long m_version;
+  Information m_information;
+
+  // Only used by the worker thread:
+  vtkNew<vtkExodusIIReader> m_reader;
+  std::unique_ptr<mvFormatReader> m_formatReader;
+};
+
+#endif // MVINFORMATIONREADER_H
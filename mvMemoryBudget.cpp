@@ -0,0 +1,255 @@
+#include "mvMemoryBudget.h"
+
+#include <vtkDataObject.h>
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+//------------------------------------------------------------------------------
+mvMemoryBudget::mvMemoryBudget()
+  : m_limit(0)
+{
+}
+
+//------------------------------------------------------------------------------
+mvMemoryBudget::~mvMemoryBudget()
+{
+}
+
+//------------------------------------------------------------------------------
+size_t mvMemoryBudget::limit() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_limit;
+}
+
+//------------------------------------------------------------------------------
+void mvMemoryBudget::setLimit(size_t bytes)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_limit = bytes;
+}
+
+//------------------------------------------------------------------------------
+void mvMemoryBudget::setUsage(const std::string &account, size_t bytes,
+                              Priority priority)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Account &acct = m_accounts[account];
+  acct.bytes = bytes;
+  acct.priority = priority;
+}
+
+//------------------------------------------------------------------------------
+void mvMemoryBudget::setUsage(const std::string &account, vtkDataObject *data,
+                              Priority priority)
+{
+  this->setUsage(account, dataSize(data), priority);
+}
+
+//------------------------------------------------------------------------------
+void mvMemoryBudget::setEvictor(const std::string &account,
+                                const Evictor &evictor)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_accounts.find(account);
+  if (it == m_accounts.end())
+    {
+    Account acct = {0, Priority::Prefetched, evictor};
+    m_accounts[account] = acct;
+    }
+  else
+    {
+    it->second.evictor = evictor;
+    }
+}
+
+//------------------------------------------------------------------------------
+size_t mvMemoryBudget::usage() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return this->usageLocked();
+}
+
+//------------------------------------------------------------------------------
+bool mvMemoryBudget::overLimit() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_limit > 0 && this->usageLocked() > m_limit;
+}
+
+//------------------------------------------------------------------------------
+bool mvMemoryBudget::request(size_t bytes, Priority priority)
+{
+  using Candidate = std::pair<Priority, Evictor>;
+  std::vector<Candidate> candidates;
+  size_t needed;
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_limit == 0)
+      {
+      return true;
+      }
+    if (bytes > m_limit)
+      {
+      return false;
+      }
+    const size_t used = this->usageLocked();
+    if (used + bytes <= m_limit)
+      {
+      return true;
+      }
+    needed = used + bytes - m_limit;
+
+    for (const auto &it : m_accounts)
+      {
+      const Account &acct = it.second;
+      if (acct.evictor && acct.bytes > 0 && acct.priority <= priority)
+        {
+        candidates.push_back(Candidate(acct.priority, acct.evictor));
+        }
+      }
+    }
+
+  // Least important first:
+  std::stable_sort(candidates.begin(), candidates.end(),
+                   [](const Candidate &a, const Candidate &b)
+    {
+    return a.first < b.first;
+    });
+  for (const Candidate &candidate : candidates)
+    {
+    const size_t freed = candidate.second(needed);
+    needed = freed < needed ? needed - freed : 0;
+    if (needed == 0)
+      {
+      break;
+      }
+    }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return this->usageLocked() + bytes <= m_limit;
+}
+
+//------------------------------------------------------------------------------
+void mvMemoryBudget::print() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  const double MiB = 1024. * 1024.;
+  std::cerr << "Memory budget: " << this->usageLocked() / MiB << " MiB used";
+  if (m_limit > 0)
+    {
+    std::cerr << " of " << m_limit / MiB << " MiB";
+    }
+  std::cerr << std::endl;
+  for (const auto &it : m_accounts)
+    {
+    std::cerr << "  " << it.first << ": " << it.second.bytes / MiB << " MiB"
+              << std::endl;
+    }
+}
+
+//------------------------------------------------------------------------------
+size_t mvMemoryBudget::dataSize(vtkDataObject *data)
+{
+  // GetActualMemorySize() is in KiB:
+  return data ? static_cast<size_t>(data->GetActualMemorySize()) * 1024 : 0;
+}
+
+//------------------------------------------------------------------------------
+size_t mvMemoryBudget::usageLocked() const
+{
+  size_t total = 0;
+  for (const auto &it : m_accounts)
+    {
+    total += it.second.bytes;
+    }
+  return total;
+}
+
+//------------------------------------------------------------------------------
+mvMemoryBudget::Result::Result(const std::string &account)
+  : m_account(account),
+    m_budget(nullptr),
+    m_state(std::make_shared<State>()),
+    m_release(false),
+    m_checkedMTime(0),
+    m_allowed(true)
+{
+}
+
+//------------------------------------------------------------------------------
+void mvMemoryBudget::Result::configure(mvMemoryBudget &budget, bool visible)
+{
+  State &state = *m_state;
+  if (m_budget != &budget)
+    {
+    // The result of a hidden object is dropped by the next execution, so
+    // count it as freed right away:
+    m_budget = &budget;
+    std::shared_ptr<State> shared = m_state;
+    mvMemoryBudget *owner = &budget;
+    const std::string account = m_account;
+    budget.setEvictor(m_account, [shared, owner, account](size_t)
+      {
+      if (shared->visible || shared->bytes == 0)
+        {
+        return static_cast<size_t>(0);
+        }
+      shared->evicted = true;
+      const size_t freed = shared->bytes.exchange(0);
+      owner->setUsage(account, static_cast<size_t>(0), Priority::Hidden);
+      return freed;
+      });
+    }
+
+  state.visible = visible;
+  if (visible)
+    {
+    state.evicted = false;
+    }
+  m_release = !visible &&
+      (state.evicted || (state.bytes > 0 && budget.overLimit()));
+  budget.setUsage(m_account, static_cast<size_t>(state.bytes),
+                  visible ? Priority::Visible : Priority::Hidden);
+}
+
+//------------------------------------------------------------------------------
+void mvMemoryBudget::Result::exportResult(vtkDataObject *data) const
+{
+  State &state = *m_state;
+  state.bytes = dataSize(data);
+  if (m_budget)
+    {
+    m_budget->setUsage(m_account, static_cast<size_t>(state.bytes),
+                       state.visible ? Priority::Visible : Priority::Hidden);
+    }
+}
+
+//------------------------------------------------------------------------------
+void mvMemoryBudget::Result::request(size_t bytes, vtkMTimeType mtime)
+{
+  if (!m_budget || !m_state->visible || mtime == m_checkedMTime)
+    {
+    return;
+    }
+
+  // Refuse results that don't fit once per request, rather than letting a
+  // large filter push the machine into swap:
+  m_checkedMTime = mtime;
+  m_allowed = m_budget->request(bytes, Priority::Visible);
+  if (!m_allowed)
+    {
+    std::cerr << "Skipping the " << m_account << " result: it needs about "
+              << (bytes >> 20) << " MiB, which exceeds the memory budget."
+              << std::endl;
+    }
+}
+
+//------------------------------------------------------------------------------
+size_t mvMemoryBudget::Result::estimate(vtkDataObject *input) const
+{
+  const size_t current = m_state->bytes;
+  return current > 0 ? current : dataSize(input) / 8;
+}
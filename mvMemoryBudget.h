@@ -0,0 +1,164 @@
+#ifndef MVMEMORYBUDGET_H
+#define MVMEMORYBUDGET_H
+
+#include <vtkType.h>
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+class vtkDataObject;
+
+/**
+ * @brief The mvMemoryBudget class tracks the memory held by MooseViewer's
+ * datasets against a configurable ceiling.
+ *
+ * Each holder of large data (the reader's dataset and array cache, the
+ * prefetched timesteps, the LOD results of the rendering objects, ...)
+ * reports its usage under a named account with a priority. Before creating
+ * new data, a holder calls request() with its estimated size, which frees
+ * memory from accounts with the same or a lower priority that have an
+ * evictor, least important first, until the request fits. Hidden objects
+ * drop their results when evicted (see Result).
+ *
+ * Sizes are estimates based on vtkDataObject::GetActualMemorySize(). Arrays
+ * that are shared between datasets are counted once per holder, so the total
+ * errs on the high side.
+ *
+ * The public API is thread-safe. Evictors are called without the internal
+ * lock held, so they may report their new usage.
+ */
+class mvMemoryBudget
+{
+public:
+  /** Account priorities, in eviction order. */
+  enum class Priority
+    {
+    Prefetched, // Data that may be needed later, e.g. upcoming timesteps.
+    Hidden,     // Results of objects that are not visible.
+    Visible     // Data on screen.
+    };
+
+  /** Frees up to @a bytes from an account, returning the bytes freed. */
+  using Evictor = std::function<size_t(size_t bytes)>;
+
+  class Result;
+
+  mvMemoryBudget();
+  ~mvMemoryBudget();
+
+  /** The ceiling in bytes, or 0 for no limit. Default is 0. @{ */
+  size_t limit() const;
+  void setLimit(size_t bytes);
+  /** @} */
+
+  /** Set the usage of @a account. @{ */
+  void setUsage(const std::string &account, size_t bytes, Priority priority);
+  void setUsage(const std::string &account, vtkDataObject *data,
+                Priority priority);
+  /** @} */
+
+  /** Set the function that frees memory held by @a account. */
+  void setEvictor(const std::string &account, const Evictor &evictor);
+
+  /** Total bytes in use. */
+  size_t usage() const;
+
+  /** True if the usage exceeds the limit. */
+  bool overLimit() const;
+
+  /**
+   * Make room for @a bytes of new data of @a priority. Returns false if the
+   * data would not fit under the limit even after evicting every account of
+   * the same or lower priority.
+   */
+  bool request(size_t bytes, Priority priority);
+
+  /** Print the accounts to stderr. */
+  void print() const;
+
+  /** The memory held by @a data, in bytes. */
+  static size_t dataSize(vtkDataObject *data);
+
+private:
+  struct Account
+  {
+    size_t bytes;
+    Priority priority;
+    Evictor evictor;
+  };
+
+  size_t usageLocked() const;
+
+private:
+  // Not implemented -- disable copy:
+  mvMemoryBudget(const mvMemoryBudget&);
+  mvMemoryBudget& operator=(const mvMemoryBudget&);
+
+private:
+  mutable std::mutex m_mutex;
+  size_t m_limit;
+  std::map<std::string, Account> m_accounts;
+};
+
+/**
+ * @brief The mvMemoryBudget::Result class accounts for the result of a
+ * vvLODAsyncGLObject data pipeline.
+ *
+ * The pipeline calls configure() from DataPipeline::configure() and
+ * exportResult() with its new result. While the object is hidden, the
+ * account has an evictor that counts the result as freed. Once evicted, or
+ * while hidden and the budget is over its limit, release() is true: the
+ * pipeline should then report that it needs an update, skip execution, and
+ * export an empty result, which frees the memory until the object is shown
+ * again.
+ *
+ * Before producing a new result, the pipeline calls request() with its
+ * estimated size and skips execution unless allowed() is true.
+ */
+class mvMemoryBudget::Result
+{
+public:
+  explicit Result(const std::string &account);
+
+  void configure(mvMemoryBudget &budget, bool visible);
+  bool release() const { return m_release; }
+  void exportResult(vtkDataObject *data) const;
+
+  /**
+   * Request room for a result of about @a bytes, once per @a mtime (the
+   * modification time of the filter producing it). Call from configure(),
+   * after configure(budget, visible). @{
+   */
+  void request(size_t bytes, vtkMTimeType mtime);
+  bool allowed() const { return m_allowed; }
+  /** @} */
+
+  /**
+   * An estimate of the size of the next result computed from @a input: the
+   * size of the current result, or for the first one, an eighth of the
+   * input, which bounds a surface, slice or contour of a volume mesh.
+   */
+  size_t estimate(vtkDataObject *input) const;
+
+private:
+  // Shared with the evictor, which is called from any thread:
+  struct State
+  {
+    std::atomic<size_t> bytes{0};
+    std::atomic<bool> visible{false};
+    std::atomic<bool> evicted{false};
+  };
+
+  std::string m_account;
+  mvMemoryBudget *m_budget;
+  std::shared_ptr<State> m_state;
+  bool m_release;
+  vtkMTimeType m_checkedMTime;
+  bool m_allowed;
+};
+
+#endif // MVMEMORYBUDGET_H
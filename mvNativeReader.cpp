@@ -0,0 +1,1074 @@
+#include "mvNativeReader.h"
+#include "mvIOLock.h"
+
+#include "mvSharedTopology.h"
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkCellType.h>
+#include <vtkDoubleArray.h>
+#include <vtkExodusIIReader.h>
+#include <vtkIdList.h>
+#include <vtkIdTypeArray.h>
+#include <vtkIntArray.h>
+#include <vtkMath.h>
+#include <vtkMultiBlockDataSet.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkSOADataArrayTemplate.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <vtk_exodusII.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <numeric>
+
+#include <strings.h>
+
+namespace {
+
+//------------------------------------------------------------------------------
+// The VTK cell type of an Exodus element, or 0 if its nodes are not ordered
+// as VTK expects.
+int cellType(const std::string &elemType, int64_t nodesPerCell)
+{
+  std::string type = elemType;
+  std::transform(type.begin(), type.end(), type.begin(),
+                 [](unsigned char c) { return std::toupper(c); });
+  auto is = [&type](const char *prefix)
+  {
+    return type.compare(0, std::strlen(prefix), prefix) == 0;
+  };
+
+  if (is("CIR") || is("SPH"))
+    {
+    return nodesPerCell == 1 ? VTK_VERTEX : 0;
+    }
+  if (is("BAR") || is("TRU") || is("BEA") || is("EDG"))
+    {
+    return nodesPerCell == 2 ? VTK_LINE :
+           nodesPerCell == 3 ? VTK_QUADRATIC_EDGE : 0;
+    }
+  if (is("TRI"))
+    {
+    return nodesPerCell == 3 ? VTK_TRIANGLE :
+           nodesPerCell == 6 ? VTK_QUADRATIC_TRIANGLE : 0;
+    }
+  if (is("QUA") || is("SHE"))
+    {
+    return nodesPerCell == 4 ? VTK_QUAD :
+           nodesPerCell == 8 ? VTK_QUADRATIC_QUAD : 0;
+    }
+  if (is("TET"))
+    {
+    return nodesPerCell == 4 ? VTK_TETRA :
+           nodesPerCell == 10 ? VTK_QUADRATIC_TETRA : 0;
+    }
+  if (is("PYR"))
+    {
+    return nodesPerCell == 5 ? VTK_PYRAMID : 0;
+    }
+  if (is("WED"))
+    {
+    return nodesPerCell == 6 ? VTK_WEDGE : 0;
+    }
+  if (is("HEX"))
+    {
+    return nodesPerCell == 8 ? VTK_HEXAHEDRON : 0;
+    }
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+// If name ends with suffix (ignoring case), set prefix to the rest of it.
+bool splitSuffix(const std::string &name, const char *suffix,
+                 std::string &prefix)
+{
+  const size_t length = std::strlen(suffix);
+  if (name.size() <= length)
+    {
+    return false;
+    }
+  for (size_t i = 0; i < length; ++i)
+    {
+    if (std::tolower(static_cast<unsigned char>(name[name.size() - length + i]))
+        != suffix[i])
+      {
+      return false;
+      }
+    }
+  prefix = name.substr(0, name.size() - length);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// A double array with a separate buffer per component, so that components
+// read from the file need not be interleaved. Single component arrays use
+// vtkDoubleArray, whose layout is the same.
+vtkSmartPointer<vtkDataArray> newArray(int numComponents, vtkIdType numTuples)
+{
+  vtkSmartPointer<vtkDataArray> array;
+  if (numComponents == 1)
+    {
+    array = vtkSmartPointer<vtkDoubleArray>::New();
+    }
+  else
+    {
+    array = vtkSmartPointer<vtkSOADataArrayTemplate<double> >::New();
+    }
+  array->SetNumberOfComponents(numComponents);
+  array->SetNumberOfTuples(numTuples);
+  return array;
+}
+
+//------------------------------------------------------------------------------
+// The buffer of component c of an array created by newArray().
+double *componentPointer(vtkDataArray *array, int c)
+{
+  if (array->GetNumberOfComponents() == 1)
+    {
+    return static_cast<vtkDoubleArray*>(array)->GetPointer(0);
+    }
+  return static_cast<vtkSOADataArrayTemplate<double>*>(array)
+      ->GetComponentArrayPointer(c);
+}
+
+//------------------------------------------------------------------------------
+// New points at points plus scale times displacements, an array created by
+// newArray() with a component per dimension of the mesh.
+vtkSmartPointer<vtkPoints> displace(vtkPoints *points,
+                                    vtkDataArray *displacements, double scale)
+{
+  const vtkIdType numPoints = points->GetNumberOfPoints();
+  const int numComponents =
+      std::min(3, displacements->GetNumberOfComponents());
+  vtkDataArray *in = points->GetData();
+  vtkSmartPointer<vtkDataArray> coordinates = newArray(3, numPoints);
+  for (int c = 0; c < 3; ++c)
+    {
+    double *out = componentPointer(coordinates, c);
+    const double *d =
+        c < numComponents ? componentPointer(displacements, c) : nullptr;
+    for (vtkIdType i = 0; i < numPoints; ++i)
+      {
+      out[i] = in->GetComponent(i, c) + (d ? scale * d[i] : 0.);
+      }
+    }
+
+  vtkSmartPointer<vtkPoints> result = vtkSmartPointer<vtkPoints>::New();
+  result->SetData(coordinates);
+  return result;
+}
+
+} // end anon namespace
+
+//------------------------------------------------------------------------------
+mvNativeReader::mvNativeReader()
+  : m_topology(nullptr),
+    m_exoid(-1),
+    m_supported(false),
+    m_numberOfTimeSteps(0),
+    m_dimension(0),
+    m_numberOfNodes(0),
+    m_elementBlocksChild(0)
+{
+}
+
+//------------------------------------------------------------------------------
+mvNativeReader::~mvNativeReader()
+{
+  this->close();
+}
+
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkMultiBlockDataSet>
+mvNativeReader::read(const mvReadSettings &settings, int step)
+{
+  mvIOLock lock;
+  if (!settings.pieces.empty() || !settings.nodeSets.empty() ||
+      !settings.sideSets.empty() || !this->open(settings))
+    {
+    return nullptr;
+    }
+  if (step < 0 || step >= m_numberOfTimeSteps)
+    {
+    std::cerr << "mvNativeReader: timestep " << step << " is not in '"
+              << m_fileName << "'." << std::endl;
+    return nullptr;
+    }
+
+  // Find the requested variables:
+  std::vector<std::pair<std::string, const Variable*> > nodal;
+  std::vector<std::pair<std::string, const Variable*> > element;
+  for (const std::string &name : settings.variables)
+    {
+    Variables::const_iterator it = m_nodalVariables.find(name);
+    if (it != m_nodalVariables.end())
+      {
+      nodal.push_back(std::make_pair(name, &it->second));
+      }
+    else if ((it = m_elementVariables.find(name)) != m_elementVariables.end())
+      {
+      element.push_back(std::make_pair(name, &it->second));
+      }
+    else
+      {
+      this->unsupported("variable '" + name + "' is not a nodal or element "
+                        "variable.");
+      return nullptr;
+      }
+    }
+
+  // Load the mesh of the selected blocks:
+  std::vector<Block*> blocks;
+  for (Block &block : m_blocks)
+    {
+    if (settings.excludedBlocks.count(block.name))
+      {
+      continue;
+      }
+    if (block.cellType == 0)
+      {
+      this->unsupported("block '" + block.name + "' has an unsupported "
+                        "element type.");
+      return nullptr;
+      }
+    if (this->aborted() || !this->loadBlock(block))
+      {
+      return nullptr;
+      }
+    blocks.push_back(&block);
+    }
+
+  std::vector<vtkUnstructuredGrid*> grids;
+  vtkSmartPointer<vtkMultiBlockDataSet> result = this->meshes(blocks, grids);
+
+  // Move the points of this timestep, as vtkExodusIIReader does. The mesh
+  // kept for later timesteps is not displaced.
+  if (!m_displacements.empty())
+    {
+    std::vector<vtkSmartPointer<vtkDataArray> > displacements;
+    if (this->aborted() ||
+        !this->readNodal(m_nodalVariables[m_displacements], step, blocks,
+                         displacements))
+      {
+      return nullptr;
+      }
+    const double scale = m_metaData->GetDisplacementMagnitude();
+    for (size_t i = 0; i < grids.size(); ++i)
+      {
+      grids[i]->SetPoints(
+            displace(grids[i]->GetPoints(), displacements[i], scale));
+      }
+    }
+
+  for (const auto &var : nodal)
+    {
+    std::vector<vtkSmartPointer<vtkDataArray> > arrays;
+    if (!this->readNodal(*var.second, step, blocks, arrays))
+      {
+      return nullptr;
+      }
+    for (size_t i = 0; i < grids.size(); ++i)
+      {
+      arrays[i]->SetName(var.first.c_str());
+      grids[i]->GetPointData()->AddArray(arrays[i]);
+      }
+    }
+
+  for (const auto &var : element)
+    {
+    for (size_t i = 0; i < grids.size(); ++i)
+      {
+      const Block &block = *blocks[i];
+      if (!block.variables[var.second->components.front() - 1])
+        {
+        continue;
+        }
+      vtkSmartPointer<vtkDataArray> array;
+      if (this->aborted() ||
+          !this->readElement(*var.second, step, block, array))
+        {
+        return nullptr;
+        }
+      array->SetName(var.first.c_str());
+      grids[i]->GetCellData()->AddArray(array);
+      }
+    }
+
+  return this->aborted() ? nullptr : result;
+}
+
+//------------------------------------------------------------------------------
+bool mvNativeReader::readTimeSeries(const mvReadSettings &settings,
+                                    const std::string &variable,
+                                    const double point[3], TimeSeries &series)
+{
+  mvIOLock lock;
+  if (!settings.pieces.empty())
+    {
+    std::cerr << "mvNativeReader: time series of decomposed datasets are not "
+                 "supported." << std::endl;
+    return false;
+    }
+  if (!this->open(settings))
+    {
+    return false;
+    }
+
+  series = TimeSeries();
+  series.variable = variable;
+  const Variable *var = nullptr;
+  Variables::const_iterator it = m_nodalVariables.find(variable);
+  if (it != m_nodalVariables.end())
+    {
+    var = &it->second;
+    }
+  else if ((it = m_elementVariables.find(variable)) !=
+           m_elementVariables.end())
+    {
+    var = &it->second;
+    series.nodal = false;
+    }
+  else
+    {
+    std::cerr << "mvNativeReader: '" << variable << "' is not a nodal or "
+                 "element variable of '" << m_fileName << "'." << std::endl;
+    return false;
+    }
+  series.numberOfComponents = var->numberOfComponents;
+
+  // Find the nearest node or element centroid of the selected blocks:
+  double best = std::numeric_limits<double>::max();
+  vtkNew<vtkIdList> cellPoints;
+  std::vector<Block*> loaded;
+  for (Block &block : m_blocks)
+    {
+    if (settings.excludedBlocks.count(block.name) ||
+        (!series.nodal && !block.variables[var->components.front() - 1]))
+      {
+      continue;
+      }
+    if (this->aborted() || !this->loadBlock(block))
+      {
+      return false;
+      }
+    if (block.cellType != 0)
+      {
+      loaded.push_back(&block);
+      }
+
+    double p[3];
+    if (series.nodal)
+      {
+      for (size_t i = 0; i < block.nodes.size(); ++i)
+        {
+        block.points->GetPoint(static_cast<vtkIdType>(i), p);
+        const double distance = vtkMath::Distance2BetweenPoints(p, point);
+        if (distance < best)
+          {
+          best = distance;
+          series.id = block.nodes[i] + 1;
+          series.block = block.name;
+          std::copy(p, p + 3, series.position);
+          }
+        }
+      continue;
+      }
+
+    int64_t cell = 0;
+    block.cells->InitTraversal();
+    while (block.cells->GetNextCell(cellPoints.Get()))
+      {
+      double centroid[3] = { 0., 0., 0. };
+      const vtkIdType numPoints = cellPoints->GetNumberOfIds();
+      for (vtkIdType i = 0; i < numPoints; ++i)
+        {
+        block.points->GetPoint(cellPoints->GetId(i), p);
+        for (int c = 0; c < 3; ++c)
+          {
+          centroid[c] += p[c] / numPoints;
+          }
+        }
+      const double distance = vtkMath::Distance2BetweenPoints(centroid, point);
+      if (distance < best)
+        {
+        best = distance;
+        series.id = block.elementOffset + cell + 1;
+        series.block = block.name;
+        std::copy(centroid, centroid + 3, series.position);
+        }
+      ++cell;
+      }
+    }
+  // Keep the shared mesh instead of our own, as read() does:
+  if (m_topology)
+    {
+    std::vector<vtkUnstructuredGrid*> grids;
+    this->meshes(loaded, grids);
+    }
+  if (series.id == 0)
+    {
+    std::cerr << "mvNativeReader: no selected block of '" << m_fileName
+              << "' holds '" << variable << "'." << std::endl;
+    return false;
+    }
+
+  const int numSteps = m_numberOfTimeSteps;
+  series.times.resize(numSteps);
+  if (numSteps > 0 && ex_get_all_times(m_exoid, series.times.data()) < 0)
+    {
+    std::cerr << "mvNativeReader: unable to read the times of '"
+              << m_fileName << "'." << std::endl;
+    return false;
+    }
+
+  // One time-history read per component, interleaved into the tuples:
+  const int numComponents = series.numberOfComponents;
+  series.values.assign(static_cast<size_t>(numSteps) * numComponents, 0.);
+  std::vector<double> history(numSteps);
+  for (size_t c = 0; c < var->components.size() && numSteps > 0; ++c)
+    {
+    if (this->aborted())
+      {
+      return false;
+      }
+    if (ex_get_var_time(m_exoid, series.nodal ? EX_NODAL : EX_ELEM_BLOCK,
+                        var->components[c], series.id, 1, numSteps,
+                        history.data()) < 0)
+      {
+      std::cerr << "mvNativeReader: unable to read the history of '"
+                << variable << "'." << std::endl;
+      return false;
+      }
+    for (int step = 0; step < numSteps; ++step)
+      {
+      series.values[static_cast<size_t>(step) * numComponents + c] =
+          history[step];
+      }
+    }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool mvNativeReader::readGlobalVariables(const mvReadSettings &settings,
+                                         GlobalVariables &globals)
+{
+  mvIOLock lock;
+  globals = GlobalVariables();
+  if (!this->open(settings))
+    {
+    return false;
+    }
+  if (!this->readFileVariableNames(EX_GLOBAL, globals.names))
+    {
+    std::cerr << "mvNativeReader: unable to read the global variable names "
+                 "of '" << m_fileName << "'." << std::endl;
+    return false;
+    }
+
+  const int numSteps = m_numberOfTimeSteps;
+  globals.times.resize(numSteps);
+  if (numSteps > 0 && ex_get_all_times(m_exoid, globals.times.data()) < 0)
+    {
+    std::cerr << "mvNativeReader: unable to read the times of '"
+              << m_fileName << "'." << std::endl;
+    return false;
+    }
+
+  globals.values.resize(globals.names.size());
+  for (size_t i = 0; i < globals.names.size() && numSteps > 0; ++i)
+    {
+    if (this->aborted())
+      {
+      return false;
+      }
+    globals.values[i].resize(numSteps);
+    if (ex_get_var_time(m_exoid, EX_GLOBAL, static_cast<int>(i) + 1, 1, 1,
+                        numSteps, globals.values[i].data()) < 0)
+      {
+      std::cerr << "mvNativeReader: unable to read the global variable '"
+                << globals.names[i] << "'." << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool mvNativeReader::open(const mvReadSettings &settings)
+{
+  if (settings.fileName == m_fileName &&
+      settings.numberOfTimeSteps <= m_numberOfTimeSteps)
+    {
+    return m_supported;
+    }
+
+  // Timesteps appended since the file was opened are only visible after
+  // reopening it. The mesh and variables cannot change, so only the time
+  // information is reread. A file that was not supported is examined again
+  // once it grows, as it may have been rewritten.
+  const bool reopen = settings.fileName == m_fileName && m_supported;
+  this->close();
+  if (settings.fileName != m_fileName)
+    {
+    m_warnings.clear();
+    }
+  if (!reopen)
+    {
+    m_fileName = settings.fileName;
+    m_supported = false;
+    m_numberOfTimeSteps = settings.numberOfTimeSteps;
+    m_blocks.clear();
+    m_nodalVariables.clear();
+    m_elementVariables.clear();
+    m_displacements.clear();
+    for (std::vector<double> &coordinates : m_coordinates)
+      {
+      coordinates.clear();
+      }
+    }
+
+  int compWordSize = sizeof(double);
+  int ioWordSize = 0;
+  float version = 0.f;
+  m_exoid = ex_open(m_fileName.c_str(), EX_READ, &compWordSize, &ioWordSize,
+                    &version);
+  if (m_exoid < 0)
+    {
+    // Possibly transient (e.g. while the file is being replaced). Try again
+    // on the next read:
+    this->unsupported("unable to open the file.");
+    m_supported = false;
+    m_numberOfTimeSteps = -1;
+    return false;
+    }
+  ex_set_int64_status(m_exoid, EX_ALL_INT64_API);
+  ex_set_max_name_length(
+        m_exoid,
+        static_cast<int>(ex_inquire_int(m_exoid,
+                                        EX_INQ_DB_MAX_USED_NAME_LENGTH)));
+
+  if (reopen)
+    {
+    m_numberOfTimeSteps =
+        static_cast<int>(ex_inquire_int(m_exoid, EX_INQ_TIME));
+    return true;
+    }
+  if (!this->readMetaData())
+    {
+    this->close();
+    m_numberOfTimeSteps = settings.numberOfTimeSteps;
+    return false;
+    }
+  m_supported = true;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool mvNativeReader::readMetaData()
+{
+  ex_init_params params;
+  if (ex_get_init_ext(m_exoid, &params) < 0)
+    {
+    this->unsupported("unable to read the file header.");
+    return false;
+    }
+  if (params.num_edge_blk > 0 || params.num_face_blk > 0)
+    {
+    this->unsupported("edge and face blocks are not supported.");
+    return false;
+    }
+  m_dimension = static_cast<int>(params.num_dim);
+  m_numberOfNodes = params.num_nodes;
+  m_numberOfTimeSteps = static_cast<int>(ex_inquire_int(m_exoid, EX_INQ_TIME));
+
+  // Read the metadata, and an output with the same structure as
+  // vtkExodusIIReader's with every object disabled:
+  mvReadSettings structure;
+  structure.fileName = m_fileName;
+  structure.apply(m_metaData.Get());
+  const int numBlocks =
+      m_metaData->GetNumberOfObjects(vtkExodusIIReader::ELEM_BLOCK);
+  if (numBlocks != params.num_elem_blk || numBlocks == 0)
+    {
+    this->unsupported("the element blocks could not be matched.");
+    return false;
+    }
+  for (int i = 0; i < numBlocks; ++i)
+    {
+    structure.excludedBlocks.insert(
+          m_metaData->GetObjectName(vtkExodusIIReader::ELEM_BLOCK, i));
+    }
+  structure.apply(m_metaData.Get());
+  m_metaData->Update();
+  m_structure = vtkSmartPointer<vtkMultiBlockDataSet>::New();
+  m_structure->CopyStructure(m_metaData->GetOutput());
+
+  // The element blocks are the first child with one leaf per block, as the
+  // edge and face block children are empty:
+  bool found = false;
+  for (unsigned int i = 0; i < m_structure->GetNumberOfBlocks() && !found; ++i)
+    {
+    vtkMultiBlockDataSet *child =
+        vtkMultiBlockDataSet::SafeDownCast(m_structure->GetBlock(i));
+    if (child && child->GetNumberOfBlocks() ==
+        static_cast<unsigned int>(numBlocks))
+      {
+      m_elementBlocksChild = i;
+      found = true;
+      }
+    }
+  if (!found)
+    {
+    this->unsupported("the output structure could not be matched.");
+    return false;
+    }
+
+  // The truth table is in file order, the blocks are sorted by id:
+  std::vector<int64_t> fileIds(numBlocks);
+  if (ex_get_ids(m_exoid, EX_ELEM_BLOCK, fileIds.data()) < 0)
+    {
+    this->unsupported("unable to read the element block ids.");
+    return false;
+    }
+  int numElementVariables = 0;
+  ex_get_variable_param(m_exoid, EX_ELEM_BLOCK, &numElementVariables);
+  std::vector<int> truthTable(
+        static_cast<size_t>(numBlocks) * numElementVariables, 1);
+  if (numElementVariables > 0 &&
+      ex_get_truth_table(m_exoid, EX_ELEM_BLOCK, numBlocks,
+                         numElementVariables, truthTable.data()) < 0)
+    {
+    this->unsupported("unable to read the element variable truth table.");
+    return false;
+    }
+
+  m_blocks.resize(numBlocks);
+  std::vector<size_t> fileIndices(numBlocks);
+  std::vector<int64_t> fileCells(numBlocks, 0);
+  for (int i = 0; i < numBlocks; ++i)
+    {
+    Block &block = m_blocks[i];
+    block.id = m_metaData->GetObjectId(vtkExodusIIReader::ELEM_BLOCK, i);
+    block.name = m_metaData->GetObjectName(vtkExodusIIReader::ELEM_BLOCK, i);
+
+    char elemType[MAX_STR_LENGTH + 1] = { 0 };
+    int64_t numEdges = 0;
+    int64_t numFaces = 0;
+    int64_t numAttributes = 0;
+    if (ex_get_block(m_exoid, EX_ELEM_BLOCK, block.id, elemType,
+                     &block.numCells, &block.nodesPerCell, &numEdges,
+                     &numFaces, &numAttributes) < 0)
+      {
+      this->unsupported("unable to read block '" + block.name + "'.");
+      return false;
+      }
+    block.cellType = cellType(elemType, block.nodesPerCell);
+
+    const size_t fileIndex =
+        std::find(fileIds.begin(), fileIds.end(), block.id) - fileIds.begin();
+    if (fileIndex == fileIds.size())
+      {
+      this->unsupported("the element blocks could not be matched.");
+      return false;
+      }
+    block.variables.assign(
+          truthTable.begin() + fileIndex * numElementVariables,
+          truthTable.begin() + (fileIndex + 1) * numElementVariables);
+    fileIndices[i] = fileIndex;
+    fileCells[fileIndex] = block.numCells;
+    }
+
+  // Element numbers run through the blocks in file order:
+  for (int i = 0; i < numBlocks; ++i)
+    {
+    m_blocks[i].elementOffset =
+        std::accumulate(fileCells.begin(), fileCells.begin() + fileIndices[i],
+                        static_cast<int64_t>(0));
+    }
+
+  if (!this->readVariableNames(EX_NODAL, true, m_nodalVariables) ||
+      !this->readVariableNames(EX_ELEM_BLOCK, false, m_elementVariables))
+    {
+    return false;
+    }
+
+  // vtkExodusIIReader displaces the points by the first nodal vector in the
+  // file whose name starts with "dis" and that has a component per dimension:
+  int first = 0;
+  for (const auto &var : m_nodalVariables)
+    {
+    if (m_metaData->GetApplyDisplacements() &&
+        static_cast<int>(var.second.components.size()) == m_dimension &&
+        strncasecmp(var.first.c_str(), "dis", 3) == 0 &&
+        (m_displacements.empty() || var.second.components.front() < first))
+      {
+      m_displacements = var.first;
+      first = var.second.components.front();
+      }
+    }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void mvNativeReader::close()
+{
+  if (m_exoid >= 0)
+    {
+    ex_close(m_exoid);
+    m_exoid = -1;
+    }
+}
+
+//------------------------------------------------------------------------------
+void mvNativeReader::unsupported(const std::string &reason)
+{
+  if (m_warnings.insert(reason).second)
+    {
+    std::cerr << "mvNativeReader: reading '" << m_fileName << "' with "
+                 "vtkExodusIIReader instead, " << reason << std::endl;
+    }
+}
+
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkMultiBlockDataSet>
+mvNativeReader::meshes(const std::vector<Block*> &blocks,
+                       std::vector<vtkUnstructuredGrid*> &grids)
+{
+  vtkSmartPointer<vtkMultiBlockDataSet> result =
+      vtkSmartPointer<vtkMultiBlockDataSet>::New();
+  result->CopyStructure(m_structure);
+  vtkMultiBlockDataSet *elementBlocks = vtkMultiBlockDataSet::SafeDownCast(
+        result->GetBlock(m_elementBlocksChild));
+
+  grids.clear();
+  for (Block *block : blocks)
+    {
+    vtkNew<vtkUnstructuredGrid> grid;
+    grid->SetPoints(block->points);
+    grid->SetCells(block->cellType, block->cells);
+    grid->GetCellData()->AddArray(block->objectIds);
+    elementBlocks->SetBlock(static_cast<unsigned int>(block - m_blocks.data()),
+                            grid.Get());
+    grids.push_back(grid.Get());
+    }
+
+  // Hold the shared mesh instead of our own once it matches:
+  if (m_topology && m_topology->share(result) > 0)
+    {
+    for (size_t i = 0; i < grids.size(); ++i)
+      {
+      blocks[i]->points = grids[i]->GetPoints();
+      blocks[i]->cells = grids[i]->GetCells();
+      }
+    }
+  return result;
+}
+
+//------------------------------------------------------------------------------
+bool mvNativeReader::loadBlock(Block &block)
+{
+  if (block.loaded)
+    {
+    return true;
+    }
+
+  std::vector<int64_t> connectivity(block.numCells * block.nodesPerCell);
+  if (!connectivity.empty() &&
+      ex_get_conn(m_exoid, EX_ELEM_BLOCK, block.id, connectivity.data(),
+                  nullptr, nullptr) < 0)
+    {
+    std::cerr << "mvNativeReader: unable to read the connectivity of block '"
+              << block.name << "'." << std::endl;
+    return false;
+    }
+
+  if (m_coordinates[0].empty() && m_numberOfNodes > 0)
+    {
+    for (int i = 0; i < m_dimension; ++i)
+      {
+      m_coordinates[i].resize(m_numberOfNodes);
+      }
+    if (ex_get_coord(m_exoid, m_coordinates[0].data(),
+                     m_dimension > 1 ? m_coordinates[1].data() : nullptr,
+                     m_dimension > 2 ? m_coordinates[2].data() : nullptr) < 0)
+      {
+      std::cerr << "mvNativeReader: unable to read the coordinates of '"
+                << m_fileName << "'." << std::endl;
+      m_coordinates[0].clear();
+      return false;
+      }
+    }
+
+  // Number the points in order of first use, as vtkExodusIIReader does:
+  std::vector<vtkIdType> pointIds(m_numberOfNodes, -1);
+  block.nodes.clear();
+  vtkNew<vtkIdTypeArray> cells;
+  cells->SetNumberOfValues(block.numCells * (block.nodesPerCell + 1));
+  vtkIdType *cell = cells->GetPointer(0);
+  const int64_t *node = connectivity.data();
+  for (int64_t i = 0; i < block.numCells; ++i)
+    {
+    *cell++ = block.nodesPerCell;
+    for (int64_t j = 0; j < block.nodesPerCell; ++j, ++node)
+      {
+      const int64_t index = *node - 1; // Exodus node numbers are 1-based.
+      if (pointIds[index] < 0)
+        {
+        pointIds[index] = static_cast<vtkIdType>(block.nodes.size());
+        block.nodes.push_back(index);
+        }
+      *cell++ = pointIds[index];
+      }
+    }
+
+  const vtkIdType numPoints = static_cast<vtkIdType>(block.nodes.size());
+  vtkSmartPointer<vtkDataArray> coordinates = newArray(3, numPoints);
+  for (int i = 0; i < 3; ++i)
+    {
+    double *out = componentPointer(coordinates, i);
+    if (i >= m_dimension)
+      {
+      std::fill(out, out + numPoints, 0.);
+      continue;
+      }
+    const double *in = m_coordinates[i].data();
+    for (int64_t index : block.nodes)
+      {
+      *out++ = in[index];
+      }
+    }
+  block.points = vtkSmartPointer<vtkPoints>::New();
+  block.points->SetData(coordinates);
+
+  block.cells = vtkSmartPointer<vtkCellArray>::New();
+  block.cells->SetCells(block.numCells, cells.Get());
+
+  vtkNew<vtkIntArray> objectIds;
+  objectIds->SetName("ObjectId");
+  objectIds->SetNumberOfTuples(block.numCells);
+  objectIds->FillComponent(0, static_cast<double>(block.id));
+  block.objectIds = objectIds.Get();
+
+  block.loaded = true;
+
+  // Release the coordinates once every block has its points:
+  if (std::all_of(m_blocks.begin(), m_blocks.end(),
+                  [](const Block &b) { return b.loaded; }))
+    {
+    for (std::vector<double> &c : m_coordinates)
+      {
+      std::vector<double>().swap(c);
+      }
+    }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool mvNativeReader::readNodal(const Variable &var, int step,
+                               const std::vector<Block*> &blocks,
+                               std::vector<vtkSmartPointer<vtkDataArray> > &arrays)
+{
+  const int numComponents = var.numberOfComponents;
+  for (const Block *block : blocks)
+    {
+    vtkSmartPointer<vtkDataArray> array =
+        newArray(numComponents, static_cast<vtkIdType>(block->nodes.size()));
+    if (static_cast<size_t>(numComponents) > var.components.size())
+      {
+      array->FillComponent(numComponents - 1, 0.);
+      }
+    arrays.push_back(array);
+    }
+
+  // Nodes are shared between blocks, so each component is read once for the
+  // whole mesh and gathered into the blocks:
+  std::vector<double> values(m_numberOfNodes);
+  for (size_t c = 0; c < var.components.size(); ++c)
+    {
+    if (this->aborted())
+      {
+      return false;
+      }
+    if (ex_get_var(m_exoid, step + 1, EX_NODAL, var.components[c], 1,
+                   m_numberOfNodes, values.data()) < 0)
+      {
+      std::cerr << "mvNativeReader: unable to read a nodal variable at "
+                   "timestep " << step << "." << std::endl;
+      return false;
+      }
+    for (size_t i = 0; i < blocks.size(); ++i)
+      {
+      double *out = componentPointer(arrays[i], static_cast<int>(c));
+      for (int64_t index : blocks[i]->nodes)
+        {
+        *out++ = values[index];
+        }
+      }
+    }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool mvNativeReader::readElement(const Variable &var, int step,
+                                 const Block &block,
+                                 vtkSmartPointer<vtkDataArray> &array)
+{
+  const int numComponents = var.numberOfComponents;
+  array = newArray(numComponents, block.numCells);
+  if (static_cast<size_t>(numComponents) > var.components.size())
+    {
+    array->FillComponent(numComponents - 1, 0.);
+    }
+
+  // Each hyperslab goes straight into its component buffer:
+  for (size_t c = 0; c < var.components.size(); ++c)
+    {
+    if (ex_get_var(m_exoid, step + 1, EX_ELEM_BLOCK, var.components[c],
+                   block.id, block.numCells,
+                   componentPointer(array, static_cast<int>(c))) < 0)
+      {
+      std::cerr << "mvNativeReader: unable to read an element variable of "
+                   "block '" << block.name << "' at timestep " << step << "."
+                << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool mvNativeReader::readFileVariableNames(int type,
+                                           std::vector<std::string> &names)
+{
+  names.clear();
+  int numVariables = 0;
+  if (ex_get_variable_param(m_exoid, static_cast<ex_entity_type>(type),
+                            &numVariables) < 0)
+    {
+    return false;
+    }
+  if (numVariables == 0)
+    {
+    return true;
+    }
+
+  const int length = static_cast<int>(
+        ex_inquire_int(m_exoid, EX_INQ_MAX_READ_NAME_LENGTH));
+  std::vector<std::vector<char> > buffers(
+        numVariables, std::vector<char>(length + 1, '\0'));
+  std::vector<char*> pointers;
+  for (std::vector<char> &buffer : buffers)
+    {
+    pointers.push_back(buffer.data());
+    }
+  if (ex_get_variable_names(m_exoid, static_cast<ex_entity_type>(type),
+                            numVariables, pointers.data()) < 0)
+    {
+    return false;
+    }
+  names.assign(pointers.begin(), pointers.end());
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool mvNativeReader::readVariableNames(int type, bool nodal, Variables &vars)
+{
+  std::vector<std::string> names;
+  if (!this->readFileVariableNames(type, names))
+    {
+    this->unsupported("unable to read the variable names.");
+    return false;
+    }
+  const int numVariables = static_cast<int>(names.size());
+
+  // The names and sizes vtkExodusIIReader presents:
+  std::map<std::string, int> arrays;
+  const int numArrays = nodal ? m_metaData->GetNumberOfPointResultArrays()
+                              : m_metaData->GetNumberOfElementResultArrays();
+  for (int i = 0; i < numArrays; ++i)
+    {
+    if (nodal)
+      {
+      arrays[m_metaData->GetPointResultArrayName(i)] =
+          m_metaData->GetPointResultArrayNumberOfComponents(i);
+      }
+    else
+      {
+      arrays[m_metaData->GetElementResultArrayName(i)] =
+          m_metaData->GetElementResultArrayNumberOfComponents(i);
+      }
+    }
+
+  // Join consecutive variables whose suffixes name the components of a
+  // tensor or vector, like vtkExodusIIReader:
+  static const std::vector<std::vector<const char*> > suffixes = {
+    { "xx", "yy", "zz", "xy", "yz", "zx" },
+    { "x", "y", "z" },
+    { "x", "y" }
+  };
+  int i = 0;
+  while (i < numVariables)
+    {
+    bool joined = false;
+    for (const std::vector<const char*> &group : suffixes)
+      {
+      const int size = static_cast<int>(group.size());
+      if (i + size > numVariables)
+        {
+        continue;
+        }
+      std::string prefix;
+      bool matches = splitSuffix(names[i], group[0], prefix);
+      for (int c = 1; c < size && matches; ++c)
+        {
+        std::string other;
+        matches = splitSuffix(names[i + c], group[c], other) && other == prefix;
+        }
+      if (!matches)
+        {
+        continue;
+        }
+
+      std::string name = prefix;
+      if (!name.empty() && name.back() == '_')
+        {
+        name.pop_back();
+        }
+      for (const std::string &candidate : { name, prefix })
+        {
+        auto array = arrays.find(candidate);
+        if (array != arrays.end() && array->second >= size)
+          {
+          Variable &var = vars[candidate];
+          for (int c = 0; c < size; ++c)
+            {
+            var.components.push_back(i + c + 1);
+            }
+          var.numberOfComponents = array->second;
+          joined = true;
+          break;
+          }
+        }
+      if (joined)
+        {
+        i += size;
+        break;
+        }
+      }
+
+    if (!joined)
+      {
+      Variable &var = vars[names[i]];
+      var.components.push_back(i + 1);
+      var.numberOfComponents = 1;
+      ++i;
+      }
+    }
+  return true;
+}
@@ -0,0 +1,218 @@
+#ifndef MVNATIVEREADER_H
+#define MVNATIVEREADER_H
+
+#include "mvReadSettings.h"
+
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+class mvSharedTopology;
+class vtkCellArray;
+class vtkDataArray;
+class vtkExodusIIReader;
+class vtkMultiBlockDataSet;
+class vtkPoints;
+class vtkUnstructuredGrid;
+
+/**
+ * @brief The mvNativeReader class reads the element blocks of an Exodus file
+ * through the Exodus C API, as a leaner alternative to vtkExodusIIReader.
+ *
+ * The coordinates and connectivity of a block are read the first time the
+ * block is loaded, and shared by every dataset produced afterwards. A
+ * timestep then costs one hyperslab read per requested element variable
+ * component and block, written directly into the result array, and one read
+ * per nodal variable component, gathered into the point arrays of the blocks.
+ * The displacements, if any, are read the same way and added to a copy of
+ * the points.
+ *
+ * Exodus stores each coordinate and vector component separately, so the
+ * coordinates and multi-component arrays are vtkSOADataArrayTemplate arrays
+ * with one buffer per component, which avoids interleaving them. Code that
+ * needs raw memory must check vtkDataArray::HasStandardMemoryLayout(), as
+ * GetVoidPointer() makes an interleaved copy of such arrays.
+ *
+ * The output matches the output of vtkExodusIIReader for the same settings
+ * in structure, names and values: the block hierarchy and names are taken
+ * from a private vtkExodusIIReader (which only reads metadata), the points of
+ * each block are numbered in order of first use by its connectivity, vector
+ * and tensor components are joined under the names vtkExodusIIReader uses,
+ * and every block has an "ObjectId" cell array. Like vtkExodusIIReader, the
+ * points are moved by the displacement vector of each timestep, scaled by
+ * its default displacement magnitude. The arrays differ in type and memory
+ * layout, and readTimeSeries() locates nodes and elements in the undisplaced
+ * mesh.
+ *
+ * read() returns nullptr if the settings or the file are not supported: node
+ * or side sets, decomposed datasets, or element types whose node order
+ * differs between Exodus and VTK. The caller should then read the data with
+ * vtkExodusIIReader. This only affects that read: later reads with other
+ * settings are attempted again, and a file whose structure is not supported
+ * is examined again once it grows. Each reason is reported once per file.
+ *
+ * The read methods must not be called concurrently.
+ */
+class mvNativeReader
+{
+public:
+  mvNativeReader();
+  ~mvNativeReader();
+
+  /**
+   * If set, @a check is polled between hyperslab reads. Once it returns true,
+   * read() stops and returns nullptr.
+   */
+  using AbortCheck = std::function<bool()>;
+  void setAbortCheck(const AbortCheck &check) { m_abortCheck = check; }
+
+  /**
+   * If set, the mesh of each dataset and of each time series location search
+   * is shared through @a topology, and the reader keeps the shared points and
+   * cells instead of its own once they match. Readers of files with the same
+   * mesh then hold a single copy of it. @a topology must outlive this object.
+   */
+  void setSharedTopology(mvSharedTopology *topology) { m_topology = topology; }
+
+  /**
+   * Read @a step as described by @a settings. Returns nullptr if the read is
+   * not supported, fails, or is aborted.
+   */
+  vtkSmartPointer<vtkMultiBlockDataSet> read(const mvReadSettings &settings,
+                                             int step);
+
+  /** The values of a variable at one node or element over all timesteps. */
+  struct TimeSeries
+  {
+    std::string variable;
+    bool nodal{true};
+    // The 1-based Exodus node number, or element number across all blocks:
+    int64_t id{0};
+    std::string block; // The block the node or element was found in.
+    double position[3]{0., 0., 0.}; // The node, or the element's centroid.
+    int numberOfComponents{0};
+    std::vector<double> times;
+    std::vector<double> values; // One interleaved tuple per timestep.
+  };
+
+  /**
+   * Read @a variable at the node (nodal variables) or element centroid
+   * (element variables) nearest @a point in the blocks selected by
+   * @a settings, at every timestep. Each component is read with a single
+   * time-history access, so the cost does not grow with the mesh size beyond
+   * finding the location. Returns false if the variable or file cannot be
+   * read, or if the read is aborted. Decomposed datasets are not supported.
+   */
+  bool readTimeSeries(const mvReadSettings &settings,
+                      const std::string &variable, const double point[3],
+                      TimeSeries &series);
+
+  /** The global variables of a file at every timestep. */
+  struct GlobalVariables
+  {
+    std::vector<std::string> names;
+    std::vector<double> times;
+    std::vector<std::vector<double> > values; // Per name, one per timestep.
+  };
+
+  /**
+   * Read every global variable (e.g. MOOSE postprocessors) at every timestep,
+   * with one time-history read per variable. Returns false if the file
+   * cannot be read or the read is aborted.
+   */
+  bool readGlobalVariables(const mvReadSettings &settings,
+                           GlobalVariables &globals);
+
+private:
+  // An element block, in the order of vtkExodusIIReader's output.
+  struct Block
+  {
+    int64_t id{0};
+    std::string name;
+    int64_t numCells{0};
+    int64_t nodesPerCell{0};
+    int cellType{0}; // VTK cell type, 0 if not supported.
+    std::vector<char> variables; // Truth table: element variable is defined.
+    int64_t elementOffset{0}; // Elements in the preceding blocks of the file.
+
+    // Loaded on first use:
+    bool loaded{false};
+    std::vector<int64_t> nodes; // File node index of each point.
+    vtkSmartPointer<vtkPoints> points;
+    vtkSmartPointer<vtkCellArray> cells;
+    vtkSmartPointer<vtkDataArray> objectIds;
+  };
+
+  // A variable as presented by vtkExodusIIReader, with the 1-based Exodus
+  // variable index of each component.
+  struct Variable
+  {
+    std::vector<int> components;
+    int numberOfComponents{0}; // May exceed components.size() (2D vectors).
+  };
+  using Variables = std::map<std::string, Variable>;
+
+  // Open the file if needed. Returns false if it is not supported.
+  bool open(const mvReadSettings &settings);
+  bool readMetaData();
+  void close();
+  // Report a read that falls back to vtkExodusIIReader, once per reason.
+  void unsupported(const std::string &reason);
+
+  bool loadBlock(Block &block);
+  // A dataset with the structure of vtkExodusIIReader's output holding the
+  // meshes of the loaded blocks, whose grids are returned in order. Shares
+  // the meshes through m_topology if set.
+  vtkSmartPointer<vtkMultiBlockDataSet> meshes(
+      const std::vector<Block*> &blocks,
+      std::vector<vtkUnstructuredGrid*> &grids);
+  bool readNodal(const Variable &var, int step,
+                 const std::vector<Block*> &blocks,
+                 std::vector<vtkSmartPointer<vtkDataArray> > &arrays);
+  bool readElement(const Variable &var, int step, const Block &block,
+                   vtkSmartPointer<vtkDataArray> &array);
+
+  // Join the Exodus variables of type as vtkExodusIIReader does.
+  bool readVariableNames(int type, bool nodal, Variables &vars);
+  // The names of the Exodus variables of type, in file order.
+  bool readFileVariableNames(int type, std::vector<std::string> &names);
+
+  bool aborted() const { return m_abortCheck && m_abortCheck(); }
+
+private:
+  // Not implemented -- disable copy:
+  mvNativeReader(const mvNativeReader&);
+  mvNativeReader& operator=(const mvNativeReader&);
+
+private:
+  AbortCheck m_abortCheck;
+  mvSharedTopology *m_topology;
+
+  std::string m_fileName;
+  int m_exoid;
+  bool m_supported; // Whether the file structure is supported.
+  std::set<std::string> m_warnings;
+  int m_numberOfTimeSteps;
+  int m_dimension;
+  int64_t m_numberOfNodes;
+  std::vector<Block> m_blocks;
+  Variables m_nodalVariables;
+  Variables m_elementVariables;
+  std::string m_displacements; // The nodal variable added to the points.
+
+  // The coordinates of all nodes, kept while blocks remain to be loaded.
+  std::vector<double> m_coordinates[3];
+
+  // Metadata and output structure:
+  vtkNew<vtkExodusIIReader> m_metaData;
+  vtkSmartPointer<vtkMultiBlockDataSet> m_structure;
+  unsigned int m_elementBlocksChild;
+};
+
+#endif // MVNATIVEREADER_H
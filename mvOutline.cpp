@@ -3,11 +3,13 @@
 #include <GL/GLContextData.h>
 
 #include "vtkActor.h"
+#include "vtkBoundingBox.h"
 #include "vtkCompositePolyDataMapper.h"
 #include "vtkDataObject.h"
 #include "vtkExternalOpenGLRenderer.h"
 #include "vtkMultiBlockDataSet.h"
 #include "vtkOutlineFilter.h"
+#include "vtkOutlineSource.h"
 #include "vtkProperty.h"
 
 #include "vvContextState.h"
@@ -24,7 +26,8 @@ mvOutline::DataItem::DataItem()
 
 //------------------------------------------------------------------------------
 mvOutline::mvOutline()
-  : m_visible(true)
+  : m_fromBounds(false),
+    m_visible(true)
 {
 }
 
@@ -54,29 +57,49 @@ void mvOutline::configureDataPipeline(const vvApplicationState &vvState)
   const mvApplicationState &state =
       static_cast<const mvApplicationState &>(vvState);
 
-  m_filter->SetInputDataObject(state.reader().dataObject());
+  vtkDataObject *data = state.reader().dataObject();
+  const vtkBoundingBox &bounds = state.reader().bounds();
+  m_fromBounds = !data && bounds.IsValid();
+  m_filter->SetInputDataObject(data);
+  if (m_fromBounds)
+    {
+    double b[6];
+    bounds.GetBounds(b);
+    m_source->SetBounds(b);
+    }
 }
 
 //------------------------------------------------------------------------------
 bool mvOutline::dataPipelineNeedsUpdate() const
 {
+  vtkAlgorithm *algorithm = m_fromBounds
+      ? static_cast<vtkAlgorithm*>(m_source.Get())
+      : static_cast<vtkAlgorithm*>(m_filter.Get());
   return
-      m_filter->GetInputDataObject(0, 0) &&
+      (m_fromBounds || m_filter->GetInputDataObject(0, 0)) &&
       m_visible &&
       (!m_appData ||
-       m_appData->GetMTime() < m_filter->GetMTime());
+       m_appData->GetMTime() < algorithm->GetMTime());
 }
 
 //------------------------------------------------------------------------------
 void mvOutline::executeDataPipeline() const
 {
-  m_filter->Update();
+  if (m_fromBounds)
+    {
+    m_source->Update();
+    }
+  else
+    {
+    m_filter->Update();
+    }
 }
 
 //------------------------------------------------------------------------------
 void mvOutline::retrieveDataPipelineResult()
 {
-  vtkDataObject *dObj = m_filter->GetOutputDataObject(0);
+  vtkDataObject *dObj = m_fromBounds ? m_source->GetOutputDataObject(0)
+                                     : m_filter->GetOutputDataObject(0);
   m_appData.TakeReference(dObj->NewInstance());
   m_appData->ShallowCopy(dObj);
 }
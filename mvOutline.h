@@ -10,9 +10,14 @@ class vtkActor;
 class vtkCompositePolyDataMapper;
 class vtkDataObject;
 class vtkOutlineFilter;
+class vtkOutlineSource;
 
 /**
  * @brief The mvOutline class renders an outline of the dataset bounds.
+ *
+ * Until the reader has data, the outline is drawn from the bounds in the
+ * file's metadata, so that something is on screen while the first timestep is
+ * read.
  */
 class mvOutline : public vvAsyncGLObject
 {
@@ -59,6 +64,8 @@ private:
 private:
   // Data pipeline:
   vtkNew<vtkOutlineFilter> m_filter;
+  vtkNew<vtkOutlineSource> m_source; // From the metadata bounds.
+  bool m_fromBounds; // Whether m_source is used instead of m_filter.
 
   // Renderable data:
   vtkSmartPointer<vtkDataObject> m_appData;
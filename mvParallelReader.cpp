@@ -0,0 +1,360 @@
+#include "mvParallelReader.h"
+
+#include "mvIOLock.h"
+#include "mvThreadPool.h"
+
+#include <vtkAppendFilter.h>
+#include <vtkCommand.h>
+#include <vtkCompositeDataIterator.h>
+#include <vtkDataSet.h>
+#include <vtkExodusIIReader.h>
+#include <vtkFieldData.h>
+#include <vtkMultiBlockDataSet.h>
+#include <vtkNew.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <string>
+
+//------------------------------------------------------------------------------
+mvParallelReader::mvParallelReader()
+  : m_numberOfThreads(0),
+    m_lastReadThreads(0),
+    m_aborted(false)
+{
+}
+
+//------------------------------------------------------------------------------
+mvParallelReader::~mvParallelReader()
+{
+}
+
+//------------------------------------------------------------------------------
+void mvParallelReader::setNumberOfThreads(int threads)
+{
+  if (threads != m_numberOfThreads)
+    {
+    m_numberOfThreads = threads;
+    m_pool.reset();
+    }
+}
+
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkMultiBlockDataSet>
+mvParallelReader::read(const mvReadSettings &settings, int step)
+{
+  m_aborted = false;
+  vtkSmartPointer<vtkMultiBlockDataSet> result =
+      settings.pieces.empty() ? this->readBlocks(settings, step)
+                              : this->readPieces(settings, step);
+  if (m_aborted)
+    {
+    // Some readers hold partial outputs that their pipelines consider
+    // current:
+    for (vtkExodusIIReader *reader : m_readers)
+      {
+      reader->SetAbortExecute(0);
+      reader->Modified();
+      }
+    return nullptr;
+    }
+  return result;
+}
+
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkMultiBlockDataSet>
+mvParallelReader::readBlocks(const mvReadSettings &settings, int step)
+{
+  // The first reader provides the block list:
+  vtkExodusIIReader *first = this->reader(0);
+  settings.apply(first);
+  std::vector<std::string> blocks;
+  const int numBlocks =
+      first->GetNumberOfObjects(vtkExodusIIReader::ELEM_BLOCK);
+  for (int i = 0; i < numBlocks; ++i)
+    {
+    std::string block = first->GetObjectName(vtkExodusIIReader::ELEM_BLOCK, i);
+    if (settings.excludedBlocks.find(block) == settings.excludedBlocks.end())
+      {
+      blocks.push_back(block);
+      }
+    }
+
+  // Deal the blocks out round-robin, as block sizes tend to vary with their
+  // position in the file:
+  const size_t numTasks = std::max<size_t>(
+        1, std::min(blocks.size(), static_cast<size_t>(this->concurrency())));
+  std::vector<Task> tasks;
+  for (size_t t = 0; t < numTasks; ++t)
+    {
+    mvReadSettings share = settings;
+    for (size_t b = 0; b < blocks.size(); ++b)
+      {
+      if (b % numTasks != t)
+        {
+        share.excludedBlocks.insert(blocks[b]);
+        }
+      }
+    if (t > 0)
+      {
+      share.nodeSets.clear();
+      share.sideSets.clear();
+      }
+
+    vtkExodusIIReader *reader = this->reader(t);
+    tasks.push_back([reader, share, step]()
+      {
+      mvIOLock::Delegate delegate;
+      share.apply(reader);
+      reader->SetTimeStep(step);
+      reader->Update();
+      });
+    }
+  this->runLocked(tasks);
+  m_lastReadThreads = static_cast<int>(numTasks);
+  if (this->aborted())
+    {
+    return nullptr;
+    }
+
+  // Assemble:
+  vtkMultiBlockDataSet *output = first->GetOutput();
+  vtkSmartPointer<vtkMultiBlockDataSet> result;
+  result.TakeReference(output->NewInstance());
+  result->ShallowCopy(output);
+  for (size_t t = 1; t < numTasks; ++t)
+    {
+    vtkMultiBlockDataSet *part = m_readers[t]->GetOutput();
+    vtkCompositeDataIterator *it = part->NewIterator();
+    for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextItem())
+      {
+      result->SetDataSet(it, it->GetCurrentDataObject());
+      }
+    it->Delete();
+    }
+
+  return result;
+}
+
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkMultiBlockDataSet>
+mvParallelReader::readPieces(const mvReadSettings &settings, int step)
+{
+  const size_t numPieces = settings.pieces.size();
+  std::vector<Task> tasks;
+  for (size_t p = 0; p < numPieces; ++p)
+    {
+    mvReadSettings piece = settings;
+    piece.fileName = settings.pieces[p];
+    piece.pieces.clear();
+
+    vtkExodusIIReader *reader = this->reader(p);
+    // Each piece is read once per timestep, so caching its arrays only
+    // holds on to memory:
+    reader->SetCacheSize(0.);
+    tasks.push_back([reader, piece, step]()
+      {
+      mvIOLock::Delegate delegate;
+      piece.apply(reader);
+      reader->SetTimeStep(step);
+      reader->Update();
+      });
+    }
+  this->runLocked(tasks);
+  m_lastReadThreads = static_cast<int>(
+        std::min(numPieces, static_cast<size_t>(this->concurrency())));
+  if (this->aborted())
+    {
+    return nullptr;
+    }
+
+  vtkExodusIIReader *first = m_readers.front();
+  const int numSteps = first->GetNumberOfTimeSteps();
+  for (size_t p = 1; p < numPieces; ++p)
+    {
+    if (m_readers[p]->GetNumberOfTimeSteps() != numSteps)
+      {
+      std::cerr << "Piece '" << settings.pieces[p] << "' has "
+                << m_readers[p]->GetNumberOfTimeSteps() << " timesteps, but '"
+                << settings.pieces.front() << "' has " << numSteps << "."
+                << std::endl;
+      }
+    }
+
+  // Collect the pieces of each leaf by flat index:
+  using Leaves = std::vector<vtkDataSet*>;
+  std::map<unsigned int, Leaves> leaves;
+  for (size_t p = 0; p < numPieces; ++p)
+    {
+    vtkCompositeDataIterator *it = m_readers[p]->GetOutput()->NewIterator();
+    for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextItem())
+      {
+      vtkDataSet *ds = vtkDataSet::SafeDownCast(it->GetCurrentDataObject());
+      if (ds && ds->GetNumberOfCells() > 0)
+        {
+        leaves[it->GetCurrentFlatIndex()].push_back(ds);
+        }
+      }
+    it->Delete();
+    }
+
+  vtkMultiBlockDataSet *output = first->GetOutput();
+  vtkSmartPointer<vtkMultiBlockDataSet> result;
+  result.TakeReference(output->NewInstance());
+  result->CopyStructure(output);
+
+  // Join the blocks concurrently. The appended leaves are written to
+  // separate slots, and result is only modified afterwards.
+  std::vector<unsigned int> indices;
+  std::vector<vtkSmartPointer<vtkDataSet> > joined;
+  for (const auto &leaf : leaves)
+    {
+    indices.push_back(leaf.first);
+    }
+  joined.resize(indices.size());
+
+  tasks.clear();
+  for (size_t i = 0; i < indices.size(); ++i)
+    {
+    const Leaves *parts = &leaves[indices[i]];
+    vtkSmartPointer<vtkDataSet> *slot = &joined[i];
+    tasks.push_back([parts, slot]()
+      {
+      if (parts->size() == 1)
+        {
+        *slot = parts->front();
+        return;
+        }
+
+      vtkNew<vtkAppendFilter> append;
+      append->MergePointsOff();
+      for (vtkDataSet *part : *parts)
+        {
+        append->AddInputData(part);
+        }
+      append->Update();
+
+      vtkUnstructuredGrid *grid = append->GetOutput();
+      // Global variables and other field data are replicated in every piece:
+      grid->GetFieldData()->ShallowCopy(parts->front()->GetFieldData());
+      *slot = grid;
+      });
+    }
+  this->run(tasks);
+  if (this->aborted())
+    {
+    return nullptr;
+    }
+
+  vtkCompositeDataIterator *it = output->NewIterator();
+  it->SkipEmptyNodesOff();
+  for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextItem())
+    {
+    auto match = std::lower_bound(indices.begin(), indices.end(),
+                                  it->GetCurrentFlatIndex());
+    if (match != indices.end() && *match == it->GetCurrentFlatIndex())
+      {
+      result->SetDataSet(it, joined[match - indices.begin()]);
+      }
+    }
+  it->Delete();
+
+  // Only keep the metadata of every piece. The result references the leaves
+  // it needs, and the readers execute again on the next read:
+  for (size_t p = 0; p < numPieces; ++p)
+    {
+    m_readers[p]->GetOutput()->Initialize();
+    m_readers[p]->Modified();
+    }
+
+  return result;
+}
+
+//------------------------------------------------------------------------------
+vtkExodusIIReader* mvParallelReader::reader(size_t i)
+{
+  while (m_readers.size() <= i)
+    {
+    vtkSmartPointer<vtkExodusIIReader> reader =
+        vtkSmartPointer<vtkExodusIIReader>::New();
+    reader->AddObserver(vtkCommand::ProgressEvent, this,
+                        &mvParallelReader::abortReader);
+    m_readers.push_back(reader);
+    }
+  return m_readers[i];
+}
+
+//------------------------------------------------------------------------------
+int mvParallelReader::concurrency()
+{
+  if (m_numberOfThreads == 1)
+    {
+    return 1;
+    }
+  if (!m_pool)
+    {
+    m_pool.reset(new mvThreadPool(m_numberOfThreads));
+    }
+  return m_pool->size();
+}
+
+//------------------------------------------------------------------------------
+void mvParallelReader::runLocked(const std::vector<Task> &tasks)
+{
+  // Only the tasks of this read overlap in the libraries, as they delegate
+  // to this lock. Choosing several reader threads declares that the
+  // libraries tolerate that. The other readers (prefetching, range scans,
+  // file watching) are not part of that choice, so they still wait.
+  mvIOLock lock;
+  this->run(tasks);
+}
+
+//------------------------------------------------------------------------------
+void mvParallelReader::run(const std::vector<Task> &tasks)
+{
+  // Skip the tasks that have not started when the read is aborted:
+  std::vector<Task> checked;
+  for (const Task &task : tasks)
+    {
+    checked.push_back([this, &task]()
+      {
+      if (!this->aborted())
+        {
+        task();
+        }
+      });
+    }
+
+  if (this->concurrency() == 1)
+    {
+    for (const Task &task : checked)
+      {
+      task();
+      }
+    }
+  else
+    {
+    m_pool->run(checked);
+    }
+}
+
+//------------------------------------------------------------------------------
+bool mvParallelReader::aborted()
+{
+  if (!m_aborted && m_abortCheck && m_abortCheck())
+    {
+    m_aborted = true;
+    }
+  return m_aborted;
+}
+
+//------------------------------------------------------------------------------
+void mvParallelReader::abortReader(vtkObject *caller, unsigned long, void *)
+{
+  if (this->aborted())
+    {
+    static_cast<vtkExodusIIReader*>(caller)->SetAbortExecute(1);
+    }
+}
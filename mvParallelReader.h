@@ -0,0 +1,120 @@
+#ifndef MVPARALLELREADER_H
+#define MVPARALLELREADER_H
+
+#include "mvReadSettings.h"
+
+#include <vtkSmartPointer.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+class mvThreadPool;
+class vtkExodusIIReader;
+class vtkMultiBlockDataSet;
+class vtkObject;
+
+/**
+ * @brief The mvParallelReader class reads a timestep with several
+ * vtkExodusIIReaders on a pool of threads.
+ *
+ * For a single file, the selected element blocks are split across the
+ * readers. vtkExodusIIReader produces the same block hierarchy regardless of
+ * which blocks are enabled (disabled blocks are left empty), so the partial
+ * outputs are assembled by moving the leaves of every output into a copy of
+ * the first one. Node and side sets are read by the first reader.
+ *
+ * For a decomposed dataset (see mvReadSettings::pieces), every piece is read
+ * by its own reader, and the pieces of each block are appended into a single
+ * unstructured grid. The piece readers keep no array cache and release their
+ * outputs once joined, so only their metadata outlives a read. The pieces of
+ * a Nemesis decomposition all declare every block, so the joined dataset has
+ * the same structure as the output of vtkExodusIIReader on the joined file.
+ * Points on the piece boundaries are not merged.
+ *
+ * The readers open files independently. Reading with more than one thread
+ * requires the netCDF/HDF5 libraries VTK was built with to tolerate
+ * concurrent access to separate file handles. A read holds the process-wide
+ * mvIOLock, so other readers never overlap with it.
+ *
+ * A read can be abandoned part way (see setAbortCheck()).
+ *
+ * read() must not be called concurrently.
+ */
+class mvParallelReader
+{
+public:
+  mvParallelReader();
+  ~mvParallelReader();
+
+  /**
+   * The number of reader threads. Values less than 1 use one thread per
+   * hardware thread, and 1 reads on the calling thread. Default is 0. @{
+   */
+  int numberOfThreads() const { return m_numberOfThreads; }
+  void setNumberOfThreads(int threads);
+  /** @} */
+
+  /**
+   * The number of threads used by the last read(). This is at most one per
+   * selected element block or piece.
+   */
+  int lastReadThreads() const { return m_lastReadThreads; }
+
+  /**
+   * If set, @a check is polled from the reader threads during read(). Once it
+   * returns true, the read stops as soon as possible and returns nullptr.
+   * @a check must be thread-safe.
+   */
+  using AbortCheck = std::function<bool()>;
+  void setAbortCheck(const AbortCheck &check) { m_abortCheck = check; }
+
+  /**
+   * Read @a step as described by @a settings. Returns nullptr if the read was
+   * aborted.
+   */
+  vtkSmartPointer<vtkMultiBlockDataSet> read(const mvReadSettings &settings,
+                                             int step);
+
+private:
+  using Task = std::function<void()>;
+
+  // Poll the abort check. Once it returns true, this stays true until the
+  // next read().
+  bool aborted();
+
+  // Progress observer of the readers.
+  void abortReader(vtkObject *caller, unsigned long, void *);
+
+  vtkSmartPointer<vtkMultiBlockDataSet> readBlocks(
+      const mvReadSettings &settings, int step);
+  vtkSmartPointer<vtkMultiBlockDataSet> readPieces(
+      const mvReadSettings &settings, int step);
+
+  // Return reader i, creating it if needed.
+  vtkExodusIIReader* reader(size_t i);
+
+  // The number of tasks that run concurrently.
+  int concurrency();
+
+  // Execute tasks and wait for them to finish.
+  void run(const std::vector<Task> &tasks);
+  // Execute reading tasks under one mvIOLock, which they delegate to.
+  void runLocked(const std::vector<Task> &tasks);
+
+private:
+  // Not implemented -- disable copy:
+  mvParallelReader(const mvParallelReader&);
+  mvParallelReader& operator=(const mvParallelReader&);
+
+private:
+  int m_numberOfThreads;
+  int m_lastReadThreads;
+  std::unique_ptr<mvThreadPool> m_pool; // Created on first use.
+  std::vector<vtkSmartPointer<vtkExodusIIReader> > m_readers;
+  AbortCheck m_abortCheck;
+  std::atomic<bool> m_aborted;
+};
+
+#endif // MVPARALLELREADER_H
@@ -0,0 +1,410 @@
+// Offline preprocessor for MooseViewer.
+//
+// Reads every timestep of an Exodus file and stores the products MooseViewer
+// otherwise computes while the user waits, so that later sessions show them
+// as soon as a timestep is selected:
+//
+//   ./mvpreprocess -f run.e -variables temperature,velocity
+//       -contour temperature 64,128,192
+//   ./MooseViewer -f run.e
+//
+// Only the variables the viewer will request are read and stored: those
+// named with -variables, or else those of the file's saved session (see
+// MooseViewer -session), and the contoured variables.
+//
+// - Ranges and histograms of those variables, in the statistics index
+//   (<file>.mvstats, see mvStatisticsIndex).
+// - Reduced datasets, outer surfaces and optionally contours, in the product
+//   cache (<file>.mvproducts, see mvProductCache).
+// - Optionally the timesteps themselves, in the columnar cache
+//   (<file>.mvcache, see mvColumnarCache).
+//
+// Uses the same filters and settings as the viewer, so the products are
+// identical to what it would compute for the default blocks and sets.
+
+// VTK includes
+#include <vtkCellData.h>
+#include <vtkCompositeDataGeometryFilter.h>
+#include <vtkCompositeDataIterator.h>
+#include <vtkDataObject.h>
+#include <vtkDataSet.h>
+#include <vtkExodusIIReader.h>
+#include <vtkMultiBlockDataSet.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkResampleToImage.h>
+#include <vtkSMPContourGrid.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// POSIX includes
+#include <strings.h>
+
+// MooseViewer includes
+#include "mvColumnarCache.h"
+#include "mvProductCache.h"
+#include "mvProductFilters.h"
+#include "mvReadSettings.h"
+#include "mvSession.h"
+#include "mvStatisticsIndex.h"
+
+namespace {
+
+// Contours requested with -contour.
+struct ContourRequest
+{
+  std::string variable;
+  std::vector<double> values; // In [0, 255], as in MooseViewer.
+  double globalRange[2]{std::numeric_limits<double>::max(),
+                        std::numeric_limits<double>::lowest()};
+};
+
+//------------------------------------------------------------------------------
+bool parseValues(const std::string &list, std::vector<double> &values)
+{
+  values.clear();
+  std::istringstream in(list);
+  std::string item;
+  while (std::getline(in, item, ','))
+    {
+    char *end = nullptr;
+    const double value = std::strtod(item.c_str(), &end);
+    if (item.empty() || *end != '\0' || value < 0. || value > 255.)
+      {
+      return false;
+      }
+    values.push_back(value);
+    }
+  return !values.empty();
+}
+
+//------------------------------------------------------------------------------
+bool parseNames(const std::string &list, std::set<std::string> &names)
+{
+  names.clear();
+  std::istringstream in(list);
+  std::string item;
+  while (std::getline(in, item, ','))
+    {
+    if (item.empty())
+      {
+      return false;
+      }
+    names.insert(item);
+    }
+  return !names.empty();
+}
+
+//------------------------------------------------------------------------------
+// The field association of the array named variable in mbds, as used by
+// mvContours, or -1 if no leaf has it.
+int findAssociation(vtkMultiBlockDataSet *mbds, const std::string &variable)
+{
+  vtkSmartPointer<vtkCompositeDataIterator> it;
+  it.TakeReference(mbds->NewIterator());
+  for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextItem())
+    {
+    vtkDataSet *ds = vtkDataSet::SafeDownCast(it->GetCurrentDataObject());
+    if (!ds)
+      {
+      continue;
+      }
+    if (ds->GetPointData()->GetArray(variable.c_str()))
+      {
+      return vtkDataObject::FIELD_ASSOCIATION_POINTS;
+      }
+    if (ds->GetCellData()->GetArray(variable.c_str()))
+      {
+      return vtkDataObject::FIELD_ASSOCIATION_CELLS;
+      }
+    }
+  return -1;
+}
+
+//------------------------------------------------------------------------------
+void printUsage()
+{
+  std::cout << "\nmvpreprocess - Precompute MooseViewer products for an "
+               "Exodus file" << std::endl;
+  std::cout << "\nUSAGE:\n\t./mvpreprocess -f <filename> "
+               "[-variables <names>]\n\t\t[-contour <variable> <values>]... "
+               "[-globalRanges] [-columnarCache]" << std::endl;
+  std::cout << "\nWhere:" << std::endl;
+  std::cout << "\t-f <filename>" << std::endl;
+  std::cout << "\tExodus file to preprocess. Decomposed datasets are not "
+               "supported.\n" << std::endl;
+  std::cout << "\t-variables <names>" << std::endl;
+  std::cout << "\tThe comma separated variables to store, i.e. those the "
+               "viewer\n\twill show. Defaults to the variables of the file's "
+               "saved session\n\t(see MooseViewer -session). Contoured "
+               "variables are always stored.\n" << std::endl;
+  std::cout << "\t-contour <variable> <values>" << std::endl;
+  std::cout << "\tAlso store contours of <variable> at the comma separated\n"
+               "\t<values>, each in [0, 255] as in MooseViewer's contour "
+               "dialog.\n\tMay be repeated.\n" << std::endl;
+  std::cout << "\t-globalRanges" << std::endl;
+  std::cout << "\tMap contour values to the range over all timesteps, as "
+               "the\n\tviewer does with \"Global Range\" enabled. The range "
+               "of each\n\ttimestep is used by default.\n" << std::endl;
+  std::cout << "\t-columnarCache" << std::endl;
+  std::cout << "\tAlso store the timesteps in the columnar cache (see "
+               "MooseViewer\n\t-columnarCache).\n" << std::endl;
+}
+
+} // end anon namespace
+
+//------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  std::string fileName;
+  std::set<std::string> variables;
+  std::vector<ContourRequest> contours;
+  bool globalRanges = false;
+  bool columnarCache = false;
+  for (int i = 1; i < argc; ++i)
+    {
+    if (strcasecmp(argv[i], "-f") == 0 && i + 1 < argc)
+      {
+      fileName = argv[++i];
+      }
+    else if (strcasecmp(argv[i], "-variables") == 0 && i + 1 < argc)
+      {
+      if (!parseNames(argv[++i], variables))
+        {
+        std::cerr << "mvpreprocess: Invalid variable list '" << argv[i]
+                  << "'." << std::endl;
+        return 1;
+        }
+      }
+    else if (strcasecmp(argv[i], "-contour") == 0 && i + 2 < argc)
+      {
+      ContourRequest request;
+      request.variable = argv[++i];
+      if (!parseValues(argv[++i], request.values))
+        {
+        std::cerr << "mvpreprocess: Invalid contour values '" << argv[i]
+                  << "'." << std::endl;
+        return 1;
+        }
+      contours.push_back(request);
+      }
+    else if (strcasecmp(argv[i], "-globalRanges") == 0)
+      {
+      globalRanges = true;
+      }
+    else if (strcasecmp(argv[i], "-columnarCache") == 0)
+      {
+      columnarCache = true;
+      }
+    else
+      {
+      printUsage();
+      return 1;
+      }
+    }
+  if (fileName.empty())
+    {
+    printUsage();
+    return 1;
+    }
+  if (!mvReadSettings::findPieces(fileName).empty())
+    {
+    std::cerr << "mvpreprocess: '" << fileName << "' is decomposed into "
+                 "pieces, which is not supported." << std::endl;
+    return 1;
+    }
+
+  vtkNew<vtkExodusIIReader> reader;
+  if (!reader->CanReadFile(fileName.c_str()))
+    {
+    std::cerr << "mvpreprocess: Unable to read '" << fileName << "'."
+              << std::endl;
+    return 1;
+    }
+
+  reader->SetFileName(fileName.c_str());
+  reader->UpdateInformation();
+  std::set<std::string> available;
+  for (int i = 0; i < reader->GetNumberOfPointResultArrays(); ++i)
+    {
+    available.insert(reader->GetPointResultArrayName(i));
+    }
+  for (int i = 0; i < reader->GetNumberOfElementResultArrays(); ++i)
+    {
+    available.insert(reader->GetElementResultArrayName(i));
+    }
+
+  // The variables the viewer will request, with the default blocks and sets,
+  // as the products are only used for such datasets:
+  if (variables.empty())
+    {
+    mvSession session;
+    const std::string sessionFile = mvSession::defaultFileName(fileName);
+    if (!session.load(sessionFile) || session.fileName != fileName)
+      {
+      std::cerr << "mvpreprocess: No session of '" << fileName << "' in '"
+                << sessionFile << "'. Name the variables to store with "
+                   "-variables." << std::endl;
+      return 1;
+      }
+    variables = session.variables;
+    }
+  for (const ContourRequest &request : contours)
+    {
+    variables.insert(request.variable);
+    }
+  mvReadSettings settings;
+  settings.fileName = fileName;
+  for (const std::string &variable : variables)
+    {
+    if (!available.count(variable))
+      {
+      std::cerr << "mvpreprocess: No variable named '" << variable << "'."
+                << std::endl;
+      return 1;
+      }
+    settings.variables.insert(variable);
+    }
+  settings.numberOfTimeSteps = reader->GetNumberOfTimeSteps();
+  // A file without timesteps still has its mesh at timestep 0:
+  const int numSteps = std::max(settings.numberOfTimeSteps, 1);
+
+  mvStatisticsIndex statistics;
+  statistics.setFileName(fileName);
+  mvColumnarCache columns;
+  columns.setEnabled(columnarCache);
+  mvProductCache products;
+  if (!products.create(fileName, settings.variables))
+    {
+    std::cerr << "mvpreprocess: Unable to store products for '" << fileName
+              << "'." << std::endl;
+    return 1;
+    }
+
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+
+  // The global ranges must be known before the first contour. Index the
+  // contoured variables over all timesteps first:
+  if (globalRanges && !contours.empty())
+    {
+    mvReadSettings rangeSettings = settings;
+    rangeSettings.variables.clear();
+    for (const ContourRequest &request : contours)
+      {
+      rangeSettings.variables.insert(request.variable);
+      }
+    rangeSettings.apply(reader.Get());
+    for (int step = 0; step < numSteps; ++step)
+      {
+      reader->SetTimeStep(step);
+      reader->Update();
+      statistics.add(rangeSettings, step,
+                     vtkMultiBlockDataSet::SafeDownCast(reader->GetOutput()));
+      }
+    statistics.save();
+
+    for (ContourRequest &request : contours)
+      {
+      for (int step = 0; step < numSteps; ++step)
+        {
+        mvStatisticsIndex::Statistics stats;
+        if (statistics.summary(request.variable, step, stats))
+          {
+          request.globalRange[0] = std::min(request.globalRange[0], stats.min);
+          request.globalRange[1] = std::max(request.globalRange[1], stats.max);
+          }
+        }
+      }
+    }
+
+  // The filters of mvReader, mvGeometry and mvContours:
+  vtkNew<vtkResampleToImage> reducer;
+  mvProductFilters::setupReducer(reducer.Get());
+  vtkNew<vtkCompositeDataGeometryFilter> surface;
+  mvProductFilters::setupSurface(surface.Get());
+  vtkNew<vtkSMPContourGrid> contour;
+  vtkNew<vtkCompositeDataGeometryFilter> contourGeometry;
+  mvProductFilters::setupContour(contour.Get(), contourGeometry.Get());
+
+  settings.apply(reader.Get());
+  for (int step = 0; step < numSteps; ++step)
+    {
+    std::cout << "mvpreprocess: Timestep " << (step + 1) << " of " << numSteps
+              << std::endl;
+
+    reader->SetTimeStep(step);
+    reader->Update();
+    vtkMultiBlockDataSet *mbds =
+        vtkMultiBlockDataSet::SafeDownCast(reader->GetOutput());
+    if (!mbds)
+      {
+      std::cerr << "mvpreprocess: Unable to read timestep " << step << "."
+                << std::endl;
+      return 1;
+      }
+
+    statistics.add(settings, step, mbds);
+    statistics.save();
+    columns.store(settings, step, mbds);
+
+    reducer->SetInputDataObject(mbds);
+    reducer->Update();
+    bool stored =
+        products.store(mvProductCache::Product::Reduced, step,
+                       reducer->GetOutputDataObject(0));
+
+    surface->SetInputDataObject(mbds);
+    surface->Update();
+    stored = products.store(mvProductCache::Product::Surface, step,
+                            surface->GetOutputDataObject(0)) && stored;
+
+    for (const ContourRequest &request : contours)
+      {
+      const int association = findAssociation(mbds, request.variable);
+      double range[2] = { request.globalRange[0], request.globalRange[1] };
+      mvStatisticsIndex::Statistics stats;
+      if (!globalRanges && statistics.summary(request.variable, step, stats))
+        {
+        range[0] = stats.min;
+        range[1] = stats.max;
+        }
+      if (association < 0 || range[0] > range[1])
+        {
+        continue;
+        }
+
+      contour->SetInputDataObject(mbds);
+      contour->SetInputArrayToProcess(0, 0, 0, association,
+                                      request.variable.c_str());
+      const std::vector<double> isovalues =
+          mvProductFilters::setContourValues(contour.Get(), request.values,
+                                             range);
+      contourGeometry->Update();
+      stored = products.storeContours(request.variable, association,
+                                      isovalues, step,
+                                      contourGeometry->GetOutputDataObject(0))
+          && stored;
+      }
+
+    if (!stored)
+      {
+      return 1;
+      }
+    }
+
+  timer->StopTimer();
+  std::cout << "mvpreprocess: Processed " << numSteps << " timesteps in "
+            << timer->GetElapsedTime() << " seconds." << std::endl;
+  return 0;
+}
@@ -0,0 +1,495 @@
+#include "mvProductCache.h"
+
+#include <vtkDataArraySelection.h>
+#include <vtkDataObject.h>
+#include <vtkImageData.h>
+#include <vtkPolyData.h>
+#include <vtkXMLImageDataReader.h>
+#include <vtkXMLImageDataWriter.h>
+#include <vtkXMLPolyDataReader.h>
+#include <vtkXMLPolyDataWriter.h>
+#include <vtkXMLReader.h>
+#include <vtkXMLWriter.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char ManifestVersion[] = "mvProductCache 2";
+const char VariablePrefix[] = "variable ";
+
+//------------------------------------------------------------------------------
+// Write contents to a temporary file and move it into place.
+bool writeTextFile(const std::string &fileName, const std::string &contents)
+{
+  const std::string tmpName =
+      fileName + ".tmp" + std::to_string(static_cast<long>(getpid()));
+  std::ofstream out(tmpName, std::ios::binary | std::ios::trunc);
+  out.write(contents.data(), contents.size());
+  out.close();
+
+  if (!out || std::rename(tmpName.c_str(), fileName.c_str()) != 0)
+    {
+    std::remove(tmpName.c_str());
+    return false;
+    }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool fileExists(const std::string &fileName)
+{
+  struct stat info;
+  return stat(fileName.c_str(), &info) == 0 && S_ISREG(info.st_mode);
+}
+
+} // end anon namespace
+
+//------------------------------------------------------------------------------
+mvProductCache::mvProductCache()
+  : m_available(false)
+{
+}
+
+//------------------------------------------------------------------------------
+mvProductCache::~mvProductCache()
+{
+}
+
+//------------------------------------------------------------------------------
+bool mvProductCache::open(const std::string &dataFile)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  // The file may have been rewritten or appended to since it was opened:
+  if (dataFile == m_dataFile && manifest(dataFile) == m_manifest)
+    {
+    return m_available;
+    }
+  return this->openLocked(dataFile, nullptr);
+}
+
+//------------------------------------------------------------------------------
+bool mvProductCache::create(const std::string &dataFile,
+                            const Variables &variables)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return this->openLocked(dataFile, &variables);
+}
+
+//------------------------------------------------------------------------------
+bool mvProductCache::available() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_available;
+}
+
+//------------------------------------------------------------------------------
+std::string mvProductCache::dataFile() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_dataFile;
+}
+
+//------------------------------------------------------------------------------
+mvProductCache::Variables mvProductCache::variables() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_variables;
+}
+
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkDataObject> mvProductCache::load(
+    Product product, int step, const Variables &variables) const
+{
+  std::string fileName;
+  Variables skipped;
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_available)
+      {
+      return nullptr;
+      }
+    fileName = this->pathLocked(productName(product, step));
+    std::set_difference(m_variables.begin(), m_variables.end(),
+                        variables.begin(), variables.end(),
+                        std::inserter(skipped, skipped.end()));
+    }
+  if (!fileExists(fileName))
+    {
+    return nullptr;
+    }
+  return readFile(fileName, product == Product::Reduced, skipped);
+}
+
+//------------------------------------------------------------------------------
+bool mvProductCache::store(Product product, int step, vtkDataObject *data)
+{
+  const std::string fileName = this->path(productName(product, step));
+  return !fileName.empty() && data && writeFile(fileName, data);
+}
+
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkDataObject> mvProductCache::loadContours(
+    const std::string &variable, int association,
+    const std::vector<double> &isovalues, int step) const
+{
+  const std::string indexName = this->path(contoursName(step));
+  std::vector<ContourEntry> entries;
+  if (indexName.empty() || isovalues.empty() ||
+      !readContours(indexName, entries))
+    {
+    return nullptr;
+    }
+
+  for (const ContourEntry &entry : entries)
+    {
+    if (entry.variable == variable && entry.association == association &&
+        sameIsovalues(entry.isovalues, isovalues))
+      {
+      const std::string fileName = this->path(contourName(step, entry.index));
+      return fileExists(fileName) ? readFile(fileName, false, Variables())
+                                  : nullptr;
+      }
+    }
+  return nullptr;
+}
+
+//------------------------------------------------------------------------------
+bool mvProductCache::storeContours(const std::string &variable,
+                                   int association,
+                                   const std::vector<double> &isovalues,
+                                   int step, vtkDataObject *contours)
+{
+  const std::string indexName = this->path(contoursName(step));
+  if (indexName.empty() || !contours || isovalues.empty())
+    {
+    return false;
+    }
+
+  // Replace the contours of the same isovalues, or add new ones:
+  std::vector<ContourEntry> entries;
+  readContours(indexName, entries);
+  int index = 0;
+  for (const ContourEntry &entry : entries)
+    {
+    index = std::max(index, entry.index + 1);
+    }
+  auto match = std::find_if(entries.begin(), entries.end(),
+                            [&](const ContourEntry &entry)
+    {
+    return entry.variable == variable && entry.association == association &&
+        sameIsovalues(entry.isovalues, isovalues);
+    });
+  if (match != entries.end())
+    {
+    index = match->index;
+    entries.erase(match);
+    }
+
+  if (!writeFile(this->path(contourName(step, index)), contours))
+    {
+    return false;
+    }
+
+  ContourEntry entry;
+  entry.index = index;
+  entry.association = association;
+  entry.isovalues = isovalues;
+  entry.variable = variable;
+  entries.push_back(entry);
+
+  std::ostringstream out;
+  out << std::setprecision(std::numeric_limits<double>::max_digits10);
+  for (const ContourEntry &e : entries)
+    {
+    out << e.index << " " << e.association << " " << e.isovalues.size();
+    for (double value : e.isovalues)
+      {
+      out << " " << value;
+      }
+    out << " " << e.variable << "\n";
+    }
+  return writeTextFile(indexName, out.str());
+}
+
+//------------------------------------------------------------------------------
+bool mvProductCache::openLocked(const std::string &dataFile,
+                                const Variables *create)
+{
+  m_dataFile = dataFile;
+  m_directory = dataFile + ".mvproducts";
+  m_manifest = manifest(dataFile);
+  m_variables.clear();
+  m_available = false;
+  if (dataFile.empty() || m_manifest.empty())
+    {
+    return false;
+    }
+
+  // The expected header, then one line per stored variable:
+  std::ifstream in(this->pathLocked("manifest"));
+  std::ostringstream existing;
+  existing << in.rdbuf();
+  const std::string contents = existing.str();
+  bool valid = in && contents.compare(0, m_manifest.size(), m_manifest) == 0;
+  Variables stored;
+  std::istringstream lines(valid ? contents.substr(m_manifest.size())
+                                 : std::string());
+  std::string line;
+  const size_t prefixSize = sizeof(VariablePrefix) - 1;
+  while (valid && std::getline(lines, line))
+    {
+    valid = line.compare(0, prefixSize, VariablePrefix) == 0;
+    stored.insert(line.substr(std::min(prefixSize, line.size())));
+    }
+  if (valid && (!create || *create == stored))
+    {
+    m_variables = stored;
+    m_available = true;
+    return true;
+    }
+  if (!create)
+    {
+    return false;
+    }
+
+  // Missing or stale. Start over:
+  if (mkdir(m_directory.c_str(), 0755) != 0 && errno != EEXIST)
+    {
+    std::cerr << "mvProductCache: Unable to create " << m_directory << ": "
+              << std::strerror(errno) << std::endl;
+    return false;
+    }
+
+  if (DIR *dir = opendir(m_directory.c_str()))
+    {
+    while (dirent *entry = readdir(dir))
+      {
+      const std::string name = entry->d_name;
+      if (name != "." && name != "..")
+        {
+        unlink(this->pathLocked(name).c_str());
+        }
+      }
+    closedir(dir);
+    }
+
+  std::string written = m_manifest;
+  for (const std::string &variable : *create)
+    {
+    written += VariablePrefix + variable + "\n";
+    }
+  if (!writeTextFile(this->pathLocked("manifest"), written))
+    {
+    std::cerr << "mvProductCache: Unable to write the manifest in "
+              << m_directory << "." << std::endl;
+    return false;
+    }
+
+  m_variables = *create;
+  m_available = true;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+std::string mvProductCache::pathLocked(const std::string &name) const
+{
+  return m_directory + "/" + name;
+}
+
+//------------------------------------------------------------------------------
+std::string mvProductCache::path(const std::string &name) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_available ? this->pathLocked(name) : std::string();
+}
+
+//------------------------------------------------------------------------------
+std::string mvProductCache::manifest(const std::string &dataFile)
+{
+  struct stat info;
+  if (stat(dataFile.c_str(), &info) != 0)
+    {
+    return std::string();
+    }
+
+  std::ostringstream manifest;
+  manifest << ManifestVersion << "\n"
+           << "source " << info.st_size << " " << info.st_mtime << "\n"
+           << "reduced " << ReducedDimensions << "\n";
+  return manifest.str();
+}
+
+//------------------------------------------------------------------------------
+std::string mvProductCache::productName(Product product, int step)
+{
+  const std::string prefix = "t" + std::to_string(step);
+  switch (product)
+    {
+    case Product::Reduced:
+      return prefix + ".reduced.vti";
+    case Product::Surface:
+      return prefix + ".surface.vtp";
+    }
+  return prefix;
+}
+
+//------------------------------------------------------------------------------
+std::string mvProductCache::contoursName(int step)
+{
+  return "t" + std::to_string(step) + ".contours";
+}
+
+//------------------------------------------------------------------------------
+std::string mvProductCache::contourName(int step, int index)
+{
+  return "t" + std::to_string(step) + ".contour." + std::to_string(index) +
+      ".vtp";
+}
+
+//------------------------------------------------------------------------------
+bool mvProductCache::readContours(const std::string &fileName,
+                                  std::vector<ContourEntry> &entries)
+{
+  entries.clear();
+  std::ifstream in(fileName);
+  if (!in)
+    {
+    return false;
+    }
+
+  std::string line;
+  while (std::getline(in, line))
+    {
+    std::istringstream fields(line);
+    ContourEntry entry;
+    size_t count = 0;
+    if (!(fields >> entry.index >> entry.association >> count))
+      {
+      return false;
+      }
+    entry.isovalues.resize(count);
+    for (double &value : entry.isovalues)
+      {
+      fields >> value;
+      }
+    // The name is the rest of the line, and may contain spaces:
+    if (!fields || fields.get() != ' ' ||
+        !std::getline(fields, entry.variable))
+      {
+      return false;
+      }
+    entries.push_back(entry);
+    }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool mvProductCache::sameIsovalues(const std::vector<double> &a,
+                                   const std::vector<double> &b)
+{
+  if (a.size() != b.size())
+    {
+    return false;
+    }
+  for (size_t i = 0; i < a.size(); ++i)
+    {
+    const double scale = std::max(std::abs(a[i]), std::abs(b[i]));
+    if (a[i] != b[i] && std::abs(a[i] - b[i]) > 1e-9 * scale)
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkDataObject> mvProductCache::readFile(
+    const std::string &fileName, bool image, const Variables &skipped)
+{
+  vtkSmartPointer<vtkXMLReader> reader;
+  if (image)
+    {
+    reader = vtkSmartPointer<vtkXMLImageDataReader>::New();
+    }
+  else
+    {
+    reader = vtkSmartPointer<vtkXMLPolyDataReader>::New();
+    }
+  reader->SetFileName(fileName.c_str());
+  if (!skipped.empty())
+    {
+    // The arrays are stored raw in appended mode, so the skipped ones are
+    // not read at all:
+    reader->UpdateInformation();
+    for (const std::string &name : skipped)
+      {
+      reader->GetPointDataArraySelection()->DisableArray(name.c_str());
+      reader->GetCellDataArraySelection()->DisableArray(name.c_str());
+      }
+    }
+  reader->Update();
+  vtkDataObject *output = reader->GetOutputDataObject(0);
+  if (reader->GetErrorCode() != 0 || !output)
+    {
+    std::cerr << "mvProductCache: Unable to read '" << fileName << "'."
+              << std::endl;
+    return nullptr;
+    }
+
+  vtkSmartPointer<vtkDataObject> result;
+  result.TakeReference(output->NewInstance());
+  result->ShallowCopy(output);
+  return result;
+}
+
+//------------------------------------------------------------------------------
+bool mvProductCache::writeFile(const std::string &fileName,
+                               vtkDataObject *data)
+{
+  vtkSmartPointer<vtkXMLWriter> writer;
+  if (vtkImageData::SafeDownCast(data))
+    {
+    writer = vtkSmartPointer<vtkXMLImageDataWriter>::New();
+    }
+  else if (vtkPolyData::SafeDownCast(data))
+    {
+    writer = vtkSmartPointer<vtkXMLPolyDataWriter>::New();
+    }
+  else
+    {
+    return false;
+    }
+
+  // Raw and uncompressed, so that loading is bound by the disk only:
+  const std::string tmpName =
+      fileName + ".tmp" + std::to_string(static_cast<long>(getpid()));
+  writer->SetInputDataObject(data);
+  writer->SetFileName(tmpName.c_str());
+  writer->SetDataModeToAppended();
+  writer->EncodeAppendedDataOff();
+  writer->SetCompressorTypeToNone();
+  if (writer->Write() == 0 ||
+      std::rename(tmpName.c_str(), fileName.c_str()) != 0)
+    {
+    std::remove(tmpName.c_str());
+    std::cerr << "mvProductCache: Unable to write '" << fileName << "'."
+              << std::endl;
+    return false;
+    }
+  return true;
+}
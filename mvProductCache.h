@@ -0,0 +1,155 @@
+#ifndef MVPRODUCTCACHE_H
+#define MVPRODUCTCACHE_H
+
+#include <vtkSmartPointer.h>
+
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+class vtkDataObject;
+
+/**
+ * @brief The mvProductCache class stores the derived products of each
+ * timestep of an Exodus file, as precomputed by mvpreprocess, so that a
+ * session shows them without running the filters that produce them.
+ *
+ * The products live in a directory named after the data file with a
+ * ".mvproducts" suffix:
+ * - manifest: The size and modification time of the data file, the
+ *   dimensions of the reduced datasets, and the variables stored in them and
+ *   in the surfaces. The products are ignored when the file or dimensions no
+ *   longer match.
+ * - tN.reduced.vti: The reduced dataset of timestep N, as produced by
+ *   mvReader's vtkResampleToImage.
+ * - tN.surface.vtp: The outer surface of timestep N, as produced by
+ *   mvGeometry's vtkCompositeDataGeometryFilter.
+ * - tN.contours: The contours stored for timestep N, one per line: the
+ *   contour index, the field association and isovalues of the contoured
+ *   variable, and its name.
+ * - tN.contour.I.vtp: Contour I of timestep N, as produced by mvContours.
+ *
+ * Ranges and histograms are not stored here; mvpreprocess fills the
+ * mvStatisticsIndex of the file instead.
+ *
+ * Products are computed from the variables mvpreprocess was asked for and
+ * the default blocks and sets, so they only stand in for datasets read with
+ * the default objects (see mvReadSettings::defaultObjects()) and a subset of
+ * those variables. Files are written to a temporary name and renamed, so a
+ * partially written product is never read. The public API is thread-safe.
+ */
+class mvProductCache
+{
+public:
+  enum class Product
+    {
+    Reduced,
+    Surface
+    };
+
+  /** The sampling dimensions of the reduced datasets. */
+  enum { ReducedDimensions = 64 };
+
+  using Variables = std::set<std::string>;
+
+  mvProductCache();
+  ~mvProductCache();
+
+  /**
+   * Use the products of @a dataFile, if they are up to date. The file is
+   * checked again on every call, so products of a file that was rewritten or
+   * grew are dropped. Nothing is written. Returns available().
+   */
+  bool open(const std::string &dataFile);
+
+  /**
+   * Prepare the products directory of @a dataFile for writing products of
+   * @a variables. Products that are out of date or hold other variables are
+   * removed. Returns false if the directory can't be written.
+   */
+  bool create(const std::string &dataFile, const Variables &variables);
+
+  /** True if the products of dataFile() can be used. */
+  bool available() const;
+
+  /** The data file passed to open() or create(). */
+  std::string dataFile() const;
+
+  /** The variables stored in the reduced datasets and surfaces. */
+  Variables variables() const;
+
+  /**
+   * Read and write @a product of @a step. load() only reads the arrays of
+   * the stored variables in @a variables, and returns nullptr if the product
+   * is not stored. @{
+   */
+  vtkSmartPointer<vtkDataObject> load(Product product, int step,
+                                      const Variables &variables) const;
+  bool store(Product product, int step, vtkDataObject *data);
+  /** @} */
+
+  /**
+   * Read and write the contours of @a variable, with the field association
+   * @a association (a vtkDataObject::FieldAssociations value), at @a step.
+   * load() only returns contours stored for the same isovalues, within a
+   * small relative tolerance. @{
+   */
+  vtkSmartPointer<vtkDataObject> loadContours(
+      const std::string &variable, int association,
+      const std::vector<double> &isovalues, int step) const;
+  bool storeContours(const std::string &variable, int association,
+                     const std::vector<double> &isovalues, int step,
+                     vtkDataObject *contours);
+  /** @} */
+
+private:
+  // A line of a tN.contours file.
+  struct ContourEntry
+  {
+    int index;
+    int association;
+    std::vector<double> isovalues;
+    std::string variable;
+  };
+
+  // These require m_mutex to be held. openLocked() creates the products of
+  // the variables in create, if set:
+  bool openLocked(const std::string &dataFile, const Variables *create);
+  std::string pathLocked(const std::string &name) const;
+
+  // Returns the path of a product file under the lock, or an empty string if
+  // no products are available.
+  std::string path(const std::string &name) const;
+
+  static std::string manifest(const std::string &dataFile);
+  static std::string productName(Product product, int step);
+  static std::string contoursName(int step);
+  static std::string contourName(int step, int index);
+
+  static bool readContours(const std::string &fileName,
+                           std::vector<ContourEntry> &entries);
+  static bool sameIsovalues(const std::vector<double> &a,
+                            const std::vector<double> &b);
+
+  // Reads every array except those named in skipped:
+  static vtkSmartPointer<vtkDataObject> readFile(const std::string &fileName,
+                                                 bool image,
+                                                 const Variables &skipped);
+  static bool writeFile(const std::string &fileName, vtkDataObject *data);
+
+private:
+  // Not implemented -- disable copy:
+  mvProductCache(const mvProductCache&);
+  mvProductCache& operator=(const mvProductCache&);
+
+private:
+  mutable std::mutex m_mutex;
+  std::string m_dataFile;
+  std::string m_directory;
+  std::string m_manifest; // The expected header of the manifest.
+  Variables m_variables;
+  bool m_available;
+};
+
+#endif // MVPRODUCTCACHE_H
@@ -0,0 +1,53 @@
+#include "mvProductFilters.h"
+
+#include "mvProductCache.h"
+
+#include <vtkCompositeDataGeometryFilter.h>
+#include <vtkResampleToImage.h>
+#include <vtkSMPContourGrid.h>
+
+//------------------------------------------------------------------------------
+void mvProductFilters::setupReducer(vtkResampleToImage *reducer)
+{
+  reducer->SetSamplingDimensions(mvProductCache::ReducedDimensions,
+                                 mvProductCache::ReducedDimensions,
+                                 mvProductCache::ReducedDimensions);
+}
+
+//------------------------------------------------------------------------------
+void mvProductFilters::setupSurface(vtkCompositeDataGeometryFilter *)
+{
+  // The surfaces use the filter's defaults. Anything set here applies to the
+  // viewer and to the stored surfaces alike.
+}
+
+//------------------------------------------------------------------------------
+void mvProductFilters::setupContour(vtkSMPContourGrid *contour,
+                                    vtkCompositeDataGeometryFilter *geometry)
+{
+  contour->GenerateTrianglesOn();
+  contour->ComputeScalarsOn();
+
+  // These cause artifacts with the SMPContourGrid filter. Reported as VTK
+  // bug 15969.
+  contour->MergePiecesOff();
+  contour->UseScalarTreeOff();
+
+  geometry->SetInputConnection(contour->GetOutputPort());
+}
+
+//------------------------------------------------------------------------------
+std::vector<double> mvProductFilters::setContourValues(
+    vtkSMPContourGrid *contour, const std::vector<double> &values,
+    const double range[2])
+{
+  const double spread = range[1] - range[0];
+  std::vector<double> isovalues(values.size());
+  contour->SetNumberOfContours(static_cast<int>(values.size()));
+  for (size_t i = 0; i < values.size(); ++i)
+    {
+    isovalues[i] = (values[i] / 255.0) * spread + range[0];
+    contour->SetValue(static_cast<int>(i), isovalues[i]);
+    }
+  return isovalues;
+}
@@ -0,0 +1,48 @@
+#ifndef MVPRODUCTFILTERS_H
+#define MVPRODUCTFILTERS_H
+
+#include <vector>
+
+class vtkCompositeDataGeometryFilter;
+class vtkResampleToImage;
+class vtkSMPContourGrid;
+
+/**
+ * @brief The mvProductFilters class configures the filters whose outputs
+ * mvProductCache stores.
+ *
+ * mvReader, mvGeometry and mvContours set up their filters here, and so does
+ * mvpreprocess, so that a stored product is what the viewer would compute
+ * for the same input.
+ */
+class mvProductFilters
+{
+public:
+  /** The reducer of mvReader, which produces the reduced datasets. */
+  static void setupReducer(vtkResampleToImage *reducer);
+
+  /** The outer surface filter of mvGeometry. */
+  static void setupSurface(vtkCompositeDataGeometryFilter *surface);
+
+  /**
+   * The contour filter of mvContours, and the filter that merges its output
+   * into a single polydata. @a geometry is connected to @a contour.
+   */
+  static void setupContour(vtkSMPContourGrid *contour,
+                           vtkCompositeDataGeometryFilter *geometry);
+
+  /**
+   * Map @a values, each in [0, 255] as in the contour dialog, into @a range
+   * and set the results as the isovalues of @a contour. Returns the
+   * isovalues.
+   */
+  static std::vector<double> setContourValues(
+      vtkSMPContourGrid *contour, const std::vector<double> &values,
+      const double range[2]);
+
+private:
+  // Not implemented -- static API only:
+  mvProductFilters();
+};
+
+#endif // MVPRODUCTFILTERS_H
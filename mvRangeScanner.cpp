@@ -0,0 +1,370 @@
+#include "mvRangeScanner.h"
+
+#include "mvIOLock.h"
+#include "mvParallelReader.h"
+#include "mvReadSettings.h"
+#include "mvStatisticsIndex.h"
+
+#include <vtkCellData.h>
+#include <vtkCommand.h>
+#include <vtkCompositeDataIterator.h>
+#include <vtkDataArray.h>
+#include <vtkDataSet.h>
+#include <vtkExodusIIReader.h>
+#include <vtkMultiBlockDataSet.h>
+#include <vtkPointData.h>
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
+//------------------------------------------------------------------------------
+mvRangeScanner::mvRangeScanner()
+  : m_quit(false),
+    m_paused(false),
+    m_numberOfTimeSteps(0),
+    m_epoch(0),
+    m_resultsVersion(0),
+    m_statistics(nullptr),
+    m_scanEpoch(0)
+{
+  m_reader->AddObserver(vtkCommand::ProgressEvent, this,
+                        &mvRangeScanner::abortReader);
+  m_pieceReader.setNumberOfThreads(1);
+  m_pieceReader.setAbortCheck([this]() { return this->interrupted(); });
+  m_worker = std::thread(&mvRangeScanner::workerLoop, this);
+}
+
+//------------------------------------------------------------------------------
+mvRangeScanner::~mvRangeScanner()
+{
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_quit = true;
+    m_pending.clear();
+    }
+  m_condition.notify_all();
+  m_worker.join();
+}
+
+//------------------------------------------------------------------------------
+void mvRangeScanner::setFileName(const std::string &fileName)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (fileName != m_fileName)
+    {
+    m_fileName = fileName;
+    m_numberOfTimeSteps = 0;
+    ++m_epoch;
+    m_pending.clear();
+    m_ranges.clear();
+    m_missing.clear();
+    ++m_resultsVersion;
+    }
+}
+
+//------------------------------------------------------------------------------
+void mvRangeScanner::setNumberOfTimeSteps(int numSteps)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (numSteps > m_numberOfTimeSteps)
+    {
+    const bool rescan = m_numberOfTimeSteps > 0;
+    m_numberOfTimeSteps = numSteps;
+    if (rescan)
+      {
+      ++m_epoch;
+      m_pending.clear();
+      m_ranges.clear();
+      m_missing.clear();
+      ++m_resultsVersion;
+      }
+    }
+}
+
+//------------------------------------------------------------------------------
+void mvRangeScanner::scan(const std::set<std::string> &variables)
+{
+  bool queued = false;
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto &var : variables)
+      {
+      if (m_ranges.find(var) == m_ranges.end() &&
+          m_missing.find(var) == m_missing.end() &&
+          std::find(m_pending.begin(), m_pending.end(), var) == m_pending.end())
+        {
+        m_pending.push_back(var);
+        queued = true;
+        }
+      }
+    }
+
+  if (queued)
+    {
+    m_condition.notify_all();
+    }
+}
+
+//------------------------------------------------------------------------------
+void mvRangeScanner::setPaused(bool paused)
+{
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_paused = paused;
+    }
+  m_condition.notify_all();
+}
+
+//------------------------------------------------------------------------------
+bool mvRangeScanner::globalRange(const std::string &variable,
+                                 double range[2]) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_ranges.find(variable);
+  if (it == m_ranges.end())
+    {
+    return false;
+    }
+  range[0] = it->second[0];
+  range[1] = it->second[1];
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void mvRangeScanner::setStatisticsIndex(mvStatisticsIndex *index)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_statistics = index;
+}
+
+//------------------------------------------------------------------------------
+unsigned long mvRangeScanner::resultsVersion() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_resultsVersion;
+}
+
+//------------------------------------------------------------------------------
+void mvRangeScanner::workerLoop()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  for (;;)
+    {
+    m_condition.wait(lock, [this]()
+      {
+      return m_quit || (!m_pending.empty() && !m_fileName.empty());
+      });
+    if (m_quit)
+      {
+      return;
+      }
+
+    // Keep the variable queued while scanning, so scan() won't add it twice.
+    const std::string variable = m_pending.front();
+    const std::string fileName = m_fileName;
+    const int numSteps = m_numberOfTimeSteps;
+    const unsigned long epoch = m_epoch;
+    mvStatisticsIndex *statistics = m_statistics;
+
+    lock.unlock();
+    double range[2];
+    const bool complete =
+        this->scanVariable(fileName, numSteps, variable, epoch, statistics,
+                           range);
+    lock.lock();
+
+    if (epoch != m_epoch)
+      {
+      continue; // m_pending was reset along with the file.
+      }
+
+    m_pending.erase(std::remove(m_pending.begin(), m_pending.end(), variable),
+                    m_pending.end());
+    if (complete && range[0] <= range[1])
+      {
+      m_ranges[variable] = {{range[0], range[1]}};
+      ++m_resultsVersion;
+      }
+    else if (complete)
+      {
+      m_missing.insert(variable);
+      }
+    }
+}
+
+//------------------------------------------------------------------------------
+bool mvRangeScanner::scanVariable(const std::string &fileName, int numSteps,
+                                  const std::string &variable,
+                                  unsigned long epoch,
+                                  mvStatisticsIndex *statistics,
+                                  double range[2])
+{
+  // Looking for pieces lists the directory, so only do it once per file:
+  if (fileName != m_piecesFileName)
+    {
+    m_pieces = mvReadSettings::findPieces(fileName);
+    m_piecesFileName = fileName;
+    }
+
+  mvReadSettings settings;
+  settings.fileName = fileName;
+  settings.variables.insert(variable);
+  settings.pieces = m_pieces;
+  settings.numberOfTimeSteps = numSteps;
+  m_scanEpoch = epoch;
+
+  range[0] = std::numeric_limits<double>::max();
+  range[1] = std::numeric_limits<double>::lowest();
+
+  int steps[2];
+  mvFormatReader *format = mvFormatReader::forFile(m_formatReader, fileName);
+  if (format)
+    {
+    format->setAbortCheck([this]() { return this->interrupted(); });
+    steps[0] = 0;
+    steps[1] = numSteps - 1;
+    }
+  else
+    {
+    settings.apply(m_reader.Get());
+    m_reader->GetTimeStepRange(steps);
+    }
+  for (int step = steps[0]; step <= steps[1]; ++step)
+    {
+    // Indexed timesteps don't need to be read at all:
+    mvStatisticsIndex::Statistics stats;
+    if (statistics && statistics->contains(variable, step))
+      {
+      if (statistics->summary(variable, step, stats))
+        {
+        range[0] = std::min(range[0], stats.min);
+        range[1] = std::max(range[1], stats.max);
+        }
+      continue;
+      }
+
+    // The older timesteps of a stream are gone unless they were indexed:
+    if (format && !format->canRead(step))
+      {
+      continue;
+      }
+
+    if (!this->waitForTurn(epoch))
+      {
+      return false;
+      }
+
+    vtkSmartPointer<vtkMultiBlockDataSet> output =
+        this->read(format, settings, step);
+    if (!output && this->interrupted())
+      {
+      // Paused by a foreground read, or the file changed. Wait, then read
+      // the same timestep again:
+      if (!this->waitForTurn(epoch))
+        {
+        return false;
+        }
+      --step;
+      continue;
+      }
+    if (!output)
+      {
+      // Report the variable as having no values rather than retrying it:
+      std::cerr << "mvRangeScanner: Unable to read '" << variable
+                << "' at timestep " << step << "." << std::endl;
+      range[0] = std::numeric_limits<double>::max();
+      range[1] = std::numeric_limits<double>::lowest();
+      return true;
+      }
+
+    if (statistics)
+      {
+      statistics->add(settings, step, output);
+      if (statistics->summary(variable, step, stats))
+        {
+        range[0] = std::min(range[0], stats.min);
+        range[1] = std::max(range[1], stats.max);
+        }
+      continue;
+      }
+
+    vtkCompositeDataIterator *it = output->NewIterator();
+    for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextItem())
+      {
+      vtkDataSet *ds = vtkDataSet::SafeDownCast(it->GetCurrentDataObject());
+      if (!ds)
+        {
+        continue;
+        }
+
+      vtkDataArray *array = ds->GetPointData()->GetArray(variable.c_str());
+      if (!array)
+        {
+        array = ds->GetCellData()->GetArray(variable.c_str());
+        }
+      if (array && array->GetNumberOfTuples() > 0)
+        {
+        // Same component as the per-timestep ranges in mvReader:
+        double r[2];
+        array->GetRange(r);
+        range[0] = std::min(range[0], r[0]);
+        range[1] = std::max(range[1], r[1]);
+        }
+      }
+    it->Delete();
+    }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkMultiBlockDataSet>
+mvRangeScanner::read(mvFormatReader *format, const mvReadSettings &settings,
+                     int step)
+{
+  if (format)
+    {
+    return format->read(settings, step);
+    }
+  if (!settings.pieces.empty())
+    {
+    return m_pieceReader.read(settings, step);
+    }
+
+  mvIOLock lock;
+  m_reader->SetTimeStep(step);
+  m_reader->Update();
+  if (m_reader->GetAbortExecute())
+    {
+    // The output is incomplete, but the pipeline considers it current:
+    m_reader->SetAbortExecute(0);
+    m_reader->Modified();
+    return nullptr;
+    }
+  return m_reader->GetOutput();
+}
+
+//------------------------------------------------------------------------------
+bool mvRangeScanner::waitForTurn(unsigned long epoch)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_condition.wait(lock, [this]() { return m_quit || !m_paused; });
+  return !m_quit && epoch == m_epoch;
+}
+
+//------------------------------------------------------------------------------
+bool mvRangeScanner::interrupted() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_quit || m_paused || m_scanEpoch != m_epoch;
+}
+
+//------------------------------------------------------------------------------
+void mvRangeScanner::abortReader(vtkObject *caller, unsigned long, void *)
+{
+  if (this->interrupted())
+    {
+    static_cast<vtkExodusIIReader*>(caller)->SetAbortExecute(1);
+    }
+}
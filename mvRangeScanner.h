@@ -0,0 +1,147 @@
+#ifndef MVRANGESCANNER_H
+#define MVRANGESCANNER_H
+
+#include <vtkNew.h>
+
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mvFormatReader.h"
+#include "mvParallelReader.h"
+
+class mvStatisticsIndex;
+class vtkExodusIIReader;
+class vtkMultiBlockDataSet;
+class vtkObject;
+
+/**
+ * @brief The mvRangeScanner class computes the range of variables over all
+ * timesteps of a file on a low priority background thread.
+ *
+ * Variables passed to scan() are read one at a time, with no other result
+ * arrays enabled, for every timestep. A variable's range is published by
+ * globalRange() once all timesteps have been read, so consumers never see a
+ * partial range.
+ *
+ * If a statistics index is set, timesteps it already covers are not read,
+ * and the timesteps that are read are added to it.
+ *
+ * The scan yields to the foreground reader: pausing (see setPaused())
+ * abandons the timestep being read, and the worker waits to read it again
+ * until unpaused. A variable that a reader fails to read is reported as
+ * having no values. The worker owns a private vtkExodusIIReader. The public
+ * API is thread-safe.
+ */
+class mvRangeScanner
+{
+public:
+  mvRangeScanner();
+  ~mvRangeScanner();
+
+  /**
+   * The file to scan. Changing the file discards all ranges and pending
+   * work, including a scan in progress.
+   */
+  void setFileName(const std::string &fileName);
+
+  /**
+   * Notify the scanner that the file now has @a numSteps timesteps. If this
+   * is more than before, the ranges are discarded and rescanned to include
+   * the new timesteps. Timesteps in the statistics index are not reread.
+   */
+  void setNumberOfTimeSteps(int numSteps);
+
+  /**
+   * Queue @a variables for scanning. Variables that have been scanned or are
+   * already queued are ignored.
+   */
+  void scan(const std::set<std::string> &variables);
+
+  /**
+   * If true, the worker abandons the current timestep and waits until
+   * unpaused. Used to keep the scan from competing with foreground reads.
+   */
+  void setPaused(bool paused);
+
+  /**
+   * If the range of @a variable over all timesteps is known, copy it into
+   * @a range and return true.
+   */
+  bool globalRange(const std::string &variable, double range[2]) const;
+
+  /**
+   * If set, the index is consulted before reading a timestep, and updated
+   * with the timesteps read. @a index must outlive this object.
+   */
+  void setStatisticsIndex(mvStatisticsIndex *index);
+
+  /** Incremented each time a new range is published. */
+  unsigned long resultsVersion() const;
+
+private:
+  void workerLoop();
+
+  // Read variable at all timesteps. Returns false if interrupted. If the
+  // variable has no values or could not be read, range is left inverted.
+  // Called without m_mutex held.
+  bool scanVariable(const std::string &fileName, int numSteps,
+                    const std::string &variable,
+                    unsigned long epoch, mvStatisticsIndex *statistics,
+                    double range[2]);
+
+  // Reads step with the reader for settings. Returns nullptr if the read
+  // failed or was interrupted.
+  vtkSmartPointer<vtkMultiBlockDataSet> read(mvFormatReader *format,
+                                             const mvReadSettings &settings,
+                                             int step);
+
+  // Waits while paused. Returns false if the scan should stop.
+  bool waitForTurn(unsigned long epoch);
+
+  // True if the read in progress should be abandoned: the scanner is paused
+  // or quitting, or the file changed since m_scanEpoch.
+  bool interrupted() const;
+  void abortReader(vtkObject *caller, unsigned long, void *);
+
+private:
+  // Not implemented -- disable copy:
+  mvRangeScanner(const mvRangeScanner&);
+  mvRangeScanner& operator=(const mvRangeScanner&);
+
+private:
+  mutable std::mutex m_mutex;
+  std::condition_variable m_condition;
+  std::thread m_worker;
+  bool m_quit;
+  bool m_paused;
+
+  std::string m_fileName;
+  int m_numberOfTimeSteps;
+  // Incremented when the file changes, so that a running scan can detect it
+  // is stale.
+  unsigned long m_epoch;
+
+  std::deque<std::string> m_pending;
+  std::map<std::string, std::array<double, 2> > m_ranges;
+  std::set<std::string> m_missing; // Scanned, but no values were found.
+  unsigned long m_resultsVersion;
+  mvStatisticsIndex *m_statistics;
+
+  // Only used by the worker thread:
+  unsigned long m_scanEpoch; // The epoch of the scan in progress.
+  std::string m_piecesFileName; // The file m_pieces was found for.
+  std::vector<std::string> m_pieces;
+  vtkNew<vtkExodusIIReader> m_reader;
+  mvParallelReader m_pieceReader; // Joins decomposed datasets.
+  std::unique_ptr<mvFormatReader> m_formatReader; // Non-Exodus files.
+};
+
+#endif // MVRANGESCANNER_H
@@ -0,0 +1,193 @@
+#include "mvReadSettings.h"
+
+#include "mvIOLock.h"
+
+#include <vtkExodusIIReader.h>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <cctype>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+//------------------------------------------------------------------------------
+bool fileExists(const std::string &fileName)
+{
+  struct stat info;
+  return stat(fileName.c_str(), &info) == 0;
+}
+
+//------------------------------------------------------------------------------
+bool isNumber(const std::string &str)
+{
+  if (str.empty())
+    {
+    return false;
+    }
+  for (char c : str)
+    {
+    if (!std::isdigit(static_cast<unsigned char>(c)))
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Split "<base>.<count>.<rank>" into its parts.
+bool splitPieceName(const std::string &fileName, std::string &base,
+                    std::string &count, std::string &rank)
+{
+  const size_t rankDot = fileName.rfind('.');
+  if (rankDot == std::string::npos || rankDot == 0)
+    {
+    return false;
+    }
+  const size_t countDot = fileName.rfind('.', rankDot - 1);
+  if (countDot == std::string::npos)
+    {
+    return false;
+    }
+
+  base = fileName.substr(0, countDot);
+  count = fileName.substr(countDot + 1, rankDot - countDot - 1);
+  rank = fileName.substr(rankDot + 1);
+  return isNumber(count) && isNumber(rank) && rank.size() == count.size();
+}
+
+} // end anon namespace
+
+//------------------------------------------------------------------------------
+std::vector<std::string> mvReadSettings::findPieces(const std::string &fileName)
+{
+  std::vector<std::string> result;
+
+  std::string base;
+  std::string count;
+  std::string rank;
+  if (!splitPieceName(fileName, base, count, rank))
+    {
+    // Look for the pieces of "<base>" in its directory:
+    if (fileName.empty() || fileExists(fileName))
+      {
+      return result;
+      }
+
+    const size_t slash = fileName.rfind('/');
+    const std::string dir =
+        slash == std::string::npos ? std::string(".")
+                                   : fileName.substr(0, slash + 1);
+    const std::string prefix =
+        (slash == std::string::npos ? fileName : fileName.substr(slash + 1))
+        + ".";
+
+    DIR *handle = opendir(dir.c_str());
+    if (!handle)
+      {
+      return result;
+      }
+    std::string piece;
+    while (dirent *entry = readdir(handle))
+      {
+      const std::string name = entry->d_name;
+      if (name.compare(0, prefix.size(), prefix) == 0 &&
+          splitPieceName(name, base, count, rank) &&
+          base + "." == prefix)
+        {
+        piece = fileName + name.substr(prefix.size() - 1);
+        break;
+        }
+      }
+    closedir(handle);
+
+    if (piece.empty() || !splitPieceName(piece, base, count, rank))
+      {
+      return result;
+      }
+    }
+
+  const int numPieces = std::atoi(count.c_str());
+  if (numPieces < 1)
+    {
+    return result;
+    }
+
+  for (int i = 0; i < numPieces; ++i)
+    {
+    std::ostringstream name;
+    name << base << "." << count << "."
+         << std::setw(static_cast<int>(count.size())) << std::setfill('0')
+         << i;
+    if (!fileExists(name.str()))
+      {
+      std::cerr << "Decomposed dataset '" << base << "' is missing piece '"
+                << name.str() << "'. Reading '" << fileName << "' only."
+                << std::endl;
+      result.clear();
+      return result;
+      }
+    result.push_back(name.str());
+    }
+
+  return result;
+}
+
+//------------------------------------------------------------------------------
+void mvReadSettings::apply(vtkExodusIIReader *reader) const
+{
+  if (!reader->GetFileName() || this->fileName != reader->GetFileName())
+    {
+    mvIOLock lock;
+    reader->SetFileName(this->fileName.c_str());
+    reader->UpdateInformation();
+    }
+  if (this->numberOfTimeSteps > reader->GetNumberOfTimeSteps())
+    {
+    mvIOLock lock;
+    reader->UpdateTimeInformation();
+    reader->UpdateInformation();
+    }
+
+  const int numPointArrays = reader->GetNumberOfPointResultArrays();
+  for (int i = 0; i < numPointArrays; ++i)
+    {
+    std::string array = reader->GetPointResultArrayName(i);
+    reader->SetPointResultArrayStatus(
+          array.c_str(), this->variables.count(array) ? 1 : 0);
+    }
+  const int numElementArrays = reader->GetNumberOfElementResultArrays();
+  for (int i = 0; i < numElementArrays; ++i)
+    {
+    std::string array = reader->GetElementResultArrayName(i);
+    reader->SetElementResultArrayStatus(
+          array.c_str(), this->variables.count(array) ? 1 : 0);
+    }
+
+  const int numBlocks = reader->GetNumberOfObjects(vtkExodusIIReader::ELEM_BLOCK);
+  for (int i = 0; i < numBlocks; ++i)
+    {
+    std::string block = reader->GetObjectName(vtkExodusIIReader::ELEM_BLOCK, i);
+    reader->SetObjectStatus(vtkExodusIIReader::ELEM_BLOCK, i,
+                            this->excludedBlocks.count(block) ? 0 : 1);
+    }
+  const int numNodeSets = reader->GetNumberOfObjects(vtkExodusIIReader::NODE_SET);
+  for (int i = 0; i < numNodeSets; ++i)
+    {
+    std::string set = reader->GetObjectName(vtkExodusIIReader::NODE_SET, i);
+    reader->SetObjectStatus(vtkExodusIIReader::NODE_SET, i,
+                            this->nodeSets.count(set) ? 1 : 0);
+    }
+  const int numSideSets = reader->GetNumberOfObjects(vtkExodusIIReader::SIDE_SET);
+  for (int i = 0; i < numSideSets; ++i)
+    {
+    std::string set = reader->GetObjectName(vtkExodusIIReader::SIDE_SET, i);
+    reader->SetObjectStatus(vtkExodusIIReader::SIDE_SET, i,
+                            this->sideSets.count(set) ? 1 : 0);
+    }
+}
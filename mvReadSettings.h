@@ -0,0 +1,135 @@
+#ifndef MVREADSETTINGS_H
+#define MVREADSETTINGS_H
+
+#include <set>
+#include <string>
+#include <vector>
+
+class vtkExodusIIReader;
+
+/**
+ * @brief The mvReadSettings struct describes what mvReader loads from a file,
+ * independent of the timestep.
+ *
+ * mvReader owns several vtkExodusIIReader instances (the foreground reader and
+ * those used by background tasks). This struct collects the state that must
+ * be identical across them for their outputs to be interchangeable, and is
+ * used as the key that invalidates cached data when the user changes what is
+ * loaded.
+ */
+struct mvReadSettings
+{
+  /**
+   * The file that is read. For a decomposed dataset, this is the first piece,
+   * which also provides the metadata of the whole dataset.
+   */
+  std::string fileName;
+  std::set<std::string> variables;
+
+  /**
+   * The files of a spatially decomposed dataset (see findPieces()), or empty
+   * if fileName holds the complete mesh. Readers configured with apply() only
+   * load fileName; mvParallelReader reads and joins all pieces.
+   */
+  std::vector<std::string> pieces;
+
+  /**
+   * The other runs of an ensemble that are read along with fileName and laid
+   * out side by side (see mvEnsembleReader), or empty to read fileName only.
+   * Readers configured with apply() ignore them.
+   */
+  std::vector<std::string> runs;
+
+  /**
+   * The number of timesteps known to be in the file. If a reader has fewer,
+   * apply() re-reads its time information, so that timesteps appended while
+   * the file is open can be read. Not compared by operator==, since existing
+   * timesteps are unaffected. Default is 0.
+   */
+  int numberOfTimeSteps = 0;
+
+  /**
+   * If true, the data is converted to single precision after reading (see
+   * mvSinglePrecision). Readers are unaffected; whoever reads with these
+   * settings performs the conversion. Default is false.
+   */
+  bool singlePrecision = false;
+
+  /**
+   * If true, whoever reads with these settings tries mvNativeReader before
+   * vtkExodusIIReader. Not compared by operator==, since both produce the
+   * same datasets. Default is false.
+   */
+  bool nativeReader = false;
+
+  /** Element blocks that are not read. All blocks are read by default. */
+  std::set<std::string> excludedBlocks;
+
+  /** Node sets and side sets that are read. No sets are read by default. @{ */
+  std::set<std::string> nodeSets;
+  std::set<std::string> sideSets;
+  /** @} */
+
+  /**
+   * True if every element block and no set is read from fileName alone.
+   * Datasets read with the default objects always have the same block
+   * structure, which the on-disk caches rely on.
+   */
+  bool defaultObjects() const;
+
+  /**
+   * True if @a other reads the same files and the same blocks and sets, i.e.
+   * the two produce datasets with the same structure.
+   */
+  bool sameObjects(const mvReadSettings &other) const;
+
+  /**
+   * If @a fileName is part of a decomposed output written by N processes, as
+   * "<base>.N.i" with i zero-padded to the width of N (the Nemesis
+   * convention used by MOOSE), return the N piece filenames in rank order.
+   * @a fileName may also be "<base>" if that file does not exist. Returns an
+   * empty list if @a fileName is not decomposed or a piece is missing.
+   */
+  static std::vector<std::string> findPieces(const std::string &fileName);
+
+  /**
+   * Configure @a reader to load the data described by these settings. The
+   * timestep is not modified. The reader's information is updated if the
+   * filename changes.
+   */
+  void apply(vtkExodusIIReader *reader) const;
+
+  bool operator==(const mvReadSettings &other) const;
+  bool operator!=(const mvReadSettings &other) const;
+};
+
+//------------------------------------------------------------------------------
+inline bool mvReadSettings::defaultObjects() const
+{
+  return this->excludedBlocks.empty() && this->nodeSets.empty() &&
+      this->sideSets.empty() && this->runs.empty();
+}
+
+//------------------------------------------------------------------------------
+inline bool mvReadSettings::sameObjects(const mvReadSettings &other) const
+{
+  return this->fileName == other.fileName && this->runs == other.runs &&
+      this->excludedBlocks == other.excludedBlocks &&
+      this->nodeSets == other.nodeSets &&
+      this->sideSets == other.sideSets;
+}
+
+//------------------------------------------------------------------------------
+inline bool mvReadSettings::operator==(const mvReadSettings &other) const
+{
+  return this->sameObjects(other) && this->variables == other.variables &&
+      this->singlePrecision == other.singlePrecision;
+}
+
+//------------------------------------------------------------------------------
+inline bool mvReadSettings::operator!=(const mvReadSettings &other) const
+{
+  return !(*this == other);
+}
+
+#endif // MVREADSETTINGS_H
@@ -1,6 +1,7 @@
 #include "mvReader.h"
 
 #include <vtkCellData.h>
+#include <vtkCommand.h>
 #include <vtkCompositeDataIterator.h>
 #include <vtkDataArray.h>
 #include <vtkDataSet.h>
@@ -15,23 +16,76 @@
 #include <vtkTimerLog.h>
 
 #include "mvApplicationState.h"
+#include "mvIOLock.h"
+#include "mvMemoryBudget.h"
+#include "mvProductFilters.h"
+#include "mvSinglePrecision.h"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
+#include <iterator>
 
 //------------------------------------------------------------------------------
 mvReader::mvReader()
-  : m_numberOfTimeSteps(0),
+  : m_applyReaderSettings(false),
+    m_statisticsSaveTime(0.),
+    m_prefetchWindow(0),
+    m_prefetchWraps(false),
+    m_dataTimeStep(-1),
+    m_incrementalVariables(true),
+    m_requestedTimeStep(0),
+    m_cancelSuperseded(true),
+    m_readCancelled(false),
+    m_readFailed(false),
+    m_failedTimeStep(-1),
+    m_singlePrecision(false),
+    m_useNativeReader(false),
+    m_memoryBudget(nullptr),
+    m_readEstimate(0),
+    m_readThreads(1),
+    m_syncedReadThreads(1),
+    m_benchmark(false),
+    m_informationReaderVersion(0),
+    m_informationVersion(0),
+    m_informationComplete(true),
+    m_sideBySide(false),
+    m_globalVariablesRequested(false),
+    m_globalRanges(false),
+    m_rangesVersion(0),
+    m_reducerProducts(nullptr),
+    m_reducerStep(-1),
+    m_reducerAllowed(true),
+    m_watcherVersion(0),
+    m_followLatest(false),
+    m_numberOfTimeSteps(0),
     m_timeStep(0),
     m_timeStepRange{0, 0},
     m_timeRange{0., 0.}
 {
-  m_reducer->SetSamplingDimensions(64, 64, 64);
+  // The array cache of the foreground reader is what lets a timestep change
+  // skip re-reading the coordinates and connectivity from disk. The mesh
+  // arrays are touched on every read, so the LRU cache keeps them while result
+  // arrays cycle through. The other readers keep VTK's default.
+  m_reader->SetCacheSize(1024.);
+  m_reader->AddObserver(vtkCommand::ProgressEvent, this,
+                        &mvReader::abortSupersededRead);
+  m_arrayReader->AddObserver(vtkCommand::ProgressEvent, this,
+                             &mvReader::abortSupersededRead);
+  m_timeStepCache.setSharedTopology(&m_sharedTopology);
+  m_nativeReader.setSharedTopology(&m_sharedTopology);
+  m_timeSeries.setSharedTopology(&m_sharedTopology);
+  m_timeStepCache.setColumnarCache(&m_columnarCache);
+  m_timeStepCache.setStatisticsIndex(&m_statistics);
+  m_rangeScanner.setStatisticsIndex(&m_statistics);
+  this->setPrefetchWindow(4);
+  mvProductFilters::setupReducer(m_reducer.Get());
 }
 
 //------------------------------------------------------------------------------
 mvReader::~mvReader()
 {
+  this->setMemoryBudget(nullptr);
 }
 
 //------------------------------------------------------------------------------
@@ -52,6 +106,16 @@ void mvReader::clearRequestedVariables()
   m_requestedVariables.clear();
 }
 
+//------------------------------------------------------------------------------
+void mvReader::setRequestedVariables(const Variables &variables)
+{
+  m_requestedVariables = variables;
+  if (m_informationComplete)
+    {
+    this->dropUnavailableVariables();
+    }
+}
+
 //------------------------------------------------------------------------------
 void mvReader::requestVariable(const std::string &variable)
 {
@@ -71,76 +135,853 @@ void mvReader::unrequestVariable(const std::string &variable)
   m_requestedVariables.erase(variable);
 }
 
+//------------------------------------------------------------------------------
+void mvReader::setObjectSelected(ObjectType type, const std::string &name,
+                                 bool selected)
+{
+  switch (type)
+    {
+    case ObjectType::ElementBlock:
+      if (selected)
+        {
+        m_excludedBlocks.erase(name);
+        }
+      else
+        {
+        m_excludedBlocks.insert(name);
+        }
+      break;
+
+    case ObjectType::NodeSet:
+      if (selected)
+        {
+        m_selectedNodeSets.insert(name);
+        }
+      else
+        {
+        m_selectedNodeSets.erase(name);
+        }
+      break;
+
+    case ObjectType::SideSet:
+      if (selected)
+        {
+        m_selectedSideSets.insert(name);
+        }
+      else
+        {
+        m_selectedSideSets.erase(name);
+        }
+      break;
+    }
+}
+
+//------------------------------------------------------------------------------
+void mvReader::setPrefetchWindow(int steps)
+{
+  m_prefetchWindow = std::max(0, steps);
+
+  // Hold the window plus the current timestep:
+  m_timeStepCache.setCapacity(m_prefetchWindow > 0 ? m_prefetchWindow + 1 : 0);
+}
+
+//------------------------------------------------------------------------------
+void mvReader::setReadThreads(int threads)
+{
+  m_readThreads = threads;
+}
+
+//------------------------------------------------------------------------------
+void mvReader::setBenchmark(bool bench)
+{
+  m_benchmark = bench;
+  m_timeStepCache.setBenchmark(bench);
+  m_timeSeries.setBenchmark(bench);
+  this->vvReader::setBenchmark(bench);
+}
+
+//------------------------------------------------------------------------------
+void mvReader::setRuns(const std::vector<std::string> &files)
+{
+  m_runs = files;
+  if (!m_runs.empty() && this->activeRun() < 0)
+    {
+    this->setActiveRun(0);
+    }
+}
+
+//------------------------------------------------------------------------------
+int mvReader::activeRun() const
+{
+  auto it = std::find(m_runs.begin(), m_runs.end(), m_fileName);
+  return it != m_runs.end() ? static_cast<int>(it - m_runs.begin()) : -1;
+}
+
+//------------------------------------------------------------------------------
+void mvReader::setActiveRun(int run)
+{
+  if (run >= 0 && run < static_cast<int>(m_runs.size()))
+    {
+    this->setFileName(m_runs[run]);
+    }
+}
+
+//------------------------------------------------------------------------------
+void mvReader::requestInformation()
+{
+  this->updatePieces();
+  const std::string fileName = m_pieces.empty() ? m_fileName
+                                                : m_pieces.front();
+
+  // Present an empty file until the new metadata arrives, and install the
+  // metadata again if it was read before:
+  mvInformationReader::Information info;
+  info.fileName = fileName;
+  this->installInformation(info);
+  m_informationComplete = fileName.empty();
+  m_informationReader.request(fileName);
+  m_informationReaderVersion = 0;
+}
+
+//------------------------------------------------------------------------------
+double mvReader::timeValue(int step) const
+{
+  if (step >= 0 && step < static_cast<int>(m_times.size()))
+    {
+    return m_times[step];
+    }
+  if (m_numberOfTimeSteps < 2)
+    {
+    return m_timeRange[0];
+    }
+  return m_timeRange[0] + (m_timeRange[1] - m_timeRange[0]) * step /
+      (m_numberOfTimeSteps - 1);
+}
+
+//------------------------------------------------------------------------------
+void mvReader::requestTimeSeries(const std::string &variable,
+                                 const double position[3])
+{
+  const mvReadSettings settings = this->readSettings();
+  if (mvFormatReader::isExodus(settings.fileName))
+    {
+    m_timeSeries.request(settings, variable, position);
+    }
+}
+
+//------------------------------------------------------------------------------
+void mvReader::setMemoryBudget(mvMemoryBudget *budget)
+{
+  if (m_memoryBudget)
+    {
+    m_memoryBudget->setEvictor("Cached timesteps", nullptr);
+    m_memoryBudget->setUsage("Reader array cache", static_cast<size_t>(0),
+                             mvMemoryBudget::Priority::Visible);
+    }
+  m_memoryBudget = budget;
+  m_timeStepCache.setMemoryBudget(budget);
+  if (m_memoryBudget)
+    {
+    m_memoryBudget->setEvictor("Cached timesteps", [this](size_t bytes)
+      {
+      return m_timeStepCache.trim(bytes);
+      });
+    }
+}
+
+//------------------------------------------------------------------------------
+void mvReader::update(vvApplicationState &state)
+{
+  // Pick up appended timesteps before syncing the reader state. A stream is
+  // always followed, since its timesteps only arrive while it is open:
+  m_watcher.setFileName(m_syncedSettings.fileName);
+  if (mvFormatReader::isStream(m_syncedSettings.fileName) &&
+      !m_watcher.enabled())
+    {
+    m_watcher.setEnabled(true);
+    }
+  const unsigned long watcherVersion = m_watcher.version();
+  if (watcherVersion != m_watcherVersion)
+    {
+    m_watcherVersion = watcherVersion;
+    this->appendTimeSteps();
+    }
+
+  // Install the metadata read in the background since the last update:
+  if (!m_informationComplete)
+    {
+    const unsigned long version = m_informationReader.version();
+    if (version != m_informationReaderVersion)
+      {
+      m_informationReaderVersion = version;
+      mvInformationReader::Information info;
+      m_informationReader.information(info);
+      if (info.fileName == (m_pieces.empty() ? m_fileName : m_pieces.front()))
+        {
+        this->installInformation(info);
+        m_informationComplete = info.complete;
+        }
+      }
+    }
+
+  // Let background work on other timesteps know that it is superseded:
+  m_requestedTimeStep = m_timeStep;
+
+  this->vvReader::update(state);
+  this->schedulePrefetch();
+
+  // Global variables are read once per file, and again as it grows:
+  if (m_globalVariablesRequested && !m_fileName.empty() &&
+      mvFormatReader::isExodus(m_fileName))
+    {
+    mvReadSettings globals;
+    globals.fileName = m_pieces.empty() ? m_fileName : m_pieces.front();
+    globals.numberOfTimeSteps = m_numberOfTimeSteps;
+    m_timeSeries.requestGlobalVariables(globals);
+    }
+
+  if (m_globalRanges)
+    {
+    m_rangeScanner.setFileName(m_syncedSettings.fileName);
+    m_rangeScanner.setNumberOfTimeSteps(m_numberOfTimeSteps);
+    m_rangeScanner.scan(m_requestedVariables);
+
+    const unsigned long version = m_rangeScanner.resultsVersion();
+    if (version != m_rangesVersion)
+      {
+      m_rangesVersion = version;
+      if (this->updateMetaDataRanges())
+        {
+        m_metaDataMTime.Modified();
+        }
+      }
+    }
+}
+
+//------------------------------------------------------------------------------
+void mvReader::appendTimeSteps()
+{
+  const int numSteps = m_watcher.numberOfTimeSteps();
+  if (numSteps <= m_numberOfTimeSteps)
+    {
+    return;
+    }
+
+  m_numberOfTimeSteps = numSteps;
+  m_timeStepRange[1] = m_timeStepRange[0] + numSteps - 1;
+  double range[2];
+  m_watcher.timeRange(range);
+  m_timeRange[1] = range[1];
+
+  // The readers catch up in syncReaderState through
+  // mvReadSettings::numberOfTimeSteps.
+  if (m_followLatest)
+    {
+    m_timeStep = m_timeStepRange[1];
+    }
+}
+
+//------------------------------------------------------------------------------
+void mvReader::setGlobalRanges(bool global)
+{
+  if (global != m_globalRanges)
+    {
+    m_globalRanges = global;
+    if (this->updateMetaDataRanges())
+      {
+      m_metaDataMTime.Modified();
+      }
+    }
+}
+
+//------------------------------------------------------------------------------
+const mvProductCache *mvReader::products() const
+{
+  if (m_dataTimeStep < 0 || !m_dataSettings.defaultObjects() ||
+      !m_dataSettings.pieces.empty() || !m_products.available() ||
+      m_products.dataFile() != m_dataSettings.fileName)
+    {
+    return nullptr;
+    }
+
+  // The products must hold every loaded variable:
+  const mvProductCache::Variables stored = m_products.variables();
+  return std::includes(stored.begin(), stored.end(),
+                       m_dataSettings.variables.begin(),
+                       m_dataSettings.variables.end()) ? &m_products
+                                                       : nullptr;
+}
+
+//------------------------------------------------------------------------------
+bool mvReader::histogram(const std::string &variable, const double range[2],
+                         float *bins, int numBins) const
+{
+  return m_dataSettings.defaultObjects() &&
+      m_dataSettings.variables.count(variable) &&
+      m_statistics.histogram(variable, m_dataTimeStep, range, bins, numBins);
+}
+
+//------------------------------------------------------------------------------
+bool mvReader::blockStatistics(const std::string &variable, unsigned int block,
+                               mvStatisticsIndex::Statistics &stats) const
+{
+  return m_dataSettings.defaultObjects() &&
+      m_dataSettings.variables.count(variable) &&
+      m_statistics.find(variable, m_dataTimeStep, block, stats);
+}
+
 //------------------------------------------------------------------------------
 void mvReader::syncReaderState()
 {
-  m_reader->SetFileName(m_fileName.c_str());
+  this->updatePieces();
+
+  // Opening another file reads all of its metadata, which is left to the data
+  // update thread so that update() does not block:
+  const mvReadSettings settings = this->readSettings();
+  const bool exodus = mvFormatReader::isExodus(settings.fileName);
+  // So does rereading the time information of a file that grew, which would
+  // wait here for any background read holding the I/O lock:
+  m_applyReaderSettings = exodus &&
+      (!m_reader->GetFileName() ||
+       settings.fileName != m_reader->GetFileName() ||
+       settings.numberOfTimeSteps > m_reader->GetNumberOfTimeSteps());
+  if (exodus && !m_applyReaderSettings)
+    {
+    settings.apply(m_reader.Get());
+    }
+  m_statistics.setFileName(settings.fileName);
+  m_products.open(settings.fileName);
   m_reader->SetTimeStep(m_timeStep);
+  if (m_dataObject &&
+      m_dataSettings.singlePrecision != settings.singlePrecision)
+    {
+    // Nothing in the reader changed, but the data must be reread:
+    m_reader->Modified();
+    }
+  else if ((!exodus || m_applyReaderSettings || !settings.runs.empty() ||
+            !m_dataSettings.runs.empty()) &&
+           (!m_dataObject || m_dataSettings != settings))
+    {
+    // Other formats and ensembles are read by m_formatReader and
+    // m_ensembleReader, and new files are opened later, but m_reader's
+    // modification time still drives dataNeedsUpdate():
+    m_reader->Modified();
+    }
+
+  // Discards the cached timesteps if the settings changed:
+  m_timeStepCache.setReadSettings(settings);
+  if (settings.fileName != m_syncedSettings.fileName ||
+      settings.runs != m_syncedSettings.runs)
+    {
+    // Another file or run, whose meshes the reference ones won't match:
+    m_sharedTopology.clear();
+    }
+  m_syncedSettings = settings;
+  m_syncedReadThreads = m_readThreads;
+  this->syncMemoryBudget();
 
-  // Sync variables:
-  const int numPointArrays = m_reader->GetNumberOfPointResultArrays();
-  for (int i = 0; i < numPointArrays; ++i)
+  m_addedVariables.clear();
+  m_droppedVariables.clear();
+  m_mergeBase = nullptr;
+
+  // Update the current dataset in place if only the variables changed:
+  if (!m_incrementalVariables || !m_dataObject || !settings.pieces.empty() ||
+      !settings.runs.empty() ||
+      m_dataTimeStep != m_timeStep ||
+      !m_dataSettings.sameObjects(settings) ||
+      m_dataSettings.singlePrecision != settings.singlePrecision ||
+      m_dataSettings.variables == settings.variables)
+    {
+    return;
+    }
+
+  const Variables &loaded = m_dataSettings.variables;
+  std::set_difference(m_requestedVariables.begin(), m_requestedVariables.end(),
+                      loaded.begin(), loaded.end(),
+                      std::inserter(m_addedVariables, m_addedVariables.end()));
+  std::set_difference(loaded.begin(), loaded.end(),
+                      m_requestedVariables.begin(), m_requestedVariables.end(),
+                      std::inserter(m_droppedVariables,
+                                    m_droppedVariables.end()));
+
+  if (!m_addedVariables.empty())
     {
-    std::string array = m_reader->GetPointResultArrayName(i);
-    m_reader->SetPointResultArrayStatus(
-          array.c_str(), this->isVariableRequested(array) ? 1 : 0);
+    // Read just the new arrays in executeReaderData. They are about as large
+    // as the loaded ones:
+    m_arrayReader->SetTimeStep(m_timeStep);
+    m_mergeBase = this->typedDataObject();
+    m_readEstimate = m_readEstimate * m_addedVariables.size() /
+        std::max<size_t>(1, loaded.size());
     }
-  const int numElementArrays = m_reader->GetNumberOfElementResultArrays();
-  for (int i = 0; i < numElementArrays; ++i)
+  else
     {
-    std::string array = m_reader->GetElementResultArrayName(i);
-    m_reader->SetElementResultArrayStatus(
-          array.c_str(), this->isVariableRequested(array) ? 1 : 0);
+    // Nothing to read. Installing the new dataset after the reader state was
+    // modified above keeps dataNeedsUpdate() from starting a read.
+    vtkSmartPointer<vtkMultiBlockDataSet> pruned =
+        mergeVariables(this->typedDataObject(), m_droppedVariables, nullptr);
+    this->installDataObject(pruned, m_dataTimeStep, settings);
+    m_timeStepCache.insert(m_dataTimeStep, pruned);
+    m_droppedVariables.clear();
     }
 }
 
 //------------------------------------------------------------------------------
 bool mvReader::dataNeedsUpdate()
 {
-  return !m_dataObject || m_dataObject->GetMTime() < m_reader->GetMTime();
+  if (m_dataObject && m_dataObject->GetMTime() >= m_reader->GetMTime())
+    {
+    return false;
+    }
+
+  // Publish the requested timestep immediately if it has been prefetched:
+  mvTimeStepCache::DataObject cached = m_timeStepCache.find(m_timeStep);
+  if (cached)
+    {
+    this->installDataObject(cached, m_timeStep, m_syncedSettings);
+    return false;
+    }
+
+  // Don't retry a failed read until the timestep or the settings change:
+  return m_timeStep != m_failedTimeStep ||
+      m_syncedSettings != m_failedSettings;
 }
 
 //------------------------------------------------------------------------------
 void mvReader::executeReaderInformation()
 {
-  m_reader->UpdateInformation();
+  mvFormatReader *format = mvFormatReader::forFile(m_formatReader, m_fileName);
+  if (format)
+    {
+    if (!format->readInformation(m_formatInformation))
+      {
+      m_formatInformation = mvFormatReader::Information();
+      }
+    }
+  else
+    {
+    mvIOLock lock;
+    this->applyReaderSettings();
+    m_reader->UpdateInformation();
+    }
 }
 
 //------------------------------------------------------------------------------
 void mvReader::executeReaderData()
 {
-  m_reader->Update();
+  const int step = m_mergeBase ? m_arrayReader->GetTimeStep()
+                               : m_reader->GetTimeStep();
+  m_readCancelled = this->superseded(step);
+  m_readFailed = false;
+  if (m_readCancelled)
+    {
+    return;
+    }
+
+  // Keep the range scan off the disk while the user waits on this read:
+  m_rangeScanner.setPaused(true);
+
+  // Make room for the new data. It replaces the dataset on screen, so it is
+  // read even if it does not fit:
+  if (m_memoryBudget &&
+      !m_memoryBudget->request(m_readEstimate,
+                               mvMemoryBudget::Priority::Visible) &&
+      m_benchmark)
+    {
+    std::cerr << "mvReader: Timestep " << step << " needs about "
+              << (m_readEstimate >> 20) << " MiB, which exceeds the memory "
+                 "budget." << std::endl;
+    }
+  this->applyReaderSettings();
+  m_nativeReader.setAbortCheck([this, step]()
+    {
+    return this->superseded(step);
+    });
+  const bool ensemble = !m_syncedSettings.runs.empty();
+  mvFormatReader *format = ensemble ? nullptr :
+      mvFormatReader::forFile(m_formatReader, m_syncedSettings.fileName);
+  if (format)
+    {
+    format->setAbortCheck([this, step]()
+      {
+      return this->superseded(step);
+      });
+    }
+
+  if (m_mergeBase)
+    {
+    mvReadSettings added = m_syncedSettings;
+    added.variables = m_addedVariables;
+    vtkSmartPointer<vtkMultiBlockDataSet> arrays;
+    if (format)
+      {
+      arrays = format->read(added, step);
+      }
+    else if (added.nativeReader)
+      {
+      arrays = m_nativeReader.read(added, step);
+      }
+    if (!arrays && !format && !this->superseded(step))
+      {
+      mvIOLock lock;
+      added.apply(m_arrayReader.Get());
+      m_arrayReader->Update();
+      if (m_arrayReader->GetAbortExecute())
+        {
+        // The output is incomplete, but the pipeline considers it current:
+        m_arrayReader->SetAbortExecute(0);
+        m_arrayReader->Modified();
+        }
+      else
+        {
+        arrays = m_arrayReader->GetOutput();
+        }
+      }
+
+    if (!arrays)
+      {
+      m_readCancelled = true;
+      m_readFailed = !this->superseded(step);
+      }
+    else
+      {
+      m_mergedOutput = mergeVariables(m_mergeBase, m_droppedVariables, arrays);
+      m_statistics.add(added, step, arrays);
+      if (m_syncedSettings.singlePrecision)
+        {
+        m_mergedOutput = mvSinglePrecision::convert(m_mergedOutput);
+        }
+      }
+    }
+  else
+    {
+    const double start = vtkTimerLog::GetUniversalTime();
+    const char *source = "compressed cache";
+    bool threaded = false;
+    // Compressed timesteps were indexed and converted when first read:
+    m_readerOutput = m_timeStepCache.decompress(step);
+    const bool decoded = m_readerOutput != nullptr;
+    if (!decoded)
+      {
+      source = "columnar cache";
+      m_readerOutput = m_columnarCache.load(m_syncedSettings, step);
+      }
+    if (!m_readerOutput)
+      {
+      if (ensemble)
+        {
+        source = "ensemble";
+        m_ensembleReader.setAbortCheck([this, step]()
+          {
+          return this->superseded(step);
+          });
+        m_readerOutput = m_ensembleReader.read(m_syncedSettings, step);
+        }
+      else if (format)
+        {
+        source = format->formatName();
+        m_readerOutput = format->read(m_syncedSettings, step);
+        }
+      else if (m_syncedSettings.nativeReader)
+        {
+        // Falls back to vtkExodusIIReader below if unsupported:
+        source = "native";
+        m_readerOutput = m_nativeReader.read(m_syncedSettings, step);
+        }
+      if (!m_readerOutput && !format && !ensemble && !this->superseded(step))
+        {
+        if (!m_syncedSettings.pieces.empty())
+          {
+          source = "decomposed";
+          threaded = true;
+          m_parallelReader.setNumberOfThreads(m_syncedReadThreads);
+          m_parallelReader.setAbortCheck([this, step]()
+            {
+            return this->superseded(step);
+            });
+          m_readerOutput = m_parallelReader.read(m_syncedSettings, step);
+          }
+        else if (m_syncedReadThreads != 1)
+          {
+          source = "parallel";
+          threaded = true;
+          m_parallelReader.setNumberOfThreads(m_syncedReadThreads);
+          m_parallelReader.setAbortCheck([this, step]()
+            {
+            return this->superseded(step);
+            });
+          m_readerOutput = m_parallelReader.read(m_syncedSettings, step);
+          }
+        else
+          {
+          source = "serial";
+          mvIOLock lock;
+          m_reader->Update();
+          m_readerOutput = m_reader->GetOutput();
+          if (m_reader->GetAbortExecute())
+            {
+            // The output is incomplete, but the pipeline considers it
+            // current:
+            m_reader->SetAbortExecute(0);
+            m_reader->Modified();
+            m_readerOutput = nullptr;
+            }
+          }
+        }
+
+      if (!m_readerOutput)
+        {
+        if (m_benchmark)
+          {
+          std::cerr << "mvReader abandoned the " << source << " read of "
+                       "timestep " << step << " after "
+                    << vtkTimerLog::GetUniversalTime() - start << " s."
+                    << std::endl;
+          }
+        m_readCancelled = true;
+        m_readFailed = !this->superseded(step);
+        m_rangeScanner.setPaused(false);
+        return;
+        }
+      m_columnarCache.store(m_syncedSettings, step, m_readerOutput);
+      }
+
+    if (m_benchmark)
+      {
+      const double seconds = vtkTimerLog::GetUniversalTime() - start;
+      const double mib = m_readerOutput->GetActualMemorySize() / 1024.;
+      std::cerr << "mvReader read timestep " << step << " (" << source;
+      if (threaded)
+        {
+        std::cerr << ", " << m_parallelReader.lastReadThreads() << " threads";
+        }
+      std::cerr << "): " << mib << " MiB in " << seconds << " s ("
+                << (seconds > 0. ? mib / seconds : 0.) << " MiB/s)"
+                << std::endl;
+      }
+
+    // The statistics are computed before any conversion, so they are exact:
+    if (!decoded)
+      {
+      m_statistics.add(m_syncedSettings, step, m_readerOutput);
+      if (m_syncedSettings.singlePrecision)
+        {
+        m_readerOutput = mvSinglePrecision::convert(m_readerOutput);
+        }
+      }
+    m_sharedTopology.share(m_readerOutput);
+    }
+
+  // Persist new statistics every few seconds, off the main thread. The rest
+  // is saved when the index is destroyed:
+  const double now = vtkTimerLog::GetUniversalTime();
+  if (now - m_statisticsSaveTime > 10.)
+    {
+    m_statistics.save();
+    m_statisticsSaveTime = now;
+    }
+
+  m_rangeScanner.setPaused(false);
 }
 
 //------------------------------------------------------------------------------
 void mvReader::updateInformationCache()
 {
-  m_numberOfTimeSteps = m_reader->GetNumberOfTimeSteps();
-  m_reader->GetTimeStepRange(m_timeStepRange);
-  vtkInformation *info = m_reader->GetOutputInformation(0);
-  info->Get(vtkStreamingDemandDrivenPipeline::TIME_RANGE(), m_timeRange);
-
-  // Set available arrays:
-  m_availableVariables.clear();
-  const int numPointArrays = m_reader->GetNumberOfPointResultArrays();
-  for (int i = 0; i < numPointArrays; ++i)
+  mvInformationReader::Information info;
+  if (m_formatReader)
     {
-    m_availableVariables.insert(m_reader->GetPointResultArrayName(i));
+    mvInformationReader::fromFormat(m_formatInformation, info);
     }
-  const int numElementArrays = m_reader->GetNumberOfElementResultArrays();
-  for (int i = 0; i < numElementArrays; ++i)
+  else
     {
-    m_availableVariables.insert(m_reader->GetElementResultArrayName(i));
+    mvInformationReader::fromReader(m_reader.Get(), info);
     }
+  this->installInformation(info);
+  m_informationComplete = true;
 }
 
 //------------------------------------------------------------------------------
 void mvReader::updateDataCache()
+{
+  if (m_readCancelled)
+    {
+    // Nothing new was read. dataNeedsUpdate() still reports the current
+    // timestep as missing, so the next update() starts its read, unless the
+    // read failed rather than being superseded:
+    if (m_readFailed)
+      {
+      m_failedTimeStep = m_mergeBase ? m_arrayReader->GetTimeStep()
+                                     : m_reader->GetTimeStep();
+      m_failedSettings = m_syncedSettings;
+      std::cerr << "mvReader: Unable to read timestep " << m_failedTimeStep
+                << " of '" << m_failedSettings.fileName << "'." << std::endl;
+      }
+    m_mergeBase = nullptr;
+    m_readerOutput = nullptr;
+    return;
+    }
+
+  if (m_mergedOutput)
+    {
+    this->installDataObject(m_mergedOutput, m_arrayReader->GetTimeStep(),
+                            m_syncedSettings);
+    m_mergeBase = nullptr;
+    m_mergedOutput = nullptr;
+    }
+  else
+    {
+    this->installDataObject(m_readerOutput, m_reader->GetTimeStep(),
+                            m_syncedSettings);
+    m_readerOutput = nullptr;
+    }
+
+  // Keep the new timestep around in case the user steps back to it:
+  m_timeStepCache.insert(m_dataTimeStep, this->typedDataObject());
+}
+
+//------------------------------------------------------------------------------
+mvReadSettings mvReader::readSettings() const
+{
+  mvReadSettings settings;
+  settings.fileName = m_pieces.empty() ? m_fileName : m_pieces.front();
+  settings.pieces = m_pieces;
+  settings.numberOfTimeSteps = m_numberOfTimeSteps;
+  settings.singlePrecision = m_singlePrecision;
+  settings.nativeReader = m_useNativeReader &&
+      mvFormatReader::isExodus(settings.fileName);
+  settings.variables = m_requestedVariables;
+  if (m_sideBySide)
+    {
+    for (const std::string &run : m_runs)
+      {
+      if (run != m_fileName)
+        {
+        settings.runs.push_back(run);
+        }
+      }
+    }
+  settings.excludedBlocks = m_excludedBlocks;
+  settings.nodeSets = m_selectedNodeSets;
+  settings.sideSets = m_selectedSideSets;
+  return settings;
+}
+
+//------------------------------------------------------------------------------
+void mvReader::updatePieces()
+{
+  if (m_fileName != m_piecesFileName)
+    {
+    m_piecesFileName = m_fileName;
+    m_pieces = mvReadSettings::findPieces(m_fileName);
+    if (!m_pieces.empty())
+      {
+      std::cerr << "Reading '" << m_fileName << "' as a dataset decomposed "
+                   "into " << m_pieces.size() << " pieces." << std::endl;
+      }
+    }
+}
+
+//------------------------------------------------------------------------------
+void mvReader::installInformation(
+    const mvInformationReader::Information &info)
+{
+  m_numberOfTimeSteps = info.numberOfTimeSteps;
+  m_timeStepRange[0] = 0;
+  m_timeStepRange[1] = std::max(0, info.numberOfTimeSteps - 1);
+  m_timeRange[0] = info.timeRange[0];
+  m_timeRange[1] = info.timeRange[1];
+  m_times = info.times;
+  m_availableVariables = info.variables;
+  m_availableBlocks = info.blocks;
+  m_availableNodeSets = info.nodeSets;
+  m_availableSideSets = info.sideSets;
+
+  // Until the first timestep is read, the bounds of the mesh stand in for
+  // those of the data. They only cover the first piece and run:
+  if (!m_dataObject && info.bounds.IsValid() && m_pieces.empty() &&
+      (!m_sideBySide || m_runs.size() < 2))
+    {
+    m_bounds = info.bounds;
+    }
+  if (info.complete)
+    {
+    this->dropUnavailableVariables();
+    }
+  ++m_informationVersion;
+}
+
+//------------------------------------------------------------------------------
+void mvReader::dropUnavailableVariables()
+{
+  for (Variables::iterator it = m_requestedVariables.begin();
+       it != m_requestedVariables.end();)
+    {
+    if (this->isVariableAvailable(*it))
+      {
+      ++it;
+      continue;
+      }
+    std::cerr << "Ignoring request for variable '" << *it << "', as it is "
+                 "not available in '" << m_fileName << "'." << std::endl;
+    it = m_requestedVariables.erase(it);
+    }
+}
+
+//------------------------------------------------------------------------------
+void mvReader::applyReaderSettings()
+{
+  if (m_applyReaderSettings)
+    {
+    m_syncedSettings.apply(m_reader.Get());
+    m_applyReaderSettings = false;
+    }
+}
+
+//------------------------------------------------------------------------------
+void mvReader::syncMemoryBudget()
+{
+  m_readEstimate = 0;
+  if (!m_memoryBudget)
+    {
+    return;
+    }
+
+  // Give the array cache at most a quarter of the budget. It is counted at
+  // its capacity, which it fills as timesteps are read:
+  const double MiB = 1024. * 1024.;
+  const size_t limit = m_memoryBudget->limit();
+  const double cacheSize = limit > 0 ? std::min(1024., limit / MiB / 4.)
+                                     : 1024.;
+  if (m_reader->GetCacheSize() != cacheSize)
+    {
+    m_reader->SetCacheSize(cacheSize);
+    }
+  m_memoryBudget->setUsage(
+        "Reader array cache",
+        static_cast<size_t>((m_reader->GetCacheSize() +
+                              m_arrayReader->GetCacheSize()) * MiB),
+        mvMemoryBudget::Priority::Visible);
+
+  // Other timesteps of the same objects are about as large as this one:
+  if (m_dataObject && m_dataSettings.sameObjects(m_syncedSettings))
+    {
+    m_readEstimate = mvMemoryBudget::dataSize(m_dataObject);
+    }
+}
+
+//------------------------------------------------------------------------------
+void mvReader::installDataObject(vtkMultiBlockDataSet *mbds, int timeStep,
+                                 const mvReadSettings &settings)
 {
   // Copy data object:
-  vtkMultiBlockDataSet *mbds = m_reader->GetOutput();
   m_dataObject.TakeReference(mbds->NewInstance());
   m_dataObject->ShallowCopy(mbds);
+  m_dataTimeStep = timeStep;
+  m_dataSettings = settings;
+  if (m_memoryBudget)
+    {
+    m_memoryBudget->setUsage("Loaded dataset", m_dataObject,
+                             mvMemoryBudget::Priority::Visible);
+    }
 
   // Collect metadata next:
 
@@ -148,8 +989,10 @@ void mvReader::updateDataCache()
   m_bounds.Reset();
   m_variableMap.clear();
 
-  // Helper lambda to update m_variableMap with the arrays in fd.
-  auto mergeMetaData = [&](VariableMetaData::Location loc, vtkFieldData *fd)
+  // Helper lambda to update m_variableMap with the arrays in fd, which belong
+  // to the block with the given flat index.
+  auto mergeMetaData = [&](VariableMetaData::Location loc, vtkFieldData *fd,
+                           unsigned int block)
   {
     const int size = fd->GetNumberOfArrays();
     for (int i = 0; i < size; ++i)
@@ -175,9 +1018,20 @@ void mvReader::updateDataCache()
         std::cerr << "Field data location mismatch for array: " << name << "\n";
         }
 
-      // Merge the ranges:
+      // Merge the ranges, using the statistics index if possible:
       double range[2];
-      array->GetRange(range);
+      mvStatisticsIndex::Statistics stats;
+      if (loc != VariableMetaData::Location::FieldData &&
+          settings.defaultObjects() && settings.variables.count(name) &&
+          m_statistics.find(name, timeStep, block, stats))
+        {
+        range[0] = stats.min;
+        range[1] = stats.max;
+        }
+      else
+        {
+        array->GetRange(range);
+        }
       metaData.range[0] = std::min(range[0], metaData.range[0]);
       metaData.range[1] = std::max(range[1], metaData.range[1]);
       }
@@ -189,27 +1043,179 @@ void mvReader::updateDataCache()
     {
     if (vtkDataSet *ds = vtkDataSet::SafeDownCast(i->GetCurrentDataObject()))
       {
-      mergeMetaData(VariableMetaData::Location::FieldData, ds->GetFieldData());
-      mergeMetaData(VariableMetaData::Location::PointData, ds->GetPointData());
-      mergeMetaData(VariableMetaData::Location::CellData,  ds->GetCellData());
+      const unsigned int block = i->GetCurrentFlatIndex();
+      mergeMetaData(VariableMetaData::Location::FieldData, ds->GetFieldData(),
+                    block);
+      mergeMetaData(VariableMetaData::Location::PointData, ds->GetPointData(),
+                    block);
+      mergeMetaData(VariableMetaData::Location::CellData,  ds->GetCellData(),
+                    block);
       double b[6];
       ds->GetBounds(b);
       m_bounds.AddBounds(b);
       }
     }
   i->Delete();
+
+  for (auto &entry : m_variableMap)
+    {
+    entry.second.stepRange[0] = entry.second.range[0];
+    entry.second.stepRange[1] = entry.second.range[1];
+    }
+  this->updateMetaDataRanges();
+  m_metaDataMTime.Modified();
+}
+
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkMultiBlockDataSet>
+mvReader::mergeVariables(vtkMultiBlockDataSet *source, const Variables &drop,
+                         vtkMultiBlockDataSet *addFrom)
+{
+  vtkSmartPointer<vtkMultiBlockDataSet> result;
+  result.TakeReference(source->NewInstance());
+  result->ShallowCopy(source);
+
+  // The leaves are shared with source after the shallow copy, and may be in
+  // use by the rendering pipelines. Replace them with copies before editing.
+  vtkCompositeDataIterator *it = source->NewIterator();
+  for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextItem())
+    {
+    vtkDataSet *ds = vtkDataSet::SafeDownCast(it->GetCurrentDataObject());
+    if (!ds)
+      {
+      continue;
+      }
+
+    vtkSmartPointer<vtkDataSet> leaf;
+    leaf.TakeReference(ds->NewInstance());
+    leaf->ShallowCopy(ds);
+
+    for (const auto &var : drop)
+      {
+      leaf->GetPointData()->RemoveArray(var.c_str());
+      leaf->GetCellData()->RemoveArray(var.c_str());
+      }
+
+    vtkDataSet *added =
+        addFrom ? vtkDataSet::SafeDownCast(addFrom->GetDataSet(it)) : nullptr;
+    if (added)
+      {
+      vtkPointData *pd = added->GetPointData();
+      for (int i = 0; i < pd->GetNumberOfArrays(); ++i)
+        {
+        leaf->GetPointData()->AddArray(pd->GetAbstractArray(i));
+        }
+      vtkCellData *cd = added->GetCellData();
+      for (int i = 0; i < cd->GetNumberOfArrays(); ++i)
+        {
+        leaf->GetCellData()->AddArray(cd->GetAbstractArray(i));
+        }
+      }
+
+    result->SetDataSet(it, leaf);
+    }
+  it->Delete();
+
+  return result;
+}
+
+//------------------------------------------------------------------------------
+void mvReader::schedulePrefetch()
+{
+  std::vector<int> steps;
+  if (m_prefetchWindow > 0 && !m_fileName.empty())
+    {
+    const int first = m_timeStepRange[0];
+    const int last = m_timeStepRange[1];
+    for (int i = 1; i <= m_prefetchWindow; ++i)
+      {
+      int step = m_timeStep + i;
+      if (step > last)
+        {
+        if (!m_prefetchWraps)
+          {
+          break;
+          }
+        step = first + (step - last - 1) % (last - first + 1);
+        }
+      if (step == m_timeStep)
+        {
+        break;
+        }
+      steps.push_back(step);
+      }
+    }
+
+  m_timeStepCache.prefetch(steps);
+}
+
+//------------------------------------------------------------------------------
+void mvReader::abortSupersededRead(vtkObject *caller, unsigned long, void *)
+{
+  vtkExodusIIReader *reader = static_cast<vtkExodusIIReader*>(caller);
+  if (this->superseded(reader->GetTimeStep()))
+    {
+    reader->SetAbortExecute(1);
+    }
+}
+
+//------------------------------------------------------------------------------
+bool mvReader::updateMetaDataRanges()
+{
+  bool changed = false;
+  for (auto &entry : m_variableMap)
+    {
+    VariableMetaData &metaData = entry.second;
+    double range[2] = { metaData.stepRange[0], metaData.stepRange[1] };
+    if (m_globalRanges)
+      {
+      m_rangeScanner.globalRange(entry.first, range);
+      }
+
+    if (range[0] != metaData.range[0] || range[1] != metaData.range[1])
+      {
+      metaData.range[0] = range[0];
+      metaData.range[1] = range[1];
+      changed = true;
+      }
+    }
+  return changed;
 }
 
 //------------------------------------------------------------------------------
 void mvReader::syncReducerState()
 {
+  const bool newInput =
+      m_reducer->GetInputDataObject(0, 0) != m_dataObject.Get();
   m_reducer->SetInputDataObject(m_dataObject.Get());
+  m_reducerProducts = this->products();
+  m_reducerStep = m_dataTimeStep;
+  m_reducerVariables = m_dataSettings.variables;
+
+  // Each variable is resampled to a double array, plus the valid point mask:
+  if (newInput && m_dataObject && m_memoryBudget)
+    {
+    const size_t dims = mvProductCache::ReducedDimensions;
+    const size_t bytes = dims * dims * dims * sizeof(double) *
+        (m_dataSettings.variables.size() + 1);
+    m_reducerAllowed = m_memoryBudget->request(
+          bytes, mvMemoryBudget::Priority::Visible);
+    if (!m_reducerAllowed)
+      {
+      std::cerr << "mvReader: Skipping the reduced dataset: it needs about "
+                << (bytes >> 20) << " MiB, which exceeds the memory budget."
+                << std::endl;
+      }
+    }
 }
 
 //------------------------------------------------------------------------------
 bool mvReader::reducerNeedsUpdate()
 {
+  // Don't reduce a timestep the user has already left:
   return
+      !this->superseded(m_dataTimeStep) &&
+      m_reducerAllowed &&
       m_reducer->GetInputDataObject(0, 0) &&
       (!m_reducedData.Get() ||
        m_reducer->GetMTime() > m_reducedData->GetMTime());
@@ -218,13 +1224,33 @@ bool mvReader::reducerNeedsUpdate()
 //------------------------------------------------------------------------------
 void mvReader::executeReducer()
 {
-  m_reducer->Update();
+  m_reducedProduct = m_reducerProducts
+      ? m_reducerProducts->load(mvProductCache::Product::Reduced,
+                                m_reducerStep, m_reducerVariables)
+      : nullptr;
+  if (!m_reducedProduct)
+    {
+    m_reducer->Update();
+    }
 }
 
 //------------------------------------------------------------------------------
 void mvReader::updateReducedData()
 {
-  vtkDataObject *output = m_reducer->GetOutputDataObject(0);
-  m_reducedData.TakeReference(output->NewInstance());
-  m_reducedData->ShallowCopy(output);
+  if (m_reducedProduct)
+    {
+    m_reducedData = m_reducedProduct;
+    m_reducedProduct = nullptr;
+    }
+  else
+    {
+    vtkDataObject *output = m_reducer->GetOutputDataObject(0);
+    m_reducedData.TakeReference(output->NewInstance());
+    m_reducedData->ShallowCopy(output);
+    }
+  if (m_memoryBudget)
+    {
+    m_memoryBudget->setUsage("Reduced dataset", m_reducedData,
+                             mvMemoryBudget::Priority::Visible);
+    }
 }
@@ -4,17 +4,36 @@
 #include <vtkBoundingBox.h>
 #include <vtkNew.h>
 #include <vtkSmartPointer.h>
+#include <vtkTimeStamp.h>
 
 #include <vvReader.h>
 
+#include "mvColumnarCache.h"
+#include "mvEnsembleReader.h"
+#include "mvFileWatcher.h"
+#include "mvFormatReader.h"
+#include "mvInformationReader.h"
+#include "mvNativeReader.h"
+#include "mvParallelReader.h"
+#include "mvProductCache.h"
+#include "mvRangeScanner.h"
+#include "mvSharedTopology.h"
+#include "mvStatisticsIndex.h"
+#include "mvTimeSeries.h"
+#include "mvTimeStepCache.h"
+
+#include <atomic>
 #include <map>
+#include <memory>
 #include <set>
 #include <limits>
 #include <vector>
 
+class mvMemoryBudget;
 class vtkExodusIIReader;
 class vtkImageData;
 class vtkMultiBlockDataSet;
+class vtkObject;
 class vtkResampleToImage;
 
 /**
@@ -23,7 +42,10 @@ class vtkResampleToImage;
  *
  * This class manages the current dataset. It provides metadata and performs
  * asynchronous updates, rereading the data from an Exodus II file as the
- * reading parameters change.
+ * reading parameters change. Decomposed outputs, ensembles, streams and other
+ * file formats are read through helper readers (see pieces(), runs() and
+ * mvFormatReader), and upcoming timesteps are prefetched into a cache (see
+ * prefetchWindow()).
  *
  * It is important to keep in mind that the data is read asynchronously. For
  * example, if a new variable is requested and then update() is called, the new
@@ -31,7 +53,8 @@ class vtkResampleToImage;
  * call to update() after the asynchronous read completes.
  *
  * The updateInformation() method does execute synchronously, as long as no
- * background update is in progress.
+ * background update is in progress. requestInformation() reads the metadata
+ * in the background instead.
  */
 class mvReader : public vvReader
 {
@@ -40,6 +63,15 @@ public:
   using Variables = std::set<std::string>;
   using VariableMetaDataMap = std::map<std::string, VariableMetaData>;
 
+  /** The kinds of mesh objects that can be selected for loading. */
+  enum class ObjectType
+    {
+    ElementBlock,
+    NodeSet,
+    SideSet
+    };
+  using ObjectNames = std::vector<std::string>;
+
   mvReader();
   ~mvReader();
 
@@ -49,9 +81,31 @@ public:
   vtkMultiBlockDataSet* typedDataObject() const;
   vtkImageData* typedReducedDataObject() const;
 
+  /**
+   * Read the metadata of the file in the background (see
+   * mvInformationReader). Until it is read, the metadata of a new file is
+   * empty, and the data is read with every element block. Each call to
+   * update() installs what has been read since, in stages: the timestep
+   * range first, then the variables, blocks and sets, so that the caller can
+   * present a placeholder and fill it in.
+   */
+  void requestInformation();
+
+  /**
+   * Incremented each time the metadata changes, by updateInformation() or as
+   * update() installs the results of requestInformation().
+   */
+  unsigned long informationVersion() const { return m_informationVersion; }
+
+  /**
+   * False while requestInformation() is reading metadata that is not
+   * installed yet.
+   */
+  bool informationComplete() const { return m_informationComplete; }
+
   /**
    * The variables (i.e. attribute arrays) that can be read from the file.
-   * This data is populated by updateInformation().
+   * This data is populated by updateInformation() or requestInformation().
    */
   const Variables& availableVariables() const { return m_availableVariables; }
 
@@ -68,6 +122,13 @@ public:
   /** Clear the list of requested variables. */
   void clearRequestedVariables();
 
+  /**
+   * Replace the requested variables with @a variables. Used to restore a
+   * session before the metadata is read: variables that are not available
+   * are dropped once it is, or right away if it already is.
+   */
+  void setRequestedVariables(const Variables &variables);
+
   /**
    * Request that @a variable will be loaded on the next update(). @a variable
    * must exist in availableVariables().
@@ -103,14 +164,58 @@ public:
    */
   bool isVariableLoaded(const std::string &variable);
 
+  /**
+   * The element blocks, node sets or side sets in the file, in file order.
+   * This data is populated by updateInformation() or requestInformation().
+   */
+  const ObjectNames& availableObjects(ObjectType type) const;
+
+  /**
+   * Whether the object @a name of @a type is read on the next update().
+   * Every element block and no set is selected by default. Only selected
+   * objects are present in dataObject(), so all downstream pipelines operate
+   * on the selection. @{
+   */
+  bool isObjectSelected(ObjectType type, const std::string &name) const;
+  void setObjectSelected(ObjectType type, const std::string &name,
+                         bool selected);
+  /** @} */
+
+  /**
+   * The files of the decomposed dataset being read, or an empty list if the
+   * file is not decomposed. If the file is one piece of a decomposed output
+   * ("out.e.N.i"), all pieces are read and joined into a single dataset, and
+   * the metadata is taken from the first piece (see
+   * mvReadSettings::findPieces()).
+   */
+  const std::vector<std::string>& pieces() const { return m_pieces; }
+
   /** The number of timesteps present in dataObject(). */
   int numberOfTimeSteps() const { return m_numberOfTimeSteps; }
 
   /** The index of the current timestep. @{ */
   int timeStep() const { return m_timeStep; }
-  void setTimeStep(int t) { m_timeStep = t; }
+  void setTimeStep(int t) { m_timeStep = t; m_requestedTimeStep = t; }
+  /** @} */
+
+  /** The timestep held by dataObject(), or -1 if no data is loaded. */
+  int dataTimeStep() const { return m_dataTimeStep; }
+
+  /**
+   * If true, reads, reductions and the data pipelines of the rendering
+   * objects (see mvCancellation) stop working on a timestep as soon as
+   * another one is requested. Default is true. @{
+   */
+  bool cancelSupersededWork() const { return m_cancelSuperseded; }
+  void setCancelSupersededWork(bool cancel) { m_cancelSuperseded = cancel; }
   /** @} */
 
+  /**
+   * True if work on @a timeStep should be abandoned, as another timestep has
+   * been requested since. This may be called from any thread.
+   */
+  bool superseded(int timeStep) const;
+
   /** The inclusive range of valid timestep indices. @{ */
   const int* timeStepRange() const { return m_timeStepRange; }
   void timeStepRange(int r[2]);
@@ -121,6 +226,250 @@ public:
   void timeRange(double r[2]);
   /** @} */
 
+  /**
+   * The time value of @a step. The time values are read after the time range
+   * (see requestInformation()); until then, and for timesteps appended since,
+   * the time is interpolated over timeRange().
+   */
+  double timeValue(int step) const;
+
+  /**
+   * The number of timesteps following timeStep() that are read in the
+   * background. Set to 0 to disable prefetching. Default is 4. @{
+   */
+  int prefetchWindow() const { return m_prefetchWindow; }
+  void setPrefetchWindow(int steps);
+  /** @} */
+
+  /**
+   * Keep up to @a steps timesteps that leave the prefetch cache in memory,
+   * compressed with @a codec (see mvCompressedDataSet), so that returning to
+   * them costs a decode rather than a read. @a tolerance is the error bound of
+   * the ErrorBounded codec, relative to each component's range. Requires a
+   * prefetch window. 0 steps disables compression, the default.
+   */
+  void setCompressedTimeSteps(size_t steps, mvCompressedDataSet::Codec codec,
+                              double tolerance = 1e-4);
+
+  /**
+   * If true, the prefetch window wraps around to the first timestep when it
+   * reaches the end of timeStepRange(). This should match the animation's
+   * looping behavior. Default is false. @{
+   */
+  bool prefetchWraps() const { return m_prefetchWraps; }
+  void setPrefetchWraps(bool wrap) { m_prefetchWraps = wrap; }
+  /** @} */
+
+  /**
+   * If true, changing the requested variables only reads the newly requested
+   * arrays and merges them into the current dataset. Variables that are no
+   * longer requested are removed without reading anything. If false, every
+   * change rereads the whole dataset. Default is true. @{
+   */
+  bool incrementalVariableLoading() const { return m_incrementalVariables; }
+  void setIncrementalVariableLoading(bool inc) { m_incrementalVariables = inc; }
+  /** @} */
+
+  /**
+   * If true, the range reported in VariableMetaData spans all timesteps once
+   * a background scan of the variable has finished, so that color and
+   * contour mappings stay fixed during animation. The range of the current
+   * timestep is always available as VariableMetaData::stepRange. Default is
+   * false. @{
+   */
+  bool globalRanges() const { return m_globalRanges; }
+  void setGlobalRanges(bool global);
+  /** @} */
+
+  /**
+   * The last time the variableMetaData() changed, either because new data was
+   * loaded or because a global range became available.
+   */
+  vtkMTimeType metaDataMTime() const { return m_metaDataMTime.GetMTime(); }
+
+  /**
+   * Add the histogram of the loaded @a variable, with @a numBins equal bins
+   * over @a range, to @a bins using the statistics index. The result is an
+   * approximation built from per-block histograms. Returns false if the
+   * variable is not indexed at the loaded timestep.
+   */
+  bool histogram(const std::string &variable, const double range[2],
+                 float *bins, int numBins) const;
+
+  /**
+   * Statistics of the loaded @a variable in the block with flat index
+   * @a block, e.g. to skip blocks whose range excludes a value of interest.
+   * Returns false if not indexed.
+   */
+  bool blockStatistics(const std::string &variable, unsigned int block,
+                       mvStatisticsIndex::Statistics &stats) const;
+
+  /**
+   * If true, timesteps are loaded from the memory-mapped sidecar cache
+   * written by previous sessions when possible, and timesteps read from the
+   * file are added to it. See mvColumnarCache. Default is false. @{
+   */
+  bool columnarCache() const { return m_columnarCache.enabled(); }
+  void setColumnarCache(bool enable) { m_columnarCache.setEnabled(enable); }
+  /** @} */
+
+  /**
+   * The products precomputed by mvpreprocess for the file (see
+   * mvProductCache), or nullptr if there are none, or if dataObject() was not
+   * read from that file alone with the default objects and stored variables.
+   * Products are looked up for dataTimeStep().
+   */
+  const mvProductCache* products() const;
+
+  /**
+   * If true, coordinates and double result arrays are converted to float
+   * after reading (see mvSinglePrecision), halving the memory and bandwidth
+   * used by cached timesteps and downstream filters. Variable ranges are
+   * computed before the conversion and stay exact. Changing this rereads the
+   * data. Default is false. @{
+   */
+  bool singlePrecision() const { return m_singlePrecision; }
+  void setSinglePrecision(bool single) { m_singlePrecision = single; }
+  /** @} */
+
+  /**
+   * If true, timesteps are read with mvNativeReader, which reads the mesh
+   * once and then one hyperslab per requested variable and block through the
+   * Exodus C API. Settings or files it does not support (sets, decomposed
+   * datasets, some element types) are read with vtkExodusIIReader as usual.
+   * Default is false. @{
+   */
+  bool nativeReader() const { return m_useNativeReader; }
+  void setNativeReader(bool native) { m_useNativeReader = native; }
+  /** @} */
+
+  /**
+   * The number of threads that read the element blocks, or the pieces of a
+   * decomposed dataset, of a timestep in parallel (see mvParallelReader). 1
+   * reads serially, and values less than 1 use one thread per hardware
+   * thread. Parallel reads need a netCDF/HDF5 build that supports concurrent
+   * readers. Default is 1. @{
+   */
+  int readThreads() const { return m_readThreads; }
+  void setReadThreads(int threads);
+  /** @} */
+
+  /**
+   * If true, the file is polled in the background for appended timesteps
+   * (see mvFileWatcher), and timeStepRange() and timeRange() grow as they
+   * are written. Default is false. @{
+   */
+  bool follow() const { return m_watcher.enabled(); }
+  void setFollow(bool follow) { m_watcher.setEnabled(follow); }
+  /** @} */
+
+  /**
+   * If true while following, the current timestep jumps to each newly
+   * written timestep. Default is false. @{
+   */
+  bool followLatest() const { return m_followLatest; }
+  void setFollowLatest(bool latest) { m_followLatest = latest; }
+  /** @} */
+
+  /**
+   * The runs of an ensemble: files written by several runs of a simulation
+   * on the same mesh, e.g. with different parameters. fileName() is the
+   * active run, whose metadata is presented. Datasets of different runs
+   * share their mesh in memory (see mvSharedTopology), so that each run only
+   * adds its result arrays. Setting the runs makes the first one active,
+   * unless fileName() is one of them. @{
+   */
+  const std::vector<std::string>& runs() const { return m_runs; }
+  void setRuns(const std::vector<std::string> &files);
+  /** @} */
+
+  /**
+   * The index of the active run in runs(), or -1. Changing the active run
+   * reads the current timestep and variables from that run; call
+   * updateInformation() or requestInformation() afterwards, as after
+   * setFileName(). @{
+   */
+  int activeRun() const;
+  void setActiveRun(int run);
+  /** @} */
+
+  /**
+   * If true, every run is read at the current timestep, and the runs are laid
+   * out side by side along x, the active run first (see mvEnsembleReader).
+   * The datasets then have one child per run. Default is false. @{
+   */
+  bool sideBySide() const { return m_sideBySide; }
+  void setSideBySide(bool side) { m_sideBySide = side; }
+  /** @} */
+
+  /** Seconds between checks for appended timesteps. Default is 2. @{ */
+  double followInterval() const { return m_watcher.interval(); }
+  void setFollowInterval(double seconds) { m_watcher.setInterval(seconds); }
+  /** @} */
+
+  /**
+   * Read the values of @a variable at every timestep, at the node or element
+   * nearest @a position in the selected blocks, in the background (see
+   * mvTimeSeries). timeSeries() returns the result once it is read. Only the
+   * latest request is read. Requests are ignored for files that are not
+   * Exodus files.
+   */
+  void requestTimeSeries(const std::string &variable,
+                         const double position[3]);
+
+  /**
+   * Copy the result of the last time series request into @a series. Returns
+   * false if there is none, or if it could not be read.
+   */
+  bool timeSeries(mvTimeSeries::Series &series) const;
+
+  /** Incremented each time timeSeries() changes. */
+  unsigned long timeSeriesVersion() const;
+
+  /** True while a time series request is being read. */
+  bool readingTimeSeries() const { return m_timeSeries.busy(); }
+
+  /** Discard the time series and any pending request. */
+  void clearTimeSeries() { m_timeSeries.clear(); }
+
+  /**
+   * Start reading the global variables of Exodus files. Reading them opens
+   * the file a second time, so this is left until they are first shown.
+   */
+  void requestGlobalVariables() { m_globalVariablesRequested = true; }
+
+  /**
+   * Copy the global variables of the file, with their values at every
+   * timestep, into @a globals. Once requested, they are read in the
+   * background once per file, and again when timesteps are appended. Returns
+   * false until they are read.
+   */
+  bool globalVariables(mvTimeSeries::GlobalVariables &globals) const;
+
+  /** Incremented each time globalVariables() changes. */
+  unsigned long globalVariablesVersion() const;
+
+  /**
+   * Extends vvReader::setBenchmark() to also report the source, size and
+   * throughput of each dataset read, and the time taken by time series.
+   */
+  void setBenchmark(bool bench);
+
+  /**
+   * Account the loaded, reduced and cached datasets and the reader's array
+   * cache in @a budget. Reads request their estimated size first, and cached
+   * timesteps are evicted, oldest first, when other data needs the memory.
+   * The loaded dataset is read even if it does not fit, since it is on
+   * screen. @a budget must outlive this object.
+   */
+  void setMemoryBudget(mvMemoryBudget *budget);
+
+  /**
+   * Extends vvReader::update() to publish cached timesteps and schedule
+   * background reads of upcoming timesteps.
+   */
+  void update(vvApplicationState &state);
+
 private:
   void syncReaderState() override;
   bool dataNeedsUpdate() override;
@@ -134,19 +483,169 @@ private:
   void executeReducer() override;
   void updateReducedData() override;
 
+  // The settings the readers should use for the current state.
+  mvReadSettings readSettings() const;
+
+  // Find the pieces of m_fileName if it changed.
+  void updatePieces();
+
+  // Replace the metadata with info.
+  void installInformation(const mvInformationReader::Information &info);
+  // Drop the requested variables that are not available.
+  void dropUnavailableVariables();
+
+  // Open the file of m_syncedSettings in m_reader if syncReaderState left it
+  // to the data update thread.
+  void applyReaderSettings();
+
+  // Size m_reader's array cache for the memory budget, account for it, and
+  // estimate the size of the next read. Called by syncReaderState.
+  void syncMemoryBudget();
+
+  // Replace m_dataObject with a copy of mbds and refresh the metadata.
+  void installDataObject(vtkMultiBlockDataSet *mbds, int timeStep,
+                         const mvReadSettings &settings);
+
+  // Return a copy of source without the arrays named in drop, and with the
+  // point and cell arrays of the matching leaves in addFrom (if any). The
+  // leaves are copied, so source is not modified.
+  static vtkSmartPointer<vtkMultiBlockDataSet> mergeVariables(
+      vtkMultiBlockDataSet *source, const Variables &drop,
+      vtkMultiBlockDataSet *addFrom);
+
+  // Request the timesteps in the prefetch window from m_timeStepCache.
+  void schedulePrefetch();
+
+  // Extend the timestep range to the timesteps found by m_watcher.
+  void appendTimeSteps();
+
+  // Progress observer of the readers; aborts reads of superseded timesteps.
+  void abortSupersededRead(vtkObject *caller, unsigned long, void *);
+
+  // Set each VariableMetaData::range to the global or per-timestep range.
+  // Returns true if any range changed.
+  bool updateMetaDataRanges();
+
 private:
   vtkNew<vtkExodusIIReader> m_reader;
+  bool m_applyReaderSettings; // See applyReaderSettings().
   VariableMetaDataMap m_variableMap;
 
+  // Declared before m_timeStepCache and m_rangeScanner, whose worker threads
+  // use them. Timesteps and runs with the same mesh share their point and
+  // connectivity arrays through m_sharedTopology.
+  mvSharedTopology m_sharedTopology;
+  mvColumnarCache m_columnarCache;
+  mvStatisticsIndex m_statistics;
+  double m_statisticsSaveTime; // Only used by the data update thread.
+  mvTimeStepCache m_timeStepCache;
+  int m_prefetchWindow;
+  bool m_prefetchWraps;
+
+  // The timestep held by m_dataObject, or -1 if no data is loaded.
+  int m_dataTimeStep;
+  // The settings m_dataObject was read with.
+  mvReadSettings m_dataSettings;
+  // The settings the next data update will produce.
+  mvReadSettings m_syncedSettings;
+
+  // Incremental variable loading:
+  bool m_incrementalVariables;
+  vtkNew<vtkExodusIIReader> m_arrayReader;
+  Variables m_addedVariables;
+  Variables m_droppedVariables;
+  vtkSmartPointer<vtkMultiBlockDataSet> m_mergeBase;
+  vtkSmartPointer<vtkMultiBlockDataSet> m_mergedOutput;
+
+  // The dataset produced by the last full read in executeReaderData.
+  vtkSmartPointer<vtkMultiBlockDataSet> m_readerOutput;
+
+  // Cancellation. m_requestedTimeStep mirrors m_timeStep for other threads.
+  std::atomic<int> m_requestedTimeStep;
+  std::atomic<bool> m_cancelSuperseded;
+  bool m_readCancelled; // Whether the last executeReaderData was abandoned.
+  bool m_readFailed; // Whether it was abandoned for another reason.
+  // The last timestep and settings whose read failed. They are not retried
+  // until either changes.
+  int m_failedTimeStep;
+  mvReadSettings m_failedSettings;
+
+  bool m_singlePrecision;
+  bool m_useNativeReader;
+  mvMemoryBudget *m_memoryBudget;
+  // The estimated size of the data read by the next executeReaderData, set
+  // by syncReaderState.
+  size_t m_readEstimate;
+
+  // Parallel reads. m_readThreads is only read on the data update thread after
+  // being copied by syncReaderState.
+  int m_readThreads;
+  int m_syncedReadThreads;
+  mvParallelReader m_parallelReader;
+  mvNativeReader m_nativeReader;
+  bool m_benchmark;
+
+  // Reads files that are not Exodus files, on the data update thread.
+  // m_formatInformation is filled by executeReaderInformation.
+  std::unique_ptr<mvFormatReader> m_formatReader;
+  mvFormatReader::Information m_formatInformation;
+
+  // Metadata read in the background:
+  mvInformationReader m_informationReader;
+  unsigned long m_informationReaderVersion;
+  unsigned long m_informationVersion;
+  bool m_informationComplete;
+
+  // Ensembles:
+  std::vector<std::string> m_runs;
+  bool m_sideBySide;
+  mvEnsembleReader m_ensembleReader; // On the data update thread.
+
+  // Histories at a location, read by a worker thread:
+  mvTimeSeries m_timeSeries;
+  bool m_globalVariablesRequested;
+
+  // Ranges over all timesteps:
+  bool m_globalRanges;
+  mvRangeScanner m_rangeScanner;
+  unsigned long m_rangesVersion;
+  vtkTimeStamp m_metaDataMTime;
+
   vtkNew<vtkResampleToImage> m_reducer;
 
+  // Precomputed products. The reducer loads the reduced dataset of
+  // m_reducerStep from m_reducerProducts instead of resampling, if stored.
+  mvProductCache m_products;
+  const mvProductCache *m_reducerProducts;
+  int m_reducerStep;
+  Variables m_reducerVariables;
+  vtkSmartPointer<vtkDataObject> m_reducedProduct;
+  bool m_reducerAllowed; // Whether the budget had room for the reduction.
+
+  // Following files that are being written:
+  mvFileWatcher m_watcher;
+  unsigned long m_watcherVersion;
+  bool m_followLatest;
+
+  // The pieces of m_fileName, if it is decomposed:
+  std::string m_piecesFileName;
+  std::vector<std::string> m_pieces;
+
   int m_numberOfTimeSteps;
   int m_timeStep;
   int m_timeStepRange[2];
   double m_timeRange[2];
+  std::vector<double> m_times; // Empty until read.
 
   Variables m_availableVariables;
   Variables m_requestedVariables;
+
+  ObjectNames m_availableBlocks;
+  ObjectNames m_availableNodeSets;
+  ObjectNames m_availableSideSets;
+  Variables m_excludedBlocks;
+  Variables m_selectedNodeSets;
+  Variables m_selectedSideSets;
 };
 
 /**
@@ -165,14 +664,42 @@ struct mvReader::VariableMetaData
   explicit VariableMetaData(Location loc = Location::Invalid,
                             double min = std::numeric_limits<double>::max(),
                             double max = std::numeric_limits<double>::min())
-    : location(loc), range{min, max} {}
+    : location(loc), range{min, max}, stepRange{min, max} {}
 
   bool valid() const { return location != Location::Invalid; }
 
   Location location;
+  // The range used for mapping. See mvReader::globalRanges().
   double range[2];
+  // The range at the loaded timestep.
+  double stepRange[2];
 };
 
+//------------------------------------------------------------------------------
+inline bool mvReader::timeSeries(mvTimeSeries::Series &series) const
+{
+  return m_timeSeries.result(series);
+}
+
+//------------------------------------------------------------------------------
+inline unsigned long mvReader::timeSeriesVersion() const
+{
+  return m_timeSeries.resultsVersion();
+}
+
+//------------------------------------------------------------------------------
+inline bool
+mvReader::globalVariables(mvTimeSeries::GlobalVariables &globals) const
+{
+  return m_timeSeries.globalVariables(globals);
+}
+
+//------------------------------------------------------------------------------
+inline unsigned long mvReader::globalVariablesVersion() const
+{
+  return m_timeSeries.globalVariablesVersion();
+}
+
 //------------------------------------------------------------------------------
 inline bool mvReader::isVariableRequested(const std::string &variable)
 {
@@ -210,6 +737,52 @@ inline bool mvReader::isVariableAvailable(const std::string &variable)
   return m_availableVariables.find(variable) != m_availableVariables.end();
 }
 
+//------------------------------------------------------------------------------
+inline const mvReader::ObjectNames&
+mvReader::availableObjects(ObjectType type) const
+{
+  switch (type)
+    {
+    case ObjectType::NodeSet:
+      return m_availableNodeSets;
+    case ObjectType::SideSet:
+      return m_availableSideSets;
+    case ObjectType::ElementBlock:
+    default:
+      return m_availableBlocks;
+    }
+}
+
+//------------------------------------------------------------------------------
+inline bool mvReader::isObjectSelected(ObjectType type,
+                                       const std::string &name) const
+{
+  switch (type)
+    {
+    case ObjectType::NodeSet:
+      return m_selectedNodeSets.find(name) != m_selectedNodeSets.end();
+    case ObjectType::SideSet:
+      return m_selectedSideSets.find(name) != m_selectedSideSets.end();
+    case ObjectType::ElementBlock:
+    default:
+      return m_excludedBlocks.find(name) == m_excludedBlocks.end();
+    }
+}
+
+//------------------------------------------------------------------------------
+inline bool mvReader::superseded(int timeStep) const
+{
+  return m_cancelSuperseded && timeStep != m_requestedTimeStep;
+}
+
+//------------------------------------------------------------------------------
+inline void mvReader::setCompressedTimeSteps(size_t steps,
+                                             mvCompressedDataSet::Codec codec,
+                                             double tolerance)
+{
+  m_timeStepCache.setCompression(steps, codec, tolerance);
+}
+
 //------------------------------------------------------------------------------
 inline void mvReader::timeStepRange(int r[2])
 {
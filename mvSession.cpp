@@ -0,0 +1,230 @@
+#include "mvSession.h"
+
+#include <vtk_jsoncpp.h>
+
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+//------------------------------------------------------------------------------
+Json::Value toJson(const double *values, size_t count)
+{
+  Json::Value result(Json::arrayValue);
+  for (size_t i = 0; i < count; ++i)
+    {
+    result.append(values[i]);
+    }
+  return result;
+}
+
+//------------------------------------------------------------------------------
+// Replace values with the numbers in @a json, if it holds exactly count.
+void fromJson(const Json::Value &json, double *values, size_t count)
+{
+  if (!json.isArray() || json.size() != count)
+    {
+    return;
+    }
+  for (Json::ArrayIndex i = 0; i < json.size(); ++i)
+    {
+    if (!json[i].isNumeric())
+      {
+      return;
+      }
+    }
+  for (Json::ArrayIndex i = 0; i < json.size(); ++i)
+    {
+    values[i] = json[i].asDouble();
+    }
+}
+
+//------------------------------------------------------------------------------
+// Replace value with @a json, if it is a string. The other overloads do the
+// same for their types, so that a hand edited session of the wrong type keeps
+// the defaults instead of throwing.
+void fromJson(const Json::Value &json, std::string &value)
+{
+  if (json.isString())
+    {
+    value = json.asString();
+    }
+}
+
+//------------------------------------------------------------------------------
+void fromJson(const Json::Value &json, int &value)
+{
+  if (json.isInt())
+    {
+    value = json.asInt();
+    }
+}
+
+//------------------------------------------------------------------------------
+void fromJson(const Json::Value &json, bool &value)
+{
+  if (json.isBool())
+    {
+    value = json.asBool();
+    }
+}
+
+//------------------------------------------------------------------------------
+void fromJson(const Json::Value &json, double &value)
+{
+  if (json.isNumeric())
+    {
+    value = json.asDouble();
+    }
+}
+
+//------------------------------------------------------------------------------
+std::vector<double> doublesFromJson(const Json::Value &json)
+{
+  std::vector<double> result;
+  if (json.isArray())
+    {
+    for (Json::ArrayIndex i = 0; i < json.size(); ++i)
+      {
+      if (json[i].isNumeric())
+        {
+        result.push_back(json[i].asDouble());
+        }
+      }
+    }
+  return result;
+}
+
+} // end anon namespace
+
+//------------------------------------------------------------------------------
+std::string mvSession::defaultFileName(const std::string &dataFile)
+{
+  return dataFile + ".mvsession";
+}
+
+//------------------------------------------------------------------------------
+bool mvSession::load(const std::string &fileName)
+{
+  std::ifstream inFile(fileName.c_str());
+  if (!inFile)
+    {
+    std::cerr << "mvSession: Unable to open '" << fileName << "'."
+              << std::endl;
+    return false;
+    }
+
+  Json::Value root;
+  Json::Reader reader;
+  if (!reader.parse(inFile, root) || !root.isObject())
+    {
+    std::cerr << "mvSession: Unable to parse '" << fileName << "':\n"
+              << reader.getFormattedErrorMessages() << std::endl;
+    return false;
+    }
+
+  mvSession session;
+  fromJson(root["fileName"], session.fileName);
+  fromJson(root["timeStep"], session.timeStep);
+
+  const Json::Value &variables = root["variables"];
+  if (variables.isArray())
+    {
+    for (Json::ArrayIndex i = 0; i < variables.size(); ++i)
+      {
+      if (variables[i].isString())
+        {
+        session.variables.insert(variables[i].asString());
+        }
+      }
+    }
+  fromJson(root["colorBy"], session.colorBy);
+
+  fromJson(root["colorMap"], session.colorMap);
+  session.colorTable = doublesFromJson(root["colorTable"]);
+  if (session.colorTable.size() != 256 * 4)
+    {
+    session.colorTable.clear();
+    }
+
+  fromJson(root["representation"], session.representation);
+  fromJson(root["opacity"], session.opacity);
+  fromJson(root["outlineVisible"], session.outlineVisible);
+  fromJson(root["volumeVisible"], session.volumeVisible);
+
+  fromJson(root["contoursVisible"], session.contoursVisible);
+  session.contourValues = doublesFromJson(root["contourValues"]);
+
+  const Json::Value &slice = root["slice"];
+  if (slice.isObject())
+    {
+    fromJson(slice["visible"], session.sliceVisible);
+    fromJson(slice["normal"], session.sliceNormal.data(), 3);
+    fromJson(slice["origin"], session.sliceOrigin.data(), 3);
+    }
+
+  const Json::Value &camera = root["camera"];
+  if (camera.isObject())
+    {
+    session.hasCamera = true;
+    fromJson(camera["translation"], session.cameraTranslation.data(), 3);
+    fromJson(camera["rotation"], session.cameraRotation.data(), 4);
+    fromJson(camera["scaling"], session.cameraScaling);
+    }
+
+  *this = session;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool mvSession::save(const std::string &fileName) const
+{
+  Json::Value root(Json::objectValue);
+  root["fileName"] = this->fileName;
+  root["timeStep"] = this->timeStep;
+
+  Json::Value variables(Json::arrayValue);
+  for (const std::string &variable : this->variables)
+    {
+    variables.append(variable);
+    }
+  root["variables"] = variables;
+  root["colorBy"] = this->colorBy;
+
+  root["colorMap"] = this->colorMap;
+  root["colorTable"] = toJson(this->colorTable.data(),
+                              this->colorTable.size());
+
+  root["representation"] = this->representation;
+  root["opacity"] = this->opacity;
+  root["outlineVisible"] = this->outlineVisible;
+  root["volumeVisible"] = this->volumeVisible;
+
+  root["contoursVisible"] = this->contoursVisible;
+  root["contourValues"] = toJson(this->contourValues.data(),
+                                 this->contourValues.size());
+
+  Json::Value &slice = root["slice"];
+  slice["visible"] = this->sliceVisible;
+  slice["normal"] = toJson(this->sliceNormal.data(), 3);
+  slice["origin"] = toJson(this->sliceOrigin.data(), 3);
+
+  if (this->hasCamera)
+    {
+    Json::Value &camera = root["camera"];
+    camera["translation"] = toJson(this->cameraTranslation.data(), 3);
+    camera["rotation"] = toJson(this->cameraRotation.data(), 4);
+    camera["scaling"] = this->cameraScaling;
+    }
+
+  std::ofstream outFile(fileName.c_str());
+  if (!outFile)
+    {
+    std::cerr << "mvSession: Unable to write '" << fileName << "'."
+              << std::endl;
+    return false;
+    }
+  Json::StyledStreamWriter writer;
+  writer.write(outFile, root);
+  return static_cast<bool>(outFile);
+}
@@ -0,0 +1,80 @@
+#ifndef MVSESSION_H
+#define MVSESSION_H
+
+#include <array>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The mvSession struct holds the state of a viewing session that is
+ * restored when the same dataset is opened again.
+ *
+ * MooseViewer saves the session on exit, and restores it before the first
+ * timestep is read when asked to (see MooseViewer::setSession()). Since the
+ * state is applied before anything is loaded, the first read already uses the
+ * saved timestep and variables, and the contours, slice and geometry are all
+ * computed from it concurrently, rather than one after another as the user
+ * redoes each step.
+ *
+ * Sessions are stored as JSON. Missing members keep their defaults, so older
+ * and hand-edited files load.
+ */
+struct mvSession
+{
+  /** The dataset the session was saved for. */
+  std::string fileName;
+
+  /** The displayed timestep, or -1 to keep the default. */
+  int timeStep = -1;
+
+  /** The variables that are read, and the one the data is colored by. @{ */
+  std::set<std::string> variables;
+  std::string colorBy;
+  /** @} */
+
+  /**
+   * The color map: the index of the preset in the color map menu (-1 if
+   * unset), and the resulting 256 RGBA table, alpha ramp included. The table
+   * is empty if unset.
+   */
+  int colorMap = -1;
+  std::vector<double> colorTable;
+
+  /** Geometry representation (an mvGeometry::Representation) and opacity. */
+  int representation = -1;
+  double opacity = 1.;
+  bool outlineVisible = true;
+  bool volumeVisible = false;
+
+  /** Contours. */
+  bool contoursVisible = false;
+  std::vector<double> contourValues;
+
+  /** Slice plane. */
+  bool sliceVisible = false;
+  std::array<double, 3> sliceNormal{{1., 1., 1.}};
+  std::array<double, 3> sliceOrigin{{0., 0., 0.}};
+
+  /**
+   * The navigation transformation: a translation, a rotation quaternion and a
+   * scaling factor. Only valid if hasCamera is true.
+   */
+  bool hasCamera = false;
+  std::array<double, 3> cameraTranslation{{0., 0., 0.}};
+  std::array<double, 4> cameraRotation{{0., 0., 0., 1.}};
+  double cameraScaling = 1.;
+
+  /** The session file used for @a dataFile unless another is given. */
+  static std::string defaultFileName(const std::string &dataFile);
+
+  /**
+   * Read and write the session file @a fileName. Errors are printed to
+   * stderr, and leave the session unchanged on load. @{
+   */
+  bool load(const std::string &fileName);
+  bool save(const std::string &fileName) const;
+  /** @} */
+};
+
+#endif // MVSESSION_H
@@ -0,0 +1,184 @@
+#include "mvSharedTopology.h"
+
+#include <vtkCellArray.h>
+#include <vtkDataArray.h>
+#include <vtkDataObjectTreeIterator.h>
+#include <vtkIdTypeArray.h>
+#include <vtkMultiBlockDataSet.h>
+#include <vtkPoints.h>
+#include <vtkSOADataArrayTemplate.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <cstring>
+
+namespace {
+
+//------------------------------------------------------------------------------
+// FNV-1a style hash over a block of memory.
+void hashBytes(const void *data, size_t size, std::uint64_t &hash)
+{
+  const unsigned char *bytes = static_cast<const unsigned char*>(data);
+
+  // Mix in a word at a time -- this runs on the full mesh for every read.
+  const size_t numWords = size / sizeof(std::uint64_t);
+  for (size_t i = 0; i < numWords; ++i)
+    {
+    std::uint64_t word;
+    std::memcpy(&word, bytes + i * sizeof(std::uint64_t), sizeof(word));
+    hash ^= word;
+    hash *= 1099511628211ull;
+    }
+  for (size_t i = numWords * sizeof(std::uint64_t); i < size; ++i)
+    {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+    }
+}
+
+//------------------------------------------------------------------------------
+// Hash the component buffers of a structure-of-arrays array in place, rather
+// than through GetVoidPointer(), which would make an interleaved copy.
+template <typename T>
+bool hashComponents(vtkDataArray *array, std::uint64_t &hash)
+{
+  auto *soa = vtkArrayDownCast<vtkSOADataArrayTemplate<T> >(array);
+  if (!soa)
+    {
+    return false;
+    }
+  const size_t size = static_cast<size_t>(soa->GetNumberOfTuples()) * sizeof(T);
+  for (int c = 0; c < soa->GetNumberOfComponents(); ++c)
+    {
+    hashBytes(soa->GetComponentArrayPointer(c), size, hash);
+    }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Hash the raw contents of an array.
+void hashArray(vtkDataArray *array, std::uint64_t &hash)
+{
+  if (!array)
+    {
+    return;
+    }
+
+  if (array->HasStandardMemoryLayout())
+    {
+    hashBytes(array->GetVoidPointer(0),
+              static_cast<size_t>(array->GetNumberOfValues()) *
+              static_cast<size_t>(array->GetDataTypeSize()),
+              hash);
+    }
+  else if (!hashComponents<double>(array, hash) &&
+           !hashComponents<float>(array, hash))
+    {
+    // Other layouts are not produced by the readers; hash the values.
+    const vtkIdType numValues = array->GetNumberOfValues();
+    const int numComps = array->GetNumberOfComponents();
+    for (vtkIdType i = 0; i < numValues; ++i)
+      {
+      const double value = array->GetComponent(i / numComps, i % numComps);
+      hashBytes(&value, sizeof(value), hash);
+      }
+    }
+
+  // Also mix in the layout, so that e.g. float and double zeros differ:
+  hash ^= (static_cast<std::uint64_t>(array->GetDataType()) << 32) |
+      static_cast<std::uint64_t>(array->GetNumberOfComponents());
+  hash *= 1099511628211ull;
+}
+
+//------------------------------------------------------------------------------
+std::uint64_t fingerprint(vtkUnstructuredGrid *ug)
+{
+  std::uint64_t hash = 14695981039346656037ull;
+  hashArray(ug->GetPoints() ? ug->GetPoints()->GetData() : nullptr, hash);
+  hashArray(ug->GetCells() ? ug->GetCells()->GetData() : nullptr, hash);
+  hashArray(ug->GetCellTypesArray(), hash);
+  return hash;
+}
+
+} // end anon namespace
+
+//------------------------------------------------------------------------------
+mvSharedTopology::mvSharedTopology()
+{
+}
+
+//------------------------------------------------------------------------------
+mvSharedTopology::~mvSharedTopology()
+{
+}
+
+//------------------------------------------------------------------------------
+size_t mvSharedTopology::share(vtkMultiBlockDataSet *mbds)
+{
+  if (!mbds)
+    {
+    return 0;
+    }
+
+  size_t shared = 0;
+
+  vtkDataObjectTreeIterator *it = mbds->NewTreeIterator();
+  for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextItem())
+    {
+    vtkUnstructuredGrid *ug =
+        vtkUnstructuredGrid::SafeDownCast(it->GetCurrentDataObject());
+
+    // Polyhedral grids carry an additional face stream; leave them alone.
+    if (!ug || !ug->GetPoints() || !ug->GetCells() || ug->GetFaces())
+      {
+      continue;
+      }
+
+    const unsigned int index = it->GetCurrentFlatIndex();
+
+      {
+      // Already sharing with the reference:
+      std::lock_guard<std::mutex> lock(m_mutex);
+      auto entry = m_entries.find(index);
+      if (entry != m_entries.end() &&
+          entry->second.points.Get() == ug->GetPoints() &&
+          entry->second.cells.Get() == ug->GetCells())
+        {
+        ++shared;
+        continue;
+        }
+      }
+
+    // Hashing doesn't need the lock:
+    const std::uint64_t hash = fingerprint(ug);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry &entry = m_entries[index];
+    if (entry.points && entry.fingerprint == hash &&
+        entry.points->GetNumberOfPoints() == ug->GetNumberOfPoints() &&
+        entry.cells->GetNumberOfCells() == ug->GetNumberOfCells())
+      {
+      ug->SetPoints(entry.points);
+      ug->SetCells(entry.cellTypes, entry.cellLocations, entry.cells);
+      ++shared;
+      }
+    else
+      {
+      entry.fingerprint = hash;
+      entry.points = ug->GetPoints();
+      entry.cellTypes = ug->GetCellTypesArray();
+      entry.cellLocations = ug->GetCellLocationsArray();
+      entry.cells = ug->GetCells();
+      }
+    }
+  it->Delete();
+
+  return shared;
+}
+
+//------------------------------------------------------------------------------
+void mvSharedTopology::clear()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_entries.clear();
+}
@@ -0,0 +1,65 @@
+#ifndef MVSHAREDTOPOLOGY_H
+#define MVSHAREDTOPOLOGY_H
+
+#include <vtkSmartPointer.h>
+#include <vtkType.h>
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+
+class vtkCellArray;
+class vtkIdTypeArray;
+class vtkMultiBlockDataSet;
+class vtkPoints;
+class vtkUnsignedCharArray;
+
+/**
+ * @brief The mvSharedTopology class lets datasets read from different
+ * timesteps share their mesh.
+ *
+ * MOOSE meshes are usually static, but every read produces new point and
+ * connectivity arrays for each block. share() fingerprints the coordinates
+ * and connectivity of each leaf of a dataset and, if they match the leaf at
+ * the same position in a previously shared dataset, replaces them with the
+ * arrays from that dataset. Cached timesteps then only hold their own result
+ * arrays.
+ *
+ * share() is thread-safe, so a single instance may be used by the foreground
+ * reader and by background reads.
+ */
+class mvSharedTopology
+{
+public:
+  mvSharedTopology();
+  ~mvSharedTopology();
+
+  /**
+   * Share the mesh of matching leaves in @a mbds. Leaves that do not match
+   * become the reference for later calls. Returns the number of leaves that
+   * now share their mesh with a previous dataset.
+   */
+  size_t share(vtkMultiBlockDataSet *mbds);
+
+  /** Forget all reference meshes. */
+  void clear();
+
+private:
+  struct Entry
+  {
+    std::uint64_t fingerprint;
+    vtkSmartPointer<vtkPoints> points;
+    vtkSmartPointer<vtkUnsignedCharArray> cellTypes;
+    vtkSmartPointer<vtkIdTypeArray> cellLocations;
+    vtkSmartPointer<vtkCellArray> cells;
+  };
+
+  // Not implemented -- disable copy:
+  mvSharedTopology(const mvSharedTopology&);
+  mvSharedTopology& operator=(const mvSharedTopology&);
+
+  std::mutex m_mutex;
+  std::map<unsigned int, Entry> m_entries; // Keyed by flat index.
+};
+
+#endif // MVSHAREDTOPOLOGY_H
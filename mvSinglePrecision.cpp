@@ -0,0 +1,192 @@
+#include "mvSinglePrecision.h"
+
+#include <vtkCellData.h>
+#include <vtkCompositeDataIterator.h>
+#include <vtkDataSet.h>
+#include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkMultiBlockDataSet.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPointSet.h>
+#include <vtkSOADataArrayTemplate.h>
+
+#include <limits>
+#include <vector>
+
+namespace {
+
+//------------------------------------------------------------------------------
+bool hasDoubles(vtkFieldData *fd)
+{
+  const int numArrays = fd->GetNumberOfArrays();
+  for (int i = 0; i < numArrays; ++i)
+    {
+    vtkDataArray *array = fd->GetArray(i);
+    if (array && array->GetDataType() == VTK_DOUBLE)
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
+//------------------------------------------------------------------------------
+void convertArrays(vtkFieldData *fd)
+{
+  const int numArrays = fd->GetNumberOfArrays();
+  for (int i = 0; i < numArrays; ++i)
+    {
+    vtkDataArray *array = fd->GetArray(i);
+    if (array && array->GetDataType() == VTK_DOUBLE)
+      {
+      // Replaces the array of the same name, keeping attribute assignments:
+      fd->AddArray(mvSinglePrecision::convert(array));
+      }
+    }
+}
+
+} // end anon namespace
+
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkMultiBlockDataSet>
+mvSinglePrecision::convert(vtkMultiBlockDataSet *mbds)
+{
+  vtkSmartPointer<vtkMultiBlockDataSet> result;
+  result.TakeReference(mbds->NewInstance());
+  result->CopyStructure(mbds);
+
+  vtkCompositeDataIterator *it = mbds->NewIterator();
+  for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextItem())
+    {
+    vtkDataSet *ds = vtkDataSet::SafeDownCast(it->GetCurrentDataObject());
+    if (!ds)
+      {
+      result->SetDataSet(it, it->GetCurrentDataObject());
+      continue;
+      }
+
+    vtkPointSet *ps = vtkPointSet::SafeDownCast(ds);
+    const bool doublePoints = ps && ps->GetPoints() &&
+        ps->GetPoints()->GetDataType() == VTK_DOUBLE;
+    if (!doublePoints && !hasDoubles(ds->GetPointData()) &&
+        !hasDoubles(ds->GetCellData()))
+      {
+      result->SetDataSet(it, ds);
+      continue;
+      }
+
+    vtkSmartPointer<vtkDataSet> leaf;
+    leaf.TakeReference(ds->NewInstance());
+    leaf->ShallowCopy(ds);
+    if (doublePoints)
+      {
+      vtkNew<vtkPoints> points;
+      points->SetData(convert(ps->GetPoints()->GetData()));
+      vtkPointSet::SafeDownCast(leaf)->SetPoints(points.Get());
+      }
+    convertArrays(leaf->GetPointData());
+    convertArrays(leaf->GetCellData());
+    result->SetDataSet(it, leaf);
+    }
+  it->Delete();
+
+  return result;
+}
+
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkDataArray> mvSinglePrecision::convert(vtkDataArray *array)
+{
+  if (!array || array->GetDataType() != VTK_DOUBLE)
+    {
+    return array;
+    }
+
+  const int numComps = array->GetNumberOfComponents();
+  const vtkIdType numTuples = array->GetNumberOfTuples();
+
+  // Convert and compute the exact ranges in one pass. NaNs fail both
+  // comparisons and are skipped.
+  std::vector<double> ranges;
+  for (int c = 0; c < numComps; ++c)
+    {
+    ranges.push_back(std::numeric_limits<double>::max());
+    ranges.push_back(std::numeric_limits<double>::lowest());
+    }
+  auto convertValue = [&ranges](double value, int c)
+  {
+    if (value < ranges[2 * c])
+      {
+      ranges[2 * c] = value;
+      }
+    if (value > ranges[2 * c + 1])
+      {
+      ranges[2 * c + 1] = value;
+      }
+    return static_cast<float>(value);
+  };
+
+  vtkSmartPointer<vtkDataArray> result;
+  if (vtkDoubleArray *doubles = vtkDoubleArray::SafeDownCast(array))
+    {
+    vtkSmartPointer<vtkFloatArray> floats =
+        vtkSmartPointer<vtkFloatArray>::New();
+    floats->SetNumberOfComponents(numComps);
+    floats->SetNumberOfTuples(numTuples);
+    const double *src = doubles->GetPointer(0);
+    float *dst = floats->GetPointer(0);
+    for (vtkIdType t = 0; t < numTuples; ++t)
+      {
+      for (int c = 0; c < numComps; ++c)
+        {
+        *dst++ = convertValue(*src++, c);
+        }
+      }
+    result = floats;
+    }
+  else if (auto *soa =
+           vtkArrayDownCast<vtkSOADataArrayTemplate<double> >(array))
+    {
+    // Keep the layout, converting one component buffer at a time:
+    vtkSmartPointer<vtkSOADataArrayTemplate<float> > floats =
+        vtkSmartPointer<vtkSOADataArrayTemplate<float> >::New();
+    floats->SetNumberOfComponents(numComps);
+    floats->SetNumberOfTuples(numTuples);
+    for (int c = 0; c < numComps; ++c)
+      {
+      const double *src = soa->GetComponentArrayPointer(c);
+      float *dst = floats->GetComponentArrayPointer(c);
+      for (vtkIdType t = 0; t < numTuples; ++t)
+        {
+        dst[t] = convertValue(src[t], c);
+        }
+      }
+    result = floats;
+    }
+  else
+    {
+    return array;
+    }
+  result->SetName(array->GetName());
+  result->CopyComponentNames(array);
+
+  // Seed the range cache that vtkDataArray::GetRange() consults. This is set
+  // after the values are written, so the cache is newer than the array.
+  vtkNew<vtkInformationVector> perComponent;
+  perComponent->SetNumberOfInformationObjects(numComps);
+  for (int c = 0; c < numComps; ++c)
+    {
+    if (ranges[2 * c] <= ranges[2 * c + 1])
+      {
+      perComponent->GetInformationObject(c)->Set(
+            vtkDataArray::COMPONENT_RANGE(), &ranges[2 * c], 2);
+      }
+    }
+  result->GetInformation()->Set(vtkAbstractArray::PER_COMPONENT(),
+                                perComponent.Get());
+
+  return result;
+}
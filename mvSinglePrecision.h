@@ -0,0 +1,45 @@
+#ifndef MVSINGLEPRECISION_H
+#define MVSINGLEPRECISION_H
+
+#include <vtkSmartPointer.h>
+
+class vtkDataArray;
+class vtkMultiBlockDataSet;
+
+/**
+ * @brief The mvSinglePrecision class converts datasets read as doubles to
+ * single precision.
+ *
+ * The coordinates and the double point and cell arrays of every leaf are
+ * converted to float. Other arrays (ids, connectivity, field data) are kept.
+ * Arrays with one buffer per component (vtkSOADataArrayTemplate) keep that
+ * layout.
+ *
+ * The range of each component is computed from the double values during the
+ * conversion and stored in the float array's range cache, so that
+ * vtkDataArray::GetRange() on a converted array reports the exact range of
+ * the original data rather than a rounded one. Values beyond the float range
+ * become infinite.
+ */
+class mvSinglePrecision
+{
+public:
+  /**
+   * Return a copy of @a mbds with converted leaves. The input is not
+   * modified. Leaves without double data are shared with the input.
+   */
+  static vtkSmartPointer<vtkMultiBlockDataSet> convert(
+      vtkMultiBlockDataSet *mbds);
+
+  /**
+   * Return a float copy of @a array if it holds doubles, or @a array itself
+   * otherwise.
+   */
+  static vtkSmartPointer<vtkDataArray> convert(vtkDataArray *array);
+
+private:
+  // Not implemented -- static API only:
+  mvSinglePrecision();
+};
+
+#endif // MVSINGLEPRECISION_H
@@ -336,6 +336,9 @@ mvSlice::HiResDataPipeline::HiResDataPipeline()
 //  this->contour->UseScalarTreeOn();
 //  this->contour->MergePiecesOn();
   this->cutter->MergePiecesOff();
+
+  this->cancel.watch(this->addPlane.Get());
+  this->cancel.watch(this->cutter.Get());
 }
 
 //------------------------------------------------------------------------------
@@ -346,6 +349,8 @@ void mvSlice::HiResDataPipeline::configure(const ObjectState &objState,
       static_cast<const mvApplicationState &>(vvState);
   const SliceState& sliceState = static_cast<const SliceState&>(objState);
 
+  this->memory.configure(appState.memoryBudget(), sliceState.visible);
+  this->cancel.configure(appState.reader());
   this->addPlane->SetInputDataObject(appState.reader().dataObject());
 
   this->cutter->SetInputArrayToProcess(0, 0, 0,
@@ -355,6 +360,12 @@ void mvSlice::HiResDataPipeline::configure(const ObjectState &objState,
   // Casts are for VTK (not const-correct)
   this->plane->SetNormal(const_cast<double*>(sliceState.plane.normal.data()));
   this->plane->SetOrigin(const_cast<double*>(sliceState.plane.origin.data()));
+
+  vtkDataObject *input = this->addPlane->GetInputDataObject(0, 0);
+  this->memory.request(this->memory.estimate(input),
+                       std::max({this->plane->GetMTime(),
+                                 this->addPlane->GetMTime(),
+                                 this->cutter->GetMTime()}));
 }
 
 //------------------------------------------------------------------------------
@@ -364,8 +375,15 @@ bool mvSlice::HiResDataPipeline::needsUpdate(const ObjectState &objState,
   const SliceState& sliceState = static_cast<const SliceState&>(objState);
   const HiResLODData& data = static_cast<const HiResLODData&>(result);
 
+  if (this->memory.release())
+    {
+    return data.slice != nullptr;
+    }
+
   return
       sliceState.visible &&
+      this->memory.allowed() &&
+      !this->cancel.superseded() &&
       this->addPlane->GetInputDataObject(0, 0) &&
       (!data.slice ||
        data.slice->GetMTime() < this->plane->GetMTime() ||
@@ -376,7 +394,11 @@ bool mvSlice::HiResDataPipeline::needsUpdate(const ObjectState &objState,
 //------------------------------------------------------------------------------
 void mvSlice::HiResDataPipeline::execute()
 {
-  this->cutter->Update();
+  if (!this->memory.release() && this->cancel.start())
+    {
+    this->cutter->Update();
+    }
+  this->cancel.finish();
 }
 
 //------------------------------------------------------------------------------
@@ -384,9 +406,23 @@ void mvSlice::HiResDataPipeline::exportResult(LODData &result) const
 {
   HiResLODData& data = static_cast<HiResLODData&>(result);
 
-  vtkDataObject *newSlice = this->cutter->GetOutputDataObject(0);
-  data.slice.TakeReference(newSlice->NewInstance());
-  data.slice->ShallowCopy(newSlice);
+  if (!this->memory.release() && this->cancel.cancelled())
+    {
+    // Keep the previous slice until the current timestep is cut:
+    return;
+    }
+
+  if (this->memory.release())
+    {
+    data.slice = nullptr;
+    }
+  else
+    {
+    vtkDataObject *newSlice = this->cutter->GetOutputDataObject(0);
+    data.slice.TakeReference(newSlice->NewInstance());
+    data.slice->ShallowCopy(newSlice);
+    }
+  this->memory.exportResult(data.slice);
 }
 
 //------------------------------------------------------------------------------
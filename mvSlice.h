@@ -3,6 +3,9 @@
 
 #include "vvLODAsyncGLObject.h"
 
+#include "mvCancellation.h"
+#include "mvMemoryBudget.h"
+
 #include <vtkNew.h>
 #include <vtkSmartPointer.h>
 
@@ -129,6 +132,8 @@ public:
     vtkNew<vtkPlane> plane;
     vtkNew<vtkSampleImplicitFunctionFilter> addPlane;
     vtkNew<vtkSMPContourGrid> cutter;
+    mvMemoryBudget::Result memory{"Slice"};
+    mvCancellation cancel;
 
     HiResDataPipeline();
     void configure(const ObjectState &objState,
@@ -0,0 +1,469 @@
+#include "mvStatisticsIndex.h"
+
+#include <vtkCellData.h>
+#include <vtkCompositeDataIterator.h>
+#include <vtkDataArray.h>
+#include <vtkDataSet.h>
+#include <vtkMultiBlockDataSet.h>
+#include <vtkPointData.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+#include <sys/stat.h>
+
+namespace {
+
+const char SidecarMagic[8] = {'M', 'V', 'S', 'T', 'A', 'T', 'S', '1'};
+
+// Marks the end of the records of one (variable, timestep). Keys without it
+// were not completely written, and are ignored when loading.
+const std::uint32_t EndOfKey = 0xffffffff;
+
+//------------------------------------------------------------------------------
+template <typename T>
+void writeValue(std::ostream &out, const T &value)
+{
+  out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+//------------------------------------------------------------------------------
+template <typename T>
+bool readValue(std::istream &in, T &value)
+{
+  return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+//------------------------------------------------------------------------------
+void writeRecord(std::ostream &out, const std::string &variable, int step,
+                 std::uint32_t block,
+                 const mvStatisticsIndex::Statistics &stats)
+{
+  writeValue(out, static_cast<std::uint32_t>(variable.size()));
+  out.write(variable.data(), variable.size());
+  writeValue(out, static_cast<std::int32_t>(step));
+  writeValue(out, block);
+  writeValue(out, static_cast<std::int64_t>(stats.count));
+  writeValue(out, stats.min);
+  writeValue(out, stats.max);
+  writeValue(out, stats.mean);
+  out.write(reinterpret_cast<const char*>(stats.histogram.data()),
+            sizeof(double) * stats.histogram.size());
+}
+
+//------------------------------------------------------------------------------
+bool readRecord(std::istream &in, std::string &variable, int &step,
+                std::uint32_t &block, mvStatisticsIndex::Statistics &stats)
+{
+  std::uint32_t length;
+  std::int32_t step32;
+  std::int64_t count;
+  if (!readValue(in, length) || length > 4096)
+    {
+    return false;
+    }
+  variable.resize(length);
+  if (!in.read(&variable[0], length) ||
+      !readValue(in, step32) || !readValue(in, block) ||
+      !readValue(in, count) || !readValue(in, stats.min) ||
+      !readValue(in, stats.max) || !readValue(in, stats.mean) ||
+      !in.read(reinterpret_cast<char*>(stats.histogram.data()),
+               sizeof(double) * stats.histogram.size()))
+    {
+    return false;
+    }
+  step = step32;
+  stats.count = static_cast<vtkIdType>(count);
+  return true;
+}
+
+} // end anon namespace
+
+//------------------------------------------------------------------------------
+mvStatisticsIndex::mvStatisticsIndex()
+  : m_fileSize(0),
+    m_fileTime(0),
+    m_persistent(false),
+    m_rewrite(false)
+{
+}
+
+//------------------------------------------------------------------------------
+mvStatisticsIndex::~mvStatisticsIndex()
+{
+  this->save();
+}
+
+//------------------------------------------------------------------------------
+void mvStatisticsIndex::setFileName(const std::string &fileName)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (fileName == m_fileName)
+    {
+    return;
+    }
+
+  this->saveLocked();
+
+  m_fileName = fileName;
+  m_entries.clear();
+  m_unsaved.clear();
+  this->loadLocked();
+}
+
+//------------------------------------------------------------------------------
+void mvStatisticsIndex::add(const mvReadSettings &settings, int step,
+                            vtkMultiBlockDataSet *mbds)
+{
+  if (!mbds || !settings.defaultObjects())
+    {
+    return;
+    }
+
+  for (const auto &var : settings.variables)
+    {
+    if (this->contains(var, step))
+      {
+      continue;
+      }
+
+    // Compute without holding the lock:
+    Blocks blocks;
+    vtkCompositeDataIterator *it = mbds->NewIterator();
+    for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextItem())
+      {
+      vtkDataSet *ds = vtkDataSet::SafeDownCast(it->GetCurrentDataObject());
+      if (!ds)
+        {
+        continue;
+        }
+
+      vtkDataArray *array = ds->GetPointData()->GetArray(var.c_str());
+      if (!array)
+        {
+        array = ds->GetCellData()->GetArray(var.c_str());
+        }
+      if (array)
+        {
+        blocks[it->GetCurrentFlatIndex()] = compute(array);
+        }
+      }
+    it->Delete();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const Key key(var, step);
+    if (m_entries.insert(std::make_pair(key, blocks)).second)
+      {
+      m_unsaved.push_back(key);
+      }
+    }
+}
+
+//------------------------------------------------------------------------------
+bool mvStatisticsIndex::contains(const std::string &variable, int step) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_entries.find(Key(variable, step)) != m_entries.end();
+}
+
+//------------------------------------------------------------------------------
+bool mvStatisticsIndex::find(const std::string &variable, int step,
+                             unsigned int block, Statistics &stats) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto entry = m_entries.find(Key(variable, step));
+  if (entry == m_entries.end())
+    {
+    return false;
+    }
+
+  auto it = entry->second.find(block);
+  if (it == entry->second.end())
+    {
+    return false;
+    }
+
+  stats = it->second;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool mvStatisticsIndex::summary(const std::string &variable, int step,
+                                Statistics &stats) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto entry = m_entries.find(Key(variable, step));
+  if (entry == m_entries.end())
+    {
+    return false;
+    }
+
+  stats.min = std::numeric_limits<double>::max();
+  stats.max = std::numeric_limits<double>::lowest();
+  stats.mean = 0.;
+  stats.count = 0;
+  stats.histogram.fill(0.);
+
+  double sum = 0.;
+  for (const auto &block : entry->second)
+    {
+    const Statistics &b = block.second;
+    if (b.count > 0)
+      {
+      stats.min = std::min(stats.min, b.min);
+      stats.max = std::max(stats.max, b.max);
+      stats.count += b.count;
+      sum += b.mean * b.count;
+      }
+    }
+
+  if (stats.count > 0)
+    {
+    stats.mean = sum / stats.count;
+    const double range[2] = { stats.min, stats.max };
+    for (const auto &block : entry->second)
+      {
+      resample(block.second, range, stats.histogram.data(), NumberOfBins);
+      }
+    }
+  return stats.count > 0;
+}
+
+//------------------------------------------------------------------------------
+bool mvStatisticsIndex::histogram(const std::string &variable, int step,
+                                  const double range[2], float *bins,
+                                  int numBins) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto entry = m_entries.find(Key(variable, step));
+  if (entry == m_entries.end())
+    {
+    return false;
+    }
+
+  std::vector<double> result(numBins, 0.);
+  for (const auto &block : entry->second)
+    {
+    resample(block.second, range, result.data(), numBins);
+    }
+  for (int i = 0; i < numBins; ++i)
+    {
+    bins[i] += static_cast<float>(result[i]);
+    }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void mvStatisticsIndex::save()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  this->saveLocked();
+}
+
+//------------------------------------------------------------------------------
+mvStatisticsIndex::Statistics mvStatisticsIndex::compute(vtkDataArray *array)
+{
+  Statistics stats;
+  stats.min = std::numeric_limits<double>::max();
+  stats.max = std::numeric_limits<double>::lowest();
+  stats.mean = 0.;
+  stats.count = 0;
+  stats.histogram.fill(0.);
+
+  double sum = 0.;
+  const vtkIdType numTuples = array->GetNumberOfTuples();
+  for (vtkIdType t = 0; t < numTuples; ++t)
+    {
+    const double value = array->GetComponent(t, 0);
+    if (std::isnan(value))
+      {
+      continue;
+      }
+    stats.min = std::min(stats.min, value);
+    stats.max = std::max(stats.max, value);
+    sum += value;
+    ++stats.count;
+    }
+
+  if (stats.count == 0)
+    {
+    return stats;
+    }
+
+  stats.mean = sum / stats.count;
+  const double spread = stats.max - stats.min;
+  for (vtkIdType t = 0; t < numTuples; ++t)
+    {
+    const double value = array->GetComponent(t, 0);
+    if (std::isnan(value))
+      {
+      continue;
+      }
+    int bin = spread > 0.
+        ? static_cast<int>((value - stats.min) * NumberOfBins / spread) : 0;
+    ++stats.histogram[std::min(bin, NumberOfBins - 1)];
+    }
+
+  return stats;
+}
+
+//------------------------------------------------------------------------------
+void mvStatisticsIndex::saveLocked()
+{
+  if (!m_persistent || (m_unsaved.empty() && !m_rewrite))
+    {
+    return;
+    }
+
+  const std::ios::openmode mode = std::ios::binary |
+      (m_rewrite ? std::ios::trunc : std::ios::app);
+  std::ofstream out(sidecarName(m_fileName), mode);
+  if (!out)
+    {
+    // Read-only location, most likely. Keep the index in memory only.
+    m_unsaved.clear();
+    m_rewrite = false;
+    return;
+    }
+
+  std::vector<Key> keys;
+  if (m_rewrite)
+    {
+    out.write(SidecarMagic, sizeof(SidecarMagic));
+    writeValue(out, static_cast<std::int64_t>(m_fileSize));
+    writeValue(out, static_cast<std::int64_t>(m_fileTime));
+    writeValue(out, static_cast<std::int32_t>(NumberOfBins));
+    for (const auto &entry : m_entries)
+      {
+      keys.push_back(entry.first);
+      }
+    }
+  else
+    {
+    keys.swap(m_unsaved);
+    }
+
+  Statistics marker;
+  std::memset(&marker, 0, sizeof(marker));
+  for (const auto &key : keys)
+    {
+    const std::string &variable = std::get<0>(key);
+    const int step = std::get<1>(key);
+    for (const auto &block : m_entries[key])
+      {
+      writeRecord(out, variable, step, block.first, block.second);
+      }
+    writeRecord(out, variable, step, EndOfKey, marker);
+    }
+
+  m_unsaved.clear();
+  m_rewrite = false;
+}
+
+//------------------------------------------------------------------------------
+void mvStatisticsIndex::loadLocked()
+{
+  m_rewrite = true;
+  m_persistent = false;
+
+  // Keep m_fileName, so that setFileName() doesn't retry the same file:
+  struct stat info;
+  if (m_fileName.empty() || stat(m_fileName.c_str(), &info) != 0)
+    {
+    return;
+    }
+  m_persistent = true;
+  m_fileSize = static_cast<long long>(info.st_size);
+  m_fileTime = static_cast<long long>(info.st_mtime);
+
+  std::ifstream in(sidecarName(m_fileName), std::ios::binary);
+  char magic[sizeof(SidecarMagic)];
+  std::int64_t size;
+  std::int64_t time;
+  std::int32_t numBins;
+  if (!in.read(magic, sizeof(magic)) ||
+      std::memcmp(magic, SidecarMagic, sizeof(magic)) != 0 ||
+      !readValue(in, size) || !readValue(in, time) || !readValue(in, numBins) ||
+      size != m_fileSize || time != m_fileTime || numBins != NumberOfBins)
+    {
+    return; // Missing or stale.
+    }
+
+  std::map<Key, Blocks> partial;
+  std::string variable;
+  int step;
+  std::uint32_t block;
+  Statistics stats;
+  while (readRecord(in, variable, step, block, stats))
+    {
+    const Key key(variable, step);
+    if (block == EndOfKey)
+      {
+      m_entries[key] = partial[key];
+      partial.erase(key);
+      }
+    else
+      {
+      partial[key][block] = stats;
+      }
+    }
+
+  m_rewrite = false;
+}
+
+//------------------------------------------------------------------------------
+void mvStatisticsIndex::resample(const Statistics &stats,
+                                 const double range[2], double *bins,
+                                 int numBins)
+{
+  const double width = (range[1] - range[0]) / numBins;
+  if (stats.count == 0 || numBins <= 0 || width <= 0.)
+    {
+    return;
+    }
+
+  // Position in target bins, clamped to the histogram.
+  auto toBin = [&](double value)
+  {
+    return std::max(0., std::min(static_cast<double>(numBins),
+                                 (value - range[0]) / width));
+  };
+
+  const double sourceWidth = (stats.max - stats.min) / NumberOfBins;
+  for (int i = 0; i < NumberOfBins; ++i)
+    {
+    const double count = stats.histogram[i];
+    if (count == 0.)
+      {
+      continue;
+      }
+
+    const double t0 = toBin(stats.min + i * sourceWidth);
+    const double t1 = toBin(stats.min + (i + 1) * sourceWidth);
+    if (t1 - t0 <= 0.)
+      {
+      // Constant data, or entirely outside of range: use the nearest bin.
+      const int bin = std::min(static_cast<int>(t0), numBins - 1);
+      bins[bin] += count;
+      continue;
+      }
+
+    // Spread the count evenly over the bins the source bin overlaps:
+    for (int j = static_cast<int>(t0); j < numBins && j < t1; ++j)
+      {
+      const double overlap = std::min(t1, j + 1.) - std::max(t0, double(j));
+      bins[j] += count * overlap / (t1 - t0);
+      }
+    }
+}
+
+//------------------------------------------------------------------------------
+std::string mvStatisticsIndex::sidecarName(const std::string &fileName)
+{
+  return fileName + ".mvstats";
+}
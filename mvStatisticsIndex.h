@@ -0,0 +1,136 @@
+#ifndef MVSTATISTICSINDEX_H
+#define MVSTATISTICSINDEX_H
+
+#include <vtkType.h>
+
+#include <array>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "mvReadSettings.h"
+
+class vtkDataArray;
+class vtkMultiBlockDataSet;
+
+/**
+ * @brief The mvStatisticsIndex class records summary statistics of each
+ * variable, per timestep and per block, and persists them next to the data
+ * file.
+ *
+ * For every (variable, timestep, block), the index holds the min, max, mean,
+ * value count and a coarse histogram of the first component, which is the
+ * component used for all range computations. Once a timestep has been
+ * indexed for a variable, ranges, histograms and per-block value ranges (e.g.
+ * to skip blocks that can't contain a contour value) are available without
+ * touching the array data.
+ *
+ * The index is stored in "<file>.mvstats". New records are appended by
+ * save(), so the file is written incrementally; it is discarded when the size
+ * or modification time of the data file changes. The public API is
+ * thread-safe.
+ */
+class mvStatisticsIndex
+{
+public:
+  enum { NumberOfBins = 16 };
+
+  struct Statistics
+  {
+    double min;
+    double max;
+    double mean;
+    vtkIdType count;
+    // Value counts over [min, max], in NumberOfBins equal bins.
+    std::array<double, NumberOfBins> histogram;
+  };
+
+  mvStatisticsIndex();
+  ~mvStatisticsIndex();
+
+  /**
+   * The data file being indexed. Changing the file saves the current index
+   * and loads the sidecar of the new file, if it is still valid.
+   */
+  void setFileName(const std::string &fileName);
+
+  /**
+   * Compute and record the statistics of the variables in @a settings in
+   * every block of @a mbds, read at @a step. Variables already indexed at
+   * @a step are skipped. Block indices are only comparable between datasets
+   * with the same structure, so nothing is recorded unless @a settings read
+   * the default objects.
+   */
+  void add(const mvReadSettings &settings, int step,
+           vtkMultiBlockDataSet *mbds);
+
+  /** Returns true if @a variable has been indexed at @a step. */
+  bool contains(const std::string &variable, int step) const;
+
+  /**
+   * Statistics of @a variable in the block at flat index @a block. Returns
+   * false if unknown.
+   */
+  bool find(const std::string &variable, int step, unsigned int block,
+            Statistics &stats) const;
+
+  /**
+   * Statistics of @a variable over all blocks at @a step. The histogram is
+   * approximate. Returns false if @a variable is not indexed at @a step, or
+   * has no values there (see contains()).
+   */
+  bool summary(const std::string &variable, int step,
+               Statistics &stats) const;
+
+  /**
+   * Add the histogram of @a variable at @a step, resampled to @a numBins
+   * equal bins over @a range, to @a bins. Returns false if @a variable is not
+   * indexed at @a step.
+   */
+  bool histogram(const std::string &variable, int step, const double range[2],
+                 float *bins, int numBins) const;
+
+  /** Append the records added since the last save to the sidecar. */
+  void save();
+
+  /** Compute the statistics of the first component of @a array. */
+  static Statistics compute(vtkDataArray *array);
+
+private:
+  using Key = std::tuple<std::string, int>; // (variable, timestep)
+  using Blocks = std::map<unsigned int, Statistics>;
+
+  void saveLocked();
+  void loadLocked();
+
+  // Spread the histogram of stats over numBins equal bins covering range.
+  static void resample(const Statistics &stats, const double range[2],
+                       double *bins, int numBins);
+
+  static std::string sidecarName(const std::string &fileName);
+
+private:
+  // Not implemented -- disable copy:
+  mvStatisticsIndex(const mvStatisticsIndex&);
+  mvStatisticsIndex& operator=(const mvStatisticsIndex&);
+
+private:
+  mutable std::mutex m_mutex;
+  std::string m_fileName;
+  long long m_fileSize;
+  long long m_fileTime;
+  // False if m_fileName could not be stat'ed. The index is then kept in
+  // memory only.
+  bool m_persistent;
+
+  std::map<Key, Blocks> m_entries;
+
+  // Keys not yet written to the sidecar:
+  std::vector<Key> m_unsaved;
+  // True if the sidecar is missing or stale, and must be rewritten.
+  bool m_rewrite;
+};
+
+#endif // MVSTATISTICSINDEX_H
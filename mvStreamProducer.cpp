@@ -0,0 +1,364 @@
+// Stand-alone test producer for mvStreamReader.
+//
+// Listens on a Unix domain socket, waits for MooseViewer to connect and sends
+// a synthetic transient hexahedral mesh in the mvStreamProtocol format:
+//
+//   ./mvStreamProducer /tmp/mv.sock &
+//   ./MooseViewer -f unix:/tmp/mv.sock
+//
+// Does not depend on VTK, so that it doubles as an example for instrumenting
+// a simulation.
+
+// STD includes
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// POSIX includes
+#include <signal.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// MooseViewer includes
+#include "mvStreamProtocol.h"
+
+namespace {
+
+const std::uint8_t Hexahedron = 12; // VTK_HEXAHEDRON
+
+//------------------------------------------------------------------------------
+// Collects the payload of one message.
+class Message
+{
+public:
+  template <typename T>
+  void add(const T &value)
+  {
+    this->add(&value, sizeof(T));
+  }
+
+  template <typename T>
+  void add(const std::vector<T> &values)
+  {
+    this->add(values.data(), values.size() * sizeof(T));
+  }
+
+  void add(const std::string &str)
+  {
+    this->add(static_cast<std::uint32_t>(str.size()));
+    this->add(str.data(), str.size());
+  }
+
+  void add(const void *data, size_t size)
+  {
+    const char *bytes = static_cast<const char*>(data);
+    m_payload.insert(m_payload.end(), bytes, bytes + size);
+  }
+
+  bool send(int fd, mvStreamProtocol::MessageType type) const
+  {
+    mvStreamProtocol::MessageHeader header;
+    std::memcpy(header.magic, mvStreamProtocol::Magic, sizeof(header.magic));
+    header.type = type;
+    header.size = m_payload.size();
+    return sendAll(fd, &header, sizeof(header)) &&
+        sendAll(fd, m_payload.data(), m_payload.size());
+  }
+
+private:
+  static bool sendAll(int fd, const void *data, size_t size)
+  {
+    const char *bytes = static_cast<const char*>(data);
+    while (size > 0)
+      {
+      const ssize_t sent = ::send(fd, bytes, size, 0);
+      if (sent <= 0)
+        {
+        return false;
+        }
+      bytes += sent;
+      size -= static_cast<size_t>(sent);
+      }
+    return true;
+  }
+
+  std::vector<char> m_payload;
+};
+
+//------------------------------------------------------------------------------
+// A structured block of n^3 hexahedra, offset along x.
+struct Block
+{
+  std::string name;
+  std::vector<double> points;
+  std::vector<std::int64_t> offsets;
+  std::vector<std::int64_t> connectivity;
+
+  std::int64_t numPoints() const { return points.size() / 3; }
+  std::int64_t numCells() const { return offsets.size() - 1; }
+};
+
+//------------------------------------------------------------------------------
+Block makeBlock(int index, int n)
+{
+  Block block;
+  block.name = "block_" + std::to_string(index + 1);
+  const int np = n + 1;
+  for (int k = 0; k < np; ++k)
+    {
+    for (int j = 0; j < np; ++j)
+      {
+      for (int i = 0; i < np; ++i)
+        {
+        block.points.push_back(index + static_cast<double>(i) / n);
+        block.points.push_back(static_cast<double>(j) / n);
+        block.points.push_back(static_cast<double>(k) / n);
+        }
+      }
+    }
+
+  block.offsets.push_back(0);
+  for (int k = 0; k < n; ++k)
+    {
+    for (int j = 0; j < n; ++j)
+      {
+      for (int i = 0; i < n; ++i)
+        {
+        const std::int64_t p = i + np * (j + np * k);
+        const std::int64_t ids[8] = {
+          p, p + 1, p + 1 + np, p + np,
+          p + np * np, p + 1 + np * np, p + 1 + np + np * np, p + np + np * np
+        };
+        block.connectivity.insert(block.connectivity.end(), ids, ids + 8);
+        block.offsets.push_back(block.connectivity.size());
+        }
+      }
+    }
+  return block;
+}
+
+//------------------------------------------------------------------------------
+bool sendBlock(int fd, const Block &block)
+{
+  Message message;
+  message.add(block.name);
+  message.add(block.numPoints());
+  message.add(block.numCells());
+  message.add(static_cast<std::int64_t>(block.connectivity.size()));
+  message.add(block.points);
+  message.add(std::vector<std::uint8_t>(block.numCells(), Hexahedron));
+  message.add(block.offsets);
+  message.add(block.connectivity);
+  return message.send(fd, mvStreamProtocol::Block);
+}
+
+//------------------------------------------------------------------------------
+template <typename T>
+void addArray(Message &message, std::uint32_t block,
+              mvStreamProtocol::ArrayAssociation association,
+              const std::string &name, std::uint32_t numComponents,
+              const std::vector<T> &values)
+{
+  message.add(block);
+  message.add(static_cast<std::uint8_t>(association));
+  message.add(static_cast<std::uint8_t>(sizeof(T) == sizeof(float)
+                                        ? mvStreamProtocol::Float32
+                                        : mvStreamProtocol::Float64));
+  message.add(name);
+  message.add(numComponents);
+  message.add(static_cast<std::int64_t>(values.size() / numComponents));
+  message.add(values);
+}
+
+//------------------------------------------------------------------------------
+// A travelling wave: "temperature" and "velocity" on the points, "stress"
+// (single precision) on the cells.
+bool sendStep(int fd, const std::vector<Block> &blocks, int step)
+{
+  const double time = 0.1 * step;
+  Message message;
+  message.add(time);
+  message.add(static_cast<std::uint32_t>(3 * blocks.size()));
+  for (size_t b = 0; b < blocks.size(); ++b)
+    {
+    const Block &block = blocks[b];
+    std::vector<double> temperature;
+    std::vector<double> velocity;
+    for (std::int64_t p = 0; p < block.numPoints(); ++p)
+      {
+      const double *x = &block.points[3 * p];
+      temperature.push_back(std::sin(3. * x[0] - time) * std::cos(2. * x[1]));
+      velocity.push_back(std::cos(x[2] + time));
+      velocity.push_back(std::sin(x[0] - time));
+      velocity.push_back(0.1 * x[1]);
+      }
+
+    std::vector<float> stress;
+    for (std::int64_t c = 0; c < block.numCells(); ++c)
+      {
+      const double *x = &block.points[3 * block.connectivity[8 * c]];
+      stress.push_back(static_cast<float>(x[0] * x[2] + 0.5 * std::sin(time)));
+      }
+
+    const std::uint32_t index = static_cast<std::uint32_t>(b);
+    addArray(message, index, mvStreamProtocol::PointData, "temperature", 1,
+             temperature);
+    addArray(message, index, mvStreamProtocol::PointData, "velocity", 3,
+             velocity);
+    addArray(message, index, mvStreamProtocol::CellData, "stress", 1, stress);
+    }
+  return message.send(fd, mvStreamProtocol::Step);
+}
+
+//------------------------------------------------------------------------------
+void printUsage()
+{
+  std::cout << "\nmvStreamProducer - Stream a synthetic simulation to "
+               "MooseViewer" << std::endl;
+  std::cout << "\nUSAGE:\n\t./mvStreamProducer <socket> [-blocks <digit>] "
+               "[-size <digit>]\n\t\t[-steps <digit>] [-interval <ms>]"
+            << std::endl;
+  std::cout << "\nWhere:" << std::endl;
+  std::cout << "\t<socket>" << std::endl;
+  std::cout << "\tPath of the Unix domain socket to listen on. Open it with\n"
+               "\tMooseViewer -f unix:<socket>.\n" << std::endl;
+  std::cout << "\t-blocks <digit>" << std::endl;
+  std::cout << "\tNumber of element blocks (default 3).\n" << std::endl;
+  std::cout << "\t-size <digit>" << std::endl;
+  std::cout << "\tHexahedra along each edge of a block (default 20).\n"
+            << std::endl;
+  std::cout << "\t-steps <digit>" << std::endl;
+  std::cout << "\tNumber of timesteps to send (default 100).\n" << std::endl;
+  std::cout << "\t-interval <ms>" << std::endl;
+  std::cout << "\tTime between timesteps (default 500).\n" << std::endl;
+}
+
+} // end anon namespace
+
+//------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  if (argc < 2 || argv[1][0] == '-')
+    {
+    printUsage();
+    return 1;
+    }
+  const std::string socketPath = argv[1];
+  int numBlocks = 3;
+  int size = 20;
+  int numSteps = 100;
+  int interval = 500;
+  for (int i = 2; i + 1 < argc; i += 2)
+    {
+    const int value = std::atoi(argv[i + 1]);
+    if (strcasecmp(argv[i], "-blocks") == 0)
+      {
+      numBlocks = value;
+      }
+    else if (strcasecmp(argv[i], "-size") == 0)
+      {
+      size = value;
+      }
+    else if (strcasecmp(argv[i], "-steps") == 0)
+      {
+      numSteps = value;
+      }
+    else if (strcasecmp(argv[i], "-interval") == 0)
+      {
+      interval = value;
+      }
+    else
+      {
+      printUsage();
+      return 1;
+      }
+    }
+  if (numBlocks < 1 || size < 1 || numSteps < 0 || interval < 0)
+    {
+    printUsage();
+    return 1;
+    }
+
+  sockaddr_un address;
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (socketPath.size() >= sizeof(address.sun_path))
+    {
+    std::cerr << "mvStreamProducer: Socket path is too long." << std::endl;
+    return 1;
+    }
+  std::strncpy(address.sun_path, socketPath.c_str(),
+               sizeof(address.sun_path) - 1);
+
+  // A closed viewer must not kill the producer:
+  signal(SIGPIPE, SIG_IGN);
+
+  const int server = socket(AF_UNIX, SOCK_STREAM, 0);
+  unlink(socketPath.c_str());
+  if (server < 0 ||
+      bind(server, reinterpret_cast<sockaddr*>(&address),
+           sizeof(address)) != 0 ||
+      listen(server, 1) != 0)
+    {
+    std::cerr << "mvStreamProducer: Cannot listen on '" << socketPath << "': "
+              << std::strerror(errno) << std::endl;
+    return 1;
+    }
+
+  std::vector<Block> blocks;
+  for (int b = 0; b < numBlocks; ++b)
+    {
+    blocks.push_back(makeBlock(b, size));
+    }
+
+  std::cout << "Waiting for a viewer on '" << socketPath << "'..."
+            << std::endl;
+  const int fd = accept(server, nullptr, nullptr);
+  if (fd < 0)
+    {
+    std::cerr << "mvStreamProducer: accept failed: " << std::strerror(errno)
+              << std::endl;
+    return 1;
+    }
+
+  bool ok = true;
+  for (size_t b = 0; ok && b < blocks.size(); ++b)
+    {
+    ok = sendBlock(fd, blocks[b]);
+    }
+  for (int step = 0; ok && step < numSteps; ++step)
+    {
+    if (step > 0)
+      {
+      std::this_thread::sleep_for(std::chrono::milliseconds(interval));
+      }
+    ok = sendStep(fd, blocks, step);
+    if (ok)
+      {
+      std::cout << "Sent timestep " << step + 1 << "/" << numSteps << "."
+                << std::endl;
+      }
+    }
+  if (ok)
+    {
+    ok = Message().send(fd, mvStreamProtocol::End);
+    }
+  if (!ok)
+    {
+    std::cerr << "mvStreamProducer: The viewer disconnected." << std::endl;
+    }
+
+  close(fd);
+  close(server);
+  unlink(socketPath.c_str());
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,67 @@
+#ifndef MVSTREAMPROTOCOL_H
+#define MVSTREAMPROTOCOL_H
+
+#include <cstdint>
+
+/**
+ * @brief The wire format of the in-situ stream read by mvStreamReader and
+ * written by the mvStreamProducer test program.
+ *
+ * The simulation listens on a Unix domain socket and MooseViewer connects to
+ * it. Both run on the same host, so all values are in native byte order. The
+ * stream is a sequence of messages, each a MessageHeader followed by
+ * MessageHeader::size bytes of payload:
+ *
+ * - Block, once per element block, before the first Step:
+ *   uint32 nameLength, char name[nameLength],
+ *   int64 numPoints, int64 numCells, int64 numConnectivityIds,
+ *   float64 points[numPoints * 3], uint8 cellTypes[numCells] (VTK types),
+ *   int64 offsets[numCells + 1], int64 connectivity[numConnectivityIds].
+ *   The connectivity of a block indexes its own points.
+ *
+ * - Step, once per timestep:
+ *   float64 time, uint32 numArrays, then for each array:
+ *   uint32 block, uint8 association (ArrayAssociation),
+ *   uint8 valueType (ValueType), uint32 nameLength, char name[nameLength],
+ *   uint32 numComponents, int64 numTuples, values[numTuples * numComponents].
+ *   numTuples must match the block's points or cells.
+ *
+ * - End, when the simulation finishes. No payload.
+ *
+ * Messages of unknown types are skipped.
+ */
+namespace mvStreamProtocol {
+
+const char Magic[4] = {'M', 'V', 'S', '1'};
+
+enum MessageType : std::uint32_t
+{
+  Block = 1,
+  Step = 2,
+  End = 3
+};
+
+enum ArrayAssociation : std::uint8_t
+{
+  PointData = 0,
+  CellData = 1
+};
+
+enum ValueType : std::uint8_t
+{
+  Float64 = 0,
+  Float32 = 1
+};
+
+struct MessageHeader
+{
+  char magic[4];
+  std::uint32_t type;
+  std::uint64_t size; // Payload bytes following the header.
+};
+static_assert(sizeof(MessageHeader) == 16,
+              "The message header must have no padding.");
+
+} // end namespace mvStreamProtocol
+
+#endif // MVSTREAMPROTOCOL_H
@@ -0,0 +1,627 @@
+#include "mvStreamReader.h"
+
+#include "mvStreamProtocol.h"
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkMultiBlockDataSet.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+const double mvStreamReader::ConnectTimeout = 30.;
+const int mvStreamReader::StoredTimeSteps = 64;
+
+/**
+ * The connection to one socket, and everything received from it.
+ */
+class mvStreamReader::Connection
+{
+public:
+  explicit Connection(const std::string &socketPath);
+  ~Connection();
+
+  // Wait up to seconds for the first timestep. Returns false on timeout.
+  bool waitForFirstStep(double seconds);
+
+  void information(Information &info) const;
+
+  // Whether step was received and is still held.
+  bool holds(int step) const;
+
+  // The blocks of step in settings, with the requested arrays, or false if
+  // step has not been received or is no longer held.
+  bool read(const mvReadSettings &settings, int step,
+            std::vector<vtkSmartPointer<vtkUnstructuredGrid> > &blocks,
+            std::vector<std::string> &names) const;
+
+private:
+  struct Block
+  {
+    std::string name;
+    int64_t numPoints{0};
+    int64_t numCells{0};
+    vtkSmartPointer<vtkPoints> points;
+    vtkSmartPointer<vtkUnsignedCharArray> types;
+    vtkSmartPointer<vtkIdTypeArray> locations;
+    vtkSmartPointer<vtkCellArray> cells;
+  };
+
+  struct Array
+  {
+    size_t block{0};
+    bool cellData{false};
+    vtkSmartPointer<vtkDataArray> values;
+  };
+
+  struct Step
+  {
+    double time{0.};
+    std::vector<Array> arrays; // Cleared once outside the stored window.
+    bool dropped{false};
+  };
+
+  void receiveLoop();
+  bool connectSocket();
+
+  // Receive exactly size bytes. Returns false if the stream ended.
+  bool receive(void *data, size_t size);
+  bool receiveString(std::string &str, uint64_t &remaining);
+  bool receiveBlock(uint64_t size);
+  bool receiveStep(uint64_t size);
+  bool skip(uint64_t size);
+
+private:
+  // Not implemented -- disable copy:
+  Connection(const Connection&);
+  Connection& operator=(const Connection&);
+
+private:
+  const std::string m_path;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_condition;
+  std::thread m_thread;
+  bool m_quit;
+  int m_socket; // -1 unless connected.
+  bool m_finished;
+
+  // Blocks are only added before the first step. Only the arrays of the
+  // latest StoredTimeSteps steps are kept, but the times of all steps are, so
+  // that the timestep numbers stay put.
+  std::vector<Block> m_blocks;
+  std::vector<Step> m_steps;
+  std::set<std::string> m_pointVariables;
+  std::set<std::string> m_cellVariables;
+};
+
+//------------------------------------------------------------------------------
+mvStreamReader::Connection::Connection(const std::string &socketPath)
+  : m_path(socketPath),
+    m_quit(false),
+    m_socket(-1),
+    m_finished(false)
+{
+  m_thread = std::thread(&Connection::receiveLoop, this);
+}
+
+//------------------------------------------------------------------------------
+mvStreamReader::Connection::~Connection()
+{
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_quit = true;
+    if (m_socket >= 0)
+      {
+      // Wakes up the blocking receive:
+      shutdown(m_socket, SHUT_RDWR);
+      }
+    }
+  m_condition.notify_all();
+  m_thread.join();
+}
+
+//------------------------------------------------------------------------------
+bool mvStreamReader::Connection::waitForFirstStep(double seconds)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  const std::chrono::duration<double> timeout(seconds);
+  return m_condition.wait_for(lock, timeout, [this]()
+    {
+    return !m_steps.empty() || m_finished;
+    }) && !m_steps.empty();
+}
+
+//------------------------------------------------------------------------------
+void mvStreamReader::Connection::information(Information &info) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  info.numberOfTimeSteps = static_cast<int>(m_steps.size());
+  info.times.clear();
+  for (const Step &step : m_steps)
+    {
+    info.times.push_back(step.time);
+    }
+  info.pointVariables = m_pointVariables;
+  info.cellVariables = m_cellVariables;
+  info.blocks.clear();
+  for (const Block &block : m_blocks)
+    {
+    info.blocks.push_back(block.name);
+    }
+}
+
+//------------------------------------------------------------------------------
+bool mvStreamReader::Connection::holds(int step) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return step >= 0 && step < static_cast<int>(m_steps.size()) &&
+      !m_steps[step].dropped;
+}
+
+//------------------------------------------------------------------------------
+bool mvStreamReader::Connection::read(
+    const mvReadSettings &settings, int step,
+    std::vector<vtkSmartPointer<vtkUnstructuredGrid> > &blocks,
+    std::vector<std::string> &names) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (step < 0 || step >= static_cast<int>(m_steps.size()))
+    {
+    return false;
+    }
+  if (m_steps[step].dropped)
+    {
+    return false;
+    }
+
+  // The mesh and arrays are never modified once received, so the datasets
+  // share them:
+  blocks.assign(m_blocks.size(), nullptr);
+  names.resize(m_blocks.size());
+  for (size_t i = 0; i < m_blocks.size(); ++i)
+    {
+    const Block &block = m_blocks[i];
+    names[i] = block.name;
+    if (settings.excludedBlocks.count(block.name))
+      {
+      continue;
+      }
+    blocks[i] = vtkSmartPointer<vtkUnstructuredGrid>::New();
+    blocks[i]->SetPoints(block.points);
+    blocks[i]->SetCells(block.types, block.locations, block.cells);
+    }
+
+  for (const Array &array : m_steps[step].arrays)
+    {
+    vtkUnstructuredGrid *grid = blocks[array.block];
+    if (grid && settings.variables.count(array.values->GetName()))
+      {
+      if (array.cellData)
+        {
+        grid->GetCellData()->AddArray(array.values);
+        }
+      else
+        {
+        grid->GetPointData()->AddArray(array.values);
+        }
+      }
+    }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void mvStreamReader::Connection::receiveLoop()
+{
+  if (!this->connectSocket())
+    {
+    return;
+    }
+  std::cerr << "mvStreamReader: Connected to '" << m_path << "'."
+            << std::endl;
+
+  bool ended = false;
+  while (!ended)
+    {
+    mvStreamProtocol::MessageHeader header;
+    if (!this->receive(&header, sizeof(header)))
+      {
+      break;
+      }
+    if (std::memcmp(header.magic, mvStreamProtocol::Magic,
+                    sizeof(header.magic)) != 0)
+      {
+      std::cerr << "mvStreamReader: Invalid message from '" << m_path
+                << "'. Closing the stream." << std::endl;
+      break;
+      }
+
+    bool ok = true;
+    switch (header.type)
+      {
+      case mvStreamProtocol::Block:
+        ok = this->receiveBlock(header.size);
+        break;
+      case mvStreamProtocol::Step:
+        ok = this->receiveStep(header.size);
+        break;
+      case mvStreamProtocol::End:
+        ended = true;
+        ok = this->skip(header.size);
+        break;
+      default:
+        ok = this->skip(header.size);
+        break;
+      }
+    if (!ok)
+      {
+      break;
+      }
+    }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_quit)
+    {
+    std::cerr << "mvStreamReader: The stream from '" << m_path << "' "
+              << (ended ? "ended" : "was interrupted") << " after "
+              << m_steps.size() << " timesteps." << std::endl;
+    }
+  close(m_socket);
+  m_socket = -1;
+  m_finished = true;
+  m_condition.notify_all();
+}
+
+//------------------------------------------------------------------------------
+bool mvStreamReader::Connection::connectSocket()
+{
+  sockaddr_un address;
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (m_path.size() >= sizeof(address.sun_path))
+    {
+    std::cerr << "mvStreamReader: Socket path '" << m_path << "' is too "
+                 "long." << std::endl;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_finished = true;
+    m_condition.notify_all();
+    return false;
+    }
+  std::strncpy(address.sun_path, m_path.c_str(), sizeof(address.sun_path) - 1);
+
+  // The simulation may not be listening yet:
+  bool waiting = false;
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (!m_quit)
+    {
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 &&
+        connect(fd, reinterpret_cast<sockaddr*>(&address),
+                sizeof(address)) == 0)
+      {
+      m_socket = fd;
+      return true;
+      }
+    if (fd >= 0)
+      {
+      close(fd);
+      }
+    if (!waiting)
+      {
+      std::cerr << "mvStreamReader: Waiting for a simulation to listen on '"
+                << m_path << "'..." << std::endl;
+      waiting = true;
+      }
+    m_condition.wait_for(lock, std::chrono::seconds(1),
+                         [this]() { return m_quit; });
+    }
+  return false;
+}
+
+//------------------------------------------------------------------------------
+bool mvStreamReader::Connection::receive(void *data, size_t size)
+{
+  char *dest = static_cast<char*>(data);
+  while (size > 0)
+    {
+    const ssize_t received = recv(m_socket, dest, size, 0);
+    if (received < 0 && errno == EINTR)
+      {
+      continue;
+      }
+    if (received <= 0)
+      {
+      return false;
+      }
+    dest += received;
+    size -= static_cast<size_t>(received);
+    }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool mvStreamReader::Connection::receiveString(std::string &str,
+                                               uint64_t &remaining)
+{
+  uint32_t length = 0;
+  if (remaining < sizeof(length) || !this->receive(&length, sizeof(length)) ||
+      remaining - sizeof(length) < length)
+    {
+    return false;
+    }
+  remaining -= sizeof(length) + length;
+  str.resize(length);
+  return length == 0 || this->receive(&str[0], length);
+}
+
+//------------------------------------------------------------------------------
+bool mvStreamReader::Connection::receiveBlock(uint64_t size)
+{
+  Block block;
+  uint64_t remaining = size;
+  int64_t numIds = 0;
+  if (!this->receiveString(block.name, remaining) ||
+      remaining < 3 * sizeof(int64_t) ||
+      !this->receive(&block.numPoints, sizeof(int64_t)) ||
+      !this->receive(&block.numCells, sizeof(int64_t)) ||
+      !this->receive(&numIds, sizeof(int64_t)))
+    {
+    return false;
+    }
+  remaining -= 3 * sizeof(int64_t);
+
+  // Check the sizes against the payload before allocating anything:
+  if (block.numPoints < 0 || block.numCells < 0 || numIds < 0 ||
+      remaining != static_cast<uint64_t>(block.numPoints) * 3 * sizeof(double)
+                   + static_cast<uint64_t>(block.numCells) * (1 + 8) + 8
+                   + static_cast<uint64_t>(numIds) * sizeof(int64_t))
+    {
+    std::cerr << "mvStreamReader: Block '" << block.name << "' from '"
+              << m_path << "' has an invalid size." << std::endl;
+    return false;
+    }
+
+  vtkNew<vtkDoubleArray> coordinates;
+  coordinates->SetNumberOfComponents(3);
+  coordinates->SetNumberOfTuples(block.numPoints);
+  block.types = vtkSmartPointer<vtkUnsignedCharArray>::New();
+  block.types->SetNumberOfValues(block.numCells);
+  std::vector<int64_t> offsets(static_cast<size_t>(block.numCells) + 1);
+  std::vector<int64_t> connectivity(static_cast<size_t>(numIds));
+  if (!this->receive(coordinates->GetPointer(0),
+                     static_cast<size_t>(block.numPoints) * 3 * sizeof(double)) ||
+      !this->receive(block.types->GetPointer(0),
+                     static_cast<size_t>(block.numCells)) ||
+      !this->receive(offsets.data(), offsets.size() * sizeof(int64_t)) ||
+      !this->receive(connectivity.data(),
+                     connectivity.size() * sizeof(int64_t)))
+    {
+    return false;
+    }
+
+  if (!makeCells(offsets, connectivity, block.numPoints, block.locations,
+                 block.cells))
+    {
+    std::cerr << "mvStreamReader: Block '" << block.name << "' from '"
+              << m_path << "' has invalid cells." << std::endl;
+    return false;
+    }
+  block.points = vtkSmartPointer<vtkPoints>::New();
+  block.points->SetData(coordinates.Get());
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_steps.empty())
+    {
+    std::cerr << "mvStreamReader: Ignoring block '" << block.name << "' sent "
+                 "after the first timestep." << std::endl;
+    return true;
+    }
+  m_blocks.push_back(block);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool mvStreamReader::Connection::receiveStep(uint64_t size)
+{
+  Step step;
+  uint64_t remaining = size;
+  uint32_t numArrays = 0;
+  if (remaining < sizeof(double) + sizeof(numArrays) ||
+      !this->receive(&step.time, sizeof(double)) ||
+      !this->receive(&numArrays, sizeof(numArrays)))
+    {
+    return false;
+    }
+  remaining -= sizeof(double) + sizeof(numArrays);
+
+  for (uint32_t i = 0; i < numArrays; ++i)
+    {
+    uint32_t block = 0;
+    uint8_t association = 0;
+    uint8_t valueType = 0;
+    std::string name;
+    uint32_t numComponents = 0;
+    int64_t numTuples = 0;
+    const uint64_t fixedSize = sizeof(block) + 2;
+    if (remaining < fixedSize || !this->receive(&block, sizeof(block)) ||
+        !this->receive(&association, 1) || !this->receive(&valueType, 1))
+      {
+      return false;
+      }
+    remaining -= fixedSize;
+    if (!this->receiveString(name, remaining) ||
+        remaining < sizeof(numComponents) + sizeof(numTuples) ||
+        !this->receive(&numComponents, sizeof(numComponents)) ||
+        !this->receive(&numTuples, sizeof(numTuples)))
+      {
+      return false;
+      }
+    remaining -= sizeof(numComponents) + sizeof(numTuples);
+
+    const Block *target = block < m_blocks.size() ? &m_blocks[block] : nullptr;
+    const bool cellData = association == mvStreamProtocol::CellData;
+    const size_t valueSize =
+        valueType == mvStreamProtocol::Float32 ? sizeof(float) : sizeof(double);
+    if (!target || numComponents == 0 || name.empty() ||
+        numTuples != (cellData ? target->numCells : target->numPoints) ||
+        (valueType != mvStreamProtocol::Float32 &&
+         valueType != mvStreamProtocol::Float64) ||
+        remaining < static_cast<uint64_t>(numTuples) * numComponents *
+                    valueSize)
+      {
+      std::cerr << "mvStreamReader: Array '" << name << "' from '" << m_path
+                << "' does not match its block." << std::endl;
+      return false;
+      }
+    remaining -= static_cast<uint64_t>(numTuples) * numComponents * valueSize;
+
+    Array array;
+    array.block = block;
+    array.cellData = cellData;
+    if (valueType == mvStreamProtocol::Float32)
+      {
+      array.values = vtkSmartPointer<vtkFloatArray>::New();
+      }
+    else
+      {
+      array.values = vtkSmartPointer<vtkDoubleArray>::New();
+      }
+    array.values->SetName(name.c_str());
+    array.values->SetNumberOfComponents(static_cast<int>(numComponents));
+    array.values->SetNumberOfTuples(numTuples);
+    if (!this->receive(array.values->GetVoidPointer(0),
+                       static_cast<size_t>(numTuples) * numComponents *
+                       valueSize))
+      {
+      return false;
+      }
+    step.arrays.push_back(array);
+    }
+
+  if (!this->skip(remaining))
+    {
+    return false;
+    }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (const Array &array : step.arrays)
+    {
+    (array.cellData ? m_cellVariables : m_pointVariables).insert(
+          array.values->GetName());
+    }
+  m_steps.push_back(step);
+  // Datasets already read keep their arrays, so this only releases steps no
+  // one holds:
+  if (m_steps.size() > static_cast<size_t>(StoredTimeSteps))
+    {
+    Step &old = m_steps[m_steps.size() - StoredTimeSteps - 1];
+    old.arrays.clear();
+    old.arrays.shrink_to_fit();
+    old.dropped = true;
+    }
+  m_condition.notify_all();
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool mvStreamReader::Connection::skip(uint64_t size)
+{
+  char buffer[4096];
+  while (size > 0)
+    {
+    const size_t chunk = size < sizeof(buffer) ? static_cast<size_t>(size)
+                                               : sizeof(buffer);
+    if (!this->receive(buffer, chunk))
+      {
+      return false;
+      }
+    size -= chunk;
+    }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+mvStreamReader::mvStreamReader(const std::string &fileName)
+  : mvFormatReader(fileName),
+    m_connection(connection(fileName.substr(5))) // Strip "unix:".
+{
+}
+
+//------------------------------------------------------------------------------
+mvStreamReader::~mvStreamReader()
+{
+}
+
+//------------------------------------------------------------------------------
+bool mvStreamReader::readInformation(Information &info)
+{
+  if (!m_connection->waitForFirstStep(ConnectTimeout))
+    {
+    std::cerr << "mvStreamReader: No timestep received from '"
+              << this->fileName() << "' within " << ConnectTimeout << " s."
+              << std::endl;
+    return false;
+    }
+  m_connection->information(info);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkMultiBlockDataSet>
+mvStreamReader::read(const mvReadSettings &settings, int step)
+{
+  std::vector<vtkSmartPointer<vtkUnstructuredGrid> > blocks;
+  std::vector<std::string> names;
+  if (!m_connection->read(settings, step, blocks, names))
+    {
+    std::cerr << "mvStreamReader: Timestep " << step << " has not been "
+                 "received from '" << this->fileName() << "', or is older "
+                 "than the latest " << StoredTimeSteps << ", which are all "
+                 "that is kept." << std::endl;
+    return nullptr;
+    }
+  return makeOutput(blocks, names);
+}
+
+//------------------------------------------------------------------------------
+bool mvStreamReader::canRead(int step) const
+{
+  return m_connection->holds(step);
+}
+
+//------------------------------------------------------------------------------
+std::shared_ptr<mvStreamReader::Connection>
+mvStreamReader::connection(const std::string &socketPath)
+{
+  // Connections live as long as a reader uses them:
+  static std::mutex mutex;
+  static std::map<std::string, std::weak_ptr<Connection> > connections;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  std::shared_ptr<Connection> result = connections[socketPath].lock();
+  if (!result)
+    {
+    result = std::make_shared<Connection>(socketPath);
+    connections[socketPath] = result;
+    }
+  return result;
+}
@@ -0,0 +1,63 @@
+#ifndef MVSTREAMREADER_H
+#define MVSTREAMREADER_H
+
+#include "mvFormatReader.h"
+
+#include <memory>
+#include <string>
+
+/**
+ * @brief The mvStreamReader class reads timesteps sent by a running
+ * simulation over a Unix domain socket, instead of from a file.
+ *
+ * The "file name" is "unix:<socket path>". The simulation listens on the
+ * socket; a background thread connects to it (retrying until it is there)
+ * and receives the mesh of each block once, then the field arrays of each
+ * timestep as they are computed (see mvStreamProtocol). The mesh and the
+ * arrays of the latest StoredTimeSteps timesteps are kept in memory, and
+ * read() assembles a timestep from the shared mesh and the requested arrays
+ * without copying them. Older timesteps stay in the time information, but
+ * can no longer be read.
+ *
+ * Every mvStreamReader of the same socket shares one connection, so the
+ * foreground reader, the prefetch cache and the file watcher see the same
+ * stream. New timesteps are reported by readInformation() as they arrive.
+ *
+ * See mvStreamProducer.cpp for a test producer.
+ */
+class mvStreamReader : public mvFormatReader
+{
+public:
+  explicit mvStreamReader(const std::string &fileName);
+  ~mvStreamReader();
+
+  const char* formatName() const override { return "stream"; }
+
+  /**
+   * Waits up to ConnectTimeout seconds for the first timestep to arrive.
+   * Returns false if none arrived in time.
+   */
+  bool readInformation(Information &info) override;
+  vtkSmartPointer<vtkMultiBlockDataSet> read(const mvReadSettings &settings,
+                                             int step) override;
+  bool canRead(int step) const override;
+
+  static const double ConnectTimeout;
+  static const int StoredTimeSteps;
+
+private:
+  class Connection;
+
+  // The connection to socketPath, shared by all readers of that socket.
+  static std::shared_ptr<Connection> connection(const std::string &socketPath);
+
+private:
+  // Not implemented -- disable copy:
+  mvStreamReader(const mvStreamReader&);
+  mvStreamReader& operator=(const mvStreamReader&);
+
+private:
+  std::shared_ptr<Connection> m_connection;
+};
+
+#endif // MVSTREAMREADER_H
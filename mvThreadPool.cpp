@@ -0,0 +1,79 @@
+#include "mvThreadPool.h"
+
+#include <algorithm>
+
+//------------------------------------------------------------------------------
+mvThreadPool::mvThreadPool(int numThreads)
+  : m_quit(false)
+{
+  if (numThreads < 1)
+    {
+    numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+  for (int i = 0; i < numThreads; ++i)
+    {
+    m_workers.emplace_back(&mvThreadPool::workerLoop, this);
+    }
+}
+
+//------------------------------------------------------------------------------
+mvThreadPool::~mvThreadPool()
+{
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_quit = true;
+    }
+  m_jobsAvailable.notify_all();
+  for (auto &worker : m_workers)
+    {
+    worker.join();
+    }
+}
+
+//------------------------------------------------------------------------------
+void mvThreadPool::run(const std::vector<Task> &tasks)
+{
+  if (tasks.empty())
+    {
+    return;
+    }
+
+  Batch batch;
+  batch.remaining = tasks.size();
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  for (const auto &task : tasks)
+    {
+    m_jobs.push_back(Job{task, &batch});
+    }
+  m_jobsAvailable.notify_all();
+
+  m_batchDone.wait(lock, [&batch]() { return batch.remaining == 0; });
+}
+
+//------------------------------------------------------------------------------
+void mvThreadPool::workerLoop()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  for (;;)
+    {
+    m_jobsAvailable.wait(lock, [this]() { return m_quit || !m_jobs.empty(); });
+    if (m_quit)
+      {
+      return;
+      }
+
+    Job job = m_jobs.front();
+    m_jobs.pop_front();
+
+    lock.unlock();
+    job.task();
+    lock.lock();
+
+    if (--job.batch->remaining == 0)
+      {
+      m_batchDone.notify_all();
+      }
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef MVTHREADPOOL_H
+#define MVTHREADPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief The mvThreadPool class runs batches of tasks on a fixed set of
+ * worker threads.
+ *
+ * run() queues a batch and blocks until every task in it has finished, so
+ * the caller can use the results directly. Batches from different callers
+ * may be interleaved.
+ */
+class mvThreadPool
+{
+public:
+  using Task = std::function<void()>;
+
+  /**
+   * Start @a numThreads workers. If @a numThreads is less than 1, one worker
+   * per hardware thread is started.
+   */
+  explicit mvThreadPool(int numThreads = 0);
+  ~mvThreadPool();
+
+  /** The number of worker threads. */
+  int size() const { return static_cast<int>(m_workers.size()); }
+
+  /** Execute @a tasks on the workers and wait for them to complete. */
+  void run(const std::vector<Task> &tasks);
+
+private:
+  struct Batch
+  {
+    size_t remaining;
+  };
+
+  struct Job
+  {
+    Task task;
+    Batch *batch;
+  };
+
+  void workerLoop();
+
+private:
+  // Not implemented -- disable copy:
+  mvThreadPool(const mvThreadPool&);
+  mvThreadPool& operator=(const mvThreadPool&);
+
+private:
+  std::mutex m_mutex;
+  std::condition_variable m_jobsAvailable;
+  std::condition_variable m_batchDone;
+  std::deque<Job> m_jobs;
+  bool m_quit;
+  std::vector<std::thread> m_workers;
+};
+
+#endif // MVTHREADPOOL_H
@@ -0,0 +1,241 @@
+#include "mvTimeSeries.h"
+
+#include <vtkTimerLog.h>
+
+#include <algorithm>
+#include <iostream>
+
+//------------------------------------------------------------------------------
+mvTimeSeries::mvTimeSeries()
+  : m_quit(false),
+    m_benchmark(false),
+    m_pending(false),
+    m_reading(false),
+    m_position{0., 0., 0.},
+    m_epoch(0),
+    m_readEpoch(0),
+    m_valid(false),
+    m_resultsVersion(0),
+    m_globalsPending(false),
+    m_readingGlobals(false),
+    m_globalsValid(false),
+    m_globalsVersion(0)
+{
+  // Give up on a location read as soon as it is superseded. Global variables
+  // are always read to completion.
+  m_reader.setAbortCheck([this]()
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_quit || (!m_readingGlobals && m_epoch != m_readEpoch);
+    });
+  m_worker = std::thread(&mvTimeSeries::workerLoop, this);
+}
+
+//------------------------------------------------------------------------------
+mvTimeSeries::~mvTimeSeries()
+{
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_quit = true;
+    m_pending = false;
+    }
+  m_condition.notify_all();
+  m_worker.join();
+}
+
+//------------------------------------------------------------------------------
+void mvTimeSeries::request(const mvReadSettings &settings,
+                           const std::string &variable,
+                           const double position[3])
+{
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_settings = settings;
+    m_variable = variable;
+    std::copy(position, position + 3, m_position);
+    m_pending = true;
+    ++m_epoch;
+    }
+  m_condition.notify_all();
+}
+
+//------------------------------------------------------------------------------
+void mvTimeSeries::clear()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_pending = false;
+  ++m_epoch;
+  if (m_valid)
+    {
+    m_valid = false;
+    m_result = Series();
+    ++m_resultsVersion;
+    }
+}
+
+//------------------------------------------------------------------------------
+bool mvTimeSeries::result(Series &series) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_valid)
+    {
+    return false;
+    }
+  series = m_result;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool mvTimeSeries::busy() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_pending || m_reading;
+}
+
+//------------------------------------------------------------------------------
+unsigned long mvTimeSeries::resultsVersion() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_resultsVersion;
+}
+
+//------------------------------------------------------------------------------
+void mvTimeSeries::requestGlobalVariables(const mvReadSettings &settings)
+{
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const bool newFile = settings.fileName != m_globalsSettings.fileName;
+    if (!newFile &&
+        settings.numberOfTimeSteps <= m_globalsSettings.numberOfTimeSteps)
+      {
+      return;
+      }
+    if (newFile && m_globalsValid)
+      {
+      m_globalsValid = false;
+      m_globals = GlobalVariables();
+      ++m_globalsVersion;
+      }
+    // Every piece of a decomposed dataset holds the same global variables:
+    m_globalsSettings = mvReadSettings();
+    m_globalsSettings.fileName = settings.fileName;
+    m_globalsSettings.numberOfTimeSteps = settings.numberOfTimeSteps;
+    m_globalsPending = !settings.fileName.empty();
+    }
+  m_condition.notify_all();
+}
+
+//------------------------------------------------------------------------------
+bool mvTimeSeries::globalVariables(GlobalVariables &globals) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_globalsValid)
+    {
+    return false;
+    }
+  globals = m_globals;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+unsigned long mvTimeSeries::globalVariablesVersion() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_globalsVersion;
+}
+
+//------------------------------------------------------------------------------
+void mvTimeSeries::setBenchmark(bool bench)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_benchmark = bench;
+}
+
+//------------------------------------------------------------------------------
+void mvTimeSeries::setSharedTopology(mvSharedTopology *topology)
+{
+  // The worker only uses m_reader after taking a request under the lock:
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_reader.setSharedTopology(topology);
+}
+
+//------------------------------------------------------------------------------
+void mvTimeSeries::workerLoop()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  for (;;)
+    {
+    m_condition.wait(lock, [this]()
+      {
+      return m_quit || m_pending || m_globalsPending;
+      });
+    if (m_quit)
+      {
+      return;
+      }
+
+    if (m_globalsPending)
+      {
+      const mvReadSettings settings = m_globalsSettings;
+      const bool benchmark = m_benchmark;
+      m_globalsPending = false;
+      m_readingGlobals = true;
+
+      lock.unlock();
+      const double start = vtkTimerLog::GetUniversalTime();
+      GlobalVariables globals;
+      const bool valid = m_reader.readGlobalVariables(settings, globals);
+      const double seconds = vtkTimerLog::GetUniversalTime() - start;
+      lock.lock();
+
+      m_readingGlobals = false;
+      if (m_quit || settings.fileName != m_globalsSettings.fileName)
+        {
+        continue; // The file changed while reading.
+        }
+      if (benchmark && valid)
+        {
+        std::cerr << "mvTimeSeries read " << globals.names.size()
+                  << " global variables over " << globals.times.size()
+                  << " timesteps in " << seconds << " s." << std::endl;
+        }
+      m_globalsValid = valid;
+      m_globals = valid ? globals : GlobalVariables();
+      ++m_globalsVersion;
+      continue;
+      }
+
+    const mvReadSettings settings = m_settings;
+    const std::string variable = m_variable;
+    double position[3];
+    std::copy(m_position, m_position + 3, position);
+    const bool benchmark = m_benchmark;
+    m_pending = false;
+    m_reading = true;
+    m_readEpoch = m_epoch;
+
+    lock.unlock();
+    const double start = vtkTimerLog::GetUniversalTime();
+    Series series;
+    const bool valid =
+        m_reader.readTimeSeries(settings, variable, position, series);
+    const double seconds = vtkTimerLog::GetUniversalTime() - start;
+    lock.lock();
+
+    m_reading = false;
+    if (m_quit || m_epoch != m_readEpoch)
+      {
+      continue; // Superseded or cleared; the result may be incomplete.
+      }
+    if (benchmark && valid)
+      {
+      std::cerr << "mvTimeSeries read '" << variable << "' at "
+                << (series.nodal ? "node " : "element ") << series.id
+                << " over " << series.times.size() << " timesteps in "
+                << seconds << " s." << std::endl;
+      }
+    m_valid = valid;
+    m_result = valid ? series : Series();
+    ++m_resultsVersion;
+    }
+}
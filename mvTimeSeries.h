@@ -0,0 +1,128 @@
+#ifndef MVTIMESERIES_H
+#define MVTIMESERIES_H
+
+#include "mvNativeReader.h"
+#include "mvReadSettings.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * @brief The mvTimeSeries class reads the history of a variable at a picked
+ * location on a background thread.
+ *
+ * Stepping through every timestep to plot one location would read the whole
+ * mesh at each step. Instead, the worker finds the nearest node or element
+ * and reads the variable there at all timesteps with one time-history access
+ * per component (see mvNativeReader::readTimeSeries()).
+ *
+ * Only the latest request matters: a new request replaces a pending one and
+ * abandons a read in progress.
+ *
+ * The worker also reads the global variables of the file (MOOSE
+ * postprocessors) at every timestep, one time-history read per variable, and
+ * keeps them until the file changes or grows (see requestGlobalVariables()).
+ *
+ * The public API is thread-safe.
+ */
+class mvTimeSeries
+{
+public:
+  using Series = mvNativeReader::TimeSeries;
+  using GlobalVariables = mvNativeReader::GlobalVariables;
+
+  mvTimeSeries();
+  ~mvTimeSeries();
+
+  /**
+   * Read @a variable at the location nearest @a position in the file and
+   * blocks described by @a settings.
+   */
+  void request(const mvReadSettings &settings, const std::string &variable,
+               const double position[3]);
+
+  /** Discard the result and any pending request. */
+  void clear();
+
+  /**
+   * Copy the result of the last completed request into @a series. Returns
+   * false if there is none, or if it could not be read.
+   */
+  bool result(Series &series) const;
+
+  /** True while a request is pending or being read. */
+  bool busy() const;
+
+  /** Incremented each time result() changes. */
+  unsigned long resultsVersion() const;
+
+  /**
+   * Read the global variables of the file named by @a settings, unless they
+   * have been read from it with at least settings.numberOfTimeSteps
+   * timesteps. Cheap enough to call on every frame.
+   */
+  void requestGlobalVariables(const mvReadSettings &settings);
+
+  /**
+   * Copy the global variables into @a globals. Returns false if they are not
+   * read yet, or could not be read.
+   */
+  bool globalVariables(GlobalVariables &globals) const;
+
+  /** Incremented each time globalVariables() changes. */
+  unsigned long globalVariablesVersion() const;
+
+  /** If true, print the time taken by each read to stderr. */
+  void setBenchmark(bool bench);
+
+  /**
+   * Share the mesh loaded to find locations through @a topology (see
+   * mvNativeReader::setSharedTopology()).
+   */
+  void setSharedTopology(mvSharedTopology *topology);
+
+private:
+  void workerLoop();
+
+private:
+  // Not implemented -- disable copy:
+  mvTimeSeries(const mvTimeSeries&);
+  mvTimeSeries& operator=(const mvTimeSeries&);
+
+private:
+  mutable std::mutex m_mutex;
+  std::condition_variable m_condition;
+  std::thread m_worker;
+  bool m_quit;
+  bool m_benchmark;
+
+  // The pending request:
+  bool m_pending;
+  bool m_reading;
+  mvReadSettings m_settings;
+  std::string m_variable;
+  double m_position[3];
+  // Incremented by each request and clear(), so that the worker can tell
+  // whether the read in progress (m_readEpoch) is still wanted.
+  unsigned long m_epoch;
+  unsigned long m_readEpoch;
+
+  bool m_valid;
+  Series m_result;
+  unsigned long m_resultsVersion;
+
+  // Global variables of m_globalsSettings.fileName:
+  bool m_globalsPending;
+  bool m_readingGlobals;
+  mvReadSettings m_globalsSettings;
+  bool m_globalsValid;
+  GlobalVariables m_globals;
+  unsigned long m_globalsVersion;
+
+  // Only used by the worker thread:
+  mvNativeReader m_reader;
+};
+
+#endif // MVTIMESERIES_H
@@ -0,0 +1,619 @@
+#include "mvTimeStepCache.h"
+
+#include "mvColumnarCache.h"
+#include "mvIOLock.h"
+#include "mvMemoryBudget.h"
+#include "mvSharedTopology.h"
+#include "mvSinglePrecision.h"
+#include "mvStatisticsIndex.h"
+
+#include <vtkCommand.h>
+#include <vtkExodusIIReader.h>
+#include <vtkMultiBlockDataSet.h>
+#include <vtkTimerLog.h>
+
+#include <algorithm>
+#include <iostream>
+
+//------------------------------------------------------------------------------
+mvTimeStepCache::mvTimeStepCache()
+  : m_quit(false),
+    m_capacity(0),
+    m_topology(nullptr),
+    m_columnarCache(nullptr),
+    m_statistics(nullptr),
+    m_generation(0),
+    m_readingStep(-1),
+    m_abortRead(false),
+    m_budget(nullptr),
+    m_bytes(0),
+    m_compressedCapacity(0),
+    m_codec(mvCompressedDataSet::Codec::Lossless),
+    m_tolerance(1e-4),
+    m_benchmark(false)
+{
+  m_reader->AddObserver(vtkCommand::ProgressEvent, this,
+                        &mvTimeStepCache::abortRead);
+  m_pieceReader.setNumberOfThreads(1);
+  m_pieceReader.setAbortCheck([this]() { return m_abortRead.load(); });
+  m_nativeReader.setAbortCheck([this]() { return m_abortRead.load(); });
+  m_ensembleReader.setAbortCheck([this]() { return m_abortRead.load(); });
+  m_worker = std::thread(&mvTimeStepCache::workerLoop, this);
+}
+
+//------------------------------------------------------------------------------
+mvTimeStepCache::~mvTimeStepCache()
+{
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_quit = true;
+    m_pending.clear();
+    m_abortRead = true;
+    }
+  m_condition.notify_all();
+  m_worker.join();
+}
+
+//------------------------------------------------------------------------------
+size_t mvTimeStepCache::capacity() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_capacity;
+}
+
+//------------------------------------------------------------------------------
+void mvTimeStepCache::setCapacity(size_t cap)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_capacity = cap;
+  if (m_capacity == 0)
+    {
+    m_pending.clear();
+    m_wanted.clear();
+    this->abortReadLocked();
+    }
+  this->evictLocked();
+  this->reportLocked();
+}
+
+//------------------------------------------------------------------------------
+void mvTimeStepCache::setReadSettings(const mvReadSettings &settings)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (settings != m_settings)
+    {
+    ++m_generation;
+    m_pending.clear();
+    m_wanted.clear();
+    this->abortReadLocked();
+    this->clearLocked();
+    }
+  // Always keep the timestep count current:
+  m_settings = settings;
+}
+
+//------------------------------------------------------------------------------
+void mvTimeStepCache::prefetch(const std::vector<int> &steps)
+{
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_capacity == 0 || m_settings.fileName.empty() || steps == m_wanted)
+      {
+      return;
+      }
+
+    m_wanted = steps;
+    m_pending.clear();
+    this->abortReadLocked();
+    for (int step : steps)
+      {
+      if (!this->containsLocked(step))
+        {
+        m_pending.push_back(step);
+        }
+      }
+    }
+  m_condition.notify_all();
+}
+
+//------------------------------------------------------------------------------
+mvTimeStepCache::DataObject mvTimeStepCache::find(int step)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_entries.find(step);
+  if (it != m_entries.end())
+    {
+    this->touchLocked(step);
+    return it->second;
+    }
+
+  // Not compressed yet, so it can be used as is:
+  auto queued = std::find_if(m_compressQueue.begin(), m_compressQueue.end(),
+                             [step](const std::pair<int, DataObject> &entry)
+    {
+    return entry.first == step;
+    });
+  if (queued == m_compressQueue.end())
+    {
+    return nullptr;
+    }
+  const DataObject data = queued->second;
+  m_compressQueue.erase(queued);
+  m_entries[step] = data;
+  this->touchLocked(step);
+  this->evictLocked();
+  return data;
+}
+
+//------------------------------------------------------------------------------
+mvTimeStepCache::DataObject mvTimeStepCache::decompress(int step)
+{
+  std::shared_ptr<const mvCompressedDataSet> compressed;
+  bool benchmark = false;
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_compressed.find(step);
+    if (it == m_compressed.end())
+      {
+      return nullptr;
+      }
+    compressed = it->second;
+    benchmark = m_benchmark;
+    }
+
+  const double start = vtkTimerLog::GetUniversalTime();
+  DataObject data = compressed->decompress();
+  if (benchmark)
+    {
+    std::cerr << "mvTimeStepCache decoded timestep " << step << " in "
+              << vtkTimerLog::GetUniversalTime() - start << " s." << std::endl;
+    }
+
+  // Replace the compressed entry, unless it was dropped meanwhile. One that
+  // can't be decoded is dropped, so that the timestep is read again:
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_compressed.find(step);
+  if (it != m_compressed.end() && it->second == compressed)
+    {
+    if (data)
+      {
+      this->insertLocked(step, data);
+      }
+    else
+      {
+      this->removeLocked(step);
+      this->reportLocked();
+      if (std::find(m_wanted.begin(), m_wanted.end(), step) != m_wanted.end())
+        {
+        m_pending.push_back(step);
+        m_condition.notify_all();
+        }
+      }
+    }
+  return data;
+}
+
+//------------------------------------------------------------------------------
+void mvTimeStepCache::insert(int step, vtkMultiBlockDataSet *data)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_capacity > 0 && data)
+    {
+    this->insertLocked(step, data);
+    }
+}
+
+//------------------------------------------------------------------------------
+void mvTimeStepCache::clear()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  ++m_generation;
+  m_pending.clear();
+  m_wanted.clear();
+  this->abortReadLocked();
+  this->clearLocked();
+}
+
+//------------------------------------------------------------------------------
+size_t mvTimeStepCache::trim(size_t bytes)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  const size_t before = m_bytes;
+  while (!m_lru.empty() && before - m_bytes < bytes)
+    {
+    this->removeLocked(this->victimLocked());
+    }
+  this->reportLocked();
+  return before - m_bytes;
+}
+
+//------------------------------------------------------------------------------
+void mvTimeStepCache::setMemoryBudget(mvMemoryBudget *budget)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_budget = budget;
+  this->reportLocked();
+}
+
+//------------------------------------------------------------------------------
+void mvTimeStepCache::setCompression(size_t steps,
+                                     mvCompressedDataSet::Codec codec,
+                                     double tolerance)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_compressedCapacity = steps;
+  m_codec = codec;
+  m_tolerance = tolerance;
+  this->evictLocked();
+  this->reportLocked();
+}
+
+//------------------------------------------------------------------------------
+void mvTimeStepCache::setBenchmark(bool bench)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_benchmark = bench;
+}
+
+//------------------------------------------------------------------------------
+void mvTimeStepCache::setSharedTopology(mvSharedTopology *topology)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_topology = topology;
+}
+
+//------------------------------------------------------------------------------
+void mvTimeStepCache::setColumnarCache(mvColumnarCache *cache)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_columnarCache = cache;
+}
+
+//------------------------------------------------------------------------------
+void mvTimeStepCache::setStatisticsIndex(mvStatisticsIndex *index)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_statistics = index;
+}
+
+//------------------------------------------------------------------------------
+void mvTimeStepCache::workerLoop()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  for (;;)
+    {
+    m_condition.wait(lock, [this]()
+      {
+      return m_quit || !m_pending.empty() || !m_compressQueue.empty() ||
+          this->nextDecodeLocked() >= 0;
+      });
+    if (m_quit)
+      {
+      return;
+      }
+
+    // Requested timesteps are decoded first, then read. Compressing the
+    // timesteps that went cold waits until nothing else is left to do.
+    const int decode = this->nextDecodeLocked();
+    if (decode >= 0)
+      {
+      lock.unlock();
+      this->decompress(decode);
+      lock.lock();
+      continue;
+      }
+    if (m_pending.empty())
+      {
+      this->compressNextLocked(lock);
+      continue;
+      }
+
+    const int step = m_pending.front();
+    m_pending.pop_front();
+    if (this->containsLocked(step))
+      {
+      continue;
+      }
+
+    const mvReadSettings settings = m_settings;
+    const unsigned long generation = m_generation;
+    mvSharedTopology *topology = m_topology;
+    mvColumnarCache *columnarCache = m_columnarCache;
+    mvStatisticsIndex *statistics = m_statistics;
+    mvMemoryBudget *budget = m_budget;
+    m_readingStep = step;
+    m_abortRead = false;
+
+    // Read without holding the lock:
+    lock.unlock();
+    DataObject data = columnarCache ? columnarCache->load(settings, step)
+                                    : nullptr;
+    if (!data)
+      {
+      const bool ensemble = !settings.runs.empty();
+      mvFormatReader *format = ensemble ? nullptr :
+          mvFormatReader::forFile(m_formatReader, settings.fileName);
+      if (ensemble)
+        {
+        data = m_ensembleReader.read(settings, step);
+        }
+      else if (format)
+        {
+        format->setAbortCheck([this]() { return m_abortRead.load(); });
+        data = format->read(settings, step);
+        }
+      else if (settings.nativeReader)
+        {
+        data = m_nativeReader.read(settings, step);
+        }
+      if (data || m_abortRead || format || ensemble)
+        {
+        // Read natively, by a format or ensemble reader, or abandoned.
+        }
+      else if (settings.pieces.empty())
+        {
+        mvIOLock ioLock;
+        settings.apply(m_reader.Get());
+        m_reader->SetTimeStep(step);
+        m_reader->Update();
+
+        if (m_reader->GetAbortExecute())
+          {
+          // The output is incomplete, but the pipeline considers it current:
+          m_reader->SetAbortExecute(0);
+          m_reader->Modified();
+          }
+        else
+          {
+          vtkMultiBlockDataSet *output = m_reader->GetOutput();
+          data.TakeReference(output->NewInstance());
+          data->ShallowCopy(output);
+          }
+        }
+      else
+        {
+        data = m_pieceReader.read(settings, step);
+        }
+      if (!data)
+        {
+        // Abandoned; the request that replaced this one is pending.
+        lock.lock();
+        m_readingStep = -1;
+        continue;
+        }
+      if (columnarCache)
+        {
+        columnarCache->store(settings, step, data);
+        }
+      }
+    // Statistics are exact, as they are computed before any conversion:
+    if (statistics)
+      {
+      statistics->add(settings, step, data);
+      }
+    if (settings.singlePrecision)
+      {
+      data = mvSinglePrecision::convert(data);
+      }
+    if (topology)
+      {
+      topology->share(data);
+      }
+    const bool fits = !budget ||
+        budget->request(mvMemoryBudget::dataSize(data),
+                        mvMemoryBudget::Priority::Prefetched);
+    lock.lock();
+    m_readingStep = -1;
+
+    if (!fits)
+      {
+      // Out of memory: stop prefetching until the next request.
+      m_pending.clear();
+      continue;
+      }
+
+    // Discard the result if the cache was invalidated during the read:
+    if (generation == m_generation && m_capacity > 0)
+      {
+      this->insertLocked(step, data);
+      }
+    }
+}
+
+//------------------------------------------------------------------------------
+void mvTimeStepCache::abortRead(vtkObject *caller, unsigned long, void *)
+{
+  if (m_abortRead)
+    {
+    static_cast<vtkExodusIIReader*>(caller)->SetAbortExecute(1);
+    }
+}
+
+//------------------------------------------------------------------------------
+void mvTimeStepCache::abortReadLocked()
+{
+  if (m_readingStep >= 0 &&
+      std::find(m_wanted.begin(), m_wanted.end(), m_readingStep) ==
+      m_wanted.end())
+    {
+    m_abortRead = true;
+    }
+}
+
+//------------------------------------------------------------------------------
+void mvTimeStepCache::insertLocked(int step, const DataObject &data)
+{
+  this->removeLocked(step);
+  m_entries[step] = data;
+  m_entryBytes[step] = mvMemoryBudget::dataSize(data);
+  m_bytes += m_entryBytes[step];
+  this->touchLocked(step);
+  this->evictLocked();
+  this->reportLocked();
+}
+
+//------------------------------------------------------------------------------
+void mvTimeStepCache::touchLocked(int step)
+{
+  m_lru.remove(step);
+  m_lru.push_front(step);
+}
+
+//------------------------------------------------------------------------------
+bool mvTimeStepCache::containsLocked(int step) const
+{
+  return m_entries.count(step) || m_compressed.count(step) ||
+      std::any_of(m_compressQueue.begin(), m_compressQueue.end(),
+                  [step](const std::pair<int, DataObject> &entry)
+    {
+    return entry.first == step;
+    });
+}
+
+//------------------------------------------------------------------------------
+void mvTimeStepCache::evictLocked()
+{
+  while (m_entries.size() > m_capacity)
+    {
+    const int victim = this->victimLocked(Victim::Decoded);
+    const bool wanted =
+        std::find(m_wanted.begin(), m_wanted.end(), victim) != m_wanted.end();
+    if (m_capacity > 0 && m_compressedCapacity > 0 && !wanted)
+      {
+      // Keep it for the worker to compress. Wanted steps are not, as they
+      // would be decoded again right away.
+      m_compressQueue.push_back(std::make_pair(victim, m_entries[victim]));
+      m_entries.erase(victim);
+      m_condition.notify_all();
+      }
+    else
+      {
+      this->removeLocked(victim);
+      }
+    }
+  const size_t compressedCapacity = m_capacity > 0 ? m_compressedCapacity : 0;
+  while (m_compressed.size() + m_compressQueue.size() > compressedCapacity)
+    {
+    this->removeLocked(this->victimLocked(Victim::Compressed));
+    }
+}
+
+//------------------------------------------------------------------------------
+int mvTimeStepCache::victimLocked(Victim kind) const
+{
+  auto candidate = [this, kind](int step)
+  {
+    return kind == Victim::Any ||
+        (kind == Victim::Decoded) == (m_entries.count(step) != 0);
+  };
+
+  // Prefer the least recently used step that hasn't been requested. If all
+  // entries are wanted, drop the least recently used one anyway.
+  auto victim = std::find_if(m_lru.rbegin(), m_lru.rend(),
+                             [this, &candidate](int step)
+    {
+    return candidate(step) &&
+        std::find(m_wanted.begin(), m_wanted.end(), step) == m_wanted.end();
+    });
+  if (victim == m_lru.rend())
+    {
+    victim = std::find_if(m_lru.rbegin(), m_lru.rend(), candidate);
+    }
+  return *victim;
+}
+
+//------------------------------------------------------------------------------
+int mvTimeStepCache::nextDecodeLocked() const
+{
+  for (int step : m_wanted)
+    {
+    if (m_compressed.count(step))
+      {
+      return step;
+      }
+    }
+  return -1;
+}
+
+//------------------------------------------------------------------------------
+void mvTimeStepCache::compressNextLocked(std::unique_lock<std::mutex> &lock)
+{
+  const std::pair<int, DataObject> entry = m_compressQueue.front();
+  const mvCompressedDataSet::Codec codec = m_codec;
+  const double tolerance = m_tolerance;
+  const bool benchmark = m_benchmark;
+
+  lock.unlock();
+  const double start = vtkTimerLog::GetUniversalTime();
+  std::shared_ptr<mvCompressedDataSet> compressed =
+      std::make_shared<mvCompressedDataSet>();
+  compressed->compress(entry.second, codec, tolerance);
+  const double seconds = vtkTimerLog::GetUniversalTime() - start;
+  lock.lock();
+
+  // Discard the result if the timestep became hot or was dropped meanwhile:
+  if (m_compressQueue.empty() || m_compressQueue.front() != entry)
+    {
+    return;
+    }
+  m_compressQueue.pop_front();
+  m_compressed[entry.first] = compressed;
+  m_bytes -= m_entryBytes[entry.first];
+  m_entryBytes[entry.first] = compressed->memorySize();
+  m_bytes += m_entryBytes[entry.first];
+  this->reportLocked();
+
+  if (benchmark)
+    {
+    const double before = compressed->arrayBytes() / (1024. * 1024.);
+    const double after = compressed->compressedBytes() / (1024. * 1024.);
+    std::cerr << "mvTimeStepCache compressed timestep " << entry.first
+              << " (" << (codec == mvCompressedDataSet::Codec::Lossless
+                          ? "lossless" : "error-bounded")
+              << "): " << before << " MiB to " << after << " MiB (ratio "
+              << (after > 0. ? before / after : 0.) << ") in " << seconds
+              << " s." << std::endl;
+    }
+}
+
+//------------------------------------------------------------------------------
+void mvTimeStepCache::removeLocked(int step)
+{
+  auto it = m_entryBytes.find(step);
+  if (it != m_entryBytes.end())
+    {
+    m_bytes -= it->second;
+    m_entryBytes.erase(it);
+    }
+  m_entries.erase(step);
+  m_compressed.erase(step);
+  m_compressQueue.erase(
+        std::remove_if(m_compressQueue.begin(), m_compressQueue.end(),
+                       [step](const std::pair<int, DataObject> &entry)
+    {
+    return entry.first == step;
+    }), m_compressQueue.end());
+  m_lru.remove(step);
+}
+
+//------------------------------------------------------------------------------
+void mvTimeStepCache::clearLocked()
+{
+  m_entries.clear();
+  m_compressed.clear();
+  m_compressQueue.clear();
+  m_entryBytes.clear();
+  m_lru.clear();
+  m_bytes = 0;
+  this->reportLocked();
+}
+
+//------------------------------------------------------------------------------
+void mvTimeStepCache::reportLocked()
+{
+  if (m_budget)
+    {
+    m_budget->setUsage("Cached timesteps", m_bytes,
+                       mvMemoryBudget::Priority::Prefetched);
+    }
+}
@@ -0,0 +1,234 @@
+#ifndef MVTIMESTEPCACHE_H
+#define MVTIMESTEPCACHE_H
+
+#include "mvCompressedDataSet.h"
+#include "mvEnsembleReader.h"
+#include "mvFormatReader.h"
+#include "mvNativeReader.h"
+#include "mvParallelReader.h"
+#include "mvReadSettings.h"
+
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class mvColumnarCache;
+class mvMemoryBudget;
+class mvSharedTopology;
+class mvStatisticsIndex;
+class vtkExodusIIReader;
+class vtkMultiBlockDataSet;
+class vtkObject;
+
+/**
+ * @brief The mvTimeStepCache class holds a bounded set of recently used and
+ * upcoming timesteps, and reads requested timesteps on a background thread.
+ *
+ * The cache is used by mvReader to publish a timestep without waiting on
+ * I/O. mvReader requests the timesteps it expects to need next with
+ * prefetch(), and looks up the current timestep with find(). Datasets read by
+ * the foreground reader may be added with insert() so that stepping backwards
+ * is also served from memory.
+ *
+ * All cached datasets were read using the same mvReadSettings. Changing the
+ * settings discards the cache, the pending requests, and the result of any
+ * read in progress. A read in progress is also abandoned when its timestep is
+ * dropped from the prefetch request.
+ *
+ * When the cache is full, the least recently used timestep that is not part
+ * of the current prefetch request is evicted first. The same order is used
+ * when memory is reclaimed for the memory budget (see setMemoryBudget()).
+ *
+ * Evicted timesteps may instead be kept compressed (see setCompression()).
+ * The worker compresses them once it has no reads pending, and decodes them
+ * ahead of any read when they are requested again by prefetch(). find() only
+ * returns decoded timesteps; use decompress() off the main thread to decode a
+ * compressed timestep on demand.
+ *
+ * The public API is thread-safe. The worker thread owns a private
+ * vtkExodusIIReader, so it does not interfere with the foreground reader.
+ */
+class mvTimeStepCache
+{
+public:
+  using DataObject = vtkSmartPointer<vtkMultiBlockDataSet>;
+
+  mvTimeStepCache();
+  ~mvTimeStepCache();
+
+  /**
+   * The maximum number of timesteps held in memory. A capacity of zero
+   * disables the cache. @{
+   */
+  size_t capacity() const;
+  void setCapacity(size_t cap);
+  /** @} */
+
+  /**
+   * The settings used to read cached timesteps. Changing the settings clears
+   * the cache.
+   */
+  void setReadSettings(const mvReadSettings &settings);
+
+  /**
+   * Replace the list of timesteps to read in the background. @a steps is
+   * processed in order; timesteps already in the cache are skipped.
+   */
+  void prefetch(const std::vector<int> &steps);
+
+  /**
+   * Return the cached dataset for @a step, or nullptr if it is not available.
+   */
+  DataObject find(int step);
+
+  /**
+   * Add a dataset read elsewhere with the current read settings.
+   */
+  void insert(int step, vtkMultiBlockDataSet *data);
+
+  /**
+   * Decode the compressed timestep @a step on the calling thread, and cache
+   * the result. Returns nullptr if @a step is not compressed.
+   */
+  DataObject decompress(int step);
+
+  /** Remove all cached data and pending requests. */
+  void clear();
+
+  /**
+   * Evict timesteps until at least @a bytes are freed or the cache is empty.
+   * Returns the bytes freed.
+   */
+  size_t trim(size_t bytes);
+
+  /**
+   * If set, the cached data is accounted for in @a budget, and background
+   * reads are only cached if they fit in it. Prefetching stops when the
+   * budget is exhausted. @a budget must outlive this object.
+   */
+  void setMemoryBudget(mvMemoryBudget *budget);
+
+  /**
+   * Keep up to @a steps evicted timesteps compressed with @a codec instead of
+   * discarding them. @a tolerance is the relative error bound of
+   * mvCompressedDataSet::Codec::ErrorBounded. 0 steps disables compression.
+   * Default is 0.
+   */
+  void setCompression(size_t steps, mvCompressedDataSet::Codec codec,
+                      double tolerance);
+
+  /**
+   * If true, the compression ratio and the time spent compressing and
+   * decoding each timestep are printed to stderr. Default is false.
+   */
+  void setBenchmark(bool bench);
+
+  /**
+   * If set, background reads share their mesh through @a topology.
+   * @a topology must outlive this object.
+   */
+  void setSharedTopology(mvSharedTopology *topology);
+
+  /**
+   * If set, background reads are served from and written to @a cache.
+   * @a cache must outlive this object.
+   */
+  void setColumnarCache(mvColumnarCache *cache);
+
+  /**
+   * If set, background reads add their statistics to @a index. @a index must
+   * outlive this object.
+   */
+  void setStatisticsIndex(mvStatisticsIndex *index);
+
+private:
+  void workerLoop();
+
+  // Progress observer of m_reader.
+  void abortRead(vtkObject *caller, unsigned long, void *);
+
+  // Which entries victimLocked() considers:
+  enum class Victim
+  {
+    Any,
+    Decoded,
+    Compressed // Or waiting to be compressed.
+  };
+
+  // These require m_mutex to be held:
+  void abortReadLocked(); // If m_readingStep is no longer wanted.
+  void insertLocked(int step, const DataObject &data);
+  bool containsLocked(int step) const;
+  void touchLocked(int step);
+  void evictLocked();
+  // The next step to evict. There must be an entry of the given kind.
+  int victimLocked(Victim kind = Victim::Any) const;
+  int nextDecodeLocked() const; // A wanted compressed step, or -1.
+  void compressNextLocked(std::unique_lock<std::mutex> &lock);
+  void removeLocked(int step);
+  void clearLocked();
+  void reportLocked();
+
+private:
+  // Not implemented -- disable copy:
+  mvTimeStepCache(const mvTimeStepCache&);
+  mvTimeStepCache& operator=(const mvTimeStepCache&);
+
+private:
+  mutable std::mutex m_mutex;
+  std::condition_variable m_condition;
+  std::thread m_worker;
+  bool m_quit;
+
+  size_t m_capacity;
+  mvReadSettings m_settings;
+  mvSharedTopology *m_topology;
+  mvColumnarCache *m_columnarCache;
+  mvStatisticsIndex *m_statistics;
+
+  // Incremented when the cached data is invalidated, so that the worker can
+  // detect that its current read is stale.
+  unsigned long m_generation;
+
+  std::deque<int> m_pending;
+  std::vector<int> m_wanted;
+
+  // The step the worker is reading, or -1. The read stops once m_abortRead is
+  // set.
+  int m_readingStep;
+  std::atomic<bool> m_abortRead;
+
+  std::map<int, DataObject> m_entries;
+  std::list<int> m_lru; // Front is most recently used.
+
+  mvMemoryBudget *m_budget;
+  std::map<int, size_t> m_entryBytes;
+  size_t m_bytes;
+
+  // Compressed timesteps. Evicted timesteps wait in m_compressQueue, still
+  // decoded, until the worker compresses them.
+  size_t m_compressedCapacity;
+  mvCompressedDataSet::Codec m_codec;
+  double m_tolerance;
+  std::deque<std::pair<int, DataObject> > m_compressQueue;
+  std::map<int, std::shared_ptr<const mvCompressedDataSet> > m_compressed;
+  bool m_benchmark;
+
+  // Only used by the worker thread:
+  vtkNew<vtkExodusIIReader> m_reader;
+  mvParallelReader m_pieceReader; // Joins decomposed datasets.
+  mvNativeReader m_nativeReader;
+  mvEnsembleReader m_ensembleReader; // Reads runs side by side.
+  std::unique_ptr<mvFormatReader> m_formatReader; // Non-Exodus files.
+};
+
+#endif // MVTIMESTEPCACHE_H
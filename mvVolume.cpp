@@ -1,13 +1,16 @@
 #include "mvVolume.h"
 
 #include <vtkColorTransferFunction.h>
+#include <vtkCellData.h>
 #include <vtkCompositeDataIterator.h>
+#include <vtkDataArray.h>
 #include <vtkExternalOpenGLRenderer.h>
 #include <vtkImageData.h>
 #include <vtkLookupTable.h>
 #include <vtkMultiBlockDataSet.h>
 #include <vtkNew.h>
 #include <vtkPiecewiseFunction.h>
+#include <vtkPointData.h>
 #include <vtkResampleToImage.h>
 #include <vtkSmartVolumeMapper.h>
 #include <vtkVolume.h>
@@ -20,6 +23,50 @@
 #include "mvApplicationState.h"
 #include "mvReader.h"
 
+#include <iostream>
+
+namespace {
+
+//------------------------------------------------------------------------------
+// Estimate the size of the image vtkResampleToImage produces from input.
+// Every point and cell array becomes a point array, plus a validity mask.
+size_t estimateResampledSize(vtkDataObject *input, int dimension)
+{
+  size_t bytesPerPoint = 1;
+  vtkCompositeDataSet *cds = vtkCompositeDataSet::SafeDownCast(input);
+  vtkDataSet *leaf = vtkDataSet::SafeDownCast(input);
+  if (cds)
+    {
+    vtkCompositeDataIterator *iter = cds->NewIterator();
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal() && !leaf;
+         iter->GoToNextItem())
+      {
+      leaf = vtkDataSet::SafeDownCast(iter->GetCurrentDataObject());
+      }
+    iter->Delete();
+    }
+  if (leaf)
+    {
+    vtkFieldData *fields[2] = { leaf->GetPointData(), leaf->GetCellData() };
+    for (vtkFieldData *fd : fields)
+      {
+      for (int i = 0; i < fd->GetNumberOfArrays(); ++i)
+        {
+        if (vtkDataArray *array = fd->GetArray(i))
+          {
+          bytesPerPoint += array->GetDataTypeSize() *
+              array->GetNumberOfComponents();
+          }
+        }
+      }
+    }
+
+  const size_t dim = static_cast<size_t>(dimension > 0 ? dimension : 0);
+  return dim * dim * dim * bytesPerPoint;
+}
+
+} // end anon namespace
+
 //------------------------------------------------------------------------------
 mvVolume::VolumeState::VolumeState()
   : renderMode(vtkSmartVolumeMapper::DefaultRenderMode),
@@ -176,6 +223,7 @@ void mvVolume::VolumeRenderPipeline::disable()
 //------------------------------------------------------------------------------
 mvVolume::HiResDataPipeline::HiResDataPipeline()
 {
+  this->cancel.watch(this->filter.Get());
 }
 
 //------------------------------------------------------------------------------
@@ -186,10 +234,18 @@ void mvVolume::HiResDataPipeline::configure(const ObjectState &objState,
       static_cast<const mvApplicationState &>(vvState);
   const VolumeState &state = static_cast<const VolumeState&>(objState);
 
+  this->memory.configure(appState.memoryBudget(), state.visible);
+  this->cancel.configure(appState.reader());
   this->filter->SetInputDataObject(appState.reader().dataObject());
   this->filter->SetSamplingDimensions(state.dimension, state.dimension,
                                       state.dimension);
 
+  vtkDataObject *input = this->filter->GetInputDataObject(0, 0);
+  if (input)
+    {
+    this->memory.request(estimateResampledSize(input, state.dimension),
+                         this->filter->GetMTime());
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -199,8 +255,15 @@ bool mvVolume::HiResDataPipeline::needsUpdate(const ObjectState &objState,
   const VolumeState &state = static_cast<const VolumeState&>(objState);
   const VolumeLODData &data = static_cast<const VolumeLODData&>(result);
 
+  if (this->memory.release())
+    {
+    return data.volume != nullptr;
+    }
+
   return
       state.visible &&
+      this->memory.allowed() &&
+      !this->cancel.superseded() &&
       this->filter->GetInputDataObject(0, 0) &&
       (!data.volume ||
        data.volume->GetMTime() < this->filter->GetMTime());
@@ -209,16 +272,33 @@ bool mvVolume::HiResDataPipeline::needsUpdate(const ObjectState &objState,
 //------------------------------------------------------------------------------
 void mvVolume::HiResDataPipeline::execute()
 {
-  this->filter->Update();
+  if (!this->memory.release() && this->cancel.start())
+    {
+    this->filter->Update();
+    }
+  this->cancel.finish();
 }
 
 //------------------------------------------------------------------------------
 void mvVolume::HiResDataPipeline::exportResult(LODData &result) const
 {
   VolumeLODData &data = static_cast<VolumeLODData&>(result);
-  vtkDataObject *dObj = this->filter->GetOutputDataObject(0);
-  data.volume.TakeReference(dObj->NewInstance());
-  data.volume->ShallowCopy(dObj);
+  if (!this->memory.release() && this->cancel.cancelled())
+    {
+    // Keep the previous volume until the current timestep is resampled:
+    return;
+    }
+  if (this->memory.release())
+    {
+    data.volume = nullptr;
+    }
+  else
+    {
+    vtkDataObject *dObj = this->filter->GetOutputDataObject(0);
+    data.volume.TakeReference(dObj->NewInstance());
+    data.volume->ShallowCopy(dObj);
+    }
+  this->memory.exportResult(data.volume);
 }
 
 //------------------------------------------------------------------------------
@@ -3,6 +3,9 @@
 
 #include "vvLODAsyncGLObject.h"
 
+#include "mvCancellation.h"
+#include "mvMemoryBudget.h"
+
 #include <vtkNew.h>
 #include <vtkSmartPointer.h>
 
@@ -81,6 +84,8 @@ public:
   struct HiResDataPipeline : public Superclass::DataPipeline
   {
     vtkNew<vtkResampleToImage> filter;
+    mvMemoryBudget::Result memory{"Volume"};
+    mvCancellation cancel;
 
     HiResDataPipeline();
     void configure(const ObjectState &objState,
@@ -0,0 +1,308 @@
+#include "mvXMLReader.h"
+
+#include <vtkDataArraySelection.h>
+#include <vtkMultiBlockDataSet.h>
+#include <vtkNew.h>
+#include <vtkUnstructuredGrid.h>
+#include <vtkXMLDataElement.h>
+#include <vtkXMLDataParser.h>
+#include <vtkXMLUnstructuredGridReader.h>
+
+#include <dirent.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+namespace {
+
+//------------------------------------------------------------------------------
+bool isNumber(const std::string &str)
+{
+  if (str.empty())
+    {
+    return false;
+    }
+  for (char c : str)
+    {
+    if (!std::isdigit(static_cast<unsigned char>(c)))
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// The directory of fileName including the trailing slash, or "" if none.
+std::string directory(const std::string &fileName)
+{
+  const size_t slash = fileName.rfind('/');
+  return slash == std::string::npos ? std::string()
+                                    : fileName.substr(0, slash + 1);
+}
+
+//------------------------------------------------------------------------------
+// Enable the arrays of selection that are in variables, disable the others.
+void selectArrays(vtkDataArraySelection *selection,
+                  const std::set<std::string> &variables)
+{
+  const int numArrays = selection->GetNumberOfArrays();
+  for (int i = 0; i < numArrays; ++i)
+    {
+    const char *name = selection->GetArrayName(i);
+    selection->SetArraySetting(name, variables.count(name) ? 1 : 0);
+    }
+}
+
+} // end anon namespace
+
+//------------------------------------------------------------------------------
+mvXMLReader::mvXMLReader(const std::string &fileName)
+  : mvFormatReader(fileName)
+{
+}
+
+//------------------------------------------------------------------------------
+mvXMLReader::~mvXMLReader()
+{
+}
+
+//------------------------------------------------------------------------------
+bool mvXMLReader::readInformation(Information &info)
+{
+  // Look again, to pick up files added to the series:
+  this->findSeries();
+
+  std::vector<std::string> pieces;
+  info.pointVariables.clear();
+  info.cellVariables.clear();
+  if (!this->readPieces(m_series.front(), pieces, &info.pointVariables,
+                        &info.cellVariables))
+    {
+    return false;
+    }
+
+  info.numberOfTimeSteps = static_cast<int>(m_series.size());
+  info.times.clear();
+  for (size_t i = 0; i < m_series.size(); ++i)
+    {
+    info.times.push_back(static_cast<double>(i));
+    }
+  info.blocks.clear();
+  for (size_t i = 0; i < pieces.size(); ++i)
+    {
+    info.blocks.push_back("Piece " + std::to_string(i));
+    }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkMultiBlockDataSet>
+mvXMLReader::read(const mvReadSettings &settings, int step)
+{
+  if (m_series.empty() ||
+      settings.numberOfTimeSteps > static_cast<int>(m_series.size()))
+    {
+    this->findSeries();
+    }
+  if (step < 0 || step >= static_cast<int>(m_series.size()))
+    {
+    std::cerr << "mvXMLReader: Timestep " << step << " is not in the series "
+                 "of '" << this->fileName() << "'." << std::endl;
+    return nullptr;
+    }
+
+  std::vector<std::string> pieces;
+  if (!this->readPieces(m_series[step], pieces))
+    {
+    return nullptr;
+    }
+
+  std::vector<vtkSmartPointer<vtkUnstructuredGrid> > blocks(pieces.size());
+  std::vector<std::string> names(pieces.size());
+  for (size_t i = 0; i < pieces.size(); ++i)
+    {
+    names[i] = "Piece " + std::to_string(i);
+    if (settings.excludedBlocks.count(names[i]))
+      {
+      continue;
+      }
+    if (this->aborted())
+      {
+      return nullptr;
+      }
+
+    vtkNew<vtkXMLUnstructuredGridReader> reader;
+    reader->SetFileName(pieces[i].c_str());
+    reader->UpdateInformation();
+    selectArrays(reader->GetPointDataArraySelection(), settings.variables);
+    selectArrays(reader->GetCellDataArraySelection(), settings.variables);
+    reader->Update();
+
+    vtkUnstructuredGrid *output = reader->GetOutput();
+    if (!output || reader->GetErrorCode() != 0)
+      {
+      std::cerr << "mvXMLReader: Cannot read piece '" << pieces[i] << "'."
+                << std::endl;
+      return nullptr;
+      }
+    blocks[i] = vtkSmartPointer<vtkUnstructuredGrid>::New();
+    blocks[i]->ShallowCopy(output);
+    }
+
+  return makeOutput(blocks, names);
+}
+
+//------------------------------------------------------------------------------
+void mvXMLReader::findSeries()
+{
+  const std::string &fileName = this->fileName();
+  m_series.assign(1, fileName);
+
+  // Split "<dir>/<prefix><number><ext>":
+  const std::string dir = directory(fileName);
+  const std::string base = fileName.substr(dir.size());
+  const size_t dot = base.rfind('.');
+  if (dot == std::string::npos)
+    {
+    return;
+    }
+  size_t digits = dot;
+  while (digits > 0 &&
+         std::isdigit(static_cast<unsigned char>(base[digits - 1])))
+    {
+    --digits;
+    }
+  if (digits == dot)
+    {
+    return;
+    }
+  const std::string prefix = base.substr(0, digits);
+  const std::string ext = base.substr(dot);
+
+  DIR *handle = opendir(dir.empty() ? "." : dir.c_str());
+  if (!handle)
+    {
+    return;
+    }
+  std::vector<std::pair<long long, std::string> > files;
+  while (dirent *entry = readdir(handle))
+    {
+    const std::string name = entry->d_name;
+    if (name.size() <= prefix.size() + ext.size() ||
+        name.compare(0, prefix.size(), prefix) != 0 ||
+        name.compare(name.size() - ext.size(), ext.size(), ext) != 0)
+      {
+      continue;
+      }
+    const std::string number = name.substr(
+          prefix.size(), name.size() - prefix.size() - ext.size());
+    if (isNumber(number))
+      {
+      files.push_back(std::make_pair(std::atoll(number.c_str()), dir + name));
+      }
+    }
+  closedir(handle);
+
+  std::sort(files.begin(), files.end());
+  if (files.size() > 1)
+    {
+    m_series.clear();
+    for (const auto &file : files)
+      {
+      m_series.push_back(file.second);
+      }
+    }
+}
+
+//------------------------------------------------------------------------------
+bool mvXMLReader::readPieces(const std::string &fileName,
+                             std::vector<std::string> &pieces,
+                             std::set<std::string> *pointArrays,
+                             std::set<std::string> *cellArrays) const
+{
+  pieces.clear();
+  const std::string ext = fileName.size() >= 5 ?
+        fileName.substr(fileName.size() - 5) : std::string();
+  if (ext != ".pvtu" && ext != ".PVTU")
+    {
+    // A serial file is its only piece:
+    pieces.push_back(fileName);
+    if (pointArrays || cellArrays)
+      {
+      vtkNew<vtkXMLUnstructuredGridReader> reader;
+      reader->SetFileName(fileName.c_str());
+      reader->UpdateInformation();
+      if (reader->GetErrorCode() != 0)
+        {
+        std::cerr << "mvXMLReader: Cannot read '" << fileName << "'."
+                  << std::endl;
+        return false;
+        }
+      vtkDataArraySelection *points = reader->GetPointDataArraySelection();
+      for (int i = 0; pointArrays && i < points->GetNumberOfArrays(); ++i)
+        {
+        pointArrays->insert(points->GetArrayName(i));
+        }
+      vtkDataArraySelection *cells = reader->GetCellDataArraySelection();
+      for (int i = 0; cellArrays && i < cells->GetNumberOfArrays(); ++i)
+        {
+        cellArrays->insert(cells->GetArrayName(i));
+        }
+      }
+    return true;
+    }
+
+  // The summary file only lists the pieces and arrays, so parse it directly
+  // instead of reading any piece:
+  vtkNew<vtkXMLDataParser> parser;
+  parser->SetFileName(fileName.c_str());
+  vtkXMLDataElement *grid = nullptr;
+  if (parser->Parse() && parser->GetRootElement())
+    {
+    grid = parser->GetRootElement()->FindNestedElementWithName(
+          "PUnstructuredGrid");
+    }
+  if (!grid)
+    {
+    std::cerr << "mvXMLReader: '" << fileName << "' is not a partitioned "
+                 "unstructured grid." << std::endl;
+    return false;
+    }
+
+  // Piece sources are relative to the summary file:
+  const std::string dir = directory(fileName);
+  for (int i = 0; i < grid->GetNumberOfNestedElements(); ++i)
+    {
+    vtkXMLDataElement *element = grid->GetNestedElement(i);
+    const char *name = element->GetName();
+    std::set<std::string> *arrays =
+        std::strcmp(name, "PPointData") == 0 ? pointArrays :
+        std::strcmp(name, "PCellData") == 0 ? cellArrays : nullptr;
+    if (std::strcmp(name, "Piece") == 0)
+      {
+      const char *source = element->GetAttribute("Source");
+      if (source)
+        {
+        pieces.push_back(source[0] == '/' ? std::string(source)
+                                          : dir + source);
+        }
+      }
+    else if (arrays)
+      {
+      for (int j = 0; j < element->GetNumberOfNestedElements(); ++j)
+        {
+        const char *array = element->GetNestedElement(j)->GetAttribute("Name");
+        if (array)
+          {
+          arrays->insert(array);
+          }
+        }
+      }
+    }
+  return true;
+}
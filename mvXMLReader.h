@@ -0,0 +1,55 @@
+#ifndef MVXMLREADER_H
+#define MVXMLREADER_H
+
+#include "mvFormatReader.h"
+
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The mvXMLReader class reads partitioned (.pvtu) and serial (.vtu)
+ * VTK XML unstructured grids.
+ *
+ * Each piece of a .pvtu file is presented as an element block named
+ * "Piece N"; a .vtu file has the single block "Piece 0". The pieces are read
+ * one at a time with vtkXMLUnstructuredGridReader, with every array that is
+ * not requested disabled, so unrequested arrays are skipped in the file.
+ *
+ * A file whose name ends in a number before the extension ("run_0012.pvtu")
+ * is read as part of a file series: every file in its directory with the
+ * same prefix and extension is a timestep, in numerical order, with the
+ * series index as its time. Other files have a single timestep at time 0.
+ */
+class mvXMLReader : public mvFormatReader
+{
+public:
+  explicit mvXMLReader(const std::string &fileName);
+  ~mvXMLReader();
+
+  const char* formatName() const override { return "VTK XML"; }
+
+  bool readInformation(Information &info) override;
+  vtkSmartPointer<vtkMultiBlockDataSet> read(const mvReadSettings &settings,
+                                             int step) override;
+
+private:
+  // Set m_series to the files of the series the file belongs to.
+  void findSeries();
+
+  // The piece files of fileName, and the names of its arrays if requested.
+  bool readPieces(const std::string &fileName,
+                  std::vector<std::string> &pieces,
+                  std::set<std::string> *pointArrays = nullptr,
+                  std::set<std::string> *cellArrays = nullptr) const;
+
+private:
+  // Not implemented -- disable copy:
+  mvXMLReader(const mvXMLReader&);
+  mvXMLReader& operator=(const mvXMLReader&);
+
+private:
+  std::vector<std::string> m_series; // One file per timestep.
+};
+
+#endif // MVXMLREADER_H